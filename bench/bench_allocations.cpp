@@ -0,0 +1,131 @@
+#include "bench_data.h"
+#include "alpha/alpha_engine.h"
+#include "alpha/alpha_pipeline.h"
+#include "alpha/signal_sink.h"
+#include "util/symbol_registry.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Heap allocations per tick in steady state, counted by replacing the global
+// operator new for this binary. The hot path is meant to allocate nothing
+// once warm, so these benchmarks fail (SkipWithError) on any allocation
+// inside the timed loop.
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+
+void* countedAlloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+uint64_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void reportAllocations(benchmark::State& state, uint64_t count, uint64_t ticks) {
+    state.counters["allocs_per_tick"] = ticks ? static_cast<double>(count) / static_cast<double>(ticks) : 0.0;
+    if (count > 0) {
+        state.SkipWithError(("hot path allocated " + std::to_string(count) + " times").c_str());
+    }
+}
+
+// Swallows signals; only here so the engine builds and delivers them
+class NullSink : public SignalSink {
+public:
+    void onAlphaSignal(const AlphaSignal& signal) override { benchmark::DoNotOptimize(&signal); }
+};
+
+constexpr size_t TICKS_PER_SYMBOL = 1 << 14;
+constexpr size_t WARMUP_TICKS = 2000;
+
+// range(0) symbols through one FullAlphaPipeline each, round robin
+void BM_AllocationsFullPipeline(benchmark::State& state) {
+    const auto numSymbols = static_cast<size_t>(state.range(0));
+
+    std::vector<std::vector<MarketTick>> perSymbol;
+    std::vector<std::unique_ptr<FullAlphaPipeline>> pipelines;
+    for (size_t s = 0; s < numSymbols; ++s) {
+        std::string symbol = "ALLOC" + std::to_string(s);
+        perSymbol.push_back(bench::syntheticTicks(TICKS_PER_SYMBOL, symbol, static_cast<uint32_t>(s + 11)));
+        for (auto& tick : perSymbol.back()) tick.symbolId = SymbolRegistry::instance().intern(symbol);
+        pipelines.push_back(std::make_unique<FullAlphaPipeline>());
+    }
+
+    for (size_t i = 0; i < WARMUP_TICKS; ++i) {
+        for (size_t s = 0; s < numSymbols; ++s) pipelines[s]->onTick(perSymbol[s][i]);
+    }
+
+    size_t i = WARMUP_TICKS;
+    uint64_t ticks = 0;
+    const uint64_t before = allocationCount();
+    for (auto _ : state) {
+        for (size_t s = 0; s < numSymbols; ++s) {
+            benchmark::DoNotOptimize(pipelines[s]->onTick(perSymbol[s][i]));
+        }
+        ticks += numSymbols;
+        if (++i == TICKS_PER_SYMBOL) i = WARMUP_TICKS;
+    }
+    const uint64_t count = allocationCount() - before;
+
+    state.SetItemsProcessed(static_cast<int64_t>(ticks));
+    reportAllocations(state, count, ticks);
+}
+BENCHMARK(BM_AllocationsFullPipeline)->Arg(1)->Arg(8);
+
+// AlphaEngine tick and candle signals delivered to a sink, with a
+// one-minute candle every 60 ticks
+void BM_AllocationsAlphaEngine(benchmark::State& state) {
+    const auto data = bench::syntheticTicks(TICKS_PER_SYMBOL, "ALLOCENGINE");
+    const SymbolId id = SymbolRegistry::instance().intern("ALLOCENGINE");
+
+    NullSink sink;
+    AlphaEngine engine(20, "1m", &sink);
+
+    Candle candle{};
+    candle.symbolId = id;
+    candle.intervalSeconds = 60;
+
+    auto onTick = [&](const MarketTick& tick, size_t n) {
+        benchmark::DoNotOptimize(engine.onTick(tick));
+        if (n % 60 == 0) {
+            candle.open = candle.high = candle.low = candle.close = tick.price;
+            candle.volume = tick.volume * 60.0;
+            candle.endTime = std::chrono::system_clock::time_point(std::chrono::milliseconds(tick.timestamp));
+            engine.onCandle(candle);
+        }
+    };
+
+    for (size_t i = 0; i < WARMUP_TICKS; ++i) onTick(data[i], i);
+
+    size_t i = WARMUP_TICKS;
+    uint64_t ticks = 0;
+    const uint64_t before = allocationCount();
+    for (auto _ : state) {
+        onTick(data[i], i);
+        ++ticks;
+        if (++i == TICKS_PER_SYMBOL) i = WARMUP_TICKS;
+    }
+    const uint64_t count = allocationCount() - before;
+
+    state.SetItemsProcessed(static_cast<int64_t>(ticks));
+    reportAllocations(state, count, ticks);
+}
+BENCHMARK(BM_AllocationsAlphaEngine);
+
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
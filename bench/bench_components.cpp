@@ -0,0 +1,123 @@
+#include "bench_data.h"
+#include "alpha/alpha_engine.h"
+#include "alpha/microstructure.h"
+#include "alpha/orderflow.h"
+#include "alpha/regime.h"
+#include "alpha/vwap.h"
+#include "backtest/backtester.h"
+#include "backtest/sharpe.h"
+#include "backtest/tick_store.h"
+#include <benchmark/benchmark.h>
+
+// Per-component costs, one tick per iteration. Each analyzer is warmed on a
+// full window first so the numbers are steady state, not fill-up.
+
+namespace {
+
+constexpr size_t TICKS = 1 << 16;
+
+const std::vector<MarketTick>& ticks() {
+    static const std::vector<MarketTick> data = bench::syntheticTicks(TICKS);
+    return data;
+}
+
+template <typename Fn>
+void runTicks(benchmark::State& state, size_t warmup, Fn&& onTick) {
+    const auto& data = ticks();
+    for (size_t i = 0; i < warmup; ++i) onTick(data[i % TICKS]);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        onTick(data[i]);
+        i = (i + 1) & (TICKS - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_AlphaEngineOnTick(benchmark::State& state) {
+    const auto window = static_cast<size_t>(state.range(0));
+    AlphaEngine engine(window, "1m");
+    runTicks(state, window * 2, [&](const MarketTick& t) {
+        benchmark::DoNotOptimize(engine.onTick(t));
+    });
+}
+BENCHMARK(BM_AlphaEngineOnTick)->Arg(20)->Arg(100)->Arg(1000);
+
+void BM_MicrostructureOnTick(benchmark::State& state) {
+    const auto bucket = static_cast<size_t>(state.range(0));
+    MicrostructureAnalyzer analyzer(bucket, 50, 100);
+    runTicks(state, bucket * 100, [&](const MarketTick& t) {
+        analyzer.onTick(t);
+        benchmark::DoNotOptimize(analyzer.getVPIN());
+        benchmark::DoNotOptimize(analyzer.getHasbrouckMetrics());
+    });
+}
+BENCHMARK(BM_MicrostructureOnTick)->Arg(10)->Arg(50)->Arg(250);
+
+void BM_RegimeOnTick(benchmark::State& state) {
+    const auto window = static_cast<size_t>(state.range(0));
+    RegimeDetector regime(window, 20, 50);
+    runTicks(state, window * 2, [&](const MarketTick& t) {
+        regime.onTick(t);
+        benchmark::DoNotOptimize(regime.getMetrics());
+    });
+}
+BENCHMARK(BM_RegimeOnTick)->Arg(100)->Arg(500)->Arg(2000);
+
+void BM_OrderFlowOnTick(benchmark::State& state) {
+    OrderFlowEngine orderflow;
+    double lastPrice = 0.0;
+    runTicks(state, 1000, [&](const MarketTick& t) {
+        benchmark::DoNotOptimize(orderflow.onTick(t, t.price > lastPrice));
+        lastPrice = t.price;
+    });
+}
+BENCHMARK(BM_OrderFlowOnTick);
+
+void BM_VWAPOnTick(benchmark::State& state) {
+    const auto window = static_cast<size_t>(state.range(0));
+    VWAPCalculator vwap(2.0, window);
+    runTicks(state, window + 1000, [&](const MarketTick& t) {
+        vwap.onTick(t);
+        benchmark::DoNotOptimize(vwap.getMetrics());
+    });
+}
+BENCHMARK(BM_VWAPOnTick)->Arg(0)->Arg(100)->Arg(1000);
+
+void BM_ComputeAllMetrics(benchmark::State& state) {
+    const auto returns = bench::syntheticReturns(static_cast<size_t>(state.range(0)));
+    const auto equity = bench::equityFromReturns(returns);
+    std::vector<double> scratch;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(computeAllMetrics(returns, equity, 0.0, scratch));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ComputeAllMetrics)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Whole backtest over columnar ticks with a cheap moving-average signal, so the
+// number is dominated by the backtester's own fill / PnL bookkeeping
+void BM_BacktesterRun(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const TickColumns columns = TickColumns::fromTicks(bench::syntheticTicks(n));
+    const TickView view = columns.view();
+
+    BacktestConfig config;
+    Backtester backtester(config);
+
+    for (auto _ : state) {
+        BacktestContext ctx(config.initialCapital, false);
+        double fast = 0.0, slow = 0.0;
+        auto signal = [&](const CompactTick& t) {
+            fast += 0.2 * (t.price - fast);
+            slow += 0.02 * (t.price - slow);
+            return slow == 0.0 ? 0 : (fast > slow * 1.0005 ? 1 : (fast < slow * 0.9995 ? -1 : 0));
+        };
+        benchmark::DoNotOptimize(backtester.run(ctx, view, signal));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BacktesterRun)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+}
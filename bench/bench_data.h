@@ -0,0 +1,53 @@
+#pragma once
+#include "util/market_types.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <cstdint>
+
+// Deterministic synthetic market data shared by the benchmarks: a geometric
+// random walk with mild mean reversion and lognormal trade sizes, so the
+// analyzers see realistic branches (up / down / zero ticks, varying volume)
+namespace bench {
+
+inline std::vector<MarketTick> syntheticTicks(size_t n, const std::string& symbol = "BENCH",
+                                              uint32_t seed = 42) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> shock(0.0, 0.0005);
+    std::lognormal_distribution<double> size(0.0, 1.0);
+    std::bernoulli_distribution unchanged(0.2);
+
+    std::vector<MarketTick> ticks;
+    ticks.reserve(n);
+
+    double price = 100.0;
+    long timestamp = 1700000000000L;
+    for (size_t i = 0; i < n; ++i) {
+        if (!unchanged(rng)) {
+            price *= std::exp(shock(rng) - 0.01 * std::log(price / 100.0));
+        }
+        timestamp += 1 + static_cast<long>(i % 7);
+        ticks.push_back(MarketTick{symbol, price, size(rng), timestamp});
+    }
+    return ticks;
+}
+
+inline std::vector<double> syntheticReturns(size_t n, uint32_t seed = 7) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> r(0.0002, 0.01);
+
+    std::vector<double> returns(n);
+    for (auto& x : returns) x = r(rng);
+    return returns;
+}
+
+inline std::vector<double> equityFromReturns(const std::vector<double>& returns, double start = 10000.0) {
+    std::vector<double> equity;
+    equity.reserve(returns.size() + 1);
+    equity.push_back(start);
+    for (double r : returns) equity.push_back(equity.back() * (1.0 + r));
+    return equity;
+}
+
+}
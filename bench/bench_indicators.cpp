@@ -0,0 +1,368 @@
+#include "bench_data.h"
+#include "alpha/indicator_kernels.h"
+#include "alpha/indicators.h"
+#include "alpha/streaming_indicators.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Batch indicator kernels against the scalar functions in indicators.h. Before
+// timing, every kernel output on a CHECK_BARS series is compared with the
+// scalar function on the same prefix; any difference beyond TOLERANCE fails
+// the benchmark (SkipWithError), so a kernel that drifts can't post a number.
+// The streaming MACD / ATR / stochastic get the same check, bar by bar; where
+// the scalar function approximates (MACD signal, %D) the reference is the
+// exact definition built from the scalar values.
+
+namespace {
+
+constexpr size_t CHECK_BARS = 1500;
+constexpr double TOLERANCE = 1e-9;
+
+// OHLC-ish bars from the synthetic tick walk: close is every 8th tick,
+// high / low the extremes of those 8
+struct Bars {
+    std::vector<double> highs, lows, closes, volumes;
+};
+
+Bars syntheticBars(size_t n) {
+    constexpr size_t TICKS_PER_BAR = 8;
+    const auto ticks = bench::syntheticTicks(n * TICKS_PER_BAR);
+
+    Bars bars;
+    for (size_t b = 0; b < n; ++b) {
+        double high = ticks[b * TICKS_PER_BAR].price, low = high, volume = 0.0;
+        for (size_t i = b * TICKS_PER_BAR; i < (b + 1) * TICKS_PER_BAR; ++i) {
+            high = std::max(high, ticks[i].price);
+            low = std::min(low, ticks[i].price);
+            volume += ticks[i].volume;
+        }
+        bars.highs.push_back(high);
+        bars.lows.push_back(low);
+        bars.closes.push_back(ticks[(b + 1) * TICKS_PER_BAR - 1].price);
+        bars.volumes.push_back(volume);
+    }
+    return bars;
+}
+
+const Bars& checkBars() {
+    static const Bars bars = syntheticBars(CHECK_BARS);
+    return bars;
+}
+
+std::vector<double> prefix(const std::vector<double>& v, size_t i) {
+    return std::vector<double>(v.begin(), v.begin() + i + 1);
+}
+
+// Records the worst relative error seen; reports the first mismatch
+class Checker {
+public:
+    explicit Checker(const char* kernel) : kernel_(kernel) {}
+
+    void expect(const char* field, size_t i, double got, double want) {
+        double err = std::fabs(got - want) / std::max(1.0, std::fabs(want));
+        maxError_ = std::max(maxError_, err);
+        if (err > TOLERANCE && error_.empty()) {
+            error_ = std::string(kernel_) + " " + field + "[" + std::to_string(i) + "] = " +
+                     std::to_string(got) + ", scalar " + std::to_string(want);
+        }
+    }
+
+    // False (and the benchmark skipped) on a mismatch
+    bool report(benchmark::State& state) const {
+        state.counters["max_rel_error"] = maxError_;
+        if (!error_.empty()) state.SkipWithError(error_.c_str());
+        return error_.empty();
+    }
+
+private:
+    const char* kernel_;
+    double maxError_ = 0.0;
+    std::string error_;
+};
+
+// Times fn(bars, n) over range(0) bars, after the check has passed
+template <typename Fn>
+void timeKernel(benchmark::State& state, Fn&& fn) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const Bars bars = syntheticBars(n);
+    for (auto _ : state) {
+        fn(bars, n);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+
+void BM_KernelRollingMeanStd(benchmark::State& state) {
+    constexpr int period = 20;
+    const Bars& bars = checkBars();
+    std::vector<double> mean(CHECK_BARS), stddev(CHECK_BARS);
+    computeRollingMeanStdSeries(bars.closes.data(), CHECK_BARS, period, mean.data(), stddev.data());
+
+    Checker check("computeRollingMeanStdSeries");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        double wantMean = 0.0, wantStd = 0.0;
+        if (i + 1 >= static_cast<size_t>(period)) {
+            const std::vector<double> window(bars.closes.begin() + (i + 1 - period), bars.closes.begin() + i + 1);
+            wantMean = computeMean(window);
+            wantStd = computeStdDev(window, wantMean);
+        }
+        check.expect("mean", i, mean[i], wantMean);
+        check.expect("stddev", i, stddev[i], wantStd);
+    }
+    if (!check.report(state)) return;
+
+    timeKernel(state, [&](const Bars& b, size_t n) {
+        mean.resize(n);
+        stddev.resize(n);
+        computeRollingMeanStdSeries(b.closes.data(), n, period, mean.data(), stddev.data());
+    });
+}
+
+void BM_KernelBollinger(benchmark::State& state) {
+    constexpr int period = 20;
+    constexpr double mult = 2.0;
+    const Bars& bars = checkBars();
+    std::vector<double> mean(CHECK_BARS), upper(CHECK_BARS), lower(CHECK_BARS);
+    computeBollingerSeries(bars.closes.data(), CHECK_BARS, period, mult, mean.data(), upper.data(), lower.data());
+
+    Checker check("computeBollingerSeries");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        double wantMean, wantUpper, wantLower;
+        computeBollinger(prefix(bars.closes, i), period, mult, wantMean, wantUpper, wantLower);
+        check.expect("mean", i, mean[i], wantMean);
+        check.expect("upper", i, upper[i], wantUpper);
+        check.expect("lower", i, lower[i], wantLower);
+    }
+    if (!check.report(state)) return;
+
+    timeKernel(state, [&](const Bars& b, size_t n) {
+        mean.resize(n);
+        upper.resize(n);
+        lower.resize(n);
+        computeBollingerSeries(b.closes.data(), n, period, mult, mean.data(), upper.data(), lower.data());
+    });
+}
+
+void BM_KernelRSI(benchmark::State& state) {
+    constexpr int period = 14;
+    const Bars& bars = checkBars();
+    std::vector<double> rsi(CHECK_BARS);
+    computeRSISeries(bars.closes.data(), CHECK_BARS, period, rsi.data());
+
+    Checker check("computeRSISeries");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        check.expect("rsi", i, rsi[i], computeRSI(prefix(bars.closes, i), period));
+    }
+    if (!check.report(state)) return;
+
+    timeKernel(state, [&](const Bars& b, size_t n) {
+        rsi.resize(n);
+        computeRSISeries(b.closes.data(), n, period, rsi.data());
+    });
+}
+
+void BM_KernelEMA(benchmark::State& state) {
+    constexpr int period = 20;
+    const Bars& bars = checkBars();
+    std::vector<double> ema(CHECK_BARS);
+    computeEMASeries(bars.closes.data(), CHECK_BARS, period, ema.data());
+
+    Checker check("computeEMASeries");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        check.expect("ema", i, ema[i], computeEMA(prefix(bars.closes, i), period));
+    }
+    if (!check.report(state)) return;
+
+    timeKernel(state, [&](const Bars& b, size_t n) {
+        ema.resize(n);
+        computeEMASeries(b.closes.data(), n, period, ema.data());
+    });
+}
+
+void BM_KernelMACD(benchmark::State& state) {
+    const Bars& bars = checkBars();
+    std::vector<double> macd(CHECK_BARS), signal(CHECK_BARS), histogram(CHECK_BARS);
+    computeMACDSeries(bars.closes.data(), CHECK_BARS, 12, 26, 9, macd.data(), signal.data(), histogram.data());
+
+    Checker check("computeMACDSeries");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        MACDResult want = computeMACD(prefix(bars.closes, i), 12, 26, 9);
+        check.expect("macd", i, macd[i], want.macd);
+        check.expect("signal", i, signal[i], want.signal);
+        check.expect("histogram", i, histogram[i], want.histogram);
+    }
+    if (!check.report(state)) return;
+
+    timeKernel(state, [&](const Bars& b, size_t n) {
+        macd.resize(n);
+        signal.resize(n);
+        histogram.resize(n);
+        computeMACDSeries(b.closes.data(), n, 12, 26, 9, macd.data(), signal.data(), histogram.data());
+    });
+}
+
+void BM_KernelATR(benchmark::State& state) {
+    constexpr int period = 14;
+    const Bars& bars = checkBars();
+    std::vector<double> atr(CHECK_BARS);
+    computeATRSeries(bars.highs.data(), bars.lows.data(), bars.closes.data(), CHECK_BARS, period, atr.data());
+
+    Checker check("computeATRSeries");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        double want = computeATR(prefix(bars.highs, i), prefix(bars.lows, i), prefix(bars.closes, i), period);
+        check.expect("atr", i, atr[i], want);
+    }
+    if (!check.report(state)) return;
+
+    timeKernel(state, [&](const Bars& b, size_t n) {
+        atr.resize(n);
+        computeATRSeries(b.highs.data(), b.lows.data(), b.closes.data(), n, period, atr.data());
+    });
+}
+
+void BM_KernelStochastic(benchmark::State& state) {
+    constexpr int period = 14;
+    const Bars& bars = checkBars();
+    std::vector<double> k(CHECK_BARS), d(CHECK_BARS);
+    computeStochasticSeries(bars.highs.data(), bars.lows.data(), bars.closes.data(), CHECK_BARS, period,
+                            k.data(), d.data());
+
+    Checker check("computeStochasticSeries");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        StochasticResult want = computeStochastic(prefix(bars.highs, i), prefix(bars.lows, i),
+                                                  prefix(bars.closes, i), period);
+        check.expect("k", i, k[i], want.k);
+        check.expect("d", i, d[i], want.d);
+    }
+    if (!check.report(state)) return;
+
+    timeKernel(state, [&](const Bars& b, size_t n) {
+        k.resize(n);
+        d.resize(n);
+        computeStochasticSeries(b.highs.data(), b.lows.data(), b.closes.data(), n, period, k.data(), d.data());
+    });
+}
+
+void BM_KernelVWAP(benchmark::State& state) {
+    const Bars& bars = checkBars();
+    std::vector<double> vwap(CHECK_BARS);
+    computeVWAPSeries(bars.closes.data(), bars.volumes.data(), CHECK_BARS, vwap.data());
+
+    Checker check("computeVWAPSeries");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        check.expect("vwap", i, vwap[i], computeSimpleVWAP(prefix(bars.closes, i), prefix(bars.volumes, i)));
+    }
+    if (!check.report(state)) return;
+
+    timeKernel(state, [&](const Bars& b, size_t n) {
+        vwap.resize(n);
+        computeVWAPSeries(b.closes.data(), b.volumes.data(), n, vwap.data());
+    });
+}
+
+// Times one update per bar over a long series, after the check has passed
+template <typename Fn>
+void timeUpdates(benchmark::State& state, Fn&& update) {
+    static const Bars bars = syntheticBars(1 << 16);
+    const size_t n = bars.closes.size();
+
+    size_t i = 0;
+    for (auto _ : state) {
+        update(bars, i);
+        i = (i + 1 == n) ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_StreamingMACD(benchmark::State& state) {
+    constexpr int fast = 12, slow = 26, signalPeriod = 9;
+    const Bars& bars = checkBars();
+
+    // Signal line: EMA of the MACD line from the bar the slow EMA has warmed up
+    std::vector<double> macdLine(CHECK_BARS);
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        const auto closes = prefix(bars.closes, i);
+        macdLine[i] = computeEMA(closes, fast) - computeEMA(closes, slow);
+    }
+
+    StreamingMACD macd(fast, slow, signalPeriod);
+    Checker check("StreamingMACD");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        MACDResult got = macd.update(bars.closes[i]);
+        check.expect("macd", i, got.macd, computeMACD(prefix(bars.closes, i), fast, slow, signalPeriod).macd);
+
+        double wantSignal = 0.0;
+        if (i + 1 >= static_cast<size_t>(slow + signalPeriod)) {
+            const std::vector<double> line(macdLine.begin() + (slow - 1), macdLine.begin() + i + 1);
+            wantSignal = computeEMA(line, signalPeriod);
+        }
+        check.expect("signal", i, got.signal, wantSignal);
+        check.expect("histogram", i, got.histogram, got.macd - wantSignal);
+    }
+    if (!check.report(state)) return;
+
+    timeUpdates(state, [&](const Bars& b, size_t i) { benchmark::DoNotOptimize(macd.update(b.closes[i])); });
+}
+
+void BM_StreamingATR(benchmark::State& state) {
+    constexpr int period = 14;
+    const Bars& bars = checkBars();
+
+    StreamingATR atr(period);
+    Checker check("StreamingATR");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        double got = atr.update(bars.highs[i], bars.lows[i], bars.closes[i]);
+        check.expect("atr", i, got, computeATR(prefix(bars.highs, i), prefix(bars.lows, i), prefix(bars.closes, i), period));
+    }
+    if (!check.report(state)) return;
+
+    timeUpdates(state, [&](const Bars& b, size_t i) {
+        benchmark::DoNotOptimize(atr.update(b.highs[i], b.lows[i], b.closes[i]));
+    });
+}
+
+void BM_StreamingStochastic(benchmark::State& state) {
+    constexpr int period = 14, dPeriod = 3;
+    const Bars& bars = checkBars();
+
+    StreamingStochastic stochastic(period, dPeriod);
+    std::vector<double> ks;     // scalar %K since the window filled
+    Checker check("StreamingStochastic");
+    for (size_t i = 0; i < CHECK_BARS; ++i) {
+        StochasticResult got = stochastic.update(bars.highs[i], bars.lows[i], bars.closes[i]);
+        double wantK = computeStochastic(prefix(bars.highs, i), prefix(bars.lows, i), prefix(bars.closes, i), period).k;
+        check.expect("k", i, got.k, wantK);
+
+        // %D: mean of the last dPeriod %K values (fewer while they accumulate)
+        double wantD = 50.0;
+        if (i + 1 >= static_cast<size_t>(period)) {
+            ks.push_back(wantK);
+            const size_t m = std::min<size_t>(ks.size(), dPeriod);
+            wantD = computeMean(std::vector<double>(ks.end() - m, ks.end()));
+        }
+        check.expect("d", i, got.d, wantD);
+    }
+    if (!check.report(state)) return;
+
+    timeUpdates(state, [&](const Bars& b, size_t i) {
+        benchmark::DoNotOptimize(stochastic.update(b.highs[i], b.lows[i], b.closes[i]));
+    });
+}
+
+}
+
+BENCHMARK(BM_KernelRollingMeanStd)->Arg(1 << 16);
+BENCHMARK(BM_KernelBollinger)->Arg(1 << 16);
+BENCHMARK(BM_KernelRSI)->Arg(1 << 16);
+BENCHMARK(BM_KernelEMA)->Arg(1 << 16);
+BENCHMARK(BM_KernelMACD)->Arg(1 << 16);
+BENCHMARK(BM_KernelATR)->Arg(1 << 16);
+BENCHMARK(BM_KernelStochastic)->Arg(1 << 16);
+BENCHMARK(BM_KernelVWAP)->Arg(1 << 16);
+
+BENCHMARK(BM_StreamingMACD);
+BENCHMARK(BM_StreamingATR);
+BENCHMARK(BM_StreamingStochastic);
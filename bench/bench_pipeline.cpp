@@ -0,0 +1,92 @@
+#include "bench_data.h"
+#include "alpha/alpha_pipeline.h"
+#include "backtest/tick_store.h"
+#include "util/symbol_registry.h"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+// End-to-end ticks/s of the per-symbol alpha pipeline (every stage, as the
+// live system runs it), with ticks routed to one pipeline per symbol.
+
+namespace {
+
+using Pipelines = std::vector<std::unique_ptr<FullAlphaPipeline>>;
+
+FullAlphaPipeline& pipelineFor(Pipelines& pipelines, SymbolId id) {
+    if (id >= pipelines.size()) pipelines.resize(id + 1);
+    if (!pipelines[id]) pipelines[id] = std::make_unique<FullAlphaPipeline>();
+    return *pipelines[id];
+}
+
+// Synthetic: range(0) symbols with interleaved ticks
+void BM_FullPipelineSynthetic(benchmark::State& state) {
+    const auto numSymbols = static_cast<size_t>(state.range(0));
+    constexpr size_t TICKS_PER_SYMBOL = 5000;
+
+    std::vector<std::vector<MarketTick>> perSymbol;
+    std::vector<SymbolId> ids;
+    for (size_t s = 0; s < numSymbols; ++s) {
+        std::string symbol = "SYN" + std::to_string(s);
+        perSymbol.push_back(bench::syntheticTicks(TICKS_PER_SYMBOL, symbol, static_cast<uint32_t>(s + 1)));
+        ids.push_back(SymbolRegistry::instance().intern(symbol));
+    }
+
+    std::vector<const MarketTick*> stream;
+    std::vector<SymbolId> streamIds;
+    for (size_t i = 0; i < TICKS_PER_SYMBOL; ++i) {
+        for (size_t s = 0; s < numSymbols; ++s) {
+            stream.push_back(&perSymbol[s][i]);
+            streamIds.push_back(ids[s]);
+        }
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Pipelines pipelines;
+        for (SymbolId id : ids) pipelineFor(pipelines, id);
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < stream.size(); ++i) {
+            benchmark::DoNotOptimize(pipelineFor(pipelines, streamIds[i]).onTick(*stream[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(stream.size()));
+}
+BENCHMARK(BM_FullPipelineSynthetic)->Arg(1)->Arg(8)->Arg(32)->Unit(benchmark::kMillisecond);
+
+// Recorded: replays the tape named by ALPHA_BENCH_TAPE (written by `alpha_engine record <tape> [secs]`)
+void BM_FullPipelineTape(benchmark::State& state) {
+    const char* path = std::getenv("ALPHA_BENCH_TAPE");
+    if (!path) {
+        state.SkipWithError("set ALPHA_BENCH_TAPE to a recorded tick tape");
+        return;
+    }
+
+    TapeReader tape(path);
+    const TickColumns columns = tape.load();
+    const TickView view = columns.view();
+
+    std::vector<MarketTick> ticks(view.size());
+    for (size_t i = 0; i < view.size(); ++i) {
+        CompactTick t = view[i];
+        ticks[i] = MarketTick{SymbolRegistry::instance().name(t.symbolId), t.price, t.quantity,
+                              static_cast<long>(t.timestampNs / 1000000LL)};
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Pipelines pipelines;
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < ticks.size(); ++i) {
+            benchmark::DoNotOptimize(pipelineFor(pipelines, view[i].symbolId).onTick(ticks[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ticks.size()));
+}
+BENCHMARK(BM_FullPipelineTape)->Unit(benchmark::kMillisecond);
+
+}
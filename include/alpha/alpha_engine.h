@@ -1,31 +1,67 @@
 #pragma once
 #include "../util/market_types.h"
+#include "alpha/rolling_stats.h"
+#include "alpha/streaming_indicators.h"
+#include "util/ring_buffer.h"
+#include "util/snapshot.h"
+#include <memory>
 #include <optional>
 #include <vector>
-#include <deque>
 
+class SignalSink;
+
+// Tick alpha over one rolling window, and candle indicators kept per symbol
+// (by Candle::symbolId; candles without one are ignored). onTick and onCandle
+// share no mutable state, so ticks may arrive on one thread while candles
+// arrive on another; each path needs one caller at a time. The live feeds'
+// CandleAggregator serializes onCandle by running its callback under its lock.
 class AlphaEngine {
 public:
-	explicit AlphaEngine(size_t windowSize = 20, const std::string& timeframe = "1m");
+	// sink is optional and not owned; with no sink the engine performs no I/O
+	explicit AlphaEngine(size_t windowSize = 20, const std::string& timeframe = "1m",
+						 SignalSink* sink = nullptr);
 
 	// Tick-level alpha (momentum + mean-reversion)
 	std::optional<AlphaSignal> onTick(const MarketTick& tick);
 
-	// Candle-level alpha (technical indicators)
+	// Candle-level alpha (technical indicators), per c.symbolId
 	void onCandle(const Candle& c);
 
+	void setSink(SignalSink* sink) { sink_ = sink; }
+
+	const std::string& timeframe() const { return timeframe_; }
+
+	// Rolling tick and candle state; throws if the window size no longer matches
+	void saveState(SnapshotWriter& out) const;
+	void loadState(SnapshotReader& in);
+
 private:
 	size_t windowSize_;
 	std::string timeframe_;
+	SignalSink* sink_;
+
+	// Symbol of the latest tick, compared first when a tick arrives without an id
+	SymbolId lastSymbol_;
 
-	// tick rolling window
-	std::deque<MarketTick> window_;
+	// tick rolling window (prices only, preallocated)
+	RingBuffer<double> window_;
 	double sumPrices_;
 	double sumSquares_;
 
-	// candle history
-	std::vector<double> closes_;
-	std::vector<double> highs_;
-	std::vector<double> lows_;
-	std::vector<double> volumes_;
-};
\ No newline at end of file
+	// Candle indicators per symbol: bounded state, O(1) per candle
+	static constexpr size_t VOLUME_RATIO_WINDOW = 100;
+
+	struct CandleState {
+		CandleState();
+
+		size_t candleCount;
+		RollingStats bollinger;
+		StreamingRSI rsi;
+		StreamingVolumeRatio volumeRatio;
+	};
+
+	std::vector<std::unique_ptr<CandleState>> candles_;     // indexed by SymbolId
+
+	SymbolId symbolOf(const MarketTick& tick);
+	CandleState& candleState(SymbolId symbolId);
+};
@@ -0,0 +1,409 @@
+#pragma once
+#include "util/market_types.h"
+#include "util/latency_metrics.h"
+#include "alpha/alpha_engine.h"
+#include "alpha/microstructure.h"
+#include "alpha/orderflow.h"
+#include "alpha/regime.h"
+#include "alpha/vwap.h"
+#include "alpha/bollinger.h"
+#include "util/snapshot.h"
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+#include <cstdint>
+
+// Per-tick state threaded through the stages. The pipeline fills the shared
+// inputs once per tick; each stage writes its own output slot, which stays
+// empty when the stage is not in the pipeline (or has not warmed up).
+struct TickContext {
+    const MarketTick* tick = nullptr;
+
+    // Shared inputs
+    double priceChange = 0.0;    // vs the previous tick, 0 on the first
+    double logReturn = 0.0;
+    int tickSide = 0;            // tick rule: +1 uptick, -1 downtick, zero ticks keep the last side
+    double signedVolume = 0.0;   // tickSide * volume
+
+    // Stage outputs
+    std::optional<AlphaSignal> alpha;
+    std::optional<VPINMetrics> vpin;
+    std::optional<HasbrouckMetrics> impact;
+    double quotedSpread = 0.0;
+    std::optional<OrderFlowSignal> flow;
+    std::optional<double> bookOfi;   // normalized quote OFI, once quotes have arrived
+    std::optional<RegimeMetrics> regime;
+    std::optional<RegimeSignalWeights> weights;
+    std::optional<VWAPMetrics> vwap;
+    std::optional<BollingerMetrics> bollinger;
+
+    void clearOutputs() {
+        alpha.reset();
+        vpin.reset();
+        impact.reset();
+        quotedSpread = 0.0;
+        flow.reset();
+        bookOfi.reset();
+        regime.reset();
+        weights.reset();
+        vwap.reset();
+        bollinger.reset();
+    }
+};
+
+// Returns and tick-rule side, computed once per tick for every stage
+class TickFeatures {
+public:
+    void fill(TickContext& ctx, const MarketTick& tick) {
+        ctx.tick = &tick;
+        ctx.priceChange = 0.0;
+        ctx.logReturn = 0.0;
+        if (lastPrice_ > 0.0 && tick.price > 0.0) {
+            ctx.priceChange = tick.price - lastPrice_;
+            ctx.logReturn = std::log(tick.price / lastPrice_);
+        }
+
+        if (ctx.priceChange > 0.0) lastSide_ = 1;
+        else if (ctx.priceChange < 0.0) lastSide_ = -1;
+
+        ctx.tickSide = lastSide_;
+        ctx.signedVolume = lastSide_ * tick.volume;
+        lastPrice_ = tick.price;
+    }
+
+    void reset() {
+        lastPrice_ = 0.0;
+        lastSide_ = 0;
+    }
+
+    void saveState(SnapshotWriter& out) const {
+        out.write(lastPrice_);
+        out.write(lastSide_);
+    }
+
+    void loadState(SnapshotReader& in) {
+        in.read(lastPrice_);
+        in.read(lastSide_);
+    }
+
+private:
+    double lastPrice_ = 0.0;
+    int lastSide_ = 0;
+};
+
+// Stage bits: DynamicAlphaPipeline masks, and the ids stage state is saved under
+namespace alpha_stage {
+constexpr uint32_t MOMENTUM       = 1u << 0;
+constexpr uint32_t MICROSTRUCTURE = 1u << 1;
+constexpr uint32_t ORDER_FLOW     = 1u << 2;
+constexpr uint32_t REGIME         = 1u << 3;
+constexpr uint32_t VWAP           = 1u << 4;
+constexpr uint32_t BOLLINGER      = 1u << 5;
+constexpr uint32_t ALL            = (1u << 6) - 1;
+}
+
+// Pipeline stages: thin adapters that run one analyzer and publish its output
+// into the context. A stage is any type with onTick(TickContext&); an
+// onQuote(const QuoteEvent&) member and a latencyStage (timed per tick) are
+// optional, as is a stageId with saveState / loadState for snapshots.
+namespace stage {
+
+// Tick momentum and mean-reversion z-score (AlphaEngine)
+class Momentum {
+public:
+    static constexpr LatencyStage latencyStage = LatencyStage::ALPHA_MOMENTUM;
+    static constexpr uint32_t stageId = alpha_stage::MOMENTUM;
+
+    explicit Momentum(size_t window = 20) : engine_(window, "1m") {}
+
+    void onTick(TickContext& ctx) { ctx.alpha = engine_.onTick(*ctx.tick); }
+
+    AlphaEngine& engine() { return engine_; }
+
+    void saveState(SnapshotWriter& out) const { engine_.saveState(out); }
+    void loadState(SnapshotReader& in) { engine_.loadState(in); }
+
+private:
+    AlphaEngine engine_;
+};
+
+// VPIN, Hasbrouck impact and quoted spread
+class Microstructure {
+public:
+    static constexpr LatencyStage latencyStage = LatencyStage::ALPHA_MICROSTRUCTURE;
+    static constexpr uint32_t stageId = alpha_stage::MICROSTRUCTURE;
+
+    explicit Microstructure(size_t bucketSize = 50, size_t vpinWindow = 50, size_t impactWindow = 100)
+        : analyzer_(bucketSize, vpinWindow, impactWindow) {}
+
+    void onTick(TickContext& ctx) {
+        analyzer_.onTick(*ctx.tick);
+        ctx.vpin = analyzer_.getVPIN();
+        ctx.impact = analyzer_.getHasbrouckMetrics();
+        ctx.quotedSpread = analyzer_.getQuotedSpread();
+    }
+
+    void onQuote(const QuoteEvent& quote) { analyzer_.onQuote(quote.bidPrice, quote.askPrice); }
+
+    const MicrostructureAnalyzer& analyzer() const { return analyzer_; }
+
+    void saveState(SnapshotWriter& out) const { analyzer_.saveState(out); }
+    void loadState(SnapshotReader& in) { analyzer_.loadState(in); }
+
+private:
+    MicrostructureAnalyzer analyzer_;
+};
+
+// Trade-flow OFI signed by the shared tick side, plus book OFI from quotes
+class OrderFlow {
+public:
+    static constexpr LatencyStage latencyStage = LatencyStage::ALPHA_ORDER_FLOW;
+    static constexpr uint32_t stageId = alpha_stage::ORDER_FLOW;
+
+    explicit OrderFlow(size_t quoteWindow = 100) : quoteOfi_(quoteWindow) {}
+
+    void onTick(TickContext& ctx) {
+        ctx.flow = engine_.onTick(*ctx.tick, ctx.tickSide > 0);
+        if (quoteOfi_.count() > 0) ctx.bookOfi = quoteOfi_.normalized();
+    }
+
+    void onQuote(const QuoteEvent& quote) {
+        quoteOfi_.onQuote(quote.bidPrice, quote.bidSize, quote.askPrice, quote.askSize);
+    }
+
+    void saveState(SnapshotWriter& out) const {
+        engine_.saveState(out);
+        quoteOfi_.saveState(out);
+    }
+
+    void loadState(SnapshotReader& in) {
+        engine_.loadState(in);
+        quoteOfi_.loadState(in);
+    }
+
+private:
+    OrderFlowEngine engine_;
+    QuoteOFI quoteOfi_;
+};
+
+// Hurst / volatility regime and the signal weights it implies
+class Regime {
+public:
+    static constexpr LatencyStage latencyStage = LatencyStage::ALPHA_REGIME;
+    static constexpr uint32_t stageId = alpha_stage::REGIME;
+
+    explicit Regime(size_t window = 100, size_t hurstLag = 20, size_t volWindow = 50)
+        : detector_(window, hurstLag, volWindow) {}
+
+    void onTick(TickContext& ctx) {
+        detector_.onTick(*ctx.tick);
+        ctx.regime = detector_.getMetrics();
+        ctx.weights = detector_.getSignalWeights();
+    }
+
+    void saveState(SnapshotWriter& out) const { detector_.saveState(out); }
+    void loadState(SnapshotReader& in) { detector_.loadState(in); }
+
+private:
+    RegimeDetector detector_;
+};
+
+class Vwap {
+public:
+    static constexpr LatencyStage latencyStage = LatencyStage::ALPHA_VWAP;
+    static constexpr uint32_t stageId = alpha_stage::VWAP;
+
+    explicit Vwap(double bandMultiplier = 2.0, size_t rollingWindow = 0)
+        : vwap_(bandMultiplier, rollingWindow) {}
+
+    void onTick(TickContext& ctx) {
+        vwap_.onTick(*ctx.tick);
+        ctx.vwap = vwap_.getMetrics();
+    }
+
+    void saveState(SnapshotWriter& out) const { vwap_.saveState(out); }
+    void loadState(SnapshotReader& in) { vwap_.loadState(in); }
+
+private:
+    VWAPCalculator vwap_;
+};
+
+class Bollinger {
+public:
+    static constexpr LatencyStage latencyStage = LatencyStage::ALPHA_BOLLINGER;
+    static constexpr uint32_t stageId = alpha_stage::BOLLINGER;
+
+    explicit Bollinger(int period = 20, double mult = 2.0) : tracker_(period, mult) {}
+
+    void onTick(TickContext& ctx) { ctx.bollinger = tracker_.onPrice(ctx.tick->price); }
+
+    void saveState(SnapshotWriter& out) const { tracker_.saveState(out); }
+    void loadState(SnapshotReader& in) { tracker_.loadState(in); }
+
+private:
+    BollingerTracker tracker_;
+};
+
+} // namespace stage
+
+namespace detail {
+
+template <typename Stage, typename = void>
+struct HasOnQuote : std::false_type {};
+
+template <typename Stage>
+struct HasOnQuote<Stage, std::void_t<decltype(std::declval<Stage&>().onQuote(std::declval<const QuoteEvent&>()))>>
+    : std::true_type {};
+
+template <typename Stage>
+void forwardQuote(Stage& stage, const QuoteEvent& quote) {
+    if constexpr (HasOnQuote<Stage>::value) stage.onQuote(quote);
+}
+
+template <typename Stage, typename = void>
+struct HasLatencyStage : std::false_type {};
+
+template <typename Stage>
+struct HasLatencyStage<Stage, std::void_t<decltype(Stage::latencyStage)>> : std::true_type {};
+
+template <typename Stage>
+void runStage(Stage& stage, TickContext& ctx) {
+    if constexpr (HasLatencyStage<Stage>::value) {
+        ScopedLatency timer(Stage::latencyStage);
+        stage.onTick(ctx);
+    } else {
+        stage.onTick(ctx);
+    }
+}
+
+template <typename Stage, typename = void>
+struct HasState : std::false_type {};
+
+template <typename Stage>
+struct HasState<Stage, std::void_t<decltype(Stage::stageId),
+                                   decltype(std::declval<const Stage&>().saveState(std::declval<SnapshotWriter&>())),
+                                   decltype(std::declval<Stage&>().loadState(std::declval<SnapshotReader&>()))>>
+    : std::true_type {};
+
+// One record per stage: id, then its state as a blob, so a pipeline can skip
+// stages it does not have
+template <typename Stage>
+void saveStage(const Stage& stage, SnapshotWriter& out) {
+    if constexpr (HasState<Stage>::value) {
+        out.write(Stage::stageId);
+        size_t start = out.beginBlob();
+        stage.saveState(out);
+        out.endBlob(start);
+    }
+}
+
+template <typename Stage>
+void loadStage(Stage& stage, uint32_t stageId, std::string_view blob) {
+    if constexpr (HasState<Stage>::value) {
+        if (stageId != Stage::stageId) return;
+        SnapshotReader in(blob);
+        stage.loadState(in);
+        if (!in.atEnd()) SnapshotReader::fail("trailing bytes in stage state");
+    }
+}
+
+} // namespace detail
+
+// Stages fixed at compile time and run in the listed order. onTick is a fold
+// over the stage tuple, so the calls inline into one function with no virtual
+// dispatch, and a stage that is not listed is not compiled in at all.
+template <typename... Stages>
+class AlphaPipeline {
+    static_assert(sizeof...(Stages) > 0, "AlphaPipeline needs at least one stage");
+
+public:
+    AlphaPipeline() = default;
+    explicit AlphaPipeline(Stages... stages) : stages_(std::move(stages)...) {}
+
+    // The context stays valid until the next onTick
+    const TickContext& onTick(const MarketTick& tick) {
+        ctx_.clearOutputs();
+        features_.fill(ctx_, tick);
+        std::apply([this](auto&... stage) { (detail::runStage(stage, ctx_), ...); }, stages_);
+        return ctx_;
+    }
+
+    void onQuote(const QuoteEvent& quote) {
+        std::apply([&quote](auto&... stage) { (detail::forwardQuote(stage, quote), ...); }, stages_);
+    }
+
+    template <typename Stage>
+    Stage& get() { return std::get<Stage>(stages_); }
+
+    // Stages without saveState are left out; on load, records for stages not
+    // in this pipeline are skipped and stages missing from the snapshot stay
+    // cold. Throws std::runtime_error on malformed or mismatched state, after
+    // which the pipeline is partly loaded and should be rebuilt.
+    void saveState(SnapshotWriter& out) const {
+        features_.saveState(out);
+        out.write(static_cast<uint32_t>((detail::HasState<Stages>::value + ... + 0)));
+        std::apply([&out](const auto&... stage) { (detail::saveStage(stage, out), ...); }, stages_);
+    }
+
+    void loadState(SnapshotReader& in) {
+        features_.loadState(in);
+        const uint32_t count = in.read<uint32_t>();
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t id = in.read<uint32_t>();
+            const std::string_view blob = in.readBlob();
+            std::apply([id, blob](auto&... stage) { (detail::loadStage(stage, id, blob), ...); }, stages_);
+        }
+    }
+
+private:
+    std::tuple<Stages...> stages_;
+    TickFeatures features_;
+    TickContext ctx_;
+};
+
+// Every stage, in the order ProductionAlphaSystem has always run them
+using FullAlphaPipeline = AlphaPipeline<
+    stage::Momentum,
+    stage::Microstructure,
+    stage::OrderFlow,
+    stage::Regime,
+    stage::Vwap,
+    stage::Bollinger
+>;
+
+// Comma-separated stage names ("momentum,vpin,regime", or "all") to a mask;
+// throws std::invalid_argument on an unknown name
+uint32_t parseAlphaStages(const std::string& list);
+
+// Runtime-selected stages for research runs: every stage is constructed and a
+// bitmask picks which ones run. Same context and order as FullAlphaPipeline,
+// at the cost of a branch per stage.
+class DynamicAlphaPipeline {
+public:
+    explicit DynamicAlphaPipeline(uint32_t stages = alpha_stage::ALL);
+
+    const TickContext& onTick(const MarketTick& tick);
+    void onQuote(const QuoteEvent& quote);
+
+    uint32_t stages() const { return stages_; }
+    bool enabled(uint32_t stage) const { return (stages_ & stage) != 0; }
+
+    // Same format as AlphaPipeline; only enabled stages are saved or loaded
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
+private:
+    uint32_t stages_;
+    TickFeatures features_;
+    TickContext ctx_;
+
+    stage::Momentum momentum_;
+    stage::Microstructure microstructure_;
+    stage::OrderFlow orderFlow_;
+    stage::Regime regime_;
+    stage::Vwap vwap_;
+    stage::Bollinger bollinger_;
+};
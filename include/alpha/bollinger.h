@@ -0,0 +1,95 @@
+#pragma once
+#include "alpha/rolling_stats.h"
+#include <optional>
+#include <cstdint>
+
+enum class BollingerSignal : uint8_t {
+    NEUTRAL,
+    BUY,
+    SELL,
+    BREAKOUT_UP,
+    BREAKOUT_DOWN
+};
+
+inline const char* bollingerSignalName(BollingerSignal signal) {
+    switch (signal) {
+        case BollingerSignal::BUY: return "BUY";
+        case BollingerSignal::SELL: return "SELL";
+        case BollingerSignal::BREAKOUT_UP: return "BREAKOUT_UP";
+        case BollingerSignal::BREAKOUT_DOWN: return "BREAKOUT_DOWN";
+        default: return "NEUTRAL";
+    }
+}
+
+struct BollingerMetrics {
+    double middleBand;
+    double upperBand;
+    double lowerBand;
+    double bandwidth;      // (upper - lower) / middle
+    double percentB;       // (price - lower) / (upper - lower)
+    bool isSqueezing;      // bandwidth < 5%
+    BollingerSignal signal;
+};
+
+// Tick-level Bollinger bands over a rolling price window, O(1) per tick
+class BollingerTracker {
+public:
+    explicit BollingerTracker(int period = 10, double mult = 2.0)
+        : period_(period), mult_(mult), prices_(static_cast<size_t>(period)) {}
+
+    std::optional<BollingerMetrics> onPrice(double price) {
+        prices_.push(price);
+
+        if (!prices_.full()) {
+            return std::nullopt;
+        }
+
+        double mean = prices_.mean();
+        double sd = prices_.stddev();
+        double upper = mean + mult_ * sd;
+        double lower = mean - mult_ * sd;
+
+        BollingerMetrics metrics;
+        metrics.middleBand = mean;
+        metrics.upperBand = upper;
+        metrics.lowerBand = lower;
+        metrics.bandwidth = (mean > 0) ? (upper - lower) / mean : 0.0;
+        metrics.percentB = (upper != lower) ? (price - lower) / (upper - lower) : 0.5;
+        metrics.isSqueezing = metrics.bandwidth < 0.05;  // 5% bandwidth
+
+        if (price < lower && metrics.percentB < 0.1) {
+            metrics.signal = BollingerSignal::BUY;
+        } else if (price > upper && metrics.percentB > 0.9) {
+            metrics.signal = BollingerSignal::SELL;
+        } else if (metrics.isSqueezing && metrics.percentB > 0.5) {
+            metrics.signal = BollingerSignal::BREAKOUT_UP;
+        } else if (metrics.isSqueezing && metrics.percentB < 0.5) {
+            metrics.signal = BollingerSignal::BREAKOUT_DOWN;
+        } else {
+            metrics.signal = BollingerSignal::NEUTRAL;
+        }
+
+        return metrics;
+    }
+
+    void reset() {
+        prices_.clear();
+    }
+
+    int period() const { return period_; }
+
+    void saveState(SnapshotWriter& out) const {
+        out.write(mult_);
+        prices_.saveState(out);
+    }
+
+    void loadState(SnapshotReader& in) {
+        in.expect(mult_, "Bollinger multiplier changed");
+        prices_.loadState(in);
+    }
+
+private:
+    int period_;
+    double mult_;
+    RollingStats prices_;
+};
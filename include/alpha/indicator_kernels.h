@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+
+// Batch counterparts of the scalar functions in indicators.h for historical
+// data. Each fills out[i] with what the scalar function returns for the first
+// i + 1 inputs, in one O(n) pass over contiguous arrays (so a whole backtest
+// series costs O(n) instead of O(n^2)). Windowed sums come from prefix sums;
+// the per-element window loops are branch-free so they auto-vectorize, and the
+// Bollinger kernel has explicit AVX2 (runtime-detected) and NEON paths.
+// Output arrays must hold n elements and must not alias the inputs.
+
+// Rolling mean and sample std dev (n - 1) of the last `period` values; 0 until
+// the window has filled
+void computeRollingMeanStdSeries(const double* data, size_t n, int period,
+								 double* mean, double* stddev);
+
+// computeBollinger (mean / upper / lower) at every bar
+void computeBollingerSeries(const double* closes, size_t n, int period, double mult,
+							double* mean, double* upper, double* lower);
+
+// computeRSI at every bar
+void computeRSISeries(const double* closes, size_t n, int period, double* out);
+
+// computeEMA at every bar
+void computeEMASeries(const double* data, size_t n, int period, double* out);
+
+// computeMACD at every bar
+void computeMACDSeries(const double* closes, size_t n, int fastPeriod, int slowPeriod,
+					   int signalPeriod, double* macd, double* signal, double* histogram);
+
+// computeATR at every bar
+void computeATRSeries(const double* highs, const double* lows, const double* closes,
+					  size_t n, int period, double* out);
+
+// computeStochastic at every bar
+void computeStochasticSeries(const double* highs, const double* lows, const double* closes,
+							 size_t n, int period, double* k, double* d);
+
+// computeSimpleVWAP at every bar (cumulative)
+void computeVWAPSeries(const double* prices, const double* volumes, size_t n, double* out);
@@ -1,7 +1,11 @@
 #pragma once
 #include "util/market_types.h"
-#include <deque>
+#include "util/ring_buffer.h"
+#include "alpha/rolling_stats.h"
+#include "util/snapshot.h"
 #include <vector>
+#include <utility>
+#include <cstdint>
 
 enum class TradeSide {
     BUY,
@@ -40,6 +44,9 @@ public:
     // Process new tick and update all metrics
     void onTick(const MarketTick& tick);
 
+    // Latest top of book; later trades are classified by the quote rule
+    void onQuote(double bidPrice, double askPrice);
+
     // Get current VPIN metrics (flow toxicity)
     VPINMetrics getVPIN() const;
 
@@ -60,38 +67,80 @@ public:
     // Get volume-weighted average spread
     double getEffectiveSpread() const;
 
+    // Spread of the latest quote, 0 before the first one
+    double getQuotedSpread() const;
+
     // Reset all state
     void reset();
 
+    // Trade history, VPIN buckets and impact sums; window sizes must match
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
+    static constexpr size_t TRADE_HISTORY = 1000;
+    static constexpr uint64_t RESYNC_INTERVAL = 1 << 16;
+
+    // Classified trade plus running buy/sell volume totals, so the flow over the
+    // last n trades is a difference of two entries
+    struct ClassifiedTrade {
+        TradeRecord trade;
+        double cumBuy;
+        double cumSell;
+    };
+
+    // Running sums for the Kyle lambda regression of dP on signed volume
+    struct ImpactSums {
+        double dp = 0.0, sv = 0.0, dpSv = 0.0, sv2 = 0.0;
+
+        void add(double priceChange, double signedVolume, double sign) {
+            dp += sign * priceChange;
+            sv += sign * signedVolume;
+            dpSv += sign * priceChange * signedVolume;
+            sv2 += sign * signedVolume * signedVolume;
+        }
+    };
+
     size_t bucketSize_;
     size_t vpinWindow_;
     size_t impactWindow_;
 
     // Trade history
-    std::deque<MarketTick> tradeHistory_;
-    std::deque<TradeClassification> classifiedTrades_;
-
-    // VPIN calculation state
-    std::deque<double> volumeBuckets_;  // alternating buy/sell buckets
+    RingBuffer<ClassifiedTrade> classifiedTrades_;
+    double baseBuy_;     // cumulative totals just before classifiedTrades_[0]
+    double baseSell_;
+    double cumBuy_;
+    double cumSell_;
+    TradeSide lastSide_;
+
+    // VPIN: equal-volume buckets, trades split across bucket boundaries
+    RollingSum bucketImbalances_;   // |buy - sell| of each completed bucket
     double currentBucketVolume_;
     double currentBucketBuyVolume_;
-    bool isCurrentBucketBuy_;
 
-    // Price impact state
-    std::deque<double> priceChanges_;
-    std::deque<double> signedVolumes_;
+    // Price impact state: (price change, signed volume) pairs
+    RingBuffer<std::pair<double, double>> impact_;
+    ImpactSums impactSums_;
+    RollingSum rollProducts_;       // dP_t * dP_{t-1} for Roll's spread
+    double lastPriceChange_;
+    bool hasPriceChange_;
+    uint64_t updates_;
 
     // Running statistics
     double lastPrice_;
     double lastMidPrice_;
+    double lastBid_;
+    double lastAsk_;
     double cumulativeVolume_;
     double cumulativeBuyVolume_;
     double cumulativeSellVolume_;
 
     // Helper methods
+    void recordTrade(const MarketTick& tick, const TradeClassification& trade);
     void updateVPINBuckets(const TradeClassification& trade);
     void updatePriceImpact(double priceChange, double signedVolume);
+    void resyncImpact();
+    void recentFlow(size_t window, double& buyVol, double& sellVol) const;
     double computeVPIN() const;
     HasbrouckMetrics estimatePriceImpact() const;
     TradeSide inferTradeSide(double price) const;
@@ -0,0 +1,61 @@
+#pragma once
+#include "util/market_types.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+enum class BookSide : uint8_t {
+    BID,
+    ASK
+};
+
+// Best level of each side; zeros when a side is empty
+struct TopOfBook {
+    double bidPrice;
+    double bidSize;
+    double askPrice;
+    double askSize;
+};
+
+// Incremental L2 book for one symbol, updated level by level from diff
+// messages. Each side is a flat array sorted with the best level at the back:
+// most updates land near the touch, so inserts and erases shift only a few
+// levels, the top of book is O(1), and with capacity reserved up front an
+// update does not allocate.
+class OrderBook {
+public:
+    explicit OrderBook(size_t reserveLevels = 1024);
+
+    // Sets the size at a price level; size 0 removes it. Returns true if the
+    // top of book (best price or size on either side) changed.
+    bool apply(BookSide side, double price, double size);
+
+    // Replaces both sides; levels may come in any order, zero sizes are dropped
+    void loadSnapshot(const std::vector<OrderBookLevel>& bids,
+                      const std::vector<OrderBookLevel>& asks);
+
+    void clear();
+
+    bool empty() const { return bids_.empty() && asks_.empty(); }
+    bool hasTop() const { return !bids_.empty() && !asks_.empty(); }
+
+    TopOfBook top() const;
+    double midPrice() const;
+    double spread() const;
+
+    size_t bidLevels() const { return bids_.size(); }
+    size_t askLevels() const { return asks_.size(); }
+
+    // Best `levels` per side, best first, into out's (reused) vectors
+    void depth(size_t levels, OrderBookSnapshot& out) const;
+
+    // Resting size imbalance over the best `levels`: (bid - ask) / (bid + ask)
+    double depthImbalance(size_t levels) const;
+
+    uint64_t updates() const { return updates_; }
+
+private:
+    std::vector<OrderBookLevel> bids_;   // ascending price, best bid last
+    std::vector<OrderBookLevel> asks_;   // descending price, best ask last
+    uint64_t updates_;
+};
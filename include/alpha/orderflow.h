@@ -1,7 +1,11 @@
 #pragma once
 #include "util/market_types.h"
-#include <deque>
+#include "util/ring_buffer.h"
+#include "alpha/rolling_stats.h"
+#include "alpha/p2_quantile.h"
+#include "util/snapshot.h"
 #include <optional>
+#include <cstdint>
 
 struct OFIResult {
     double imbalance;        // Net order flow imbalance
@@ -12,6 +16,9 @@ struct OFIResult {
     long timestamp;
 };
 
+// Order flow over the last `window` trades. Buy/sell volume, the two-halves
+// momentum split and the large-trade count are running sums updated as trades
+// enter and leave the window, so every query is O(1).
 class OrderFlowImbalance {
 public:
     explicit OrderFlowImbalance(size_t window = 100);
@@ -25,17 +32,73 @@ public:
     // Detect extreme imbalance (potential reversal or continuation)
     bool isExtremeImbalance(double threshold = 2.0) const;
 
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
+    struct Trade {
+        double volume;
+        bool isBuy;
+        bool isLarge;    // volume > 1.5 x the windowed median when it arrived
+    };
+
+    // Running volume totals for one side of the momentum split
+    struct FlowSums {
+        double buy = 0.0;
+        double sell = 0.0;
+
+        void add(const Trade& t, double sign) { (t.isBuy ? buy : sell) += sign * t.volume; }
+        double imbalance() const { return (buy + sell > 0) ? (buy - sell) / (buy + sell) : 0.0; }
+    };
+
+    static constexpr uint64_t RESYNC_INTERVAL = 1 << 16;
+
     size_t window_;
-    std::deque<double> buyVolumes_;
-    std::deque<double> sellVolumes_;
-    std::deque<double> buyPrices_;
-    std::deque<double> sellPrices_;
-    std::deque<long> timestamps_;
+    size_t halfWindow_;           // trades [0, halfWindow_) are "old", the rest "recent"
+    RingBuffer<Trade> trades_;
+    FlowSums old_;
+    FlowSums recent_;
+    size_t largeCount_;
+    P2Quantile medianVolume_;     // trade sizes in the current block of window_ trades
+    double referenceMedian_;      // median of the last complete block
+    long lastTimestamp_;
+    uint64_t updates_;
 
     double computeImbalance() const;
     double computeAggression() const;
     double computeMomentum() const;
+    void resync();
+};
+
+// Order flow imbalance from top-of-book changes (Cont, Kukanov & Stoikov 2014).
+// Each quote update contributes the size added at the bid minus the size added
+// at the ask, where a price move counts the whole new (or vanished) level;
+// the signal is the sum over the last `window` updates.
+class QuoteOFI {
+public:
+    explicit QuoteOFI(size_t window = 100);
+
+    void onQuote(double bidPrice, double bidSize, double askPrice, double askSize);
+
+    double value() const { return events_.sum(); }
+
+    // value() over the mean top-of-book depth, comparable across symbols
+    double normalized() const;
+
+    size_t count() const { return events_.size(); }
+    void reset();
+
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
+private:
+    RollingSum events_;
+    RollingSum depth_;
+    double lastBidPrice_;
+    double lastBidSize_;
+    double lastAskPrice_;
+    double lastAskSize_;
+    bool hasLast_;
 };
 
 struct PressureResult {
@@ -52,10 +115,13 @@ public:
     void onTrade(bool isBuy, double volume);
     PressureResult getPressure() const;
 
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
     size_t window_;
-    std::deque<double> bidVolumes_;
-    std::deque<double> askVolumes_;
+    RollingSum bidVolumes_;
+    RollingSum askVolumes_;
 };
 
 class TradeAggression {
@@ -68,9 +134,12 @@ public:
     // Get aggression score (-1 to +1: negative=passive, positive=aggressive)
     double getAggression() const;
 
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
     size_t window_;
-    std::deque<double> aggressionScores_;
+    RollingSum aggressionScores_;
 };
 
 class VolumeDelta {
@@ -83,10 +152,14 @@ public:
     double getRecentDelta() const;  // Last N trades
     void reset();
 
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
-    double cumulativeDelta_;
-    std::deque<double> recentDeltas_;
     static constexpr size_t RECENT_WINDOW = 50;
+
+    double cumulativeDelta_;
+    RollingSum recentDeltas_;
 };
 
 struct ToxicityScore {
@@ -106,6 +179,9 @@ public:
 
     ToxicityScore getScore() const;
 
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
     double threshold_;
     double toxicity_;
@@ -114,6 +190,20 @@ private:
     double aggressionWeight_;
 };
 
+enum class FlowDirection {
+    BUY_DOMINANT,
+    SELL_DOMINANT,
+    NEUTRAL
+};
+
+inline const char* flowDirectionToString(FlowDirection direction) {
+    switch (direction) {
+        case FlowDirection::BUY_DOMINANT: return "BUY_DOMINANT";
+        case FlowDirection::SELL_DOMINANT: return "SELL_DOMINANT";
+        default: return "NEUTRAL";
+    }
+}
+
 struct OrderFlowSignal {
     double ofi;
     double bidPressure;
@@ -122,7 +212,7 @@ struct OrderFlowSignal {
     double volumeDelta;
     double toxicity;
     bool isToxicFlow;
-    std::string flowDirection;  // "BUY_DOMINANT", "SELL_DOMINANT", "NEUTRAL"
+    FlowDirection flowDirection;
     long timestamp;
 };
 
@@ -136,6 +226,9 @@ public:
     // Reset all accumulators
     void reset();
 
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
     OrderFlowImbalance ofi_;
     BidAskPressure pressure_;
@@ -146,5 +239,5 @@ private:
     double avgVolume_;
     size_t tickCount_;
 
-    std::string determineFlowDirection(double ofi, double pressure) const;
+    FlowDirection determineFlowDirection(double ofi, double pressure) const;
 };
\ No newline at end of file
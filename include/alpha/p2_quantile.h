@@ -0,0 +1,118 @@
+#pragma once
+#include "util/snapshot.h"
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+// Streaming quantile estimate with the P-square algorithm (Jain & Chlamtac, 1985).
+// Five markers track the min, q/2, q, (1+q)/2 and max of the stream and are
+// nudged with a piecewise-parabolic fit, so each update is O(1) with no storage
+// beyond the markers. Exact for the first five observations.
+class P2Quantile {
+public:
+    explicit P2Quantile(double q = 0.5) : q_(q), count_(0) {
+        desiredIncrement_[0] = 0.0;
+        desiredIncrement_[1] = q_ / 2.0;
+        desiredIncrement_[2] = q_;
+        desiredIncrement_[3] = (1.0 + q_) / 2.0;
+        desiredIncrement_[4] = 1.0;
+    }
+
+    void add(double x) {
+        if (count_ < 5) {
+            height_[count_++] = x;
+            if (count_ == 5) {
+                std::sort(height_, height_ + 5);
+                for (int i = 0; i < 5; ++i) {
+                    position_[i] = i + 1;
+                    desired_[i] = 1.0 + 4.0 * desiredIncrement_[i];
+                }
+            }
+            return;
+        }
+
+        // Locate the cell containing x, extending the extremes if needed
+        int k;
+        if (x < height_[0]) {
+            height_[0] = x;
+            k = 0;
+        } else if (x >= height_[4]) {
+            height_[4] = std::max(height_[4], x);
+            k = 3;
+        } else {
+            k = 0;
+            while (k < 3 && x >= height_[k + 1]) ++k;
+        }
+
+        for (int i = k + 1; i < 5; ++i) ++position_[i];
+        for (int i = 0; i < 5; ++i) desired_[i] += desiredIncrement_[i];
+        ++count_;
+
+        // Adjust the three middle markers
+        for (int i = 1; i <= 3; ++i) {
+            double d = desired_[i] - position_[i];
+            if ((d >= 1.0 && position_[i + 1] - position_[i] > 1) ||
+                (d <= -1.0 && position_[i - 1] - position_[i] < -1)) {
+                int step = d >= 0 ? 1 : -1;
+                double h = parabolic(i, step);
+                if (height_[i - 1] < h && h < height_[i + 1]) {
+                    height_[i] = h;
+                } else {
+                    height_[i] = linear(i, step);
+                }
+                position_[i] += step;
+            }
+        }
+    }
+
+    // Current estimate (0 before any observation)
+    double value() const {
+        if (count_ >= 5) return height_[2];
+        if (count_ == 0) return 0.0;
+
+        double sorted[5];
+        std::copy(height_, height_ + count_, sorted);
+        std::sort(sorted, sorted + count_);
+        size_t idx = static_cast<size_t>(q_ * (count_ - 1) + 0.5);
+        return sorted[idx];
+    }
+
+    size_t count() const { return count_; }
+
+    void reset() { count_ = 0; }
+
+    void saveState(SnapshotWriter& out) const {
+        out.write(q_);
+        out.write(static_cast<uint64_t>(count_));
+        out.write(height_);
+        out.write(position_);
+        out.write(desired_);
+    }
+
+    void loadState(SnapshotReader& in) {
+        in.expect(q_, "P2Quantile quantile changed");
+        count_ = static_cast<size_t>(in.read<uint64_t>());
+        in.read(height_);
+        in.read(position_);
+        in.read(desired_);
+    }
+
+private:
+    double parabolic(int i, int d) const {
+        double n0 = position_[i - 1], n1 = position_[i], n2 = position_[i + 1];
+        return height_[i] + d / (n2 - n0) *
+               ((n1 - n0 + d) * (height_[i + 1] - height_[i]) / (n2 - n1) +
+                (n2 - n1 - d) * (height_[i] - height_[i - 1]) / (n1 - n0));
+    }
+
+    double linear(int i, int d) const {
+        return height_[i] + d * (height_[i + d] - height_[i]) / (position_[i + d] - position_[i]);
+    }
+
+    double q_;
+    size_t count_;
+    double height_[5];
+    double position_[5];
+    double desired_[5];
+    double desiredIncrement_[5];
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include "util/market_types.h"
-#include <deque>
+#include "alpha/rolling_stats.h"
+#include "util/ring_buffer.h"
+#include "util/snapshot.h"
 #include <vector>
 #include <string>
 
@@ -22,8 +24,23 @@ struct RegimeMetrics {
     double volRegime;          // Normalized volatility [0, 1]
     double trendStrength;      // [0, 1]: strength of trend
     double confidence;         // [0, 1]: regime classification confidence
+    size_t hurstAgeTicks;      // ticks since hurstExponent was last recomputed
 };
 
+enum class HurstMethod {
+    RESCALED_RANGE,        // R/S analysis, recomputed every hurstInterval ticks
+    AGGREGATED_VARIANCE    // streaming variance of m-period returns, O(levels) per tick
+};
+
+namespace regime {
+    // Reusable buffers so repeated Hurst estimates do not allocate
+    struct HurstScratch {
+        std::vector<double> logReturns;
+        std::vector<double> logLags;
+        std::vector<double> logRS;
+    };
+}
+
 struct RegimeSignalWeights {
     double momentumWeight;     // Weight for momentum signals
     double meanRevWeight;      // Weight for mean-reversion signals
@@ -36,7 +53,9 @@ public:
     explicit RegimeDetector(
         size_t window = 100,
         size_t hurstLag = 20,
-        size_t volWindow = 50
+        size_t volWindow = 50,
+        size_t hurstInterval = 10,
+        HurstMethod hurstMethod = HurstMethod::RESCALED_RANGE
     );
 
     // Process new price data
@@ -60,19 +79,27 @@ public:
 
     void reset();
 
+    // Windows, regime history and cached metrics; the configuration must match
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
     size_t window_;
     size_t hurstLag_;
     size_t volWindow_;
+    size_t hurstInterval_;
+    HurstMethod hurstMethod_;
+
+    static constexpr size_t REGIME_HISTORY = 50;
 
-    // Price history
-    std::deque<double> prices_;
-    std::deque<double> returns_;
-    std::deque<double> volumes_;
+    // Price history, fixed-capacity windows allocated up front
+    RingBuffer<double> prices_;
+    RingBuffer<double> returns_;
+    RingBuffer<double> volumes_;
 
     // Current state
     MarketRegime currentRegime_;
-    std::deque<MarketRegime> regimeHistory_;
+    RingBuffer<MarketRegime> regimeHistory_;
 
     // Cached metrics
     double hurstExponent_;
@@ -80,10 +107,24 @@ private:
     double volatility_;
     double trendStrength_;
 
-    void updateMetrics();
+    // Hurst decimation / scratch state
+    size_t hurstAge_;
+    bool hurstValid_;
+    std::vector<double> priceScratch_;
+    std::vector<double> returnScratch_;
+    regime::HurstScratch hurstScratch_;
+
+    // AGGREGATED_VARIANCE: rolling variance of m-period log returns, m = 1, 2, 4, ...
+    std::vector<size_t> aggLevels_;
+    std::vector<RollingStats> aggVariance_;
+
+    void updateMetrics(bool refreshHurst);
+    void updateAggregatedVariance();
+    double aggregatedVarianceHurst() const;
+    void pushPrice(double price, double volume);
     MarketRegime classifyRegime() const;
-    double computeHurstExponent() const;
-    double computeAutocorrelation(size_t lag = 1) const;
+    double computeHurstExponent();
+    double computeAutocorrelation(size_t lag = 1);
     double computeRealizedVolatility() const;
     double computeTrendStrength() const;
     double computeVolatilityRegime() const;
@@ -94,6 +135,10 @@ namespace regime {
     // Compute Hurst exponent using R/S analysis
     double hurstExponent(const std::vector<double>& prices, size_t maxLag = 20);
 
+    // Same estimate over a contiguous buffer, reusing scratch (no allocation once warmed up)
+    double hurstExponent(const double* prices, size_t numPrices, size_t maxLag,
+                         HurstScratch& scratch);
+
     // Compute autocorrelation at given lag
     double autocorrelation(const std::vector<double>& returns, size_t lag = 1);
 
@@ -101,5 +146,5 @@ namespace regime {
     bool detectRegimeChange(const std::vector<double>& returns, double threshold = 3.0);
 
     // Classify regime based on Hurst and volatility
-    std::string regimeToString(MarketRegime regime);
+    const char* regimeToString(MarketRegime regime);
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+#include "util/ring_buffer.h"
+#include "util/snapshot.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Rolling mean / variance over the last N values with O(1) updates and no
+// allocation after construction. Uses the sliding-window form of Welford's
+// update (mean and sum of squared deviations) rather than raw sum / sum of
+// squares, which cancels badly when prices are large relative to their spread.
+// The accumulators are rebuilt from the window every RESYNC_INTERVAL updates
+// to bound floating-point drift on long-running feeds.
+class RollingStats {
+public:
+    static constexpr uint64_t RESYNC_INTERVAL = 1 << 16;
+
+    explicit RollingStats(size_t window)
+        : window_(window), mean_(0.0), m2_(0.0), updates_(0) {}
+
+    void push(double x) {
+        double evicted;
+        if (window_.push(x, &evicted)) {
+            // Replace evicted with x, n unchanged
+            const double oldMean = mean_;
+            mean_ += (x - evicted) / static_cast<double>(window_.size());
+            m2_ += (x - evicted) * (x - mean_ + evicted - oldMean);
+        } else {
+            const double delta = x - mean_;
+            mean_ += delta / static_cast<double>(window_.size());
+            m2_ += delta * (x - mean_);
+        }
+
+        if (m2_ < 0.0) m2_ = 0.0;
+        if (++updates_ % RESYNC_INTERVAL == 0) resync();
+    }
+
+    void clear() {
+        window_.clear();
+        mean_ = 0.0;
+        m2_ = 0.0;
+        updates_ = 0;
+    }
+
+    size_t size() const { return window_.size(); }
+    size_t capacity() const { return window_.capacity(); }
+    bool full() const { return window_.full(); }
+
+    double mean() const { return mean_; }
+    double sum() const { return mean_ * static_cast<double>(window_.size()); }
+
+    // Sample variance (n - 1), matching computeStdDev
+    double variance() const {
+        return window_.size() > 1 ? m2_ / static_cast<double>(window_.size() - 1) : 0.0;
+    }
+    double stddev() const { return std::sqrt(variance()); }
+
+    // Oldest / newest values in the window
+    double front() const { return window_.front(); }
+    double back() const { return window_.back(); }
+    double operator[](size_t i) const { return window_[i]; }
+
+    const RingBuffer<double>& window() const { return window_; }
+
+    void saveState(SnapshotWriter& out) const {
+        out.write(static_cast<uint64_t>(window_.capacity()));
+        out.write(window_);
+        out.write(mean_);
+        out.write(m2_);
+        out.write(updates_);
+    }
+
+    // Accumulators are restored as saved, not rebuilt, so the next values match exactly
+    void loadState(SnapshotReader& in) {
+        in.expect(static_cast<uint64_t>(window_.capacity()), "RollingStats window changed");
+        in.read(window_);
+        in.read(mean_);
+        in.read(m2_);
+        in.read(updates_);
+    }
+
+private:
+    void resync() {
+        const size_t n = window_.size();
+        if (n == 0) return;
+
+        double mean = 0.0;
+        for (size_t i = 0; i < n; ++i) mean += window_[i];
+        mean /= static_cast<double>(n);
+
+        double m2 = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double d = window_[i] - mean;
+            m2 += d * d;
+        }
+
+        mean_ = mean;
+        m2_ = m2;
+    }
+
+    RingBuffer<double> window_;
+    double mean_;
+    double m2_;
+    uint64_t updates_;
+};
+
+// Rolling sum over the last N values: ring buffer plus a running total, rebuilt
+// from the window every RESYNC_INTERVAL updates like RollingStats.
+class RollingSum {
+public:
+    static constexpr uint64_t RESYNC_INTERVAL = 1 << 16;
+
+    explicit RollingSum(size_t window) : window_(window), sum_(0.0), updates_(0) {}
+
+    void push(double x) {
+        double evicted;
+        if (window_.push(x, &evicted)) sum_ -= evicted;
+        sum_ += x;
+
+        if (++updates_ % RESYNC_INTERVAL == 0) {
+            sum_ = 0.0;
+            for (size_t i = 0; i < window_.size(); ++i) sum_ += window_[i];
+        }
+    }
+
+    void clear() {
+        window_.clear();
+        sum_ = 0.0;
+        updates_ = 0;
+    }
+
+    double sum() const { return sum_; }
+    double mean() const { return window_.empty() ? 0.0 : sum_ / static_cast<double>(window_.size()); }
+    size_t size() const { return window_.size(); }
+    bool empty() const { return window_.empty(); }
+
+    void saveState(SnapshotWriter& out) const {
+        out.write(static_cast<uint64_t>(window_.capacity()));
+        out.write(window_);
+        out.write(sum_);
+        out.write(updates_);
+    }
+
+    void loadState(SnapshotReader& in) {
+        in.expect(static_cast<uint64_t>(window_.capacity()), "RollingSum window changed");
+        in.read(window_);
+        in.read(sum_);
+        in.read(updates_);
+    }
+
+private:
+    RingBuffer<double> window_;
+    double sum_;
+    uint64_t updates_;
+};
@@ -0,0 +1,12 @@
+#pragma once
+#include "../util/market_types.h"
+
+// Output edge for signals produced by the alpha classes. Engines hold a
+// non-owning pointer and do no I/O at all when it is null (the default),
+// which is what backtests and benchmarks want.
+class SignalSink {
+public:
+	virtual ~SignalSink() = default;
+
+	virtual void onAlphaSignal(const AlphaSignal& signal) = 0;
+};
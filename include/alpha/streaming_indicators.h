@@ -0,0 +1,145 @@
+#pragma once
+#include "alpha/indicators.h"
+#include "alpha/rolling_stats.h"
+#include "util/ring_buffer.h"
+#include "util/snapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Stateful, O(1)-per-update counterparts of the batch functions in indicators.h.
+// Each keeps only a bounded window, so cost and memory stay flat however long
+// a session runs. The batch functions remain the reference implementations.
+
+// EMA seeded with the first value, like computeEMA
+class StreamingEMA {
+public:
+	explicit StreamingEMA(int period);
+
+	double update(double x);
+	double value() const { return value_; }
+	bool ready() const { return count_ >= period_; }
+	void reset();
+
+private:
+	size_t period_;
+	double alpha_;
+	double value_;
+	size_t count_;
+};
+
+// RSI with Wilder smoothing: a simple average over the first `period` changes,
+// then avg = (avg * (period - 1) + x) / period
+class StreamingRSI {
+public:
+	explicit StreamingRSI(int period = 14);
+
+	double update(double close);
+	double value() const;       // 50 until the first `period` changes are seen
+	bool ready() const { return changes_ >= period_; }
+	void reset();
+
+	void saveState(SnapshotWriter& out) const;
+	void loadState(SnapshotReader& in);
+
+private:
+	size_t period_;
+	double prevClose_;
+	bool hasPrev_;
+	size_t changes_;
+	double avgGain_;
+	double avgLoss_;
+};
+
+// MACD with a real EMA signal line (computeMACD approximates it)
+class StreamingMACD {
+public:
+	StreamingMACD(int fastPeriod = 12, int slowPeriod = 26, int signalPeriod = 9);
+
+	MACDResult update(double close);
+	MACDResult value() const;
+	bool ready() const;
+	void reset();
+
+private:
+	StreamingEMA fast_;
+	StreamingEMA slow_;
+	StreamingEMA signal_;
+	size_t slowPeriod_;
+	size_t signalPeriod_;
+	size_t count_;
+};
+
+// Average True Range as a rolling mean of the last `period` true ranges (matches computeATR)
+class StreamingATR {
+public:
+	explicit StreamingATR(int period = 14);
+
+	double update(double high, double low, double close);
+	double value() const { return ready() ? trueRanges_.mean() : 0.0; }
+	bool ready() const { return trueRanges_.full(); }
+	void reset();
+
+private:
+	RollingStats trueRanges_;
+	double prevClose_;
+	bool hasPrev_;
+};
+
+// Sliding-window max or min via a monotonic queue, amortised O(1)
+class MonotonicWindow {
+public:
+	MonotonicWindow(size_t window, bool trackMax);
+
+	void push(double x);
+	double value() const { return queue_.front().second; }
+	bool empty() const { return queue_.empty(); }
+	void reset();
+
+private:
+	bool better(double a, double b) const { return trackMax_ ? a >= b : a <= b; }
+
+	size_t window_;
+	bool trackMax_;
+	uint64_t index_;
+	RingBuffer<std::pair<uint64_t, double>> queue_;   // (index, value), never exceeds window
+};
+
+// Fast stochastic with %D as the SMA of the last `dPeriod` %K values
+class StreamingStochastic {
+public:
+	explicit StreamingStochastic(int period = 14, int dPeriod = 3);
+
+	StochasticResult update(double high, double low, double close);
+	StochasticResult value() const;
+	bool ready() const { return count_ >= period_; }
+	void reset();
+
+private:
+	size_t period_;
+	size_t count_;
+	MonotonicWindow highest_;
+	MonotonicWindow lowest_;
+	RollingStats kValues_;
+	double lastK_;
+};
+
+// Up-volume / down-volume over the last `window` candles
+class StreamingVolumeRatio {
+public:
+	explicit StreamingVolumeRatio(size_t window = 100);
+
+	double update(double close, double volume);
+	double value() const { return sumDown_ > 0.0 ? sumUp_ / sumDown_ : 1.0; }
+	void reset();
+
+	void saveState(SnapshotWriter& out) const;
+	void loadState(SnapshotReader& in);
+
+private:
+	RingBuffer<std::pair<double, bool>> window_;   // (volume, isUp)
+	double sumUp_;
+	double sumDown_;
+	double prevClose_;
+	bool hasPrev_;
+};
@@ -1,7 +1,11 @@
 #pragma once
 #include "util/market_types.h"
-#include <deque>
+#include "util/ring_buffer.h"
+#include "util/snapshot.h"
 #include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 
 struct VWAPMetrics {
@@ -56,7 +60,12 @@ public:
     // Check if price is mean-reverting to VWAP
     bool isMeanReverting() const;
 
+    void saveState(SnapshotWriter& out) const;
+    void loadState(SnapshotReader& in);
+
 private:
+    static constexpr uint64_t RESYNC_INTERVAL = 1 << 16;
+
     double bandMultiplier_;
     size_t rollingWindow_;
 
@@ -68,17 +77,19 @@ private:
     // For standard deviation bands
     double cumulativePV2_;    // Sum of (price^2 * volume)
 
-    // Rolling window
-    std::deque<MarketTick> tickWindow_;
+    // Rolling window: the sums above cover exactly these trades
+    RingBuffer<TradeRecord> tickWindow_;
+    uint64_t windowUpdates_;
 
     // Anchor point
     std::chrono::system_clock::time_point anchorTime_;
     bool isAnchored_;
 
     // Price history for mean reversion detection
-    std::deque<double> recentPrices_;
+    RingBuffer<double> recentPrices_;
 
-    void updateRollingVWAP();
+    void updateRollingVWAP(const MarketTick& tick);
+    void resyncRollingSums();
     void updateSessionVWAP(const MarketTick& tick);
     double computeStdDev() const;
 };
@@ -1,9 +1,11 @@
 #pragma once
 #include "util/market_types.h"
 #include "pnl.h"
+#include "tick_store.h"
 #include <vector>
 #include <functional>
 #include <string>
+#include <cstdint>
 
 
 struct BacktestConfig {
@@ -51,9 +53,56 @@ struct BacktestResult {
     std::vector<long> timestamps;
 };
 
+// Fills result's trade statistics (PnL, win rate, profit factor, Sharpe over
+// per-trade returns) and max drawdown from its trades and equity curve
+void computeTradeStatistics(BacktestResult& result, double initialCapital);
+
 // Signal generator callback
 using SignalGenerator = std::function<int(const MarketTick&)>;  // Returns: 1=buy, -1=sell, 0=hold
 
+// Same contract over columnar / taped ticks (no per-tick string)
+using TickSignalGenerator = std::function<int(const CompactTick&)>;
+
+// Generators usually carry state (rolling windows), so concurrent runs each
+// get a fresh one from a factory
+using SignalGeneratorFactory = std::function<SignalGenerator()>;
+using TickSignalGeneratorFactory = std::function<TickSignalGenerator()>;
+
+enum class ResamplingMethod {
+    PERMUTATION,        // shuffle tick order
+    BLOCK_BOOTSTRAP     // concatenate randomly chosen contiguous blocks
+};
+
+struct MonteCarloConfig {
+    int numSimulations = 1000;
+    uint64_t seed = 42;                 // simulation i always uses (seed, i)
+    ResamplingMethod method = ResamplingMethod::PERMUTATION;
+    size_t blockSize = 100;             // ticks per block for BLOCK_BOOTSTRAP
+    size_t numThreads = 0;              // 0 = hardware concurrency
+    bool keepEquityCurves = false;      // drop per-simulation curves after scoring
+};
+
+// Mutable state of one backtest run. Backtester itself only holds the config,
+// so any number of runs can proceed concurrently, each with its own context.
+struct BacktestContext {
+    explicit BacktestContext(double initialCapital, bool logTrades = true)
+        : pnlTracker(initialCapital), cash(initialCapital), logTrades(logTrades) {}
+
+    PnLTracker pnlTracker;
+    double position = 0.0;
+    double avgEntryPrice = 0.0;
+    double cash;
+    bool logTrades;             // print entries / exits
+
+    std::vector<Trade> trades;
+    std::vector<double> equityCurve;
+    std::vector<long> timestamps;
+
+    SymbolId lastSymbol = INVALID_SYMBOL_ID;
+    double lastPrice = 0.0;
+    long now = 0;               // timestamp of the tick being processed
+};
+
 class Backtester {
 public:
     explicit Backtester(const BacktestConfig& config = BacktestConfig());
@@ -62,22 +111,60 @@ public:
     BacktestResult run(
         const std::vector<MarketTick>& historicalData,
         SignalGenerator signalFunc
-    );
+    ) const;
 
-    // Run walk-forward analysis
+    // Run backtest over columnar ticks
+    BacktestResult run(
+        const TickView& ticks,
+        TickSignalGenerator signalFunc
+    ) const;
+
+    // Run over columnar ticks with a caller-owned context (e.g. logging off)
+    BacktestResult run(
+        BacktestContext& ctx,
+        const TickView& ticks,
+        TickSignalGenerator signalFunc
+    ) const;
+
+    // Run backtest over a memory-mapped tape, chunk by chunk
+    BacktestResult run(
+        const TapeReader& tape,
+        TickSignalGenerator signalFunc
+    ) const;
+
+    // Run walk-forward analysis; folds run in parallel, results in fold order
     std::vector<BacktestResult> walkForward(
         const std::vector<MarketTick>& historicalData,
-        SignalGenerator signalFunc,
+        SignalGeneratorFactory makeSignal,
         size_t trainPeriod,
-        size_t testPeriod
-    );
+        size_t testPeriod,
+        size_t numThreads = 0
+    ) const;
+
+    std::vector<BacktestResult> walkForward(
+        const TickView& ticks,
+        TickSignalGeneratorFactory makeSignal,
+        size_t trainPeriod,
+        size_t testPeriod,
+        size_t numThreads = 0
+    ) const;
 
-    // Run Monte Carlo simulation
+    // Run Monte Carlo simulation over resampled tick orderings. Samples are
+    // index sequences into the data, never copies; results depend only on
+    // the seed, not on thread count or scheduling.
     std::vector<BacktestResult> monteCarlo(
         const std::vector<MarketTick>& historicalData,
-        SignalGenerator signalFunc,
-        int numSimulations = 1000
-    );
+        SignalGeneratorFactory makeSignal,
+        const MonteCarloConfig& mcConfig = MonteCarloConfig()
+    ) const;
+
+    std::vector<BacktestResult> monteCarlo(
+        const TickView& ticks,
+        TickSignalGeneratorFactory makeSignal,
+        const MonteCarloConfig& mcConfig = MonteCarloConfig()
+    ) const;
+
+    const BacktestConfig& getConfig() const { return config_; }
 
     // Set custom execution model
     void setExecutionModel(
@@ -86,22 +173,33 @@ public:
 
 private:
     BacktestConfig config_;
-    PnLTracker pnlTracker_;
 
-    // Current state
-    double currentPosition_;
-    double avgEntryPrice_;
-    double currentCash_;
+    // Feeds ticks [begin, begin + count) of data, or data[index[i]] when index is set
+    template <typename Data, typename Generator>
+    void runRange(BacktestContext& ctx, const Data& data, Generator& signalFunc,
+                  const uint32_t* index, size_t begin, size_t count) const;
+
+    template <typename Data, typename Factory>
+    std::vector<BacktestResult> runWalkForward(const Data& data, const Factory& makeSignal,
+                                               size_t trainPeriod, size_t testPeriod,
+                                               size_t numThreads) const;
+
+    template <typename Data, typename Factory>
+    std::vector<BacktestResult> runMonteCarlo(const Data& data, const Factory& makeSignal,
+                                              const MonteCarloConfig& mcConfig) const;
+
+    void processTick(BacktestContext& ctx, SymbolId symbol, double price, long timestamp, int signal) const;
+    BacktestResult finishRun(BacktestContext& ctx) const;
 
     // Execution modeling
     double applySlippage(double price, double quantity, bool isBuy) const;
     double calculateCommission(double notional) const;
 
     // Position management
-    bool canEnterPosition(double price, double quantity) const;
-    void enterPosition(const MarketTick& tick, double quantity, bool isLong, const std::string& reason);
-    void exitPosition(const MarketTick& tick, const std::string& reason);
+    bool canEnterPosition(const BacktestContext& ctx, double price, double quantity) const;
+    void enterPosition(BacktestContext& ctx, SymbolId symbol, double price, double quantity, bool isLong, const std::string& reason) const;
+    void exitPosition(BacktestContext& ctx, SymbolId symbol, double price, const std::string& reason) const;
 
     // Results calculation
-    BacktestResult computeResults(const std::vector<Trade>& trades) const;
+    BacktestResult computeResults(BacktestContext& ctx) const;
 };
@@ -0,0 +1,169 @@
+#pragma once
+#include "backtester.h"
+#include "tick_store.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <cstddef>
+
+class ThreadPool;
+
+// One point of a parameter grid: (name, value) pairs in axis order
+class ParameterSet {
+public:
+    void set(const std::string& name, double value);
+    double get(const std::string& name, double fallback = 0.0) const;
+
+    const std::vector<std::pair<std::string, double>>& values() const { return values_; }
+    std::string toString() const;
+
+private:
+    std::vector<std::pair<std::string, double>> values_;
+};
+
+// Cartesian product of named value lists
+class ParameterGrid {
+public:
+    ParameterGrid& addAxis(const std::string& name, const std::vector<double>& values);
+
+    size_t size() const;
+    ParameterSet at(size_t index) const;   // last axis varies fastest
+
+private:
+    std::vector<std::pair<std::string, std::vector<double>>> axes_;
+};
+
+// Per-tick feature columns shared by every variant of a sweep
+enum class FeatureKind {
+    ROLLING_MEAN,       // mean of the last `period` prices
+    ROLLING_STDDEV,     // sample std dev of the last `period` prices
+    MOMENTUM,           // price[i] / price[i - period + 1] - 1
+    RSI,                // Wilder RSI over tick prices, 50 until warmed up
+    HURST               // R/S Hurst over the last `period` prices (max lag `lag`), 0.5 until warmed up
+};
+
+struct FeatureKey {
+    FeatureKind kind;
+    size_t period;
+    size_t lag = 0;
+
+    bool operator<(const FeatureKey& o) const {
+        if (kind != o.kind) return kind < o.kind;
+        if (period != o.period) return period < o.period;
+        return lag < o.lag;
+    }
+};
+
+// Feature columns computed once over a single-instrument tick series and then
+// read concurrently by every strategy variant. Rolling features are 0 until
+// their window has filled (index < period - 1).
+class FeatureCache {
+public:
+    static constexpr size_t HURST_STRIDE = 10;   // ticks between Hurst re-estimates
+
+    explicit FeatureCache(const TickView& ticks);
+
+    // Computes the keys not yet cached, one column per pool task when a pool is given
+    void compute(const std::vector<FeatureKey>& keys, ThreadPool* pool = nullptr);
+
+    bool has(const FeatureKey& key) const { return columns_.count(key) != 0; }
+
+    // Throws std::out_of_range for a key that was never computed
+    const std::vector<double>& get(const FeatureKey& key) const;
+    const std::vector<double>& get(FeatureKind kind, size_t period, size_t lag = 0) const {
+        return get(FeatureKey{kind, period, lag});
+    }
+
+    const TickView& ticks() const { return ticks_; }
+    size_t size() const { return ticks_.size(); }
+    size_t numColumns() const { return columns_.size(); }
+
+private:
+    void computeMeanStd(size_t period, std::vector<double>& mean, std::vector<double>& stddev) const;
+    void computeColumn(const FeatureKey& key, std::vector<double>& out) const;
+
+    TickView ticks_;
+    std::map<FeatureKey, std::vector<double>> columns_;
+};
+
+// A family of strategies indexed by a ParameterSet. Generators read the shared
+// FeatureCache instead of recomputing indicators, and keep any remaining state
+// in the generator itself, so variants can be evaluated concurrently.
+class SweepStrategy {
+public:
+    virtual ~SweepStrategy() = default;
+
+    // Feature columns the variant with these parameters will read
+    virtual void requiredFeatures(const ParameterSet& params, std::vector<FeatureKey>& out) const = 0;
+
+    // Fresh generator for one run; called with ticks in order, so the n-th call is tick n
+    virtual TickSignalGenerator makeGenerator(const ParameterSet& params, const FeatureCache& features) const = 0;
+};
+
+// Bollinger band reversion (BollingerTracker's rule), with optional momentum and
+// Hurst regime filters. Parameters:
+//   period (20), multiplier (2.0)      band window / width
+//   momentum (0)                       > 0: buy only if momentum > -momentum, sell only if < momentum
+//   hurstWindow (0 = off), hurstLag (20), hurstMax (0.5)
+//                                      trade only while H < hurstMax (mean-reverting regime)
+class BollingerSweepStrategy : public SweepStrategy {
+public:
+    void requiredFeatures(const ParameterSet& params, std::vector<FeatureKey>& out) const override;
+    TickSignalGenerator makeGenerator(const ParameterSet& params, const FeatureCache& features) const override;
+};
+
+// The live tick decision (AlphaEngine momentum and z-score, weighted by the
+// regime) with AlphaEngine's window and RegimeDetector's Hurst window / lag as
+// parameters. Volatility regimes are not modelled: Hurst > 0.55 picks the
+// trending low-vol weights, anything else the mean-reverting ones. Parameters:
+//   window (20)                        AlphaEngine window (momentum, z-score)
+//   hurstWindow (100, 0 = off), hurstLag (20)
+//                                      RegimeDetector window / max lag; off = neutral weights
+//   threshold (0.01)                   |weighted score| needed to trade
+class AlphaSweepStrategy : public SweepStrategy {
+public:
+    void requiredFeatures(const ParameterSet& params, std::vector<FeatureKey>& out) const override;
+    TickSignalGenerator makeGenerator(const ParameterSet& params, const FeatureCache& features) const override;
+};
+
+enum class SweepMetric {
+    SHARPE,
+    TOTAL_RETURN,
+    PROFIT_FACTOR,
+    EXPECTANCY
+};
+
+struct SweepConfig {
+    size_t numThreads = 0;              // 0 = hardware concurrency
+    SweepMetric rankBy = SweepMetric::SHARPE;
+    bool keepTrades = false;            // keep per-trade detail and equity curves
+};
+
+struct SweepResult {
+    ParameterSet params;
+    BacktestResult result;
+    double score;
+};
+
+class ParameterSweep {
+public:
+    explicit ParameterSweep(const Backtester& backtester, const SweepConfig& config = SweepConfig());
+
+    // Evaluates every grid point over ticks; best score first
+    std::vector<SweepResult> run(
+        const TickView& ticks,
+        const ParameterGrid& grid,
+        const SweepStrategy& strategy
+    ) const;
+
+private:
+    double score(const BacktestResult& result) const;
+
+    const Backtester& backtester_;
+    SweepConfig config_;
+};
+
+// Top rows of a ranked sweep as a console table
+void printSweepTable(const std::vector<SweepResult>& results, size_t maxRows, std::ostream& out);
@@ -1,7 +1,10 @@
 #pragma once
+#include "util/symbol_registry.h"
 #include <string>
-#include <map>
 #include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
 
 enum class CostMethod {
     FIFO,       // First In First Out
@@ -11,6 +14,7 @@ enum class CostMethod {
 
 struct Position {
     std::string symbol;
+    SymbolId symbolId;
     double quantity;
     double avgEntryPrice;
     double currentPrice;
@@ -30,6 +34,50 @@ struct PortfolioMetrics {
     int numPositions;
 };
 
+enum class TransactionType : uint8_t {
+    BUY,
+    SELL,
+    CLOSE,
+    PARTIAL_CLOSE
+};
+
+const char* toString(TransactionType type);
+
+struct Transaction {
+    long timestamp;
+    double quantity;
+    double price;
+    SymbolId symbolId;
+    TransactionType type;
+};
+
+// Append-only transaction log in fixed-size chunks. The first chunk is
+// allocated up front; entries never move once written, and clear() keeps the
+// chunks for reuse.
+class TransactionLog {
+public:
+    explicit TransactionLog(size_t chunkSize = 1024);
+
+    void append(const Transaction& txn);
+    void clear() { size_ = 0; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const Transaction& operator[](size_t i) const {
+        return chunks_[i / chunkSize_][i % chunkSize_];
+    }
+
+private:
+    size_t chunkSize_;
+    size_t size_;
+    std::vector<std::unique_ptr<Transaction[]>> chunks_;
+};
+
+// P&L engine keyed by dense SymbolId. Per-symbol state lives in a flat array
+// indexed by id, and the portfolio totals are maintained incrementally, so
+// updatePrice and getPortfolioMetrics are O(1). String overloads resolve the
+// name through SymbolRegistry first.
 class PnLTracker {
 public:
     explicit PnLTracker(
@@ -37,51 +85,95 @@ public:
         CostMethod method = CostMethod::AVERAGE
     );
 
-    // Position management
-    void addPosition(const std::string& symbol, double quantity, double price);
-    void closePosition(const std::string& symbol, double price);
-    void closePartialPosition(const std::string& symbol, double quantity, double price);
+    // Position management (timestamp 0 = wall clock, in ms)
+    void addPosition(SymbolId symbol, double quantity, double price, long timestamp = 0);
+    void closePosition(SymbolId symbol, double price, long timestamp = 0);
+    void closePartialPosition(SymbolId symbol, double quantity, double price, long timestamp = 0);
 
     // Update current prices (for unrealized P&L)
-    void updatePrice(const std::string& symbol, double price);
+    void updatePrice(SymbolId symbol, double price);
 
     // Get position info
-    Position getPosition(const std::string& symbol) const;
+    Position getPosition(SymbolId symbol) const;
     std::vector<Position> getAllPositions() const;
-    bool hasPosition(const std::string& symbol) const;
+    bool hasPosition(SymbolId symbol) const {
+        return symbol < slots_.size() && slots_[symbol].openIndex != NOT_OPEN;
+    }
 
     // Get P&L metrics
-    double getUnrealizedPnL(const std::string& symbol) const;
-    double getRealizedPnL(const std::string& symbol) const;
-    double getTotalPnL(const std::string& symbol) const;
+    double getUnrealizedPnL(SymbolId symbol) const;
+    double getRealizedPnL(SymbolId symbol) const;
+    double getTotalPnL(SymbolId symbol) const;
+
+    // By name
+    void addPosition(const std::string& symbol, double quantity, double price) {
+        addPosition(intern(symbol), quantity, price);
+    }
+    void closePosition(const std::string& symbol, double price) {
+        closePosition(lookup(symbol), price);
+    }
+    void closePartialPosition(const std::string& symbol, double quantity, double price) {
+        closePartialPosition(lookup(symbol), quantity, price);
+    }
+    void updatePrice(const std::string& symbol, double price) { updatePrice(lookup(symbol), price); }
+
+    Position getPosition(const std::string& symbol) const;
+    bool hasPosition(const std::string& symbol) const { return hasPosition(lookup(symbol)); }
+    double getUnrealizedPnL(const std::string& symbol) const { return getUnrealizedPnL(lookup(symbol)); }
+    double getRealizedPnL(const std::string& symbol) const { return getRealizedPnL(lookup(symbol)); }
+    double getTotalPnL(const std::string& symbol) const { return getTotalPnL(lookup(symbol)); }
 
     // Portfolio-level metrics
     PortfolioMetrics getPortfolioMetrics() const;
-    double getTotalPortfolioPnL() const;
+    double getTotalPortfolioPnL() const { return realizedTotal_ + unrealizedTotal_; }
     double getCash() const { return cash_; }
 
-    // Reset tracker
+    // Reset tracker (keeps allocated storage)
     void reset();
 
     // Transaction history
-    struct Transaction {
-        std::string symbol;
-        long timestamp;
-        double quantity;
-        double price;
-        std::string type;  // "BUY", "SELL", "CLOSE"
-    };
-
+    const TransactionLog& transactions() const { return transactions_; }
     std::vector<Transaction> getTransactionHistory() const;
 
 private:
+    static constexpr uint32_t NOT_OPEN = UINT32_MAX;
+    static constexpr uint64_t RESYNC_INTERVAL = 1ULL << 20;   // price updates between total rebuilds
+
+    struct Slot {
+        double quantity = 0.0;
+        double avgEntryPrice = 0.0;
+        double currentPrice = 0.0;
+        double realizedPnL = 0.0;
+        double totalCost = 0.0;
+        uint32_t openIndex = NOT_OPEN;      // position in openIds_
+    };
+
     CostMethod method_;
     double initialCash_;
     double cash_;
 
-    std::map<std::string, Position> positions_;
-    std::map<std::string, double> realizedPnL_;
-    std::vector<Transaction> transactions_;
+    std::vector<Slot> slots_;           // indexed by SymbolId
+    std::vector<SymbolId> openIds_;     // symbols with an open position
+    TransactionLog transactions_;
+
+    // Running portfolio totals over open positions
+    double realizedTotal_;
+    double unrealizedTotal_;
+    double positionsValue_;
+    double exposure_;
+    uint64_t priceUpdates_;
+
+    static SymbolId intern(const std::string& symbol) { return SymbolRegistry::instance().intern(symbol); }
+    static SymbolId lookup(const std::string& symbol) { return SymbolRegistry::instance().find(symbol); }
+
+    Slot& slot(SymbolId symbol);
+    void open(SymbolId symbol, Slot& s);
+    void close(Slot& s);
+
+    // Move s's contribution to the running totals in or out
+    void addContribution(const Slot& s, double sign);
+    void resyncTotals();
 
-    void updatePositionCost(Position& pos, double quantity, double price);
+    void record(SymbolId symbol, TransactionType type, double quantity, double price, long timestamp);
+    void updatePositionCost(Slot& pos, double quantity, double price);
 };
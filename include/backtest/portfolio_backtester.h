@@ -0,0 +1,74 @@
+#pragma once
+#include "backtester.h"
+#include "tick_store.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+// Builds the per-symbol signal pipeline the first time a symbol ticks
+using SymbolStrategyFactory = std::function<TickSignalGenerator(SymbolId)>;
+
+struct PortfolioBacktestConfig {
+    BacktestConfig execution;           // capital, costs, latencyMs, shorting, margin
+    double positionFraction = 0.0;      // equity share per entry; 0 = maxPositionSize / number of symbols
+    long equityIntervalMs = 1000;       // market time between equity curve samples
+    bool logTrades = false;
+};
+
+struct SymbolSummary {
+    std::string symbol;
+    size_t ticks;
+    int numTrades;
+    double pnl;
+};
+
+struct PortfolioBacktestResult {
+    BacktestResult portfolio;           // trades across all symbols, sampled equity curve
+    std::vector<SymbolSummary> symbols; // ordered by SymbolId
+
+    size_t eventsProcessed = 0;
+    size_t ordersSubmitted = 0;
+    size_t ordersFilled = 0;
+    size_t ordersRejected = 0;          // failed the capital check at fill time
+    size_t reopensRejected = 0;         // reversals that closed but failed the check to reopen
+    size_t ordersExpired = 0;           // still in flight when the data ran out
+    double commissions = 0.0;           // paid on every entry and exit; trade PnL excludes them
+    double finalEquity = 0.0;           // after closing every position, net of commissions
+    double netReturn = 0.0;             // finalEquity against initial capital, %
+    double elapsedSeconds = 0.0;        // wall clock for the replay
+};
+
+// Event-driven backtest over a basket. Per-symbol (or per-venue) tick streams,
+// each in timestamp order, are k-way merged through a min-heap into a single
+// timeline. Every tick goes to its symbol's strategy; a signal becomes an order
+// that sits in a pending queue for latencyMs of market time and then fills at
+// the symbol's prevailing price, so strategies never trade on the tick that
+// produced the signal (unless latencyMs is 0). One position per symbol; a
+// signal against an open position closes it and, if allowed, reverses.
+class PortfolioBacktester {
+public:
+    explicit PortfolioBacktester(const PortfolioBacktestConfig& config = PortfolioBacktestConfig());
+
+    PortfolioBacktestResult run(
+        const std::vector<TickView>& streams,
+        const SymbolStrategyFactory& makeStrategy
+    ) const;
+
+    // Each in-order run of ticks within a tape chunk becomes one stream, so
+    // chunks need not be sorted
+    PortfolioBacktestResult run(
+        const TapeReader& tape,
+        const SymbolStrategyFactory& makeStrategy
+    ) const;
+
+    const PortfolioBacktestConfig& getConfig() const { return config_; }
+
+private:
+    PortfolioBacktestConfig config_;
+};
+
+// Portfolio totals and the per-symbol breakdown as a console table
+void printPortfolioSummary(const PortfolioBacktestResult& result, std::ostream& out);
@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <cstddef>
 
 struct PerformanceMetrics {
     double sharpeRatio;
@@ -66,14 +67,23 @@ double computeWinRate(const std::vector<double>& returns);
 // Profit factor: sum(wins) / abs(sum(losses))
 double computeProfitFactor(const std::vector<double>& returns);
 
-// Compute all metrics at once
+// Compute all metrics at once: one pass over returns, one over the equity
+// curve, and a single partial partition for VaR / CVaR
 PerformanceMetrics computeAllMetrics(
     const std::vector<double>& returns,
     const std::vector<double>& equityCurve,
     double riskFreeRate = 0.0
 );
 
-// Rolling Sharpe Ratio
+// Same, reusing scratch for the tail partition (for scoring many results)
+PerformanceMetrics computeAllMetrics(
+    const std::vector<double>& returns,
+    const std::vector<double>& equityCurve,
+    double riskFreeRate,
+    std::vector<double>& scratch
+);
+
+// Rolling Sharpe Ratio, O(n) with a sliding mean / variance
 std::vector<double> computeRollingSharpe(
     const std::vector<double>& returns,
     size_t window = 20,
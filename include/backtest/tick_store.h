@@ -0,0 +1,210 @@
+#pragma once
+#include "util/market_types.h"
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+
+// Non-owning view over columnar ticks: one contiguous array per field. Backed
+// either by TickColumns or directly by a memory-mapped tape chunk. When remap is
+// set, stored symbol ids are translated through it (tape ids -> registry ids).
+class TickView {
+public:
+    TickView() = default;
+    TickView(const int64_t* timestampsNs, const double* prices, const double* quantities,
+             const SymbolId* symbolIds, size_t size, const SymbolId* remap = nullptr)
+        : timestampsNs_(timestampsNs), prices_(prices), quantities_(quantities),
+          symbolIds_(symbolIds), remap_(remap), size_(size) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    int64_t timestampNs(size_t i) const { return timestampsNs_[i]; }
+    double price(size_t i) const { return prices_[i]; }
+    double quantity(size_t i) const { return quantities_[i]; }
+    SymbolId symbolId(size_t i) const { return remap_ ? remap_[symbolIds_[i]] : symbolIds_[i]; }
+
+    CompactTick operator[](size_t i) const {
+        return CompactTick{symbolId(i), prices_[i], quantities_[i], timestampsNs_[i]};
+    }
+
+    // Sub-range [begin, begin + count), clamped to the view
+    TickView slice(size_t begin, size_t count) const;
+
+    // Raw columns for batch kernels (ids are untranslated)
+    const int64_t* timestampsNs() const { return timestampsNs_; }
+    const double* prices() const { return prices_; }
+    const double* quantities() const { return quantities_; }
+
+private:
+    const int64_t* timestampsNs_ = nullptr;
+    const double* prices_ = nullptr;
+    const double* quantities_ = nullptr;
+    const SymbolId* symbolIds_ = nullptr;
+    const SymbolId* remap_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Owning struct-of-arrays tick container
+class TickColumns {
+public:
+    TickColumns() = default;
+
+    void reserve(size_t n);
+    void push(const CompactTick& tick);
+    void append(const TickView& view);
+    void clear();
+
+    size_t size() const { return prices_.size(); }
+    bool empty() const { return prices_.empty(); }
+
+    TickView view() const;
+
+    // Interns each tick's symbol and converts its millisecond timestamp
+    static TickColumns fromTicks(const std::vector<MarketTick>& ticks);
+
+private:
+    std::vector<int64_t> timestampsNs_;
+    std::vector<double> prices_;
+    std::vector<double> quantities_;
+    std::vector<SymbolId> symbolIds_;
+};
+
+// Binary tick tape. Native byte order (little-endian on every supported target);
+// all sections are 8-byte aligned so columns can be read in place from an mmap.
+//
+//   FileHeader   magic "ALPHTAPE", version, chunk capacity
+//   Chunk*       ChunkHeader (tick count, # of new symbols, time range)
+//                symbol definitions first seen in this chunk: {u32 id, u16 len, name}
+//                int64 timestampNs[n] | double price[n] | double quantity[n] | u32 symbolId[n]
+//
+// Symbol ids are the recording process's ids; names travel with the chunk that
+// first uses them, so every fully written chunk is self-describing and a tape
+// cut short by a crash stays readable up to its last complete chunk.
+class TapeWriter {
+public:
+    static constexpr size_t DEFAULT_CHUNK_TICKS = 65536;
+
+    // Throws std::runtime_error if the file cannot be created
+    explicit TapeWriter(const std::string& path, size_t chunkTicks = DEFAULT_CHUNK_TICKS);
+    ~TapeWriter();
+
+    TapeWriter(const TapeWriter&) = delete;
+    TapeWriter& operator=(const TapeWriter&) = delete;
+
+    void append(const CompactTick& tick);
+    void append(const TickView& view);
+
+    // Write out the pending partial chunk
+    void flush();
+    void close();
+
+    uint64_t ticksWritten() const { return ticksWritten_; }
+    uint64_t chunksWritten() const { return chunksWritten_; }
+
+private:
+    void noteSymbol(SymbolId id);
+    void writeChunk();
+    void writeBytes(const void* data, size_t bytes);
+
+    std::string path_;
+    std::FILE* file_;
+    size_t chunkTicks_;
+    TickColumns pending_;
+    std::vector<uint8_t> symbolWritten_;     // indexed by SymbolId
+    std::vector<SymbolId> newSymbols_;       // first seen in the pending chunk
+    uint64_t ticksWritten_;
+    uint64_t chunksWritten_;
+};
+
+// Memory-mapped tape. Opening only walks the chunk headers, re-interns the
+// symbol names and checks each chunk's symbol ids; tick columns are never
+// parsed or copied.
+class TapeReader {
+public:
+    // Throws std::runtime_error if the file is missing or not a tape
+    explicit TapeReader(const std::string& path);
+    ~TapeReader();
+
+    TapeReader(const TapeReader&) = delete;
+    TapeReader& operator=(const TapeReader&) = delete;
+
+    size_t numChunks() const { return chunks_.size(); }
+    TickView chunk(size_t i) const;
+
+    uint64_t size() const { return totalTicks_; }
+    bool truncated() const { return truncated_; }
+
+    int64_t firstTimestampNs() const;
+    int64_t lastTimestampNs() const;
+
+    // Copy the whole tape into one contiguous container
+    TickColumns load() const;
+
+private:
+    struct ChunkIndex {
+        const uint8_t* columns;
+        size_t count;
+        int64_t firstTimestampNs;
+        int64_t lastTimestampNs;
+    };
+
+    void indexChunks();
+
+    const uint8_t* data_;
+    size_t bytes_;
+    std::vector<ChunkIndex> chunks_;
+    std::vector<SymbolId> remap_;            // tape id -> registry id
+    uint64_t totalTicks_;
+    bool truncated_;
+};
+
+// Thread-safe live recorder. Feed callbacks append to an in-memory batch under a
+// short lock; a background thread swaps batches out and writes them, so disk I/O
+// never runs on a socket thread.
+class TapeRecorder {
+public:
+    explicit TapeRecorder(const std::string& path,
+                          size_t chunkTicks = TapeWriter::DEFAULT_CHUNK_TICKS);
+    ~TapeRecorder();
+
+    TapeRecorder(const TapeRecorder&) = delete;
+    TapeRecorder& operator=(const TapeRecorder&) = delete;
+
+    void start();
+    // Drains, flushes and closes the tape. Rethrows a write error that stopped
+    // the writer thread, after closing what was written before it.
+    void stop();
+
+    // Callable from any thread
+    void record(const CompactTick& tick);
+
+    uint64_t ticksRecorded() const { return recorded_.load(std::memory_order_relaxed); }
+    uint64_t ticksWritten() const { return written_.load(std::memory_order_relaxed); }
+    // A write failed; recording has stopped and stop() will throw
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    void writerLoop();
+
+    TapeWriter writer_;
+    size_t chunkTicks_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    TickColumns active_;
+    TickColumns draining_;
+    bool stopping_;
+
+    std::thread thread_;
+    std::atomic<uint64_t> recorded_;
+    std::atomic<uint64_t> written_;
+    std::atomic<bool> failed_;
+    std::exception_ptr error_;               // from the writer thread, under mutex_
+};
@@ -4,12 +4,19 @@
 #include <vector>
 #include <thread>
 #include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
 #include <ixwebsocket/IXWebSocket.h>
+#include "feeds/fast_json.h"
+#include "alpha/order_book.h"
+#include "util/market_types.h"
 
-struct MarketTick;
 class AlphaEngine;
 class CandleAggregator;
 
+// Binance trades, plus a per-symbol book refreshed from the top-20 partial
+// depth stream every 100ms. Top-of-book changes are emitted as quotes.
 class BinancePublicFeed {
 public:
 	BinancePublicFeed(
@@ -18,23 +25,66 @@ public:
 		CandleAggregator& aggregator
 	);
 
+	~BinancePublicFeed();
+
 	void start();
 	void stop();
 
 	// Set callback
-	void setTickCallback(std::function<void(const MarketTick&)> callback);
+	// Ticks are emitted with registry ids; subscribed symbols are interned up front
+	void setTickCallback(std::function<void(const CompactTick&)> callback);
+
+	// Top-of-book updates, one per depth message that moved the touch
+	void setQuoteCallback(std::function<void(const QuoteEvent&)> callback);
+
+	// Best `depth` levels of a symbol's book; false if it has none yet
+	bool getBook(SymbolId symbolId, size_t depth, OrderBookSnapshot& out) const;
+
+	fastjson::ParseStats getParseStats() const;
+	uint64_t quotesEmitted() const { return quoteCount_.load(std::memory_order_relaxed); }
+
+	// Raw socket messages before parsing (capture); set before start()
+	void setRawMessageHook(std::function<void(const std::string&)> hook);
+
+	// Runs a captured message through the live parsing path (replay)
+	void replayMessage(const std::string& message) { handleMessage(message); }
+
+	// Per-tick console lines, on by default
+	void setVerbose(bool verbose) { verbose_ = verbose; }
 
 private:
 	void connectWebSocket();
 	void handleMessage(const std::string& message);
+	void onTrade(const fastjson::TradeFields& trade);
+	bool handleDepth(std::string_view stream, std::string_view message);
 
 	std::vector<std::string> symbols_;
 	AlphaEngine& engine_;
 	CandleAggregator& aggregator_;
 
 	std::unique_ptr<ix::WebSocket> ws_;
-	std::function<void(const MarketTick&)> tickCallback_;
+	std::function<void(const CompactTick&)> tickCallback_;
+	std::function<void(const QuoteEvent&)> quoteCallback_;
+	std::function<void(const std::string&)> rawMessageHook_;
+	SymbolLookup symbolIds_;
+
+	// Reused for every tick so the symbol string keeps its capacity
+	MarketTick tick_;
+
+	// Lower-case stream name -> symbol, and books indexed by SymbolId; the
+	// mutex only guards against getBook readers
+	std::vector<std::pair<std::string, SymbolId>> depthStreams_;
+	std::vector<std::unique_ptr<OrderBook>> books_;
+	std::vector<OrderBookLevel> snapshotBids_;
+	std::vector<OrderBookLevel> snapshotAsks_;
+	mutable std::mutex bookMutex_;
+
+	std::atomic<uint64_t> fastPathCount_;
+	std::atomic<uint64_t> fallbackCount_;
+	std::atomic<uint64_t> errorCount_;
+	std::atomic<uint64_t> quoteCount_;
 
-	bool running_;
+	bool verbose_;
+	std::atomic<bool> running_;
 	std::thread wsThread_;
 };
@@ -1,26 +1,98 @@
 #pragma once
 #include "util/market_types.h"
+#include "util/ring_buffer.h"
+#include "util/snapshot.h"
 #include <functional>
 #include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
 
+struct CandleAggregatorConfig {
+	std::vector<int> intervalsSeconds = {60};   // ascending, each a multiple of the one before
+	size_t historyBars = 256;                   // closed bars kept per symbol and interval
+	size_t maxGapBars = 3600;                   // flat bars filled per gap before skipping ahead
+	std::chrono::milliseconds closeDelay{250};  // onTimer grace for exchange timestamps that lag
+};
+
+// Per-symbol OHLCV bars at several resolutions. A tick only touches the finest
+// bar; coarser bars are rolled up from finer ones as they close, so every
+// timeframe is kept in one pass. Bars are aligned to wall-clock boundaries
+// (epoch multiples of the interval) and closed bars go to a fixed-size ring per
+// symbol and interval.
+//
+// Bars close when a tick lands in a later interval, or from onTimer() so quiet
+// symbols still produce (flat, zero-volume) bars on time. Thread safe; the
+// callback runs with the aggregator locked and must not call back into it.
 class CandleAggregator {
 public:
 	using CandleCallback = std::function<void(const Candle&)>;
+	using TimePoint = std::chrono::system_clock::time_point;
 
+	// Single timeframe
 	explicit CandleAggregator(int intervalSeconds);
 
+	// Throws std::invalid_argument if the intervals cannot be rolled up
+	explicit CandleAggregator(const CandleAggregatorConfig& config);
+
 	// Called for every market tick
-	void onTick(double price,
+	void onTick(SymbolId symbolId,
+				double price,
 				double volume,
-				std::chrono::system_clock::time_point timestamp);
+				TimePoint timestamp);
+
+	// Closes every bar that ended before now - closeDelay
+	void onTimer(TimePoint now = std::chrono::system_clock::now());
 
-	// Register callback when a candle completes
+	// Register callback when a candle completes (any interval)
 	void setOnCandleClosed(CandleCallback cb);
 
+	// Closed bars of one symbol and interval, oldest first; false if none
+	bool getHistory(SymbolId symbolId, int intervalSeconds, std::vector<Candle>& out) const;
+
+	// The bar still being built; false if there is none
+	bool getCurrent(SymbolId symbolId, int intervalSeconds, Candle& out) const;
+
+	const std::vector<int>& intervals() const { return intervals_; }
+
+	// Open and closed bars of every symbol, keyed by symbol name. Loading
+	// replaces bars of the symbols in the snapshot and throws if the
+	// intervals or history size differ or the data is corrupt; nothing is
+	// replaced unless the whole snapshot loads.
+	void saveState(SnapshotWriter& out) const;
+	void loadState(SnapshotReader& in);
+
 private:
-	int intervalSeconds;
-	bool hasCandle;
-	std::chrono::system_clock::time_point candleStart;
-	Candle currentCandle;
+	struct Frame {
+		explicit Frame(int seconds, size_t history) : seconds(seconds), open(false), traded(false), closed(history) {}
+
+		int seconds;
+		bool open;          // current holds a bar
+		bool traded;        // current has seen a tick (else it is a flat fill)
+		Candle current;
+		RingBuffer<Candle> closed;
+	};
+
+	struct SymbolBars {
+		std::vector<Frame> frames;      // finest first
+	};
+
+	std::unique_ptr<SymbolBars> makeBars() const;
+	SymbolBars& barsFor(SymbolId symbolId);
+	const Frame* findFrame(SymbolId symbolId, int intervalSeconds) const;
+	TimePoint align(TimePoint t, int seconds) const;
+
+	void startBar(Frame& frame, SymbolId symbolId, TimePoint start, double price, double volume, bool traded);
+	void advance(SymbolBars& bars, SymbolId symbolId, TimePoint target);
+	void closeBar(SymbolBars& bars, size_t level);
+	void rollUp(SymbolBars& bars, size_t level, const Candle& bar, bool traded);
+
+	std::vector<int> intervals_;
+	size_t historyBars_;
+	size_t maxGapBars_;
+	std::chrono::milliseconds closeDelay_;
+
+	mutable std::mutex mutex_;
+	std::vector<std::unique_ptr<SymbolBars>> symbols_;     // indexed by SymbolId
 	CandleCallback onCandleClosed;
 };
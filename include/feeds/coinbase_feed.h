@@ -5,12 +5,19 @@
 #include <thread>
 #include <functional>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include <ixwebsocket/IXWebSocket.h>
+#include "feeds/fast_json.h"
+#include "alpha/order_book.h"
+#include "util/market_types.h"
 
-struct MarketTick;
 class AlphaEngine;
 class CandleAggregator;
 
+// Coinbase trades (matches), plus a per-product L2 book maintained from the
+// level2_batch snapshot and l2update diffs. Top-of-book changes are emitted as
+// quotes; tickers only stand in for the book until its snapshot arrives.
 class CoinbaseAdvancedFeed {
 public:
 	CoinbaseAdvancedFeed(
@@ -19,14 +26,40 @@ public:
 		CandleAggregator& aggregator
 	);
 
+	~CoinbaseAdvancedFeed();
+
 	void start();
 	void stop();
 
-	void setTickCallback(std::function<void(const MarketTick&)> callback);
+	// Ticks are emitted with registry ids; subscribed symbols are interned up front
+	void setTickCallback(std::function<void(const CompactTick&)> callback);
+
+	// Top-of-book updates, one per book message that moved the touch
+	void setQuoteCallback(std::function<void(const QuoteEvent&)> callback);
+
+	// Best `depth` levels of a product's book; false if it has none yet
+	bool getBook(SymbolId symbolId, size_t depth, OrderBookSnapshot& out) const;
+
+	fastjson::ParseStats getParseStats() const;
+	uint64_t quotesEmitted() const { return quoteCount_.load(std::memory_order_relaxed); }
+
+	// Raw socket messages before parsing (capture); set before start()
+	void setRawMessageHook(std::function<void(const std::string&)> hook);
+
+	// Runs a captured message through the live parsing path (replay)
+	void replayMessage(const std::string& message) { handleMessage(message); }
+
+	// Per-tick console lines, on by default
+	void setVerbose(bool verbose) { verbose_ = verbose; }
 
 private:
 	void connectWebSocket();
 	void handleMessage(const std::string& message);
+	bool handleBookMessage(std::string_view type, std::string_view message);
+	void onTrade(const fastjson::TradeFields& trade);
+	void onTicker(const fastjson::QuoteFields& ticker);
+	void emitQuote(SymbolId symbolId, const TopOfBook& top, int64_t timestampMs);
+	OrderBook& bookFor(SymbolId symbolId);
 	void subscribe();
 
 	std::vector<std::string> productIds_;
@@ -34,8 +67,26 @@ private:
 	CandleAggregator& aggregator_;
 
 	std::unique_ptr<ix::WebSocket> ws_;
-	std::function<void(const MarketTick&)> tickCallback_;
+	std::function<void(const CompactTick&)> tickCallback_;
+	std::function<void(const QuoteEvent&)> quoteCallback_;
+	std::function<void(const std::string&)> rawMessageHook_;
+	SymbolLookup symbolIds_;
+
+	// Reused for every tick so the symbol string keeps its capacity
+	MarketTick tick_;
+
+	// Books indexed by SymbolId; the mutex only guards against getBook readers
+	std::vector<std::unique_ptr<OrderBook>> books_;
+	std::vector<OrderBookLevel> snapshotBids_;
+	std::vector<OrderBookLevel> snapshotAsks_;
+	mutable std::mutex bookMutex_;
+
+	std::atomic<uint64_t> fastPathCount_;
+	std::atomic<uint64_t> fallbackCount_;
+	std::atomic<uint64_t> errorCount_;
+	std::atomic<uint64_t> quoteCount_;
 
-	bool running_;
+	bool verbose_;
+	std::atomic<bool> running_;
 	std::thread wsThread_;
 };
@@ -0,0 +1,79 @@
+#pragma once
+#include <string_view>
+#include <cstdint>
+
+// Schema-specific scanner for the exchange trade messages we consume on the hot
+// path. Fields are located directly in the message buffer and numbers parsed with
+// std::from_chars: no DOM, no heap allocation. Anything the scanner does not
+// recognise (other message types, escaped strings, missing fields) is reported as
+// a miss so the caller can fall back to nlohmann::json.
+namespace fastjson {
+
+// Trade fields common to every feed; symbol points into the message buffer
+struct TradeFields {
+	std::string_view symbol;
+	double price = 0.0;
+	double quantity = 0.0;
+	int64_t timestampMs = 0;   // 0 when the message carries no usable time
+};
+
+// Top-of-book fields; symbol points into the message buffer
+struct QuoteFields {
+	std::string_view symbol;
+	double bidPrice = 0.0;
+	double bidSize = 0.0;
+	double askPrice = 0.0;
+	double askSize = 0.0;
+	int64_t timestampMs = 0;
+};
+
+// Per-feed parsing counters
+struct ParseStats {
+	uint64_t fastPath;    // messages decoded by the scanner
+	uint64_t fallback;    // messages handed to nlohmann::json
+	uint64_t errors;      // messages neither path could decode
+};
+
+// Raw value of "key" as a view: string contents without quotes, or the literal
+// text of a number/bool. Only keys at object-member position match, at any depth.
+// Returns false if the key is absent or the string value contains escapes.
+bool findValue(std::string_view json, std::string_view key, std::string_view& out);
+
+// Raw text of the array value of "key", brackets included
+bool findArray(std::string_view json, std::string_view key, std::string_view& out);
+
+// Next flat tuple of an array of arrays such as [["1.5","2"],["1.4","3"]]:
+// the first `count` fields, unquoted. Start with pos = 0; pos is left just
+// past the tuple. Returns false when no complete tuple remains.
+bool nextTuple(std::string_view array, size_t& pos, std::string_view* fields, size_t count);
+
+// Number parsing, accepting both bare and quoted numbers ("p":"0.001")
+bool parseDouble(std::string_view text, double& out);
+bool parseInt(std::string_view text, int64_t& out);
+
+bool findDouble(std::string_view json, std::string_view key, double& out);
+bool findInt(std::string_view json, std::string_view key, int64_t& out);
+
+// Next object in a JSON array such as [{...},{...}], scanning from pos and
+// leaving pos just past it. Returns false when no complete object remains.
+bool nextObject(std::string_view json, size_t& pos, std::string_view& out);
+
+// "2024-03-01T12:34:56.789123Z" (or with a +hh:mm offset) -> ms since epoch
+bool parseIso8601Ms(std::string_view text, int64_t& outMs);
+
+// Binance combined-stream trade: {"stream":..,"data":{"e":"trade","s":..,"p":..,"q":..,"T":..}}
+bool parseBinanceTrade(std::string_view json, TradeFields& out);
+
+// Coinbase "match"/"last_match" message; type receives the message type
+bool parseCoinbaseTrade(std::string_view json, std::string_view& type, TradeFields& out);
+
+// Coinbase "ticker" message as a top-of-book quote
+bool parseCoinbaseTicker(std::string_view json, QuoteFields& out);
+
+// Polygon trade event, one element of a batch: {"ev":"T","sym":..,"p":..,"s":..,"t":..}
+bool parsePolygonTrade(std::string_view json, TradeFields& out);
+
+// Polygon quote event: {"ev":"Q","sym":..,"bp":..,"bs":..,"ap":..,"as":..,"t":..}
+bool parsePolygonQuote(std::string_view json, QuoteFields& out);
+
+}
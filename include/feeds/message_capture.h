@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+// Venue a raw message came from
+enum class FeedSource : uint8_t {
+	BINANCE,
+	COINBASE,
+	POLYGON
+};
+
+const char* feedSourceToString(FeedSource source);
+
+// Capture file of raw feed messages, exactly as the socket delivered them.
+//
+//   FileHeader   magic "ALPHCAPT", version
+//   Record*      int64 arrivalNs | u32 length | u8 source | 3 pad | payload[length]
+//
+// Arrival times are wall-clock ns at receipt. Records are appended as they
+// arrive, so a capture cut short by a crash stays readable up to its last
+// complete record.
+class CaptureWriter {
+public:
+	// Throws std::runtime_error if the file cannot be created
+	explicit CaptureWriter(const std::string& path);
+	~CaptureWriter();
+
+	CaptureWriter(const CaptureWriter&) = delete;
+	CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+	// Thread safe: feeds call this from their socket threads
+	void write(FeedSource source, const std::string& message);
+	void write(FeedSource source, int64_t arrivalNs, std::string_view message);
+
+	void flush();
+	void close();
+
+	uint64_t messagesWritten() const;
+
+private:
+	mutable std::mutex mutex_;
+	std::FILE* file_;
+	uint64_t messagesWritten_;
+};
+
+struct CapturedMessage {
+	int64_t arrivalNs;
+	FeedSource source;
+	std::string_view payload;   // points into the mapped file
+};
+
+// Memory-mapped capture; messages are indexed once and read in place
+class CaptureReader {
+public:
+	// Throws std::runtime_error if the file is missing or not a capture
+	explicit CaptureReader(const std::string& path);
+	~CaptureReader();
+
+	CaptureReader(const CaptureReader&) = delete;
+	CaptureReader& operator=(const CaptureReader&) = delete;
+
+	size_t size() const { return messages_.size(); }
+	const CapturedMessage& operator[](size_t i) const { return messages_[i]; }
+
+	bool truncated() const { return truncated_; }
+	uint64_t payloadBytes() const { return payloadBytes_; }
+
+private:
+	const uint8_t* data_;
+	size_t bytes_;
+	std::vector<CapturedMessage> messages_;
+	uint64_t payloadBytes_;
+	bool truncated_;
+};
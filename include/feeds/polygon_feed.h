@@ -3,36 +3,96 @@
 #include <string>
 #include <vector>
 #include <thread>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <curl/curl.h>
+#include "util/market_types.h"
+#include "util/token_bucket.h"
 
 class AlphaEngine;
 class CandleAggregator;
-struct MarketTick;
 
+struct PolygonFeedConfig {
+	size_t maxConcurrent = 8;           // requests in flight, and pooled keep-alive connections
+	double requestsPerSecond = 0.5;     // token bucket refill rate (plan limit)
+	double burst = 5.0;                 // token bucket capacity
+	int pollIntervalSeconds = 30;       // per symbol, between successful fetches
+	int lookbackDays = 30;              // window of the first fetch for a symbol
+	int multiplier = 1;                 // aggregate bar size: multiplier x timespan
+	std::string timespan = "day";
+	long timeoutSeconds = 10;
+};
+
+// Polls Polygon aggregate bars over REST with curl multi: up to maxConcurrent
+// requests in flight on reused connections, admitted by a token bucket. Each
+// symbol keeps a cursor at its newest bar, so later polls only download bars
+// from there on. The process must have called curl_global_init.
 class PolygonFeed {
 public:
 	PolygonFeed(const std::vector<std::string>& symbols,
 				const std::string& apiKey,
 				AlphaEngine& engine,
-				CandleAggregator& aggregator);
+				CandleAggregator& aggregator,
+				const PolygonFeedConfig& config = PolygonFeedConfig());
+	~PolygonFeed();
+
+	PolygonFeed(const PolygonFeed&) = delete;
+	PolygonFeed& operator=(const PolygonFeed&) = delete;
 
+	// Starts the poll thread and returns
 	void start();
 
 	void stop();
 
-	void setTickCallback(std::function<void(const MarketTick&)> callback);
+	void setTickCallback(std::function<void(const CompactTick&)> callback);
+
+	uint64_t requestsCompleted() const { return requestsCompleted_.load(std::memory_order_relaxed); }
+	uint64_t requestsFailed() const { return requestsFailed_.load(std::memory_order_relaxed); }
 
 private:
+	using Clock = std::chrono::steady_clock;
+
+	struct SymbolState {
+		std::string symbol;
+		SymbolId symbolId;
+		long long cursorMs;         // start of the newest bar seen; 0 = never fetched
+		double cursorVolume;        // its volume so far (all of it passed on already)
+		Clock::time_point nextDue;
+		int failures;
+		bool inFlight;
+	};
+
+	struct Request {
+		CURL* easy;
+		size_t symbol;              // index into symbols_
+		std::string url;
+		std::string response;
+		bool busy;
+	};
+
 	void pollLoop();
-	void fetchSymbol(const std::string& symbol);
+	void startDueRequests(Clock::time_point now);
+	void startRequest(Request& request, size_t symbol);
+	void finishRequest(Request& request, CURLcode result);
+	void handleResponse(SymbolState& state, const std::string& body);
 
-	std::vector<std::string> symbols_;
+	std::vector<SymbolState> symbols_;
 	std::string apiKey_;
 	AlphaEngine& engine_;
 	CandleAggregator& aggregator_;
-	bool running_;
+	PolygonFeedConfig config_;
+
+	CURLM* multi_;
+	std::vector<Request> requests_;
+	TokenBucket bucket_;
+	size_t nextSymbol_;                 // round-robin start for scheduling
+
+	std::atomic<bool> running_;
+	std::atomic<uint64_t> requestsCompleted_;
+	std::atomic<uint64_t> requestsFailed_;
 
 	std::thread pollThread_;
 
-	std::function<void(const MarketTick&)> tickCallback_;
-};
\ No newline at end of file
+	std::function<void(const CompactTick&)> tickCallback_;
+};
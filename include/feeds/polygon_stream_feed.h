@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <ixwebsocket/IXWebSocket.h>
+#include "feeds/fast_json.h"
+#include "util/market_types.h"
+
+class AlphaEngine;
+class CandleAggregator;
+
+// Polygon real-time stocks WebSocket: trades (T.*) and quotes (Q.*) for each
+// symbol, pushed as they print instead of polled as bars. Polygon batches
+// several events into one JSON array per message; each event is scanned in
+// place, and parse stats count events rather than messages.
+class PolygonStreamFeed {
+public:
+	PolygonStreamFeed(
+		const std::vector<std::string>& symbols,
+		const std::string& apiKey,
+		AlphaEngine& engine,
+		CandleAggregator& aggregator,
+		const std::string& url = "wss://socket.polygon.io/stocks"
+	);
+	~PolygonStreamFeed();
+
+	void start();
+	void stop();
+
+	// Ticks are emitted with registry ids; subscribed symbols are interned up front
+	void setTickCallback(std::function<void(const CompactTick&)> callback);
+
+	// Top-of-book updates from the quote channel
+	void setQuoteCallback(std::function<void(const QuoteEvent&)> callback);
+
+	fastjson::ParseStats getParseStats() const;
+	uint64_t quotesReceived() const { return quoteCount_.load(std::memory_order_relaxed); }
+
+	// Raw socket messages before parsing (capture); set before start()
+	void setRawMessageHook(std::function<void(const std::string&)> hook);
+
+	// Runs a captured message through the live parsing path (replay)
+	void replayMessage(const std::string& message) { handleMessage(message); }
+
+	// Per-tick console lines, on by default
+	void setVerbose(bool verbose) { verbose_ = verbose; }
+
+private:
+	void connectWebSocket();
+	void handleMessage(const std::string& message);
+	void handleEvent(std::string_view event);
+	void onTrade(const fastjson::TradeFields& trade);
+	void onQuote(const fastjson::QuoteFields& quote);
+	void authenticate();
+	void subscribe();
+
+	std::vector<std::string> symbols_;
+	std::string apiKey_;
+	std::string url_;
+	AlphaEngine& engine_;
+	CandleAggregator& aggregator_;
+
+	std::unique_ptr<ix::WebSocket> ws_;
+	std::function<void(const CompactTick&)> tickCallback_;
+	std::function<void(const QuoteEvent&)> quoteCallback_;
+	std::function<void(const std::string&)> rawMessageHook_;
+	SymbolLookup symbolIds_;
+
+	// Reused for every tick so the symbol string keeps its capacity
+	MarketTick tick_;
+
+	std::atomic<uint64_t> fastPathCount_;
+	std::atomic<uint64_t> fallbackCount_;
+	std::atomic<uint64_t> errorCount_;
+	std::atomic<uint64_t> quoteCount_;
+
+	bool verbose_;
+	std::atomic<bool> running_;
+	std::thread wsThread_;
+};
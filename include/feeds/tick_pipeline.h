@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include "util/market_types.h"
+#include "util/spsc_queue.h"
+
+struct TickPipelineConfig {
+	size_t numShards = 2;           // worker threads; each owns the symbols with id % numShards == shard
+	size_t queueCapacity = 8192;    // per (producer, shard) ring
+	bool pinThreads = true;         // pin worker i to CPU (firstCpu + i) where supported
+	int firstCpu = 0;
+};
+
+struct ShardStats {
+	size_t shard;
+	size_t queueDepth;          // ticks waiting across this shard's rings
+	uint64_t ticksProcessed;    // trades and quotes
+	uint64_t ticksDropped;      // rejected because a ring was full
+	double lastLagUs;           // enqueue -> handler start
+	double avgLagUs;
+	double maxLagUs;
+};
+
+// Moves ticks off the feed threads. Each producer (one per feed thread) gets its
+// own SPSC ring per shard, and each shard is drained by a single worker thread,
+// so a symbol is always processed on the same thread regardless of which feed
+// delivered it and the handler never runs on a socket thread. Quotes share the
+// trade rings, so a symbol's trades and quotes are handled in arrival order.
+class TickPipeline {
+public:
+	using Handler = std::function<void(const CompactTick&)>;
+	using QuoteHandler = std::function<void(const QuoteEvent&)>;
+
+	TickPipeline(size_t numProducers, Handler handler,
+				 const TickPipelineConfig& config = TickPipelineConfig());
+	~TickPipeline();
+
+	TickPipeline(const TickPipeline&) = delete;
+	TickPipeline& operator=(const TickPipeline&) = delete;
+
+	// Set before start(); quotes pushed without one are discarded
+	void setQuoteHandler(QuoteHandler handler) { quoteHandler_ = std::move(handler); }
+
+	void start();
+	void stop();
+
+	// Call only from the thread that owns this producer index; false if dropped
+	bool push(size_t producer, const CompactTick& tick);
+	bool pushQuote(size_t producer, const QuoteEvent& quote);
+
+	size_t numShards() const { return shards_.size(); }
+	size_t shardOf(SymbolId id) const { return id % shards_.size(); }
+
+	std::vector<ShardStats> getStats() const;
+
+private:
+	struct QueuedTick {
+		union {
+			CompactTick tick;
+			QuoteEvent quote;
+		};
+		bool isQuote;
+		int64_t enqueueNs;    // steady clock
+	};
+
+	struct Shard {
+		explicit Shard(size_t numProducers, size_t capacity);
+
+		std::vector<std::unique_ptr<SPSCQueue<QueuedTick>>> queues;   // one per producer
+		std::thread worker;
+
+		std::atomic<uint64_t> processed{0};
+		std::atomic<uint64_t> dropped{0};
+		std::atomic<uint64_t> lastLagNs{0};
+		std::atomic<uint64_t> totalLagNs{0};
+		std::atomic<uint64_t> maxLagNs{0};
+	};
+
+	bool enqueue(size_t producer, SymbolId symbolId, const QueuedTick& item);
+	void workerLoop(size_t shardIndex);
+
+	size_t numProducers_;
+	Handler handler_;
+	QuoteHandler quoteHandler_;
+	TickPipelineConfig config_;
+	std::vector<std::unique_ptr<Shard>> shards_;
+	std::atomic<bool> running_;
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include "alpha/signal_sink.h"
+
+class InfluxWriter;
+
+// Forwards alpha signals to an InfluxWriter; plugged in by the live run modes
+class InfluxSignalSink : public SignalSink {
+public:
+	explicit InfluxSignalSink(InfluxWriter& writer);
+
+	void onAlphaSignal(const AlphaSignal& signal) override;
+
+private:
+	InfluxWriter& writer_;
+};
@@ -1,16 +1,59 @@
 #pragma once
+#include "util/mpsc_queue.h"
 #include <string>
-#include <queue>
+#include <string_view>
 #include <mutex>
+#include <condition_variable>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// What writeAsync does when the queue is full
+enum class OverflowPolicy {
+	DROP_OLDEST,   // discard the oldest queued line to make room (default)
+	DROP_NEWEST,   // discard the line being written
+	BLOCK          // wait for the writer thread to free a slot
+};
+
+// Batching / transport settings for the background writer
+struct InfluxWriterConfig {
+	size_t queueCapacity = 32768;                  // preallocated line slots (rounded up to a power of two)
+	size_t lineReserve = 192;                      // bytes reserved per slot
+	OverflowPolicy overflowPolicy = OverflowPolicy::DROP_OLDEST;
+
+	size_t maxBatchPoints = 5000;                  // flush once this many lines are buffered
+	size_t maxBatchBytes = 512 * 1024;             // ... or the uncompressed body reaches this size
+	std::chrono::milliseconds maxBatchAge{1000};   // ... or the oldest buffered line is this old
+	bool gzip = true;                              // send Content-Encoding: gzip bodies
+	long requestTimeoutMs = 5000;
+};
+
+struct InfluxWriterStats {
+	uint64_t pointsWritten;       // lines accepted by InfluxDB
+	uint64_t pointsFailed;        // lines in batches that failed to send
+	uint64_t batchesSent;
+	uint64_t batchesFailed;
+	uint64_t bytesSent;           // request body bytes on the wire (after gzip)
+	uint64_t bytesUncompressed;   // line-protocol bytes before compression
+	double lastBatchLatencyMs;
+	double avgBatchLatencyMs;
+	double maxBatchLatencyMs;
+
+	uint64_t droppedOldest;       // queued lines evicted by DROP_OLDEST
+	uint64_t droppedNewest;       // incoming lines rejected by DROP_NEWEST
+	uint64_t blockedWrites;       // writeAsync calls that had to wait under BLOCK
+	size_t queueDepth;
+	size_t queueCapacity;
+};
 
 class InfluxWriter {
 public:
 	InfluxWriter(const std::string& org,
 				 const std::string& bucket,
 				 const std::string& token,
-				 const std::string& url = "http://localhost:8086");
+				 const std::string& url = "http://localhost:8086",
+				 const InfluxWriterConfig& config = InfluxWriterConfig());
 
 	~InfluxWriter();
 
@@ -19,7 +62,7 @@ public:
 						 double meanRevZ,
 						 double rsi,
 						 double vbr,
-						 const std::string& signalType) const;
+						 std::string_view signalType) const;
 
 	void writeMicrostructureSignal(const std::string& symbol,
 								   double vpin,
@@ -36,7 +79,7 @@ public:
 							 long timestamp) const;
 
 	void writeRegimeSignal(const std::string& symbol,
-						  const std::string& regime,
+						  std::string_view regime,
 						  double hurstExponent,
 						  double volatility,
 						  double trendStrength,
@@ -60,21 +103,51 @@ public:
 						double volume,
 						long timestamp) const;
 
-	void writeAsync(const std::string& lineProtocol);
+	// Queue one encoded line-protocol point (copied into a preallocated slot)
+	void writeAsync(std::string_view lineProtocol);
 
+	// Block until everything queued so far has been sent
 	void flush();
 
+	InfluxWriterStats getStats() const;
+
 private:
 	std::string org_;
 	std::string bucket_;
 	std::string token_;
 	std::string url_;
+	InfluxWriterConfig config_;
 
-	mutable std::queue<std::string> writeQueue_;
-	mutable std::mutex queueMutex_;
+	MPSCQueue<std::string> queue_;
 	std::thread writerThread_;
 	std::atomic<bool> running_;
+	std::atomic<bool> flushRequested_;
+
+	// flush() bookkeeping: every enqueued line is eventually retired (sent, failed or evicted)
+	std::atomic<uint64_t> enqueued_;
+	std::atomic<uint64_t> retired_;
+	std::mutex flushMutex_;
+	std::condition_variable flushCv_;
+
+	std::atomic<uint64_t> droppedOldest_;
+	std::atomic<uint64_t> droppedNewest_;
+	std::atomic<uint64_t> blockedWrites_;
+
+	// Transport counters (written by the writer thread only)
+	std::atomic<uint64_t> pointsWritten_;
+	std::atomic<uint64_t> pointsFailed_;
+	std::atomic<uint64_t> batchesSent_;
+	std::atomic<uint64_t> batchesFailed_;
+	std::atomic<uint64_t> bytesSent_;
+	std::atomic<uint64_t> bytesUncompressed_;
+	std::atomic<uint64_t> lastBatchLatencyUs_;
+	std::atomic<uint64_t> totalBatchLatencyUs_;
+	std::atomic<uint64_t> maxBatchLatencyUs_;
+
+	// Persistent libcurl session owned by the writer thread
+	struct Transport;
 
 	void writerLoop();
-	void writeToInflux(const std::string& data) const;
-};
\ No newline at end of file
+	bool sendBatch(Transport& transport, const std::string& body, size_t numPoints);
+	void retire(uint64_t numPoints);
+};
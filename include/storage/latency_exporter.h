@@ -0,0 +1,57 @@
+#pragma once
+#include "util/latency_metrics.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class InfluxWriter;
+
+// Latency of one stage over one export interval
+struct LatencyStageStats {
+	LatencyStage stage;
+	uint64_t count;
+	double meanNs;
+	uint64_t p50Ns;
+	uint64_t p99Ns;
+	uint64_t p999Ns;
+	uint64_t maxNs;
+};
+
+// Periodically turns the per-thread stage histograms into one "latency" point
+// per stage (tag stage=<name>; fields count, mean_ns, p50_ns, p99_ns, p999_ns,
+// max_ns). Each point covers only the samples since the previous export.
+class LatencyExporter {
+public:
+	explicit LatencyExporter(InfluxWriter& writer,
+							 std::chrono::milliseconds interval = std::chrono::seconds(10));
+	~LatencyExporter();
+
+	void start();
+	void stop();
+
+	// Stats since the previous call, stages with no samples skipped; the export
+	// thread calls this, so use it directly only while the thread is stopped
+	std::vector<LatencyStageStats> collect();
+
+private:
+	void exportLoop();
+	void write(const std::vector<LatencyStageStats>& stats);
+
+	InfluxWriter& writer_;
+	std::chrono::milliseconds interval_;
+
+	// Totals at the previous export, per stage (heap: each is ~30 KB)
+	std::vector<LatencyHistogram> previous_;
+	std::unique_ptr<LatencyHistogram> current_;
+	std::unique_ptr<LatencyHistogram> delta_;
+
+	std::atomic<bool> running_;
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::thread thread_;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+
+// Encodes one InfluxDB line-protocol point at a time into a reusable buffer.
+// Numbers go through std::to_chars (shortest round-trip, locale independent) and
+// the buffer keeps its capacity between points, so steady-state encoding does
+// not allocate.
+//
+//   builder.series(prefix).tag("regime", r).field("hurst", h).timestampMs(ts);
+class LineProtocolBuilder {
+public:
+    explicit LineProtocolBuilder(size_t reserve = 256);
+
+    // Start a new point
+    LineProtocolBuilder& measurement(std::string_view name);
+
+    // Start a new point from an already escaped "measurement,tag=value" key
+    LineProtocolBuilder& series(std::string_view seriesKey);
+
+    LineProtocolBuilder& tag(std::string_view key, std::string_view value);
+
+    // Non-finite doubles are skipped (line protocol has no NaN/Inf)
+    LineProtocolBuilder& field(std::string_view key, double value);
+    LineProtocolBuilder& intField(std::string_view key, int64_t value);
+    LineProtocolBuilder& boolField(std::string_view key, bool value);
+    LineProtocolBuilder& stringField(std::string_view key, std::string_view value);
+
+    LineProtocolBuilder& timestampNs(int64_t ns);
+    LineProtocolBuilder& timestampMs(int64_t ms) { return timestampNs(ms * 1000000LL); }
+
+    // A point needs at least one field to be valid
+    bool complete() const { return numFields_ > 0; }
+    std::string_view line() const { return buf_; }
+    void clear();
+
+    // Escaping rules, also used to precompute series keys
+    static void appendMeasurement(std::string& out, std::string_view name);
+    static void appendTagOrKey(std::string& out, std::string_view text);
+    static void appendStringValue(std::string& out, std::string_view text);
+
+private:
+    std::string buf_;
+    size_t numFields_;
+    bool hasTimestamp_;
+
+    void beginField(std::string_view key);
+};
+
+// Per-measurement cache of escaped "measurement,symbol=<symbol>" prefixes so the
+// tag set for a symbol is escaped once rather than on every point. Not thread safe;
+// keep one per writer thread.
+class SeriesKeyCache {
+public:
+    explicit SeriesKeyCache(std::string_view measurement);
+
+    const std::string& operator()(const std::string& symbol);
+
+private:
+    std::string measurement_;
+    std::unordered_map<std::string, std::string> keys_;
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// Log-linear latency histogram (HDR style): exact below 128 ns, then 64
+// sub-buckets per power of two, so any recorded value is off by at most
+// ~1.6%. Fixed size, no allocation; record() is a few instructions. Not
+// thread safe: keep one per thread and merge() for reporting.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 7;
+    static constexpr uint64_t LINEAR = 1ULL << SUB_BITS;     // exact range
+    static constexpr uint64_t HALF = LINEAR / 2;             // sub-buckets per octave
+    static constexpr size_t NUM_BUCKETS = (64 - SUB_BITS) * HALF + LINEAR;
+
+    LatencyHistogram() { reset(); }
+
+    void record(uint64_t ns) {
+        ++buckets_[bucketOf(ns)];
+        ++count_;
+        sum_ += ns;
+        min_ = std::min(min_, ns);
+        max_ = std::max(max_, ns);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) buckets_[i] += other.buckets_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    // Adds n samples to bucket i; used to rebuild a histogram from raw bucket
+    // counts, so sum/min/max are taken from the bucket bounds rather than exact
+    void addBucket(size_t i, uint64_t n) {
+        if (n == 0) return;
+        const uint64_t lo = lowerBound(i);
+        const uint64_t hi = lowerBound(i + 1) - 1;
+        buckets_[i] += n;
+        count_ += n;
+        sum_ += n * (lo + (hi - lo) / 2);
+        min_ = std::min(min_, lo);
+        max_ = std::max(max_, hi);
+    }
+
+    uint64_t bucket(size_t i) const { return buckets_[i]; }
+
+    void reset() {
+        buckets_.fill(0);
+        count_ = 0;
+        sum_ = 0;
+        min_ = UINT64_MAX;
+        max_ = 0;
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    // Value at quantile q in [0, 1] (bucket midpoint, clamped to the observed range)
+    uint64_t percentile(double q) const {
+        if (count_ == 0) return 0;
+
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * count_ + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) {
+                const uint64_t mid = lowerBound(i) + (lowerBound(i + 1) - lowerBound(i)) / 2;
+                return std::min(std::max(mid, min_), max_);
+            }
+        }
+        return max_;
+    }
+
+    // Bucket a value is counted in
+    static size_t bucketOf(uint64_t v) {
+        if (v < LINEAR) return static_cast<size_t>(v);
+        const int msb = 63 - __builtin_clzll(v);
+        const int shift = msb - SUB_BITS + 1;
+        return static_cast<size_t>(shift) * HALF + static_cast<size_t>(v >> shift);
+    }
+
+    // Smallest value that lands in bucket i
+    static uint64_t lowerBound(size_t i) {
+        if (i < LINEAR) return i;
+        const size_t shift = i / HALF - 1;
+        if (shift >= 64 - SUB_BITS + 1) return UINT64_MAX;
+        return (static_cast<uint64_t>(i % HALF) + HALF) << shift;
+    }
+
+private:
+    std::array<uint64_t, NUM_BUCKETS> buckets_;
+    uint64_t count_;
+    uint64_t sum_;
+    uint64_t min_;
+    uint64_t max_;
+};
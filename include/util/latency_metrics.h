@@ -0,0 +1,151 @@
+#pragma once
+#include "util/latency_histogram.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Hot-path stages with their own latency histogram
+enum class LatencyStage : uint8_t {
+    PARSE,                  // socket message to parsed trade / quote fields
+    DISPATCH,               // parsed trade to candles, engine and tick callback
+    ALPHA_SYSTEM,           // ProductionAlphaSystem per tick, stages plus Influx writes
+    ALPHA_MOMENTUM,
+    ALPHA_MICROSTRUCTURE,
+    ALPHA_ORDER_FLOW,
+    ALPHA_REGIME,
+    ALPHA_VWAP,
+    ALPHA_BOLLINGER,
+    INFLUX_ENCODE,          // line-protocol encode and enqueue
+    INFLUX_SEND,            // gzip and HTTP round trip per batch
+    COUNT
+};
+
+constexpr size_t NUM_LATENCY_STAGES = static_cast<size_t>(LatencyStage::COUNT);
+
+const char* latencyStageName(LatencyStage stage);
+
+// Raw timestamp source for the scoped timers: the TSC on x86 (assumed
+// invariant, as on any recent CPU), the virtual counter on arm64, otherwise
+// steady_clock. Only differences are meaningful; ticksToNs converts them.
+namespace latency_clock {
+
+inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Nanoseconds per tick; on x86 this spins for 20 ms against steady_clock
+double nsPerTick();
+
+// Measures nsPerTick once and publishes it to ticksToNs. Call at startup,
+// before any timed thread runs, so the measurement never stalls the tick
+// path; later calls return at once. Until then ticksToNs uses 1 ns per tick.
+void calibrate();
+
+namespace detail {
+extern std::atomic<double> nsPerTickScale;
+}
+
+inline uint64_t ticksToNs(uint64_t ticks) {
+    return static_cast<uint64_t>(static_cast<double>(ticks) *
+                                 detail::nsPerTickScale.load(std::memory_order_relaxed));
+}
+
+}
+
+// One thread's histograms, one per stage. Only the owning thread writes, so a
+// sample is a relaxed load and store of one bucket (no locked instruction);
+// readers on other threads see every counter monotonically increasing.
+class ThreadLatency {
+public:
+    ThreadLatency();
+
+    void record(LatencyStage stage, uint64_t ns) {
+        auto& counter = stages_[static_cast<size_t>(stage)][LatencyHistogram::bucketOf(ns)];
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Adds this thread's counts for stage into out
+    void addTo(LatencyStage stage, LatencyHistogram& out) const;
+
+private:
+    using Buckets = std::array<std::atomic<uint64_t>, LatencyHistogram::NUM_BUCKETS>;
+
+    std::array<Buckets, NUM_LATENCY_STAGES> stages_;
+};
+
+// Process-wide registry of per-thread histograms. A thread registers on its
+// first sample; its histograms live until exit, so totals only ever grow and
+// an exporter reports the difference between two snapshots.
+class LatencyMetrics {
+public:
+    static LatencyMetrics& instance() {
+        static LatencyMetrics metrics;
+        return metrics;
+    }
+
+    LatencyMetrics(const LatencyMetrics&) = delete;
+    LatencyMetrics& operator=(const LatencyMetrics&) = delete;
+
+    // The calling thread's histograms
+    static ThreadLatency& local() {
+        thread_local ThreadLatency* histograms = instance().registerThread();
+        return *histograms;
+    }
+
+    static void record(LatencyStage stage, uint64_t ns) { local().record(stage, ns); }
+
+    // Totals for stage across every thread since startup
+    void snapshot(LatencyStage stage, LatencyHistogram& out) const;
+
+    size_t threads() const;
+
+private:
+    LatencyMetrics() = default;
+
+    ThreadLatency* registerThread();
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadLatency>> threads_;
+};
+
+// Times a scope (or up to stop()) into a stage histogram
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyStage stage)
+        : stage_(stage), start_(latency_clock::now()), armed_(true) {}
+
+    ~ScopedLatency() { stop(); }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    // Records now instead of at scope exit; later calls do nothing
+    void stop() {
+        if (!armed_) return;
+        armed_ = false;
+        LatencyMetrics::record(stage_, latency_clock::ticksToNs(latency_clock::now() - start_));
+    }
+
+private:
+    LatencyStage stage_;
+    uint64_t start_;
+    bool armed_;
+};
@@ -0,0 +1,150 @@
+#pragma once
+#include "util/spsc_queue.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+enum class LogLevel : uint8_t {
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+    OFF
+};
+
+// "debug", "info", "warn", "error", "off"; anything else is INFO
+LogLevel parseLogLevel(std::string_view name);
+
+// Asynchronous console logger. Each thread writes into its own bounded ring,
+// so logging is a copy into a preallocated slot: no lock, no syscall, no
+// flush on the calling thread. A background thread drains every ring about
+// every 20 ms and writes the batch with one fwrite per stream (DEBUG / INFO
+// to stdout, WARN / ERROR to stderr). A full ring drops the message and
+// counts it rather than block a feed thread.
+//
+// The level starts from ALPHA_LOG_LEVEL (default info). The logger is never
+// destroyed, so detached threads can log right up to exit; whatever is queued
+// is flushed at exit.
+class Logger {
+public:
+    static constexpr size_t THREAD_QUEUE_CAPACITY = 4096;
+
+    static Logger& instance();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    LogLevel level() const { return level_.load(std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= this->level() && level != LogLevel::OFF; }
+
+    // Queues one message (newline included by the caller) from this thread
+    void write(LogLevel level, std::string_view text);
+
+    // Blocks until everything queued so far has been written
+    void flush();
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Record {
+        LogLevel level = LogLevel::INFO;
+        std::string text;
+    };
+
+    struct ThreadBuffer {
+        explicit ThreadBuffer(size_t capacity) : queue(capacity) {}
+        SPSCQueue<Record> queue;
+        Record staging;    // reused so a push does not allocate once warm
+    };
+
+    Logger();
+
+    ThreadBuffer& local();
+    void drainLoop();
+    void drainOnce();
+
+    std::atomic<LogLevel> level_;
+    std::atomic<uint64_t> dropped_;
+
+    std::mutex registryMutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+    // Held while draining: the rings' single consumer is whoever holds it
+    std::mutex drainMutex_;
+    std::string out_;
+    std::string err_;
+    Record popped_;
+};
+
+// std::ostream over a reusable std::string; one per thread behind LogLine
+class LogStream : private std::streambuf, public std::ostream {
+public:
+    LogStream() : std::ostream(static_cast<std::streambuf*>(this)) {}
+
+    std::string& text() { return text_; }
+
+    // Empties the text and restores default formatting
+    void reset();
+
+private:
+    std::streambuf::int_type overflow(std::streambuf::int_type c) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+    std::string text_;
+};
+
+// One log message: stream into it, and it is queued (with a trailing newline)
+// when the LogLine is destroyed. Uses the thread's LogStream, so keep a single
+// LogLine alive per thread at a time.
+class LogLine {
+public:
+    explicit LogLine(LogLevel level);
+    ~LogLine();
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    std::ostream& stream() { return stream_; }
+
+private:
+    LogLevel level_;
+    LogStream& stream_;
+};
+
+// Formats nothing when the level is filtered out
+#define ALPHA_LOG(level) \
+    if (!Logger::instance().enabled(level)) {} else LogLine(level).stream()
+
+#define LOG_DEBUG ALPHA_LOG(LogLevel::DEBUG)
+#define LOG_INFO  ALPHA_LOG(LogLevel::INFO)
+#define LOG_WARN  ALPHA_LOG(LogLevel::WARN)
+#define LOG_ERROR ALPHA_LOG(LogLevel::ERROR)
+
+// Lets something through at most once per interval; for console dashboards
+// that should refresh at a fixed rate however fast ticks arrive
+class Throttle {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Throttle(std::chrono::milliseconds interval)
+        : interval_(interval), next_() {}
+
+    bool ready(Clock::time_point now = Clock::now()) {
+        if (now < next_) return false;
+        next_ = now + interval_;
+        return true;
+    }
+
+private:
+    std::chrono::milliseconds interval_;
+    Clock::time_point next_;
+};
@@ -1,12 +1,43 @@
 #pragma once
 #include <string>
 #include <chrono>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include "util/symbol_registry.h"
 
 struct MarketTick {
     std::string symbol;
     double price;
     double volume;
     long timestamp;  // milliseconds since epoch
+    SymbolId symbolId = INVALID_SYMBOL_ID;  // set by the feeds; otherwise resolved from symbol
+};
+
+// Hot-path tick emitted by the feeds; the name is resolved through
+// SymbolRegistry only at the output edges
+struct CompactTick {
+    SymbolId symbolId;
+    double price;
+    double quantity;
+    int64_t timestampNs;  // nanoseconds since epoch
+};
+
+// Top-of-book update emitted by the feeds alongside trades
+struct QuoteEvent {
+    SymbolId symbolId;
+    double bidPrice;
+    double bidSize;
+    double askPrice;
+    double askSize;
+    int64_t timestampNs;  // nanoseconds since epoch
+};
+
+// Compact trade record for rolling analytics windows
+struct TradeRecord {
+    double price;
+    double volume;
+    int sign;         // +1 buy, -1 sell, 0 unknown
 };
 
 struct Candle {
@@ -17,6 +48,8 @@ struct Candle {
     double volume;
     std::chrono::system_clock::time_point startTime;
     std::chrono::system_clock::time_point endTime;
+    SymbolId symbolId = INVALID_SYMBOL_ID;
+    int intervalSeconds = 0;
 };
 
 struct Signal {
@@ -28,22 +61,42 @@ struct Signal {
     std::string type;  // "BUY", "SELL", "NONE"
 };
 
+enum class SignalType : uint8_t {
+    NONE,
+    TICK,   // tick-level momentum / mean reversion
+    BUY,
+    SELL
+};
+
+inline const char* signalTypeName(SignalType type) {
+    switch (type) {
+        case SignalType::TICK: return "TICK";
+        case SignalType::BUY: return "BUY";
+        case SignalType::SELL: return "SELL";
+        default: return "NONE";
+    }
+}
+
+// Fixed-size and trivially copyable: building, returning and dropping one
+// never touches the heap. Names are resolved at the output edges (symbolId
+// through SymbolRegistry, type + timeframe as "BUY_1m").
 struct AlphaSignal {
-    std::string symbol;
+    SymbolId symbolId;
     long timestamp;
     double momentum;
     double meanRevZ;
     double rsi;
     double vbr;
-    std::string type;  // "BUY_1m", "SELL_5m", "NONE", etc.
+    SignalType type;
+    const char* timeframe;  // "1m", owned by the AlphaEngine that produced the signal
 
     double vpin = 0.0;
     double ofi = 0.0;
     double toxicity = 0.0;
-
-    std::string regime = "UNKNOWN";
 };
 
+static_assert(std::is_trivially_copyable<AlphaSignal>::value, "AlphaSignal must stay a POD record");
+
 struct OrderBookLevel {
     double price;
     double volume;
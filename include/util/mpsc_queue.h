@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queue (Vyukov's sequence-numbered ring). Safe for any number
+// of producers; consumers may also be several, which lets a producer discard the
+// oldest element itself when the ring is full.
+//
+// Slots are constructed once and reused, so element types that own memory
+// (e.g. std::string with reserved capacity) are filled and drained in place through
+// the callbacks instead of being moved in and out.
+template <typename T>
+class MPSCQueue {
+public:
+    explicit MPSCQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+
+        cells_.reset(new Cell[cap]);
+        for (size_t i = 0; i < cap; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueuePos_.store(0, std::memory_order_relaxed);
+        dequeuePos_.store(0, std::memory_order_relaxed);
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    // Apply init(T&) to every slot, e.g. to reserve buffer capacity up front
+    template <typename Init>
+    void initSlots(Init&& init) {
+        for (size_t i = 0; i <= mask_; ++i) init(cells_[i].data);
+    }
+
+    // fill(T& slot) runs only if a slot was claimed; returns false when full
+    template <typename Fill>
+    bool tryPush(Fill&& fill) {
+        Cell* cell;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->data);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consume(T& slot) runs on the oldest element; returns false when empty
+    template <typename Consume>
+    bool tryPop(Consume&& consume) {
+        Cell* cell;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        consume(cell->data);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate number of queued elements (exact when quiescent)
+    size_t size() const {
+        size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+
+    alignas(64) std::atomic<size_t> enqueuePos_;
+    alignas(64) std::atomic<size_t> dequeuePos_;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Fixed-capacity FIFO window. Storage is allocated once; pushing into a full
+// buffer overwrites the oldest element. Index 0 is the oldest element.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 1)
+        : data_(capacity > 0 ? capacity : 1), head_(0), size_(0) {}
+
+    // Appends value; returns true (and the evicted element in evicted) when full
+    bool push(const T& value, T* evicted = nullptr) {
+        if (size_ < data_.size()) {
+            data_[wrap(head_ + size_)] = value;
+            ++size_;
+            return false;
+        }
+
+        if (evicted) *evicted = data_[head_];
+        data_[head_] = value;
+        head_ = wrap(head_ + 1);
+        return true;
+    }
+
+    void pop_front() {
+        if (size_ == 0) return;
+        head_ = wrap(head_ + 1);
+        --size_;
+    }
+
+    void pop_back() {
+        if (size_ == 0) return;
+        --size_;
+    }
+
+    const T& operator[](size_t i) const { return data_[wrap(head_ + i)]; }
+    T& operator[](size_t i) { return data_[wrap(head_ + i)]; }
+
+    const T& front() const { return data_[head_]; }
+    const T& back() const { return data_[wrap(head_ + size_ - 1)]; }
+    T& front() { return data_[head_]; }
+    T& back() { return data_[wrap(head_ + size_ - 1)]; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return data_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == data_.size(); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Copy oldest-to-newest into out (reuses out's capacity)
+    void copyTo(std::vector<T>& out) const {
+        out.resize(size_);
+        for (size_t i = 0; i < size_; ++i) out[i] = (*this)[i];
+    }
+
+private:
+    size_t wrap(size_t i) const { return i < data_.size() ? i : i - data_.size(); }
+
+    std::vector<T> data_;
+    size_t head_;
+    size_t size_;
+};
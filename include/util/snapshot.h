@@ -0,0 +1,260 @@
+#pragma once
+#include "util/ring_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+// Compact binary encoding of analytics state for warm restarts. Values are
+// written in host byte order with no padding or field names: a snapshot is
+// only read back by the same build on the same machine, and every class
+// writes its configuration first so loadState can refuse state that no
+// longer fits. Readers throw std::runtime_error on anything malformed.
+class SnapshotWriter {
+public:
+    void clear() { buffer_.clear(); }
+
+    const std::string& data() const { return buffer_; }
+    std::string& data() { return buffer_; }   // swap out to publish without copying
+
+    void writeBytes(const void* data, size_t bytes) {
+        buffer_.append(static_cast<const char*>(data), bytes);
+    }
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+        writeBytes(&value, sizeof(T));
+    }
+
+    template <typename A, typename B>
+    void write(const std::pair<A, B>& value) {
+        write(value.first);
+        write(value.second);
+    }
+
+    void writeString(std::string_view text) {
+        write(static_cast<uint32_t>(text.size()));
+        writeBytes(text.data(), text.size());
+    }
+
+    // Length-prefixed nested record, so a reader can skip what it does not know
+    void writeBlob(std::string_view blob) {
+        write(static_cast<uint64_t>(blob.size()));
+        writeBytes(blob.data(), blob.size());
+    }
+
+    // writeBlob without a staging buffer: beginBlob() reserves the length,
+    // endBlob() fills it in once the record is written
+    size_t beginBlob() {
+        write(static_cast<uint64_t>(0));
+        return buffer_.size();
+    }
+
+    void endBlob(size_t start) {
+        const uint64_t bytes = buffer_.size() - start;
+        std::memcpy(&buffer_[start - sizeof(bytes)], &bytes, sizeof(bytes));
+    }
+
+    // Oldest to newest
+    template <typename T>
+    void write(const RingBuffer<T>& ring) {
+        write(static_cast<uint64_t>(ring.size()));
+        for (size_t i = 0; i < ring.size(); ++i) write(ring[i]);
+    }
+
+    template <typename T>
+    void write(const std::vector<T>& values) {
+        write(static_cast<uint64_t>(values.size()));
+        for (const auto& v : values) write(v);
+    }
+
+private:
+    std::string buffer_;
+};
+
+class SnapshotReader {
+public:
+    SnapshotReader(const char* data, size_t bytes) : pos_(data), end_(data + bytes) {}
+    explicit SnapshotReader(std::string_view data) : SnapshotReader(data.data(), data.size()) {}
+
+    size_t remaining() const { return static_cast<size_t>(end_ - pos_); }
+    bool atEnd() const { return pos_ == end_; }
+
+    void readBytes(void* out, size_t bytes) {
+        require(bytes);
+        std::memcpy(out, pos_, bytes);
+        pos_ += bytes;
+    }
+
+    template <typename T>
+    void read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot values must be trivially copyable");
+        readBytes(&value, sizeof(T));
+    }
+
+    template <typename A, typename B>
+    void read(std::pair<A, B>& value) {
+        read(value.first);
+        read(value.second);
+    }
+
+    template <typename T>
+    T read() {
+        T value;
+        read(value);
+        return value;
+    }
+
+    // Points into the snapshot; valid while its storage is
+    std::string_view readString() {
+        uint32_t bytes = read<uint32_t>();
+        require(bytes);
+        std::string_view text(pos_, bytes);
+        pos_ += bytes;
+        return text;
+    }
+
+    // A writeBlob record; read it with its own SnapshotReader
+    std::string_view readBlob() {
+        uint64_t bytes = read<uint64_t>();
+        require(bytes);
+        std::string_view blob(pos_, static_cast<size_t>(bytes));
+        pos_ += bytes;
+        return blob;
+    }
+
+    // Throws if the ring cannot hold what was saved
+    template <typename T>
+    void read(RingBuffer<T>& ring) {
+        uint64_t count = read<uint64_t>();
+        if (count > ring.capacity()) fail("ring holds fewer elements than the snapshot");
+        ring.clear();
+        T value;
+        for (uint64_t i = 0; i < count; ++i) {
+            read(value);
+            ring.push(value);
+        }
+    }
+
+    template <typename T>
+    void read(std::vector<T>& values) {
+        uint64_t count = read<uint64_t>();
+        if (count > remaining()) fail("vector length exceeds snapshot");
+        values.resize(static_cast<size_t>(count));
+        for (auto& v : values) read(v);
+    }
+
+    // Reads a configuration value and throws if it differs from the current one
+    template <typename T>
+    void expect(const T& current, const char* what) {
+        if (read<T>() != current) fail(what);
+    }
+
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::runtime_error("Snapshot: " + what);
+    }
+
+private:
+    void require(size_t bytes) const {
+        if (bytes > remaining()) fail("truncated");
+    }
+
+    const char* pos_;
+    const char* end_;
+};
+
+// Named sections ("alpha/BTCUSDT", "candles/binance") gathered into one file.
+// write() goes through a temporary file and a rename, so a crash mid-write
+// leaves the previous snapshot in place.
+class SnapshotFileBuilder {
+public:
+    void clear();
+    void add(std::string_view name, std::string_view blob);
+
+    size_t sections() const { return sections_; }
+    size_t bytes() const { return payload_.size(); }
+
+    // Throws std::runtime_error on I/O failure
+    void write(const std::string& path) const;
+
+private:
+    std::string payload_;
+    uint32_t sections_ = 0;
+};
+
+// Memory-mapped snapshot file. Opening checks the header and checksum and
+// indexes the sections; section data is read in place, never copied.
+class MappedSnapshot {
+public:
+    // Throws std::runtime_error if the file is missing, truncated or corrupt
+    explicit MappedSnapshot(const std::string& path);
+    ~MappedSnapshot();
+
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    // Section data, empty if the section is absent
+    std::string_view find(std::string_view name) const;
+
+    size_t sections() const { return index_.size(); }
+    size_t bytes() const { return bytes_; }
+    std::chrono::system_clock::time_point writtenAt() const { return writtenAt_; }
+
+private:
+    const char* data_;
+    size_t bytes_;
+    std::chrono::system_clock::time_point writtenAt_;
+    std::vector<std::pair<std::string_view, std::string_view>> index_;
+};
+
+// Writes the snapshot file from a background thread every interval. Each
+// source appends its sections to the builder; sources run on the snapshot
+// thread, so they must only touch state that is safe to read from there.
+class SnapshotService {
+public:
+    using Source = std::function<void(SnapshotFileBuilder&)>;
+
+    SnapshotService(std::string path, std::chrono::seconds interval);
+    ~SnapshotService();
+
+    SnapshotService(const SnapshotService&) = delete;
+    SnapshotService& operator=(const SnapshotService&) = delete;
+
+    // Register sources before start()
+    void addSource(Source source);
+
+    void start();
+    void stop();
+
+    // Builds and writes one snapshot now; false (logged) on failure
+    bool writeNow();
+
+    const std::string& path() const { return path_; }
+    uint64_t snapshotsWritten() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    std::string path_;
+    std::chrono::seconds interval_;
+    std::vector<Source> sources_;
+    SnapshotFileBuilder builder_;
+    std::mutex writeMutex_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_;
+    std::atomic<uint64_t> written_;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bounded wait-free single-producer/single-consumer ring. Exactly one thread may
+// push and exactly one (other) thread may pop. Each side caches the opposite
+// index so the shared cache line is only touched when the ring looks full/empty.
+template <typename T>
+class SPSCQueue {
+public:
+    explicit SPSCQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        slots_.reset(new T[cap]);
+    }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Producer side; returns false when full
+    bool tryPush(const T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) return false;
+        }
+
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false when empty
+    bool tryPop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) return false;
+        }
+
+        out = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate from any thread
+    size_t size() const {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::unique_ptr<T[]> slots_;
+    size_t mask_;
+
+    // Consumer-owned
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    // Producer-owned
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+};
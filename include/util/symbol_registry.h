@@ -0,0 +1,102 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+// Dense integer handle for an instrument, assigned at subscription time
+using SymbolId = uint32_t;
+constexpr SymbolId INVALID_SYMBOL_ID = UINT32_MAX;
+
+// Process-wide symbol interning. Names are registered once (under a lock) when
+// feeds subscribe; ids are dense from 0 so hot-path state can live in vectors
+// indexed by id. name() is lock-free: names are stored in a fixed-capacity table
+// and never move once published.
+class SymbolRegistry {
+public:
+    static constexpr size_t MAX_SYMBOLS = 4096;
+
+    static SymbolRegistry& instance() {
+        static SymbolRegistry registry;
+        return registry;
+    }
+
+    SymbolRegistry(const SymbolRegistry&) = delete;
+    SymbolRegistry& operator=(const SymbolRegistry&) = delete;
+
+    // Returns the existing id for name or registers a new one
+    SymbolId intern(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = ids_.find(std::string(name));
+        if (it != ids_.end()) return it->second;
+
+        uint32_t id = count_.load(std::memory_order_relaxed);
+        if (id >= MAX_SYMBOLS) {
+            throw std::runtime_error("SymbolRegistry full, cannot register " + std::string(name));
+        }
+
+        names_[id].assign(name.data(), name.size());
+        ids_.emplace(names_[id], id);
+        count_.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    // INVALID_SYMBOL_ID if the name was never registered
+    SymbolId find(std::string_view name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(std::string(name));
+        return it != ids_.end() ? it->second : INVALID_SYMBOL_ID;
+    }
+
+    const std::string& name(SymbolId id) const {
+        static const std::string unknown = "UNKNOWN";
+        return id < count_.load(std::memory_order_acquire) ? names_[id] : unknown;
+    }
+
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    SymbolRegistry() : names_(new std::string[MAX_SYMBOLS]), count_(0) {}
+
+    std::unique_ptr<std::string[]> names_;
+    std::atomic<uint32_t> count_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, SymbolId> ids_;
+};
+
+// Per-feed name -> id table for the handful of symbols a feed subscribes to.
+// A linear scan over a few short names beats hashing; names the feed has not
+// seen yet are interned once and cached. Not thread safe; one per feed thread.
+class SymbolLookup {
+public:
+    SymbolLookup() = default;
+
+    explicit SymbolLookup(const std::vector<std::string>& names) {
+        for (const auto& n : names) add(n);
+    }
+
+    SymbolId add(std::string_view name) {
+        SymbolId id = SymbolRegistry::instance().intern(name);
+        entries_.emplace_back(std::string(name), id);
+        return id;
+    }
+
+    SymbolId operator()(std::string_view name) {
+        for (const auto& e : entries_) {
+            if (e.first == name) return e.second;
+        }
+        return add(name);
+    }
+
+private:
+    std::vector<std::pair<std::string, SymbolId>> entries_;
+};
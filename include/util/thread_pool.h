@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed set of worker threads for batch jobs (Monte Carlo runs, parameter
+// sweeps). parallelFor hands out indices dynamically, so uneven job costs
+// balance themselves; the worker number passed to the callback lets callers
+// keep per-worker scratch buffers without locking.
+class ThreadPool {
+public:
+    // 0 = one thread per hardware thread
+    explicit ThreadPool(size_t numThreads = 0)
+        : stop_(false), generation_(0), fn_(nullptr), count_(0), next_(0), active_(0) {
+        if (numThreads == 0) numThreads = std::thread::hardware_concurrency();
+        if (numThreads == 0) numThreads = 1;
+
+        workers_.reserve(numThreads);
+        for (size_t w = 0; w < numThreads; ++w) {
+            workers_.emplace_back([this, w] { workerLoop(w); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    // Runs fn(index, worker) for every index in [0, count) and blocks until all
+    // have finished. The first exception thrown by fn is rethrown here.
+    // Not reentrant: call from one thread at a time.
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& fn) {
+        if (count == 0) return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fn_ = &fn;
+            count_ = count;
+            next_.store(0, std::memory_order_relaxed);
+            active_ = workers_.size();
+            error_ = nullptr;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        fn_ = nullptr;
+
+        if (error_) std::rethrow_exception(error_);
+    }
+
+private:
+    void workerLoop(size_t worker) {
+        uint64_t seen = 0;
+
+        while (true) {
+            const std::function<void(size_t, size_t)>* fn;
+            size_t count;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+                fn = fn_;
+                count = count_;
+            }
+
+            for (size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count;
+                 i = next_.fetch_add(1, std::memory_order_relaxed)) {
+                try {
+                    (*fn)(i, worker);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!error_) error_ = std::current_exception();
+                    next_.store(count, std::memory_order_relaxed);   // stop handing out work
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0) done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    bool stop_;
+    uint64_t generation_;
+
+    // Current job
+    const std::function<void(size_t, size_t)>* fn_;
+    size_t count_;
+    std::atomic<size_t> next_;
+    size_t active_;
+    std::exception_ptr error_;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <algorithm>
+
+// Rate limiter: holds up to `burst` tokens, refilled continuously at `rate`
+// per second. Not thread safe; owned by the thread that issues requests.
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket(double ratePerSecond, double burst)
+        : rate_(std::max(0.0, ratePerSecond)),
+          burst_(std::max(1.0, burst)),
+          tokens_(burst_),
+          last_(Clock::now()) {}
+
+    // Takes one token if available
+    bool tryAcquire(Clock::time_point now = Clock::now()) {
+        refill(now);
+        if (tokens_ < 1.0) return false;
+        tokens_ -= 1.0;
+        return true;
+    }
+
+    // Time until the next token is available (zero if one is ready)
+    Clock::duration waitTime(Clock::time_point now = Clock::now()) {
+        refill(now);
+        if (tokens_ >= 1.0) return Clock::duration::zero();
+        if (rate_ <= 0.0) return std::chrono::hours(1);
+        return std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>((1.0 - tokens_) / rate_));
+    }
+
+private:
+    void refill(Clock::time_point now) {
+        if (now <= last_) return;
+        tokens_ = std::min(burst_, tokens_ + std::chrono::duration<double>(now - last_).count() * rate_);
+        last_ = now;
+    }
+
+    double rate_;
+    double burst_;
+    double tokens_;
+    Clock::time_point last_;
+};
@@ -1,26 +1,53 @@
 #include "alpha/alpha_engine.h"
-#include "storage/influx_writer.h"
-#include <iostream>
+#include "alpha/signal_sink.h"
+#include "util/logger.h"
+#include <cmath>
 
-static InfluxWriter influx("alpha_org", "market_data", "alpha_token");
-
-AlphaEngine::AlphaEngine(size_t windowSize, const std::string& timeframe)
+AlphaEngine::AlphaEngine(size_t windowSize, const std::string& timeframe, SignalSink* sink)
     : windowSize_(windowSize),
       timeframe_(timeframe),
+      sink_(sink),
+      lastSymbol_(INVALID_SYMBOL_ID),
+      window_(windowSize),
       sumPrices_(0.0),
       sumSquares_(0.0) {}
 
+AlphaEngine::CandleState::CandleState()
+    : candleCount(0),
+      bollinger(20),
+      rsi(14),
+      volumeRatio(VOLUME_RATIO_WINDOW) {}
+
+AlphaEngine::CandleState& AlphaEngine::candleState(SymbolId symbolId) {
+    if (symbolId >= candles_.size()) candles_.resize(symbolId + 1);
+
+    auto& state = candles_[symbolId];
+    if (!state) state = std::make_unique<CandleState>();
+    return *state;
+}
+
+// Ticks from the feeds carry their id; row ticks (backtests, tools) usually
+// repeat the last symbol, so compare names before going to the registry
+SymbolId AlphaEngine::symbolOf(const MarketTick& tick) {
+    if (tick.symbolId != INVALID_SYMBOL_ID) return tick.symbolId;
+
+    SymbolRegistry& registry = SymbolRegistry::instance();
+    if (lastSymbol_ != INVALID_SYMBOL_ID && registry.name(lastSymbol_) == tick.symbol) {
+        return lastSymbol_;
+    }
+    return registry.intern(tick.symbol);
+}
+
 std::optional<AlphaSignal> AlphaEngine::onTick(const MarketTick& tick) {
-    window_.push_back(tick);
-    sumPrices_ += tick.price;
-    sumSquares_ += tick.price * tick.price;
+    lastSymbol_ = symbolOf(tick);
 
-    if (window_.size() > windowSize_) {
-        const auto& old = window_.front();
-        sumPrices_ -= old.price;
-        sumSquares_ -= old.price * old.price;
-        window_.pop_front();
+    double evicted = 0.0;
+    if (window_.push(tick.price, &evicted)) {
+        sumPrices_ -= evicted;
+        sumSquares_ -= evicted * evicted;
     }
+    sumPrices_ += tick.price;
+    sumSquares_ += tick.price * tick.price;
 
     if (window_.size() < windowSize_) return std::nullopt;
 
@@ -31,59 +58,97 @@ std::optional<AlphaSignal> AlphaEngine::onTick(const MarketTick& tick) {
     if (variance < 0.0) variance = 0.0;
     double vol = std::sqrt(variance);
 
-    const auto& oldest = window_.front();
-    double momentum = (tick.price / oldest.price) - 1.0;
+    double momentum = (tick.price / window_.front()) - 1.0;
     double meanRevZ = (vol > 1e-8) ? (tick.price - sma) / vol : 0.0;
 
-    influx.writeAlphaSignal(
-        tick.symbol,
-        momentum,
-        meanRevZ,
-        0.0,
-        0.0,
-        "TICK_" + timeframe_
-    );
+    AlphaSignal signal{ lastSymbol_, tick.timestamp, momentum, meanRevZ, 0.0, 0.0,
+                        SignalType::TICK, timeframe_.c_str() };
+
+    if (sink_) sink_->onAlphaSignal(signal);
 
-    return AlphaSignal{ tick.symbol, tick.timestamp, momentum, meanRevZ, 0.0, 0.0, "TICK_" + timeframe_ };
+    return signal;
 }
 
 void AlphaEngine::onCandle(const Candle& c) {
-    closes_.push_back(c.close);
-    highs_.push_back(c.high);
-    lows_.push_back(c.low);
-    volumes_.push_back(c.volume);
+    if (c.symbolId == INVALID_SYMBOL_ID) return;
 
-    if (closes_.size() < windowSize_)
-        return;
+    CandleState& state = candleState(c.symbolId);
+    state.bollinger.push(c.close);
+    double rsi = state.rsi.update(c.close);
+    double vbr = state.volumeRatio.update(c.close, c.volume);
 
-    double mean = 0.0, upper = 0.0, lower = 0.0;
-    computeBollinger(closes_, 20, 2.0, mean, upper, lower);
-    double rsi = computeRSI(closes_, 14);
+    if (++state.candleCount < windowSize_ || !state.bollinger.full())
+        return;
 
-    std::vector<double> upVol, downVol;
-    for (size_t i = 1; i < closes_.size(); ++i) {
-        if (closes_[i] > closes_[i - 1]) upVol.push_back(volumes_[i]);
-        else downVol.push_back(volumes_[i]);
-    }
-    double vbr = computeVolumeRatio(upVol, downVol);
-    double price = closes_.back();
+    double mean = state.bollinger.mean();
+    double upper = mean + 2.0 * state.bollinger.stddev();
+    double lower = mean - 2.0 * state.bollinger.stddev();
+    double price = c.close;
 
-    std::string signalType = "NONE_" + timeframe_;
+    SignalType signalType = SignalType::NONE;
     if (price < lower && rsi < 30 && vbr < 0.7) {
-        signalType = "BUY_" + timeframe_;
-        std::cout << "[BUY] " << timeframe_
-                  << " | Price: " << price
-                  << " | RSI: " << rsi
-                  << " | VBR: " << vbr
-                  << " | LowerBand: " << lower << std::endl;
+        signalType = SignalType::BUY;
+        LOG_INFO << "[BUY] " << timeframe_
+                 << " | Price: " << price
+                 << " | RSI: " << rsi
+                 << " | VBR: " << vbr
+                 << " | LowerBand: " << lower;
     } else if (price > upper && rsi > 70 && vbr > 1.3) {
-        signalType = "SELL_" + timeframe_;
-        std::cout << "[SELL] " << timeframe_
-                  << " | Price: " << price
-                  << " | RSI: " << rsi
-                  << " | VBR: " << vbr
-                  << " | UpperBand: " << upper << std::endl;
+        signalType = SignalType::SELL;
+        LOG_INFO << "[SELL] " << timeframe_
+                 << " | Price: " << price
+                 << " | RSI: " << rsi
+                 << " | VBR: " << vbr
+                 << " | UpperBand: " << upper;
+    }
+
+    if (sink_) {
+        long timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            c.endTime.time_since_epoch()).count();
+        sink_->onAlphaSignal(AlphaSignal{ c.symbolId, timestamp, 0.0, 0.0, rsi, vbr,
+                                          signalType, timeframe_.c_str() });
+    }
+}
+
+void AlphaEngine::saveState(SnapshotWriter& out) const {
+    out.write(static_cast<uint64_t>(windowSize_));
+    // Symbol ids are per process, so the symbol travels by name
+    out.writeString(lastSymbol_ != INVALID_SYMBOL_ID ? SymbolRegistry::instance().name(lastSymbol_) : "");
+    out.write(window_);
+    out.write(sumPrices_);
+    out.write(sumSquares_);
+
+    uint64_t symbols = 0;
+    for (const auto& state : candles_) symbols += state ? 1 : 0;
+    out.write(symbols);
+
+    for (SymbolId id = 0; id < candles_.size(); ++id) {
+        if (!candles_[id]) continue;
+
+        const CandleState& state = *candles_[id];
+        out.writeString(SymbolRegistry::instance().name(id));
+        out.write(static_cast<uint64_t>(state.candleCount));
+        state.bollinger.saveState(out);
+        state.rsi.saveState(out);
+        state.volumeRatio.saveState(out);
     }
+}
+
+void AlphaEngine::loadState(SnapshotReader& in) {
+    in.expect(static_cast<uint64_t>(windowSize_), "AlphaEngine window changed");
+    std::string_view symbol = in.readString();
+    lastSymbol_ = symbol.empty() ? INVALID_SYMBOL_ID : SymbolRegistry::instance().intern(symbol);
+    in.read(window_);
+    in.read(sumPrices_);
+    in.read(sumSquares_);
 
-    influx.writeAlphaSignal("BTCUSDT", 0.0, 0.0, rsi, vbr, signalType);
+    candles_.clear();
+    const uint64_t symbols = in.read<uint64_t>();
+    for (uint64_t i = 0; i < symbols; ++i) {
+        CandleState& state = candleState(SymbolRegistry::instance().intern(in.readString()));
+        state.candleCount = static_cast<size_t>(in.read<uint64_t>());
+        state.bollinger.loadState(in);
+        state.rsi.loadState(in);
+        state.volumeRatio.loadState(in);
+    }
 }
@@ -0,0 +1,86 @@
+#include "alpha/alpha_pipeline.h"
+#include <stdexcept>
+
+uint32_t parseAlphaStages(const std::string& list) {
+    uint32_t stages = 0;
+    size_t pos = 0;
+
+    while (pos <= list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+
+        std::string name = list.substr(pos, end - pos);
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+
+        if (name == "all") stages |= alpha_stage::ALL;
+        else if (name == "momentum") stages |= alpha_stage::MOMENTUM;
+        else if (name == "microstructure" || name == "vpin") stages |= alpha_stage::MICROSTRUCTURE;
+        else if (name == "orderflow" || name == "ofi") stages |= alpha_stage::ORDER_FLOW;
+        else if (name == "regime") stages |= alpha_stage::REGIME;
+        else if (name == "vwap") stages |= alpha_stage::VWAP;
+        else if (name == "bollinger") stages |= alpha_stage::BOLLINGER;
+        else if (!name.empty()) throw std::invalid_argument("Unknown alpha stage: " + name);
+
+        pos = end + 1;
+    }
+
+    return stages;
+}
+
+DynamicAlphaPipeline::DynamicAlphaPipeline(uint32_t stages)
+    : stages_(stages & alpha_stage::ALL) {}
+
+const TickContext& DynamicAlphaPipeline::onTick(const MarketTick& tick) {
+    ctx_.clearOutputs();
+    features_.fill(ctx_, tick);
+
+    if (enabled(alpha_stage::MOMENTUM)) detail::runStage(momentum_, ctx_);
+    if (enabled(alpha_stage::MICROSTRUCTURE)) detail::runStage(microstructure_, ctx_);
+    if (enabled(alpha_stage::ORDER_FLOW)) detail::runStage(orderFlow_, ctx_);
+    if (enabled(alpha_stage::REGIME)) detail::runStage(regime_, ctx_);
+    if (enabled(alpha_stage::VWAP)) detail::runStage(vwap_, ctx_);
+    if (enabled(alpha_stage::BOLLINGER)) detail::runStage(bollinger_, ctx_);
+
+    return ctx_;
+}
+
+void DynamicAlphaPipeline::onQuote(const QuoteEvent& quote) {
+    if (enabled(alpha_stage::MICROSTRUCTURE)) microstructure_.onQuote(quote);
+    if (enabled(alpha_stage::ORDER_FLOW)) orderFlow_.onQuote(quote);
+}
+
+void DynamicAlphaPipeline::saveState(SnapshotWriter& out) const {
+    features_.saveState(out);
+
+    uint32_t count = 0;
+    for (uint32_t stage = alpha_stage::MOMENTUM; stage & alpha_stage::ALL; stage <<= 1) {
+        if (enabled(stage)) ++count;
+    }
+    out.write(count);
+
+    if (enabled(alpha_stage::MOMENTUM)) detail::saveStage(momentum_, out);
+    if (enabled(alpha_stage::MICROSTRUCTURE)) detail::saveStage(microstructure_, out);
+    if (enabled(alpha_stage::ORDER_FLOW)) detail::saveStage(orderFlow_, out);
+    if (enabled(alpha_stage::REGIME)) detail::saveStage(regime_, out);
+    if (enabled(alpha_stage::VWAP)) detail::saveStage(vwap_, out);
+    if (enabled(alpha_stage::BOLLINGER)) detail::saveStage(bollinger_, out);
+}
+
+void DynamicAlphaPipeline::loadState(SnapshotReader& in) {
+    features_.loadState(in);
+
+    const uint32_t count = in.read<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t id = in.read<uint32_t>();
+        const std::string_view blob = in.readBlob();
+        if (!enabled(id)) continue;
+
+        detail::loadStage(momentum_, id, blob);
+        detail::loadStage(microstructure_, id, blob);
+        detail::loadStage(orderFlow_, id, blob);
+        detail::loadStage(regime_, id, blob);
+        detail::loadStage(vwap_, id, blob);
+        detail::loadStage(bollinger_, id, blob);
+    }
+}
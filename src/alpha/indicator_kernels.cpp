@@ -0,0 +1,293 @@
+#include "alpha/indicator_kernels.h"
+#include "alpha/streaming_indicators.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ALPHA_KERNELS_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define ALPHA_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Prefix sums are rebuilt per block, re-centred on the block's first value, so
+// the window differences never cancel against a sum spanning the whole series
+constexpr size_t BLOCK_SIZE = 4096;
+
+// For j in [0, count): s1 = hi1[j] - lo1[j], s2 = hi2[j] - lo2[j] over one window;
+// mean = centre + s1 / p, stddev = sqrt(max(0, (s2 - s1^2 / p) / (p - 1)))
+void windowStatsScalar(const double* hi1, const double* lo1, const double* hi2, const double* lo2,
+					   size_t count, double centre, double invP, double invPm1,
+					   double* mean, double* stddev) {
+	for (size_t j = 0; j < count; ++j) {
+		const double s1 = hi1[j] - lo1[j];
+		const double s2 = hi2[j] - lo2[j];
+		const double var = (s2 - s1 * s1 * invP) * invPm1;
+		mean[j] = centre + s1 * invP;
+		stddev[j] = std::sqrt(var > 0.0 ? var : 0.0);
+	}
+}
+
+#ifdef ALPHA_KERNELS_AVX2
+__attribute__((target("avx2,fma")))
+void windowStatsAVX2(const double* hi1, const double* lo1, const double* hi2, const double* lo2,
+					 size_t count, double centre, double invP, double invPm1,
+					 double* mean, double* stddev) {
+	const __m256d vCentre = _mm256_set1_pd(centre);
+	const __m256d vInvP = _mm256_set1_pd(invP);
+	const __m256d vInvPm1 = _mm256_set1_pd(invPm1);
+	const __m256d zero = _mm256_setzero_pd();
+
+	size_t j = 0;
+	for (; j + 4 <= count; j += 4) {
+		const __m256d s1 = _mm256_sub_pd(_mm256_loadu_pd(hi1 + j), _mm256_loadu_pd(lo1 + j));
+		const __m256d s2 = _mm256_sub_pd(_mm256_loadu_pd(hi2 + j), _mm256_loadu_pd(lo2 + j));
+		const __m256d sq = _mm256_mul_pd(_mm256_mul_pd(s1, s1), vInvP);
+		const __m256d var = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(s2, sq), vInvPm1), zero);
+
+		_mm256_storeu_pd(mean + j, _mm256_fmadd_pd(s1, vInvP, vCentre));
+		_mm256_storeu_pd(stddev + j, _mm256_sqrt_pd(var));
+	}
+
+	windowStatsScalar(hi1 + j, lo1 + j, hi2 + j, lo2 + j, count - j, centre, invP, invPm1,
+					  mean + j, stddev + j);
+}
+
+bool cpuHasAVX2() {
+	static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	return supported;
+}
+#endif
+
+#ifdef ALPHA_KERNELS_NEON
+void windowStatsNEON(const double* hi1, const double* lo1, const double* hi2, const double* lo2,
+					 size_t count, double centre, double invP, double invPm1,
+					 double* mean, double* stddev) {
+	const float64x2_t vCentre = vdupq_n_f64(centre);
+	const float64x2_t vInvP = vdupq_n_f64(invP);
+	const float64x2_t vInvPm1 = vdupq_n_f64(invPm1);
+	const float64x2_t zero = vdupq_n_f64(0.0);
+
+	size_t j = 0;
+	for (; j + 2 <= count; j += 2) {
+		const float64x2_t s1 = vsubq_f64(vld1q_f64(hi1 + j), vld1q_f64(lo1 + j));
+		const float64x2_t s2 = vsubq_f64(vld1q_f64(hi2 + j), vld1q_f64(lo2 + j));
+		const float64x2_t sq = vmulq_f64(vmulq_f64(s1, s1), vInvP);
+		const float64x2_t var = vmaxq_f64(vmulq_f64(vsubq_f64(s2, sq), vInvPm1), zero);
+
+		vst1q_f64(mean + j, vfmaq_f64(vCentre, s1, vInvP));
+		vst1q_f64(stddev + j, vsqrtq_f64(var));
+	}
+
+	windowStatsScalar(hi1 + j, lo1 + j, hi2 + j, lo2 + j, count - j, centre, invP, invPm1,
+					  mean + j, stddev + j);
+}
+#endif
+
+void windowStats(const double* hi1, const double* lo1, const double* hi2, const double* lo2,
+				 size_t count, double centre, double invP, double invPm1,
+				 double* mean, double* stddev) {
+#if defined(ALPHA_KERNELS_NEON)
+	windowStatsNEON(hi1, lo1, hi2, lo2, count, centre, invP, invPm1, mean, stddev);
+#elif defined(ALPHA_KERNELS_AVX2)
+	if (cpuHasAVX2()) {
+		windowStatsAVX2(hi1, lo1, hi2, lo2, count, centre, invP, invPm1, mean, stddev);
+	} else {
+		windowStatsScalar(hi1, lo1, hi2, lo2, count, centre, invP, invPm1, mean, stddev);
+	}
+#else
+	windowStatsScalar(hi1, lo1, hi2, lo2, count, centre, invP, invPm1, mean, stddev);
+#endif
+}
+
+} // namespace
+
+// === Rolling mean / std dev ===
+void computeRollingMeanStdSeries(const double* data, size_t n, int period,
+								 double* mean, double* stddev) {
+	const size_t p = period > 0 ? static_cast<size_t>(period) : 0;
+	if (p == 0 || n < p) {
+		std::fill(mean, mean + n, 0.0);
+		std::fill(stddev, stddev + n, 0.0);
+		return;
+	}
+
+	std::fill(mean, mean + (p - 1), 0.0);
+	std::fill(stddev, stddev + (p - 1), 0.0);
+
+	const double invP = 1.0 / static_cast<double>(p);
+	const double invPm1 = p > 1 ? 1.0 / static_cast<double>(p - 1) : 0.0;
+
+	std::vector<double> s1(BLOCK_SIZE + p);
+	std::vector<double> s2(BLOCK_SIZE + p);
+
+	// Outputs [begin, end) need inputs [begin - p + 1, end)
+	for (size_t begin = p - 1; begin < n; begin += BLOCK_SIZE) {
+		const size_t end = std::min(n, begin + BLOCK_SIZE);
+		const size_t first = begin + 1 - p;
+		const double centre = data[begin];
+
+		s1[0] = s2[0] = 0.0;
+		for (size_t k = first; k < end; ++k) {
+			const double d = data[k] - centre;
+			s1[k - first + 1] = s1[k - first] + d;
+			s2[k - first + 1] = s2[k - first] + d * d;
+		}
+
+		// Window for output i covers prefix entries (i - first + 1 - p, i - first + 1]
+		windowStats(s1.data() + p, s1.data(), s2.data() + p, s2.data(), end - begin,
+					centre, invP, invPm1, mean + begin, stddev + begin);
+	}
+}
+
+// === Bollinger Bands ===
+void computeBollingerSeries(const double* closes, size_t n, int period, double mult,
+							double* mean, double* upper, double* lower) {
+	// upper holds the std dev until the bands are formed
+	computeRollingMeanStdSeries(closes, n, period, mean, upper);
+
+	for (size_t i = 0; i < n; ++i) {
+		const double band = mult * upper[i];
+		lower[i] = mean[i] - band;
+		upper[i] = mean[i] + band;
+	}
+}
+
+// === RSI ===
+void computeRSISeries(const double* closes, size_t n, int period, double* out) {
+	if (period < 1) {
+		std::fill(out, out + n, 100.0);
+		return;
+	}
+	const size_t p = static_cast<size_t>(period);
+
+	// gains[k] / losses[k] = totals over diffs [0, k)
+	std::vector<double> gains(n > 0 ? n : 1, 0.0);
+	std::vector<double> losses(n > 0 ? n : 1, 0.0);
+	for (size_t j = 0; j + 1 < n; ++j) {
+		const double diff = closes[j + 1] - closes[j];
+		gains[j + 1] = gains[j] + (diff > 0 ? diff : 0.0);
+		losses[j + 1] = losses[j] + (diff > 0 ? 0.0 : -diff);
+	}
+
+	for (size_t i = 0; i < n; ++i) {
+		const size_t len = i + 1;
+		if (len <= p) {
+			out[i] = 50.0;
+			continue;
+		}
+
+		// Diffs [len - p, len - 2], as computeRSI sums them
+		const double gain = gains[len - 1] - gains[len - p];
+		const double loss = losses[len - 1] - losses[len - p];
+		out[i] = loss == 0.0 ? 100.0 : 100.0 - (100.0 / (1.0 + gain / loss));
+	}
+}
+
+// === EMA ===
+void computeEMASeries(const double* data, size_t n, int period, double* out) {
+	if (n == 0) return;
+	if (period <= 0) {
+		std::fill(out, out + n, 0.0);
+		return;
+	}
+
+	const double alpha = 2.0 / (period + 1.0);
+	double ema = data[0];
+	out[0] = ema;
+
+	for (size_t i = 1; i < n; ++i) {
+		ema = alpha * data[i] + (1.0 - alpha) * ema;
+		out[i] = ema;
+	}
+}
+
+// === MACD ===
+void computeMACDSeries(const double* closes, size_t n, int fastPeriod, int slowPeriod,
+					   int signalPeriod, double* macd, double* signal, double* histogram) {
+	// macd / signal double as the fast / slow EMA series
+	computeEMASeries(closes, n, fastPeriod, macd);
+	computeEMASeries(closes, n, slowPeriod, signal);
+
+	const long long warmup = static_cast<long long>(slowPeriod) + signalPeriod;
+	for (size_t i = 0; i < n; ++i) {
+		const bool ready = static_cast<long long>(i + 1) >= warmup;
+		const double m = ready ? macd[i] - signal[i] : 0.0;
+		const double s = m * 0.9;  // Approximation, as computeMACD
+		macd[i] = m;
+		signal[i] = s;
+		histogram[i] = m - s;
+	}
+}
+
+// === ATR ===
+void computeATRSeries(const double* highs, const double* lows, const double* closes,
+					  size_t n, int period, double* out) {
+	if (period < 1) {
+		std::fill(out, out + n, 0.0);
+		return;
+	}
+	const size_t p = static_cast<size_t>(period);
+
+	// trueRange[j] for j >= 1, then prefix totals over [1, k]
+	std::vector<double> total(n > 0 ? n : 1, 0.0);
+	for (size_t j = 1; j < n; ++j) {
+		const double tr1 = highs[j] - lows[j];
+		const double tr2 = std::abs(highs[j] - closes[j - 1]);
+		const double tr3 = std::abs(lows[j] - closes[j - 1]);
+		total[j] = std::max(tr1, std::max(tr2, tr3));
+	}
+	for (size_t j = 1; j < n; ++j) total[j] += total[j - 1];
+
+	const double invP = 1.0 / static_cast<double>(p);
+	for (size_t i = 0; i < n; ++i) {
+		out[i] = i >= p ? (total[i] - total[i - p]) * invP : 0.0;
+	}
+}
+
+// === Stochastic ===
+void computeStochasticSeries(const double* highs, const double* lows, const double* closes,
+							 size_t n, int period, double* k, double* d) {
+	if (period < 1) {
+		std::fill(k, k + n, 50.0);
+		std::fill(d, d + n, 50.0);
+		return;
+	}
+	const size_t p = static_cast<size_t>(period);
+
+	MonotonicWindow highest(p, true);
+	MonotonicWindow lowest(p, false);
+
+	for (size_t i = 0; i < n; ++i) {
+		highest.push(highs[i]);
+		lowest.push(lows[i]);
+
+		const double hh = highest.value();
+		const double ll = lowest.value();
+		if (i + 1 < p || hh == ll) {
+			k[i] = d[i] = 50.0;
+			continue;
+		}
+
+		k[i] = 100.0 * (closes[i] - ll) / (hh - ll);
+		d[i] = k[i] * 0.9;  // Approximation, as computeStochastic
+	}
+}
+
+// === VWAP ===
+void computeVWAPSeries(const double* prices, const double* volumes, size_t n, double* out) {
+	double sumPV = 0.0;
+	double sumV = 0.0;
+
+	for (size_t i = 0; i < n; ++i) {
+		sumPV += prices[i] * volumes[i];
+		sumV += volumes[i];
+		out[i] = sumV > 0.0 ? sumPV / sumV : 0.0;
+	}
+}
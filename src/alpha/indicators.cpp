@@ -1,5 +1,6 @@
 #include "alpha/indicators.h"
 #include <numeric>
+#include <cmath>
 #include <algorithm>
 
 // === Mean ===
@@ -1,6 +1,7 @@
 #include "alpha/microstructure.h"
 #include <algorithm>
 #include <numeric>
+#include <cmath>
 
 MicrostructureAnalyzer::MicrostructureAnalyzer(
     size_t bucketSize,
@@ -10,29 +11,34 @@ MicrostructureAnalyzer::MicrostructureAnalyzer(
     : bucketSize_(bucketSize),
       vpinWindow_(vpinWindow),
       impactWindow_(impactWindow),
+      classifiedTrades_(TRADE_HISTORY),
+      baseBuy_(0.0),
+      baseSell_(0.0),
+      cumBuy_(0.0),
+      cumSell_(0.0),
+      lastSide_(TradeSide::UNKNOWN),
+      bucketImbalances_(vpinWindow),
       currentBucketVolume_(0.0),
       currentBucketBuyVolume_(0.0),
-      isCurrentBucketBuy_(true),
+      impact_(impactWindow),
+      rollProducts_(impactWindow > 1 ? impactWindow - 1 : 1),
+      lastPriceChange_(0.0),
+      hasPriceChange_(false),
+      updates_(0),
       lastPrice_(0.0),
       lastMidPrice_(0.0),
+      lastBid_(0.0),
+      lastAsk_(0.0),
       cumulativeVolume_(0.0),
       cumulativeBuyVolume_(0.0),
       cumulativeSellVolume_(0.0) {}
 
 void MicrostructureAnalyzer::onTick(const MarketTick& tick) {
-    // Classify the trade
-    auto classification = classifyTrade(tick.price, tick.volume);
+    // Classify the trade: quote rule once a quote has been seen, tick rule before
+    auto classification = classifyTrade(tick.price, tick.volume, lastBid_, lastAsk_);
 
-    // Store trade history (keep last 1000 trades)
-    tradeHistory_.push_back(tick);
-    if (tradeHistory_.size() > 1000) {
-        tradeHistory_.pop_front();
-    }
-
-    classifiedTrades_.push_back(classification);
-    if (classifiedTrades_.size() > 1000) {
-        classifiedTrades_.pop_front();
-    }
+    // Store trade history (keep last TRADE_HISTORY trades)
+    recordTrade(tick, classification);
 
     // Update cumulative volumes
     cumulativeVolume_ += tick.volume;
@@ -54,21 +60,22 @@ void MicrostructureAnalyzer::onTick(const MarketTick& tick) {
     lastPrice_ = tick.price;
 }
 
+void MicrostructureAnalyzer::onQuote(double bidPrice, double askPrice) {
+    // Ignore one-sided or crossed books
+    if (bidPrice <= 0.0 || askPrice <= 0.0 || askPrice < bidPrice) return;
+
+    lastBid_ = bidPrice;
+    lastAsk_ = askPrice;
+    lastMidPrice_ = (bidPrice + askPrice) / 2.0;
+}
+
 VPINMetrics MicrostructureAnalyzer::getVPIN() const {
     VPINMetrics metrics;
     metrics.vpin = computeVPIN();
 
     // Calculate recent buy/sell volume
     double recentBuy = 0.0, recentSell = 0.0;
-    size_t window = std::min(classifiedTrades_.size(), size_t(50));
-
-    for (size_t i = classifiedTrades_.size() - window; i < classifiedTrades_.size(); ++i) {
-        if (classifiedTrades_[i].side == TradeSide::BUY) {
-            recentBuy += classifiedTrades_[i].signedVolume;
-        } else if (classifiedTrades_[i].side == TradeSide::SELL) {
-            recentSell += std::abs(classifiedTrades_[i].signedVolume);
-        }
-    }
+    recentFlow(50, recentBuy, recentSell);
 
     metrics.buyVolume = recentBuy;
     metrics.sellVolume = recentSell;
@@ -119,93 +126,229 @@ TradeClassification MicrostructureAnalyzer::classifyTrade(
 }
 
 double MicrostructureAnalyzer::getOrderFlowImbalance(size_t window) const {
-    if (classifiedTrades_.empty()) return 0.0;
-
-    size_t n = std::min(window, classifiedTrades_.size());
     double buyVol = 0.0, sellVol = 0.0;
-
-    for (size_t i = classifiedTrades_.size() - n; i < classifiedTrades_.size(); ++i) {
-        if (classifiedTrades_[i].side == TradeSide::BUY) {
-            buyVol += classifiedTrades_[i].signedVolume;
-        } else if (classifiedTrades_[i].side == TradeSide::SELL) {
-            sellVol += std::abs(classifiedTrades_[i].signedVolume);
-        }
-    }
+    recentFlow(window, buyVol, sellVol);
 
     double total = buyVol + sellVol;
     return total > 0 ? (buyVol - sellVol) / total : 0.0;
 }
 
 double MicrostructureAnalyzer::getEffectiveSpread() const {
-    //use Roll's measure
-    if (priceChanges_.size() < 2) return 0.0;
+    // Roll's measure: Spread = 2 * sqrt(-Cov(dP_t, dP_{t-1})), from the running products
+    if (rollProducts_.empty()) return 0.0;
+
+    double covariance = rollProducts_.mean();
+    return covariance < 0 ? 2.0 * std::sqrt(-covariance) : 0.0;
+}
 
-    return microstructure::computeRollSpread(
-        std::vector<double>(priceChanges_.begin(), priceChanges_.end())
-    );
+double MicrostructureAnalyzer::getQuotedSpread() const {
+    return lastAsk_ > 0.0 ? lastAsk_ - lastBid_ : 0.0;
 }
 
 void MicrostructureAnalyzer::reset() {
-    tradeHistory_.clear();
     classifiedTrades_.clear();
-    volumeBuckets_.clear();
-    priceChanges_.clear();
-    signedVolumes_.clear();
-
+    bucketImbalances_.clear();
+    impact_.clear();
+    impactSums_ = ImpactSums();
+    rollProducts_.clear();
+
+    baseBuy_ = baseSell_ = 0.0;
+    cumBuy_ = cumSell_ = 0.0;
+    lastSide_ = TradeSide::UNKNOWN;
     currentBucketVolume_ = 0.0;
     currentBucketBuyVolume_ = 0.0;
-    isCurrentBucketBuy_ = true;
+    lastPriceChange_ = 0.0;
+    hasPriceChange_ = false;
+    updates_ = 0;
     lastPrice_ = 0.0;
     lastMidPrice_ = 0.0;
+    lastBid_ = 0.0;
+    lastAsk_ = 0.0;
     cumulativeVolume_ = 0.0;
     cumulativeBuyVolume_ = 0.0;
     cumulativeSellVolume_ = 0.0;
 }
 
-void MicrostructureAnalyzer::updateVPINBuckets(const TradeClassification& trade) {
-    double vol = std::abs(trade.signedVolume);
-    currentBucketVolume_ += vol;
+void MicrostructureAnalyzer::saveState(SnapshotWriter& out) const {
+    out.write(static_cast<uint64_t>(bucketSize_));
+    out.write(static_cast<uint64_t>(vpinWindow_));
+    out.write(static_cast<uint64_t>(impactWindow_));
+
+    out.write(classifiedTrades_);
+    out.write(baseBuy_);
+    out.write(baseSell_);
+    out.write(cumBuy_);
+    out.write(cumSell_);
+    out.write(lastSide_);
+
+    bucketImbalances_.saveState(out);
+    out.write(currentBucketVolume_);
+    out.write(currentBucketBuyVolume_);
+
+    out.write(impact_);
+    out.write(impactSums_);
+    rollProducts_.saveState(out);
+    out.write(lastPriceChange_);
+    out.write(hasPriceChange_);
+    out.write(updates_);
+
+    out.write(lastPrice_);
+    out.write(lastMidPrice_);
+    out.write(lastBid_);
+    out.write(lastAsk_);
+    out.write(cumulativeVolume_);
+    out.write(cumulativeBuyVolume_);
+    out.write(cumulativeSellVolume_);
+}
 
+void MicrostructureAnalyzer::loadState(SnapshotReader& in) {
+    in.expect(static_cast<uint64_t>(bucketSize_), "VPIN bucket size changed");
+    in.expect(static_cast<uint64_t>(vpinWindow_), "VPIN window changed");
+    in.expect(static_cast<uint64_t>(impactWindow_), "impact window changed");
+
+    in.read(classifiedTrades_);
+    in.read(baseBuy_);
+    in.read(baseSell_);
+    in.read(cumBuy_);
+    in.read(cumSell_);
+    in.read(lastSide_);
+
+    bucketImbalances_.loadState(in);
+    in.read(currentBucketVolume_);
+    in.read(currentBucketBuyVolume_);
+
+    in.read(impact_);
+    in.read(impactSums_);
+    rollProducts_.loadState(in);
+    in.read(lastPriceChange_);
+    in.read(hasPriceChange_);
+    in.read(updates_);
+
+    in.read(lastPrice_);
+    in.read(lastMidPrice_);
+    in.read(lastBid_);
+    in.read(lastAsk_);
+    in.read(cumulativeVolume_);
+    in.read(cumulativeBuyVolume_);
+    in.read(cumulativeSellVolume_);
+}
+
+void MicrostructureAnalyzer::recordTrade(const MarketTick& tick, const TradeClassification& trade) {
+    int sign = 0;
     if (trade.side == TradeSide::BUY) {
-        currentBucketBuyVolume_ += vol;
+        cumBuy_ += tick.volume;
+        sign = 1;
+    } else if (trade.side == TradeSide::SELL) {
+        cumSell_ += tick.volume;
+        sign = -1;
     }
 
-    // Check if bucket is full
-    if (currentBucketVolume_ >= bucketSize_) {
-        // Calculate imbalance for this bucket
-        double bucketImbalance = std::abs(2.0 * currentBucketBuyVolume_ - currentBucketVolume_);
-        volumeBuckets_.push_back(bucketImbalance);
+    ClassifiedTrade evicted;
+    if (classifiedTrades_.push(ClassifiedTrade{TradeRecord{tick.price, tick.volume, sign}, cumBuy_, cumSell_}, &evicted)) {
+        baseBuy_ = evicted.cumBuy;
+        baseSell_ = evicted.cumSell;
+    }
+    lastSide_ = trade.side;
 
-        // Keep only vpinWindow_ buckets
-        if (volumeBuckets_.size() > vpinWindow_) {
-            volumeBuckets_.pop_front();
+    // Rebase the running totals once per turn of the ring so they stay small
+    if (++updates_ % classifiedTrades_.capacity() == 0) {
+        for (size_t i = 0; i < classifiedTrades_.size(); ++i) {
+            classifiedTrades_[i].cumBuy -= baseBuy_;
+            classifiedTrades_[i].cumSell -= baseSell_;
         }
+        cumBuy_ -= baseBuy_;
+        cumSell_ -= baseSell_;
+        baseBuy_ = baseSell_ = 0.0;
+    }
+}
+
+void MicrostructureAnalyzer::recentFlow(size_t window, double& buyVol, double& sellVol) const {
+    size_t n = std::min(window, classifiedTrades_.size());
+    if (n == 0) {
+        buyVol = sellVol = 0.0;
+        return;
+    }
+
+    // Totals just before the first trade of the window
+    double startBuy = baseBuy_, startSell = baseSell_;
+    if (n < classifiedTrades_.size()) {
+        const auto& before = classifiedTrades_[classifiedTrades_.size() - n - 1];
+        startBuy = before.cumBuy;
+        startSell = before.cumSell;
+    }
+
+    buyVol = std::max(0.0, cumBuy_ - startBuy);
+    sellVol = std::max(0.0, cumSell_ - startSell);
+}
+
+void MicrostructureAnalyzer::updateVPINBuckets(const TradeClassification& trade) {
+    const double bucketVolume = static_cast<double>(bucketSize_);
+    if (bucketVolume <= 0.0) return;
+
+    double remaining = std::abs(trade.signedVolume);
+    const bool isBuy = trade.side == TradeSide::BUY;
+
+    // Top up the open bucket, splitting a trade that straddles its boundary
+    double fill = std::min(remaining, bucketVolume - currentBucketVolume_);
+    currentBucketVolume_ += fill;
+    if (isBuy) currentBucketBuyVolume_ += fill;
+    remaining -= fill;
+
+    if (currentBucketVolume_ < bucketVolume) return;
+
+    // Imbalance |buy - sell| for the completed bucket
+    bucketImbalances_.push(std::abs(2.0 * currentBucketBuyVolume_ - bucketVolume));
+    currentBucketVolume_ = 0.0;
+    currentBucketBuyVolume_ = 0.0;
 
-        // Reset bucket
-        currentBucketVolume_ = 0.0;
-        currentBucketBuyVolume_ = 0.0;
+    // Buckets filled entirely by this trade are one-sided (imbalance = bucket
+    // volume). A block trade can fill thousands; only the last vpinWindow_
+    // stay in the window, so push at most that many
+    double full = std::floor(remaining / bucketVolume);
+    remaining = std::max(0.0, remaining - full * bucketVolume);
+    if (remaining >= bucketVolume) {
+        full += 1.0;
+        remaining -= bucketVolume;
     }
+
+    const double pushes = std::min(full, static_cast<double>(vpinWindow_));
+    for (size_t i = 0; i < static_cast<size_t>(pushes); ++i) {
+        bucketImbalances_.push(bucketVolume);
+    }
+
+    // The rest opens the next bucket
+    currentBucketVolume_ = remaining;
+    if (isBuy) currentBucketBuyVolume_ = remaining;
 }
 
 void MicrostructureAnalyzer::updatePriceImpact(double priceChange, double signedVolume) {
-    priceChanges_.push_back(priceChange);
-    signedVolumes_.push_back(signedVolume);
+    std::pair<double, double> evicted;
+    if (impact_.push({priceChange, signedVolume}, &evicted)) {
+        impactSums_.add(evicted.first, evicted.second, -1.0);
+    }
+    impactSums_.add(priceChange, signedVolume, 1.0);
 
-    if (priceChanges_.size() > impactWindow_) {
-        priceChanges_.pop_front();
-        signedVolumes_.pop_front();
+    if (hasPriceChange_) {
+        rollProducts_.push(priceChange * lastPriceChange_);
     }
+    lastPriceChange_ = priceChange;
+    hasPriceChange_ = true;
+
+    if (updates_ % RESYNC_INTERVAL == 0) resyncImpact();
 }
 
-double MicrostructureAnalyzer::computeVPIN() const {
-    if (volumeBuckets_.size() < 2) return 0.0;
+void MicrostructureAnalyzer::resyncImpact() {
+    impactSums_ = ImpactSums();
+    for (size_t i = 0; i < impact_.size(); ++i) {
+        impactSums_.add(impact_[i].first, impact_[i].second, 1.0);
+    }
+}
 
-    // VPIN = Average(|BuyVolume - SellVolume|) / TotalVolume per bucket
-    double sumImbalance = std::accumulate(volumeBuckets_.begin(), volumeBuckets_.end(), 0.0);
-    double avgImbalance = sumImbalance / volumeBuckets_.size();
+double MicrostructureAnalyzer::computeVPIN() const {
+    if (bucketImbalances_.size() < 2) return 0.0;
 
-    // Normalize by bucket size
-    double vpin = avgImbalance / bucketSize_;
+    // VPIN = Average(|BuyVolume - SellVolume|) / bucket volume
+    double vpin = bucketImbalances_.mean() / bucketSize_;
 
     // Clamp to [0, 1]
     return std::min(std::max(vpin, 0.0), 1.0);
@@ -214,26 +357,18 @@ double MicrostructureAnalyzer::computeVPIN() const {
 HasbrouckMetrics MicrostructureAnalyzer::estimatePriceImpact() const {
     HasbrouckMetrics metrics{0.0, 0.0, 0.0, 0.0};
 
-    if (priceChanges_.size() < 10 || signedVolumes_.size() < 10) {
+    if (impact_.size() < 10) {
         return metrics;
     }
 
     // Kyle's Lambda: λ = Cov(ΔP, SignedVolume) / Var(SignedVolume)
-    // OLS: regress price changes on signed volumes
-
-    size_t n = priceChanges_.size();
-    double meanPriceChange = std::accumulate(priceChanges_.begin(), priceChanges_.end(), 0.0) / n;
-    double meanSignedVol = std::accumulate(signedVolumes_.begin(), signedVolumes_.end(), 0.0) / n;
+    // OLS slope from the running sums over the impact window
+    double n = static_cast<double>(impact_.size());
+    double meanPriceChange = impactSums_.dp / n;
+    double meanSignedVol = impactSums_.sv / n;
 
-    double covariance = 0.0;
-    double variance = 0.0;
-
-    for (size_t i = 0; i < n; ++i) {
-        double dpDev = priceChanges_[i] - meanPriceChange;
-        double volDev = signedVolumes_[i] - meanSignedVol;
-        covariance += dpDev * volDev;
-        variance += volDev * volDev;
-    }
+    double covariance = impactSums_.dpSv - n * meanPriceChange * meanSignedVol;
+    double variance = impactSums_.sv2 - n * meanSignedVol * meanSignedVol;
 
     if (variance > 1e-10) {
         metrics.lambda = covariance / variance;
@@ -259,8 +394,7 @@ TradeSide MicrostructureAnalyzer::inferTradeSide(double price) const {
         return TradeSide::SELL;
     } else {
         // Price unchanged - look at previous direction (zero-tick rule)
-        if (classifiedTrades_.empty()) return TradeSide::UNKNOWN;
-        return classifiedTrades_.back().side;
+        return lastSide_;
     }
 }
 
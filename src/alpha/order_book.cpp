@@ -0,0 +1,115 @@
+#include "alpha/order_book.h"
+#include <algorithm>
+
+namespace {
+
+// Levels sorted worst first; better(a, b) is true when price a is nearer the touch
+template <typename Better>
+void setLevel(std::vector<OrderBookLevel>& levels, double price, double size, Better better) {
+    auto it = std::lower_bound(levels.begin(), levels.end(), price,
+                               [&](const OrderBookLevel& level, double p) { return better(p, level.price); });
+
+    bool exists = it != levels.end() && it->price == price;
+    if (size <= 0.0) {
+        if (exists) levels.erase(it);
+    } else if (exists) {
+        it->volume = size;
+    } else {
+        levels.insert(it, OrderBookLevel{price, size});
+    }
+}
+
+template <typename Better>
+void loadSide(std::vector<OrderBookLevel>& levels, const std::vector<OrderBookLevel>& source, Better better) {
+    levels.clear();
+    for (const auto& level : source) {
+        if (level.volume > 0.0) levels.push_back(level);
+    }
+    std::sort(levels.begin(), levels.end(),
+              [&](const OrderBookLevel& a, const OrderBookLevel& b) { return better(b.price, a.price); });
+
+    // A snapshot should not repeat a price; keep the last one if it does
+    auto last = std::unique(levels.rbegin(), levels.rend(),
+                            [](const OrderBookLevel& a, const OrderBookLevel& b) { return a.price == b.price; });
+    levels.erase(levels.begin(), last.base());
+}
+
+const auto bidBetter = [](double a, double b) { return a > b; };
+const auto askBetter = [](double a, double b) { return a < b; };
+
+}
+
+OrderBook::OrderBook(size_t reserveLevels)
+    : updates_(0) {
+    bids_.reserve(reserveLevels);
+    asks_.reserve(reserveLevels);
+}
+
+bool OrderBook::apply(BookSide side, double price, double size) {
+    TopOfBook before = top();
+
+    if (side == BookSide::BID) {
+        setLevel(bids_, price, size, bidBetter);
+    } else {
+        setLevel(asks_, price, size, askBetter);
+    }
+    ++updates_;
+
+    TopOfBook after = top();
+    return after.bidPrice != before.bidPrice || after.bidSize != before.bidSize ||
+           after.askPrice != before.askPrice || after.askSize != before.askSize;
+}
+
+void OrderBook::loadSnapshot(const std::vector<OrderBookLevel>& bids,
+                             const std::vector<OrderBookLevel>& asks) {
+    loadSide(bids_, bids, bidBetter);
+    loadSide(asks_, asks, askBetter);
+    ++updates_;
+}
+
+void OrderBook::clear() {
+    bids_.clear();
+    asks_.clear();
+}
+
+TopOfBook OrderBook::top() const {
+    TopOfBook t{0.0, 0.0, 0.0, 0.0};
+    if (!bids_.empty()) {
+        t.bidPrice = bids_.back().price;
+        t.bidSize = bids_.back().volume;
+    }
+    if (!asks_.empty()) {
+        t.askPrice = asks_.back().price;
+        t.askSize = asks_.back().volume;
+    }
+    return t;
+}
+
+double OrderBook::midPrice() const {
+    if (!hasTop()) return 0.0;
+    return (bids_.back().price + asks_.back().price) / 2.0;
+}
+
+double OrderBook::spread() const {
+    if (!hasTop()) return 0.0;
+    return asks_.back().price - bids_.back().price;
+}
+
+void OrderBook::depth(size_t levels, OrderBookSnapshot& out) const {
+    out.bids.clear();
+    out.asks.clear();
+
+    size_t nb = std::min(levels, bids_.size());
+    size_t na = std::min(levels, asks_.size());
+    out.bids.insert(out.bids.end(), bids_.rbegin(), bids_.rbegin() + nb);
+    out.asks.insert(out.asks.end(), asks_.rbegin(), asks_.rbegin() + na);
+}
+
+double OrderBook::depthImbalance(size_t levels) const {
+    double bidSize = 0.0, askSize = 0.0;
+    for (size_t i = 0; i < std::min(levels, bids_.size()); ++i) bidSize += bids_[bids_.size() - 1 - i].volume;
+    for (size_t i = 0; i < std::min(levels, asks_.size()); ++i) askSize += asks_[asks_.size() - 1 - i].volume;
+
+    double total = bidSize + askSize;
+    return total > 0.0 ? (bidSize - askSize) / total : 0.0;
+}
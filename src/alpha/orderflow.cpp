@@ -1,38 +1,66 @@
 #include "alpha/orderflow.h"
 #include <algorithm>
-#include <numeric>
-
-OrderFlowImbalance::OrderFlowImbalance(size_t window) : window_(window) {}
+#include <cmath>
+
+OrderFlowImbalance::OrderFlowImbalance(size_t window)
+    : window_(window),
+      halfWindow_(window / 2),
+      trades_(window),
+      largeCount_(0),
+      medianVolume_(0.5),
+      referenceMedian_(0.0),
+      lastTimestamp_(0),
+      updates_(0) {}
 
 void OrderFlowImbalance::onTrade(double price, double volume, bool isBuy, long timestamp) {
-    if (isBuy) {
-        buyVolumes_.push_back(volume);
-        buyPrices_.push_back(price);
-    } else {
-        sellVolumes_.push_back(volume);
-        sellPrices_.push_back(price);
+    (void)price;
+
+    // Flag large trades on arrival against the median size of the last
+    // complete block of window_ trades (the block so far until one completes).
+    // P-square has no deletions, so the estimator restarts every block rather
+    // than drifting toward the median of the whole stream.
+    double median = updates_ >= window_ ? referenceMedian_ : medianVolume_.value();
+    bool isLarge = updates_ > 0 && volume > median * 1.5;
+    medianVolume_.add(volume);
+    if (medianVolume_.count() >= window_) {
+        referenceMedian_ = medianVolume_.value();
+        medianVolume_.reset();
     }
-    timestamps_.push_back(timestamp);
 
-    // Maintain window
-    while (buyVolumes_.size() + sellVolumes_.size() > window_) {
-        if (!buyVolumes_.empty()) {
-            buyVolumes_.pop_front();
-            buyPrices_.pop_front();
-        }
-        if (!sellVolumes_.empty()) {
-            sellVolumes_.pop_front();
-            sellPrices_.pop_front();
-        }
-        if (!timestamps_.empty()) {
-            timestamps_.pop_front();
+    Trade trade{volume, isBuy, isLarge};
+    Trade evicted;
+
+    if (trades_.push(trade, &evicted)) {
+        (halfWindow_ > 0 ? old_ : recent_).add(evicted, -1.0);
+        if (evicted.isLarge) --largeCount_;
+
+        // Indices shifted down by one: the trade now at halfWindow_ - 1 crossed into the old half
+        if (halfWindow_ > 0 && halfWindow_ < trades_.size()) {
+            const Trade& crossed = trades_[halfWindow_ - 1];
+            recent_.add(crossed, -1.0);
+            old_.add(crossed, 1.0);
         }
     }
+
+    (trades_.size() > halfWindow_ ? recent_ : old_).add(trade, 1.0);
+    if (isLarge) ++largeCount_;
+
+    lastTimestamp_ = timestamp;
+
+    if (++updates_ % RESYNC_INTERVAL == 0) resync();
+}
+
+void OrderFlowImbalance::resync() {
+    old_ = FlowSums();
+    recent_ = FlowSums();
+    for (size_t i = 0; i < trades_.size(); ++i) {
+        (i < halfWindow_ ? old_ : recent_).add(trades_[i], 1.0);
+    }
 }
 
 double OrderFlowImbalance::computeImbalance() const {
-    double buyVol = std::accumulate(buyVolumes_.begin(), buyVolumes_.end(), 0.0);
-    double sellVol = std::accumulate(sellVolumes_.begin(), sellVolumes_.end(), 0.0);
+    double buyVol = old_.buy + recent_.buy;
+    double sellVol = old_.sell + recent_.sell;
     double totalVol = buyVol + sellVol;
 
     if (totalVol < 1e-10) return 0.0;
@@ -42,56 +70,19 @@ double OrderFlowImbalance::computeImbalance() const {
 }
 
 double OrderFlowImbalance::computeAggression() const {
-    std::vector<double> allVolumes;
-    allVolumes.insert(allVolumes.end(), buyVolumes_.begin(), buyVolumes_.end());
-    allVolumes.insert(allVolumes.end(), sellVolumes_.begin(), sellVolumes_.end());
-
-    if (allVolumes.empty()) return 0.0;
-
-    std::sort(allVolumes.begin(), allVolumes.end());
-    double median = allVolumes[allVolumes.size() / 2];
-    double threshold = median * 1.5;
-
-    size_t largeCount = std::count_if(allVolumes.begin(), allVolumes.end(),
-                                     [threshold](double v) { return v > threshold; });
-
-    return static_cast<double>(largeCount) / allVolumes.size();
+    if (trades_.empty()) return 0.0;
+    return static_cast<double>(largeCount_) / trades_.size();
 }
 
 double OrderFlowImbalance::computeMomentum() const {
-    if (timestamps_.size() < 2) return 0.0;
-
-    size_t halfWindow = window_ / 2;
+    if (trades_.size() < 2) return 0.0;
 
-    double recentBuy = 0.0, recentSell = 0.0;
-    double oldBuy = 0.0, oldSell = 0.0;
-
-    size_t buyIdx = 0, sellIdx = 0;
-    for (size_t i = 0; i < timestamps_.size(); ++i) {
-        bool isRecent = (i >= halfWindow);
-
-        if (buyIdx < buyVolumes_.size()) {
-            if (isRecent) recentBuy += buyVolumes_[buyIdx];
-            else oldBuy += buyVolumes_[buyIdx];
-            buyIdx++;
-        }
-        if (sellIdx < sellVolumes_.size()) {
-            if (isRecent) recentSell += sellVolumes_[sellIdx];
-            else oldSell += sellVolumes_[sellIdx];
-            sellIdx++;
-        }
-    }
-
-    double recentImb = (recentBuy + recentSell > 0) ?
-                       (recentBuy - recentSell) / (recentBuy + recentSell) : 0.0;
-    double oldImb = (oldBuy + oldSell > 0) ?
-                    (oldBuy - oldSell) / (oldBuy + oldSell) : 0.0;
-
-    return recentImb - oldImb;
+    // Imbalance of the recent half minus the older half
+    return recent_.imbalance() - old_.imbalance();
 }
 
 std::optional<OFIResult> OrderFlowImbalance::getOFI() const {
-    if (buyVolumes_.empty() && sellVolumes_.empty()) {
+    if (trades_.empty()) {
         return std::nullopt;
     }
 
@@ -99,16 +90,14 @@ std::optional<OFIResult> OrderFlowImbalance::getOFI() const {
     double aggression = computeAggression();
     double momentum = computeMomentum();
 
-    double buyVol = std::accumulate(buyVolumes_.begin(), buyVolumes_.end(), 0.0);
-    double sellVol = std::accumulate(sellVolumes_.begin(), sellVolumes_.end(), 0.0);
+    double buyVol = old_.buy + recent_.buy;
+    double sellVol = old_.sell + recent_.sell;
     double totalVol = buyVol + sellVol;
 
     double bidPressure = (totalVol > 0) ? buyVol / totalVol : 0.5;
     double askPressure = (totalVol > 0) ? sellVol / totalVol : 0.5;
 
-    long timestamp = timestamps_.empty() ? 0 : timestamps_.back();
-
-    return OFIResult{imbalance, bidPressure, askPressure, aggression, momentum, timestamp};
+    return OFIResult{imbalance, bidPressure, askPressure, aggression, momentum, lastTimestamp_};
 }
 
 bool OrderFlowImbalance::isExtremeImbalance(double threshold) const {
@@ -116,22 +105,59 @@ bool OrderFlowImbalance::isExtremeImbalance(double threshold) const {
     return std::abs(imb) > threshold;
 }
 
-BidAskPressure::BidAskPressure(size_t window) : window_(window) {}
+QuoteOFI::QuoteOFI(size_t window)
+    : events_(window),
+      depth_(window),
+      lastBidPrice_(0.0),
+      lastBidSize_(0.0),
+      lastAskPrice_(0.0),
+      lastAskSize_(0.0),
+      hasLast_(false) {}
+
+void QuoteOFI::onQuote(double bidPrice, double bidSize, double askPrice, double askSize) {
+    if (hasLast_) {
+        double e = 0.0;
+        if (bidPrice >= lastBidPrice_) e += bidSize;
+        if (bidPrice <= lastBidPrice_) e -= lastBidSize_;
+        if (askPrice <= lastAskPrice_) e -= askSize;
+        if (askPrice >= lastAskPrice_) e += lastAskSize_;
+
+        events_.push(e);
+        depth_.push(0.5 * (bidSize + askSize));
+    }
+
+    lastBidPrice_ = bidPrice;
+    lastBidSize_ = bidSize;
+    lastAskPrice_ = askPrice;
+    lastAskSize_ = askSize;
+    hasLast_ = true;
+}
+
+double QuoteOFI::normalized() const {
+    double depth = depth_.mean();
+    return depth > 0.0 ? events_.sum() / depth : 0.0;
+}
+
+void QuoteOFI::reset() {
+    events_.clear();
+    depth_.clear();
+    hasLast_ = false;
+}
+
+BidAskPressure::BidAskPressure(size_t window)
+    : window_(window), bidVolumes_(window), askVolumes_(window) {}
 
 void BidAskPressure::onTrade(bool isBuy, double volume) {
     if (isBuy) {
-        bidVolumes_.push_back(volume);
+        bidVolumes_.push(volume);
     } else {
-        askVolumes_.push_back(volume);
+        askVolumes_.push(volume);
     }
-
-    while (bidVolumes_.size() > window_) bidVolumes_.pop_front();
-    while (askVolumes_.size() > window_) askVolumes_.pop_front();
 }
 
 PressureResult BidAskPressure::getPressure() const {
-    double bidVol = std::accumulate(bidVolumes_.begin(), bidVolumes_.end(), 0.0);
-    double askVol = std::accumulate(askVolumes_.begin(), askVolumes_.end(), 0.0);
+    double bidVol = bidVolumes_.sum();
+    double askVol = askVolumes_.sum();
     double total = bidVol + askVol;
 
     double ratio = (total > 0) ? (bidVol - askVol) / total : 0.0;
@@ -140,7 +166,8 @@ PressureResult BidAskPressure::getPressure() const {
     return PressureResult{bidVol, askVol, ratio, dominant};
 }
 
-TradeAggression::TradeAggression(size_t window) : window_(window) {}
+TradeAggression::TradeAggression(size_t window)
+    : window_(window), aggressionScores_(window) {}
 
 void TradeAggression::onTrade(double volume, double avgVolume, bool isBuy) {
     // Aggression score: how much larger than average
@@ -149,34 +176,23 @@ void TradeAggression::onTrade(double volume, double avgVolume, bool isBuy) {
     // Sign: positive for buys, negative for sells
     score = isBuy ? score : -score;
 
-    aggressionScores_.push_back(score);
-
-    if (aggressionScores_.size() > window_) {
-        aggressionScores_.pop_front();
-    }
+    aggressionScores_.push(score);
 }
 
 double TradeAggression::getAggression() const {
-    if (aggressionScores_.empty()) return 0.0;
-
-    double sum = std::accumulate(aggressionScores_.begin(), aggressionScores_.end(), 0.0);
-    return sum / aggressionScores_.size();
+    return aggressionScores_.mean();
 }
 
-VolumeDelta::VolumeDelta() : cumulativeDelta_(0.0) {}
+VolumeDelta::VolumeDelta() : cumulativeDelta_(0.0), recentDeltas_(RECENT_WINDOW) {}
 
 void VolumeDelta::onTrade(double volume, bool isBuy) {
     double delta = isBuy ? volume : -volume;
     cumulativeDelta_ += delta;
-    recentDeltas_.push_back(delta);
-
-    if (recentDeltas_.size() > RECENT_WINDOW) {
-        recentDeltas_.pop_front();
-    }
+    recentDeltas_.push(delta);
 }
 
 double VolumeDelta::getRecentDelta() const {
-    return std::accumulate(recentDeltas_.begin(), recentDeltas_.end(), 0.0);
+    return recentDeltas_.sum();
 }
 
 void VolumeDelta::reset() {
@@ -240,7 +256,7 @@ std::optional<OrderFlowSignal> OrderFlowEngine::onTick(const MarketTick& tick, b
     toxicity_.update(ofiResult->imbalance, pressureResult.imbalanceRatio, aggrScore);
     auto toxScore = toxicity_.getScore();
 
-    std::string flowDir = determineFlowDirection(ofiResult->imbalance, pressureResult.imbalanceRatio);
+    FlowDirection flowDir = determineFlowDirection(ofiResult->imbalance, pressureResult.imbalanceRatio);
 
     return OrderFlowSignal{
         ofiResult->imbalance,
@@ -255,16 +271,120 @@ std::optional<OrderFlowSignal> OrderFlowEngine::onTick(const MarketTick& tick, b
     };
 }
 
-std::string OrderFlowEngine::determineFlowDirection(double ofi, double pressure) const {
+FlowDirection OrderFlowEngine::determineFlowDirection(double ofi, double pressure) const {
     double combined = (ofi + pressure) / 2.0;
 
-    if (combined > 0.2) return "BUY_DOMINANT";
-    if (combined < -0.2) return "SELL_DOMINANT";
-    return "NEUTRAL";
+    if (combined > 0.2) return FlowDirection::BUY_DOMINANT;
+    if (combined < -0.2) return FlowDirection::SELL_DOMINANT;
+    return FlowDirection::NEUTRAL;
 }
 
 void OrderFlowEngine::reset() {
     volumeDelta_.reset();
     avgVolume_ = 0.0;
     tickCount_ = 0;
-}
\ No newline at end of file
+}
+
+// === Snapshots ===
+void OrderFlowImbalance::saveState(SnapshotWriter& out) const {
+    out.write(static_cast<uint64_t>(window_));
+    out.write(trades_);
+    out.write(old_);
+    out.write(recent_);
+    out.write(static_cast<uint64_t>(largeCount_));
+    medianVolume_.saveState(out);
+    out.write(referenceMedian_);
+    out.write(static_cast<int64_t>(lastTimestamp_));
+    out.write(updates_);
+}
+
+void OrderFlowImbalance::loadState(SnapshotReader& in) {
+    in.expect(static_cast<uint64_t>(window_), "OFI window changed");
+    in.read(trades_);
+    in.read(old_);
+    in.read(recent_);
+    largeCount_ = static_cast<size_t>(in.read<uint64_t>());
+    medianVolume_.loadState(in);
+    in.read(referenceMedian_);
+    lastTimestamp_ = static_cast<long>(in.read<int64_t>());
+    in.read(updates_);
+}
+
+void QuoteOFI::saveState(SnapshotWriter& out) const {
+    events_.saveState(out);
+    depth_.saveState(out);
+    out.write(lastBidPrice_);
+    out.write(lastBidSize_);
+    out.write(lastAskPrice_);
+    out.write(lastAskSize_);
+    out.write(hasLast_);
+}
+
+void QuoteOFI::loadState(SnapshotReader& in) {
+    events_.loadState(in);
+    depth_.loadState(in);
+    in.read(lastBidPrice_);
+    in.read(lastBidSize_);
+    in.read(lastAskPrice_);
+    in.read(lastAskSize_);
+    in.read(hasLast_);
+}
+
+void BidAskPressure::saveState(SnapshotWriter& out) const {
+    bidVolumes_.saveState(out);
+    askVolumes_.saveState(out);
+}
+
+void BidAskPressure::loadState(SnapshotReader& in) {
+    bidVolumes_.loadState(in);
+    askVolumes_.loadState(in);
+}
+
+void TradeAggression::saveState(SnapshotWriter& out) const {
+    aggressionScores_.saveState(out);
+}
+
+void TradeAggression::loadState(SnapshotReader& in) {
+    aggressionScores_.loadState(in);
+}
+
+void VolumeDelta::saveState(SnapshotWriter& out) const {
+    out.write(cumulativeDelta_);
+    recentDeltas_.saveState(out);
+}
+
+void VolumeDelta::loadState(SnapshotReader& in) {
+    in.read(cumulativeDelta_);
+    recentDeltas_.loadState(in);
+}
+
+// Weights and threshold are configuration; only the last score is state
+void FlowToxicity::saveState(SnapshotWriter& out) const {
+    out.write(threshold_);
+    out.write(toxicity_);
+}
+
+void FlowToxicity::loadState(SnapshotReader& in) {
+    in.expect(threshold_, "toxicity threshold changed");
+    in.read(toxicity_);
+}
+
+void OrderFlowEngine::saveState(SnapshotWriter& out) const {
+    ofi_.saveState(out);
+    pressure_.saveState(out);
+    aggression_.saveState(out);
+    volumeDelta_.saveState(out);
+    toxicity_.saveState(out);
+    out.write(avgVolume_);
+    out.write(static_cast<uint64_t>(tickCount_));
+}
+
+void OrderFlowEngine::loadState(SnapshotReader& in) {
+    ofi_.loadState(in);
+    pressure_.loadState(in);
+    aggression_.loadState(in);
+    volumeDelta_.loadState(in);
+    toxicity_.loadState(in);
+    in.read(avgVolume_);
+    tickCount_ = static_cast<size_t>(in.read<uint64_t>());
+}
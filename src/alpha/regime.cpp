@@ -1,78 +1,78 @@
 #include "alpha/regime.h"
 #include <algorithm>
 #include <numeric>
+#include <cmath>
+#include <limits>
 
-RegimeDetector::RegimeDetector(size_t window, size_t hurstLag, size_t volWindow)
+RegimeDetector::RegimeDetector(size_t window, size_t hurstLag, size_t volWindow,
+                               size_t hurstInterval, HurstMethod hurstMethod)
     : window_(window),
       hurstLag_(hurstLag),
       volWindow_(volWindow),
+      hurstInterval_(std::max<size_t>(1, hurstInterval)),
+      hurstMethod_(hurstMethod),
+      prices_(window),
+      returns_(window),
+      volumes_(window),
       currentRegime_(MarketRegime::UNKNOWN),
+      regimeHistory_(REGIME_HISTORY),
       hurstExponent_(0.5),
       autocorrelation_(0.0),
       volatility_(0.0),
-      trendStrength_(0.0) {}
-
-void RegimeDetector::onTick(const MarketTick& tick) {
-    prices_.push_back(tick.price);
-    volumes_.push_back(tick.volume);
-
-    if (prices_.size() > window_) {
-        prices_.pop_front();
-        volumes_.pop_front();
+      trendStrength_(0.0),
+      hurstAge_(0),
+      hurstValid_(false) {
+    priceScratch_.reserve(window_);
+    returnScratch_.reserve(window_);
+
+    if (hurstMethod_ == HurstMethod::AGGREGATED_VARIANCE) {
+        for (size_t m = 1; m <= hurstLag_ && m < window_; m *= 2) {
+            aggLevels_.push_back(m);
+            aggVariance_.emplace_back(window_);
+        }
     }
+}
+
+void RegimeDetector::pushPrice(double price, double volume) {
+    // Full windows drop their oldest element on push
+    prices_.push(price);
+    volumes_.push(volume);
 
     // Calculate returns
     if (prices_.size() >= 2) {
-        double ret = std::log(prices_.back() / prices_[prices_.size() - 2]);
-        returns_.push_back(ret);
+        returns_.push(std::log(prices_.back() / prices_[prices_.size() - 2]));
+    }
 
-        if (returns_.size() > window_) {
-            returns_.pop_front();
-        }
+    if (hurstMethod_ == HurstMethod::AGGREGATED_VARIANCE) {
+        updateAggregatedVariance();
     }
 
-    // Update metrics if we have enough data
+    ++hurstAge_;
+}
+
+void RegimeDetector::onTick(const MarketTick& tick) {
+    pushPrice(tick.price, tick.volume);
+
+    // Update metrics if we have enough data; R/S Hurst only every hurstInterval_ ticks
     if (prices_.size() >= hurstLag_ * 2) {
-        updateMetrics();
+        updateMetrics(!hurstValid_ || hurstAge_ >= hurstInterval_);
 
         MarketRegime newRegime = classifyRegime();
         if (newRegime != currentRegime_) {
             currentRegime_ = newRegime;
-            regimeHistory_.push_back(newRegime);
-
-            if (regimeHistory_.size() > 50) {
-                regimeHistory_.pop_front();
-            }
+            regimeHistory_.push(newRegime);
         }
     }
 }
 
 void RegimeDetector::onCandle(const Candle& candle) {
-    prices_.push_back(candle.close);
-    volumes_.push_back(candle.volume);
-
-    if (prices_.size() > window_) {
-        prices_.pop_front();
-        volumes_.pop_front();
-    }
-
-    if (prices_.size() >= 2) {
-        double ret = std::log(prices_.back() / prices_[prices_.size() - 2]);
-        returns_.push_back(ret);
-
-        if (returns_.size() > window_) {
-            returns_.pop_front();
-        }
-    }
+    pushPrice(candle.close, candle.volume);
 
+    // Candle close always refreshes Hurst
     if (prices_.size() >= hurstLag_ * 2) {
-        updateMetrics();
+        updateMetrics(true);
         currentRegime_ = classifyRegime();
-        regimeHistory_.push_back(currentRegime_);
-
-        if (regimeHistory_.size() > 50) {
-            regimeHistory_.pop_front();
-        }
+        regimeHistory_.push(currentRegime_);
     }
 }
 
@@ -84,6 +84,7 @@ RegimeMetrics RegimeDetector::getMetrics() const {
     metrics.volatility = volatility_;
     metrics.volRegime = computeVolatilityRegime();
     metrics.trendStrength = trendStrength_;
+    metrics.hurstAgeTicks = hurstAge_;
 
     // Confidence based on stability of regime
     if (regimeHistory_.size() < 5) {
@@ -137,11 +138,63 @@ void RegimeDetector::reset() {
     autocorrelation_ = 0.0;
     volatility_ = 0.0;
     trendStrength_ = 0.0;
+    hurstAge_ = 0;
+    hurstValid_ = false;
+    for (auto& stats : aggVariance_) stats.clear();
+}
+
+void RegimeDetector::saveState(SnapshotWriter& out) const {
+    out.write(static_cast<uint64_t>(window_));
+    out.write(static_cast<uint64_t>(hurstLag_));
+    out.write(static_cast<uint64_t>(volWindow_));
+    out.write(static_cast<uint64_t>(hurstInterval_));
+    out.write(hurstMethod_);
+
+    out.write(prices_);
+    out.write(returns_);
+    out.write(volumes_);
+    out.write(currentRegime_);
+    out.write(regimeHistory_);
+
+    out.write(hurstExponent_);
+    out.write(autocorrelation_);
+    out.write(volatility_);
+    out.write(trendStrength_);
+    out.write(static_cast<uint64_t>(hurstAge_));
+    out.write(hurstValid_);
+    for (const auto& stats : aggVariance_) stats.saveState(out);
 }
 
+void RegimeDetector::loadState(SnapshotReader& in) {
+    in.expect(static_cast<uint64_t>(window_), "regime window changed");
+    in.expect(static_cast<uint64_t>(hurstLag_), "Hurst lag changed");
+    in.expect(static_cast<uint64_t>(volWindow_), "volatility window changed");
+    in.expect(static_cast<uint64_t>(hurstInterval_), "Hurst interval changed");
+    in.expect(hurstMethod_, "Hurst method changed");
+
+    in.read(prices_);
+    in.read(returns_);
+    in.read(volumes_);
+    in.read(currentRegime_);
+    in.read(regimeHistory_);
+
+    in.read(hurstExponent_);
+    in.read(autocorrelation_);
+    in.read(volatility_);
+    in.read(trendStrength_);
+    hurstAge_ = static_cast<size_t>(in.read<uint64_t>());
+    in.read(hurstValid_);
+    for (auto& stats : aggVariance_) stats.loadState(in);
+}
+
+void RegimeDetector::updateMetrics(bool refreshHurst) {
+    // The aggregated-variance estimate is cheap enough to refresh on every update
+    if (refreshHurst || hurstMethod_ == HurstMethod::AGGREGATED_VARIANCE) {
+        hurstExponent_ = computeHurstExponent();
+        hurstAge_ = 0;
+        hurstValid_ = true;
+    }
 
-void RegimeDetector::updateMetrics() {
-    hurstExponent_ = computeHurstExponent();
     autocorrelation_ = computeAutocorrelation(1);
     volatility_ = computeRealizedVolatility();
     trendStrength_ = computeTrendStrength();
@@ -163,18 +216,67 @@ MarketRegime RegimeDetector::classifyRegime() const {
     }
 }
 
-double RegimeDetector::computeHurstExponent() const {
+double RegimeDetector::computeHurstExponent() {
     if (prices_.size() < hurstLag_ * 2) return 0.5;
 
-    std::vector<double> priceVec(prices_.begin(), prices_.end());
-    return regime::hurstExponent(priceVec, hurstLag_);
+    if (hurstMethod_ == HurstMethod::AGGREGATED_VARIANCE) {
+        return aggregatedVarianceHurst();
+    }
+
+    // copyTo() reuses the reserved capacity
+    prices_.copyTo(priceScratch_);
+    return regime::hurstExponent(priceScratch_.data(), priceScratch_.size(), hurstLag_, hurstScratch_);
+}
+
+void RegimeDetector::updateAggregatedVariance() {
+    const size_t n = prices_.size();
+    const double last = prices_.back();
+    if (last <= 0.0) return;
+
+    for (size_t i = 0; i < aggLevels_.size(); ++i) {
+        const size_t m = aggLevels_[i];
+        if (n <= m) break;
+
+        const double past = prices_[n - 1 - m];
+        if (past > 0.0) {
+            aggVariance_[i].push(std::log(last / past));
+        }
+    }
 }
 
-double RegimeDetector::computeAutocorrelation(size_t lag) const {
+double RegimeDetector::aggregatedVarianceHurst() const {
+    // Var(m-period return) ~ m^(2H): regress log variance on log m
+    double sumX = 0.0, sumY = 0.0, sumXY = 0.0, sumX2 = 0.0;
+    size_t numLevels = 0;
+
+    for (size_t i = 0; i < aggLevels_.size(); ++i) {
+        if (aggVariance_[i].size() < 10) continue;
+
+        double var = aggVariance_[i].variance();
+        if (var <= 1e-20) continue;
+
+        double x = std::log(static_cast<double>(aggLevels_[i]));
+        double y = std::log(var);
+        sumX += x;
+        sumY += y;
+        sumXY += x * y;
+        sumX2 += x * x;
+        ++numLevels;
+    }
+
+    if (numLevels < 3) return 0.5;
+
+    double n = static_cast<double>(numLevels);
+    double slope = (n * sumXY - sumX * sumY) / (n * sumX2 - sumX * sumX);
+
+    return std::min(std::max(slope / 2.0, 0.0), 1.0);
+}
+
+double RegimeDetector::computeAutocorrelation(size_t lag) {
     if (returns_.size() < lag + 10) return 0.0;
 
-    std::vector<double> retVec(returns_.begin(), returns_.end());
-    return regime::autocorrelation(retVec, lag);
+    returns_.copyTo(returnScratch_);
+    return regime::autocorrelation(returnScratch_, lag);
 }
 
 double RegimeDetector::computeRealizedVolatility() const {
@@ -280,10 +382,16 @@ RegimeSignalWeights RegimeDetector::computeSignalWeights(MarketRegime regime) co
 namespace regime {
 
 double hurstExponent(const std::vector<double>& prices, size_t maxLag) {
-    if (prices.size() < maxLag * 2) return 0.5;
+    HurstScratch scratch;
+    return hurstExponent(prices.data(), prices.size(), maxLag, scratch);
+}
+
+double hurstExponent(const double* prices, size_t numPrices, size_t maxLag,
+                     HurstScratch& scratch) {
+    if (numPrices < maxLag * 2) return 0.5;
 
-    size_t numPrices = prices.size();
-    std::vector<double> logReturns;
+    std::vector<double>& logReturns = scratch.logReturns;
+    logReturns.clear();
     logReturns.reserve(numPrices - 1);
 
     for (size_t i = 1; i < numPrices; ++i) {
@@ -295,35 +403,37 @@ double hurstExponent(const std::vector<double>& prices, size_t maxLag) {
     if (logReturns.size() < maxLag) return 0.5;
 
     // R/S analysis: compute R/S for different lags
-    std::vector<double> logLags, logRS;
+    std::vector<double>& logLags = scratch.logLags;
+    std::vector<double>& logRS = scratch.logRS;
+    logLags.clear();
+    logRS.clear();
 
     for (size_t lag = 2; lag <= maxLag && lag <= logReturns.size() / 2; ++lag) {
         size_t numSegments = logReturns.size() / lag;
         double avgRS = 0.0;
 
         for (size_t seg = 0; seg < numSegments; ++seg) {
-            size_t start = seg * lag;
-            std::vector<double> segment(logReturns.begin() + start,
-                                       logReturns.begin() + start + lag);
+            const double* segment = logReturns.data() + seg * lag;
 
-            double mean = std::accumulate(segment.begin(), segment.end(), 0.0) / lag;
+            double mean = 0.0;
+            for (size_t i = 0; i < lag; ++i) mean += segment[i];
+            mean /= lag;
 
-            // Cumulative deviation
-            std::vector<double> cumDev(lag);
+            // Range of the cumulative deviation and the variance, in one pass
             double cumSum = 0.0;
+            double maxDev = -std::numeric_limits<double>::infinity();
+            double minDev = std::numeric_limits<double>::infinity();
+            double variance = 0.0;
+
             for (size_t i = 0; i < lag; ++i) {
-                cumSum += segment[i] - mean;
-                cumDev[i] = cumSum;
+                double dev = segment[i] - mean;
+                cumSum += dev;
+                maxDev = std::max(maxDev, cumSum);
+                minDev = std::min(minDev, cumSum);
+                variance += dev * dev;
             }
 
-            double R = *std::max_element(cumDev.begin(), cumDev.end()) -
-                      *std::min_element(cumDev.begin(), cumDev.end());
-
-            // Standard deviation
-            double variance = 0.0;
-            for (double x : segment) {
-                variance += (x - mean) * (x - mean);
-            }
+            double R = maxDev - minDev;
             double S = std::sqrt(variance / lag);
 
             if (S > 1e-10) {
@@ -341,7 +451,7 @@ double hurstExponent(const std::vector<double>& prices, size_t maxLag) {
     if (logLags.size() < 3) return 0.5;
 
     // Linear regression: log(R/S) = H * log(n) + c
-    double numLags = static_cast<double>(logLags.size());  
+    double numLags = static_cast<double>(logLags.size());
     double sumX = std::accumulate(logLags.begin(), logLags.end(), 0.0);
     double sumY = std::accumulate(logRS.begin(), logRS.end(), 0.0);
     double sumXY = 0.0, sumX2 = 0.0;
@@ -351,7 +461,7 @@ double hurstExponent(const std::vector<double>& prices, size_t maxLag) {
         sumX2 += logLags[i] * logLags[i];
     }
 
-    double H = (numLags * sumXY - sumX * sumY) / (numLags * sumX2 - sumX * sumX);  
+    double H = (numLags * sumXY - sumX * sumY) / (numLags * sumX2 - sumX * sumX);
 
     // Clamp to [0, 1]
     return std::min(std::max(H, 0.0), 1.0);
@@ -403,7 +513,7 @@ bool detectRegimeChange(const std::vector<double>& returns, double threshold) {
     return stddev > 1e-10 && (maxCusum / stddev) > threshold;
 }
 
-std::string regimeToString(MarketRegime regime) {
+const char* regimeToString(MarketRegime regime) {
     switch (regime) {
         case MarketRegime::TRENDING_HIGH_VOL: return "TRENDING_HIGH_VOL";
         case MarketRegime::TRENDING_LOW_VOL: return "TRENDING_LOW_VOL";
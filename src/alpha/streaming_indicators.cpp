@@ -0,0 +1,270 @@
+#include "alpha/streaming_indicators.h"
+#include <cmath>
+#include <algorithm>
+
+// === EMA ===
+StreamingEMA::StreamingEMA(int period)
+	: period_(static_cast<size_t>(std::max(1, period))),
+	  alpha_(2.0 / (std::max(1, period) + 1.0)),
+	  value_(0.0),
+	  count_(0) {}
+
+double StreamingEMA::update(double x) {
+	value_ = (count_ == 0) ? x : alpha_ * x + (1.0 - alpha_) * value_;
+	++count_;
+	return value_;
+}
+
+void StreamingEMA::reset() {
+	value_ = 0.0;
+	count_ = 0;
+}
+
+// === RSI (Wilder) ===
+StreamingRSI::StreamingRSI(int period)
+	: period_(static_cast<size_t>(std::max(1, period))),
+	  prevClose_(0.0),
+	  hasPrev_(false),
+	  changes_(0),
+	  avgGain_(0.0),
+	  avgLoss_(0.0) {}
+
+double StreamingRSI::update(double close) {
+	if (!hasPrev_) {
+		prevClose_ = close;
+		hasPrev_ = true;
+		return value();
+	}
+
+	double diff = close - prevClose_;
+	prevClose_ = close;
+
+	double gain = diff > 0 ? diff : 0.0;
+	double loss = diff < 0 ? -diff : 0.0;
+	double p = static_cast<double>(period_);
+
+	if (changes_ < period_) {
+		// Seed with the simple average of the first `period` changes
+		avgGain_ += gain / p;
+		avgLoss_ += loss / p;
+	} else {
+		avgGain_ = (avgGain_ * (p - 1.0) + gain) / p;
+		avgLoss_ = (avgLoss_ * (p - 1.0) + loss) / p;
+	}
+	++changes_;
+
+	return value();
+}
+
+double StreamingRSI::value() const {
+	if (!ready()) return 50.0;
+	if (avgLoss_ == 0.0) return 100.0;
+
+	const double rs = avgGain_ / avgLoss_;
+	return 100.0 - (100.0 / (1.0 + rs));
+}
+
+void StreamingRSI::reset() {
+	hasPrev_ = false;
+	changes_ = 0;
+	avgGain_ = avgLoss_ = 0.0;
+}
+
+void StreamingRSI::saveState(SnapshotWriter& out) const {
+	out.write(static_cast<uint64_t>(period_));
+	out.write(prevClose_);
+	out.write(hasPrev_);
+	out.write(static_cast<uint64_t>(changes_));
+	out.write(avgGain_);
+	out.write(avgLoss_);
+}
+
+void StreamingRSI::loadState(SnapshotReader& in) {
+	in.expect(static_cast<uint64_t>(period_), "RSI period changed");
+	in.read(prevClose_);
+	in.read(hasPrev_);
+	changes_ = static_cast<size_t>(in.read<uint64_t>());
+	in.read(avgGain_);
+	in.read(avgLoss_);
+}
+
+// === MACD ===
+StreamingMACD::StreamingMACD(int fastPeriod, int slowPeriod, int signalPeriod)
+	: fast_(fastPeriod),
+	  slow_(slowPeriod),
+	  signal_(signalPeriod),
+	  slowPeriod_(static_cast<size_t>(std::max(1, slowPeriod))),
+	  signalPeriod_(static_cast<size_t>(std::max(1, signalPeriod))),
+	  count_(0) {}
+
+MACDResult StreamingMACD::update(double close) {
+	double macd = fast_.update(close) - slow_.update(close);
+	++count_;
+
+	// The signal line only starts once the slow EMA has warmed up
+	if (count_ >= slowPeriod_) {
+		signal_.update(macd);
+	}
+
+	return value();
+}
+
+MACDResult StreamingMACD::value() const {
+	if (!ready()) return MACDResult{0.0, 0.0, 0.0};
+
+	double macd = fast_.value() - slow_.value();
+	return MACDResult{macd, signal_.value(), macd - signal_.value()};
+}
+
+bool StreamingMACD::ready() const {
+	return count_ >= slowPeriod_ + signalPeriod_;
+}
+
+void StreamingMACD::reset() {
+	fast_.reset();
+	slow_.reset();
+	signal_.reset();
+	count_ = 0;
+}
+
+// === ATR ===
+StreamingATR::StreamingATR(int period)
+	: trueRanges_(static_cast<size_t>(std::max(1, period))),
+	  prevClose_(0.0),
+	  hasPrev_(false) {}
+
+double StreamingATR::update(double high, double low, double close) {
+	if (hasPrev_) {
+		double tr1 = high - low;
+		double tr2 = std::abs(high - prevClose_);
+		double tr3 = std::abs(low - prevClose_);
+		trueRanges_.push(std::max({tr1, tr2, tr3}));
+	}
+
+	prevClose_ = close;
+	hasPrev_ = true;
+	return value();
+}
+
+void StreamingATR::reset() {
+	trueRanges_.clear();
+	hasPrev_ = false;
+}
+
+// === Sliding max / min ===
+MonotonicWindow::MonotonicWindow(size_t window, bool trackMax)
+	: window_(std::max<size_t>(1, window)),
+	  trackMax_(trackMax),
+	  index_(0),
+	  queue_(std::max<size_t>(1, window)) {}
+
+void MonotonicWindow::push(double x) {
+	// Expire the element that slid out of the window
+	if (!queue_.empty() && queue_.front().first + window_ <= index_) {
+		queue_.pop_front();
+	}
+
+	// Drop entries the new value dominates
+	while (!queue_.empty() && better(x, queue_.back().second)) {
+		queue_.pop_back();
+	}
+
+	queue_.push({index_, x});
+	++index_;
+}
+
+void MonotonicWindow::reset() {
+	queue_.clear();
+	index_ = 0;
+}
+
+// === Stochastic ===
+StreamingStochastic::StreamingStochastic(int period, int dPeriod)
+	: period_(static_cast<size_t>(std::max(1, period))),
+	  count_(0),
+	  highest_(static_cast<size_t>(std::max(1, period)), true),
+	  lowest_(static_cast<size_t>(std::max(1, period)), false),
+	  kValues_(static_cast<size_t>(std::max(1, dPeriod))),
+	  lastK_(50.0) {}
+
+StochasticResult StreamingStochastic::update(double high, double low, double close) {
+	highest_.push(high);
+	lowest_.push(low);
+	++count_;
+
+	if (!ready()) return value();
+
+	double hh = highest_.value();
+	double ll = lowest_.value();
+
+	// Flat range: neutral, as computeStochastic does
+	lastK_ = (hh != ll) ? 100.0 * (close - ll) / (hh - ll) : 50.0;
+	kValues_.push(lastK_);
+
+	return value();
+}
+
+StochasticResult StreamingStochastic::value() const {
+	if (!ready()) return StochasticResult{50.0, 50.0};
+	return StochasticResult{lastK_, kValues_.mean()};
+}
+
+void StreamingStochastic::reset() {
+	count_ = 0;
+	highest_.reset();
+	lowest_.reset();
+	kValues_.clear();
+	lastK_ = 50.0;
+}
+
+// === Volume ratio ===
+StreamingVolumeRatio::StreamingVolumeRatio(size_t window)
+	: window_(window),
+	  sumUp_(0.0),
+	  sumDown_(0.0),
+	  prevClose_(0.0),
+	  hasPrev_(false) {}
+
+double StreamingVolumeRatio::update(double close, double volume) {
+	if (hasPrev_) {
+		bool isUp = close > prevClose_;
+
+		std::pair<double, bool> evicted;
+		if (window_.push({volume, isUp}, &evicted)) {
+			(evicted.second ? sumUp_ : sumDown_) -= evicted.first;
+		}
+		(isUp ? sumUp_ : sumDown_) += volume;
+
+		// Guard against drift leaving tiny negative sums after evictions
+		if (sumUp_ < 0.0) sumUp_ = 0.0;
+		if (sumDown_ < 0.0) sumDown_ = 0.0;
+	}
+
+	prevClose_ = close;
+	hasPrev_ = true;
+	return value();
+}
+
+void StreamingVolumeRatio::reset() {
+	window_.clear();
+	sumUp_ = sumDown_ = 0.0;
+	hasPrev_ = false;
+}
+
+void StreamingVolumeRatio::saveState(SnapshotWriter& out) const {
+	out.write(static_cast<uint64_t>(window_.capacity()));
+	out.write(window_);
+	out.write(sumUp_);
+	out.write(sumDown_);
+	out.write(prevClose_);
+	out.write(hasPrev_);
+}
+
+void StreamingVolumeRatio::loadState(SnapshotReader& in) {
+	in.expect(static_cast<uint64_t>(window_.capacity()), "volume ratio window changed");
+	in.read(window_);
+	in.read(sumUp_);
+	in.read(sumDown_);
+	in.read(prevClose_);
+	in.read(hasPrev_);
+}
@@ -1,4 +1,5 @@
 #include "alpha/vwap.h"
+#include <cmath>
 
 VWAPCalculator::VWAPCalculator(double bandMultiplier, size_t rollingWindow)
     : bandMultiplier_(bandMultiplier),
@@ -7,26 +8,22 @@ VWAPCalculator::VWAPCalculator(double bandMultiplier, size_t rollingWindow)
       cumulativePV_(0.0),
       cumulativeVolume_(0.0),
       cumulativePV2_(0.0),
-      isAnchored_(false) {
+      tickWindow_(rollingWindow > 0 ? rollingWindow : 1),
+      windowUpdates_(0),
+      isAnchored_(false),
+      recentPrices_(10) {
     anchorTime_ = std::chrono::system_clock::now();
 }
 
 void VWAPCalculator::onTick(const MarketTick& tick) {
     if (rollingWindow_ > 0) {
-        tickWindow_.push_back(tick);
-        if (tickWindow_.size() > rollingWindow_) {
-            tickWindow_.pop_front();
-        }
-        updateRollingVWAP();
+        updateRollingVWAP(tick);
     } else {
         updateSessionVWAP(tick);
     }
 
     // Track recent prices for mean reversion
-    recentPrices_.push_back(tick.price);
-    if (recentPrices_.size() > 10) {
-        recentPrices_.pop_front();
-    }
+    recentPrices_.push(tick.price);
 }
 
 void VWAPCalculator::reset() {
@@ -35,6 +32,7 @@ void VWAPCalculator::reset() {
     cumulativeVolume_ = 0.0;
     cumulativePV2_ = 0.0;
     tickWindow_.clear();
+    windowUpdates_ = 0;
     recentPrices_.clear();
     isAnchored_ = false;
     anchorTime_ = std::chrono::system_clock::now();
@@ -43,6 +41,10 @@ void VWAPCalculator::reset() {
 void VWAPCalculator::anchor() {
     anchorTime_ = std::chrono::system_clock::now();
     isAnchored_ = true;
+
+    // A rolling VWAP always covers its window; its sums must stay in step with it
+    if (rollingWindow_ > 0) return;
+
     cumulativePV_ = 0.0;
     cumulativeVolume_ = 0.0;
     cumulativePV2_ = 0.0;
@@ -98,23 +100,66 @@ bool VWAPCalculator::isMeanReverting() const {
     return lastDev < firstDev * 0.8;  // 20% reduction in deviation
 }
 
-void VWAPCalculator::updateRollingVWAP() {
-    if (tickWindow_.empty()) {
-        vwap_ = 0.0;
-        return;
+void VWAPCalculator::saveState(SnapshotWriter& out) const {
+    out.write(static_cast<uint64_t>(rollingWindow_));
+    out.write(vwap_);
+    out.write(cumulativePV_);
+    out.write(cumulativeVolume_);
+    out.write(cumulativePV2_);
+    out.write(tickWindow_);
+    out.write(windowUpdates_);
+    out.write(static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        anchorTime_.time_since_epoch()).count()));
+    out.write(isAnchored_);
+    out.write(recentPrices_);
+}
+
+void VWAPCalculator::loadState(SnapshotReader& in) {
+    in.expect(static_cast<uint64_t>(rollingWindow_), "VWAP rolling window changed");
+    in.read(vwap_);
+    in.read(cumulativePV_);
+    in.read(cumulativeVolume_);
+    in.read(cumulativePV2_);
+    in.read(tickWindow_);
+    in.read(windowUpdates_);
+    anchorTime_ = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(in.read<int64_t>())));
+    in.read(isAnchored_);
+    in.read(recentPrices_);
+}
+
+void VWAPCalculator::updateRollingVWAP(const MarketTick& tick) {
+    // Add the new trade and subtract whichever one slid out of the window
+    TradeRecord evicted;
+    if (tickWindow_.push(TradeRecord{tick.price, tick.volume, 0}, &evicted)) {
+        cumulativePV_ -= evicted.price * evicted.volume;
+        cumulativeVolume_ -= evicted.volume;
+        cumulativePV2_ -= evicted.price * evicted.price * evicted.volume;
     }
 
+    cumulativePV_ += tick.price * tick.volume;
+    cumulativeVolume_ += tick.volume;
+    cumulativePV2_ += tick.price * tick.price * tick.volume;
+
+    // Rebuild from the window periodically to bound drift from the subtractions
+    if (++windowUpdates_ % RESYNC_INTERVAL == 0) resyncRollingSums();
+
+    vwap_ = cumulativeVolume_ > 0 ? cumulativePV_ / cumulativeVolume_ : 0.0;
+}
+
+void VWAPCalculator::resyncRollingSums() {
     double sumPV = 0.0;
     double sumV = 0.0;
     double sumPV2 = 0.0;
 
-    for (const auto& tick : tickWindow_) {
-        sumPV += tick.price * tick.volume;
-        sumV += tick.volume;
-        sumPV2 += tick.price * tick.price * tick.volume;
+    for (size_t i = 0; i < tickWindow_.size(); ++i) {
+        const TradeRecord& trade = tickWindow_[i];
+        sumPV += trade.price * trade.volume;
+        sumV += trade.volume;
+        sumPV2 += trade.price * trade.price * trade.volume;
     }
 
-    vwap_ = sumV > 0 ? sumPV / sumV : 0.0;
     cumulativeVolume_ = sumV;
     cumulativePV_ = sumPV;
     cumulativePV2_ = sumPV2;
@@ -1,110 +1,218 @@
 #include "backtest/backtester.h"
 #include "backtest/sharpe.h"
+#include "util/thread_pool.h"
 #include <algorithm>
+#include <numeric>
 #include <random>
+#include <atomic>
+#include <sstream>
 #include <iostream>
 
+namespace {
+
+// Uniform tick access for the row and columnar containers
+const MarketTick& tickAt(const std::vector<MarketTick>& data, size_t i) { return data[i]; }
+CompactTick tickAt(const TickView& data, size_t i) { return data[i]; }
+
+// Row ticks carry names; consecutive ticks usually repeat the symbol, so compare
+// against the last one before going to the registry
+SymbolId symbolOf(const BacktestContext& ctx, const MarketTick& tick) {
+    SymbolRegistry& registry = SymbolRegistry::instance();
+    if (ctx.lastSymbol != INVALID_SYMBOL_ID && registry.name(ctx.lastSymbol) == tick.symbol) {
+        return ctx.lastSymbol;
+    }
+    return registry.intern(tick.symbol);
+}
+SymbolId symbolOf(const BacktestContext&, const CompactTick& tick) { return tick.symbolId; }
+
+long timestampOf(const MarketTick& tick) { return tick.timestamp; }
+long timestampOf(const CompactTick& tick) { return static_cast<long>(tick.timestampNs / 1000000); }
+
+// Fill index with one resampled ordering of [0, n)
+void resample(std::vector<uint32_t>& index, size_t n, const MonteCarloConfig& mcConfig, std::mt19937_64& rng) {
+    index.resize(n);
+
+    if (mcConfig.method == ResamplingMethod::PERMUTATION || n <= mcConfig.blockSize) {
+        std::iota(index.begin(), index.end(), 0u);
+        std::shuffle(index.begin(), index.end(), rng);
+        return;
+    }
+
+    // Block bootstrap: keeps short-range structure inside each block
+    const size_t block = std::max<size_t>(1, mcConfig.blockSize);
+    std::uniform_int_distribution<size_t> startDist(0, n - block);
+
+    for (size_t filled = 0; filled < n;) {
+        size_t start = startDist(rng);
+        size_t len = std::min(block, n - filled);
+        for (size_t j = 0; j < len; ++j) {
+            index[filled + j] = static_cast<uint32_t>(start + j);
+        }
+        filled += len;
+    }
+}
+
+} // namespace
+
 Backtester::Backtester(const BacktestConfig& config)
-    : config_(config),
-      pnlTracker_(config.initialCapital),
-      currentPosition_(0.0),
-      avgEntryPrice_(0.0),
-      currentCash_(config.initialCapital) {}
+    : config_(config) {}
+
+template <typename Data, typename Generator>
+void Backtester::runRange(
+    BacktestContext& ctx,
+    const Data& data,
+    Generator& signalFunc,
+    const uint32_t* index,
+    size_t begin,
+    size_t count
+) const {
+    ctx.equityCurve.reserve(ctx.equityCurve.size() + count);
+    ctx.timestamps.reserve(ctx.timestamps.size() + count);
+
+    for (size_t i = begin; i < begin + count; ++i) {
+        const auto& tick = tickAt(data, index ? index[i] : i);
+
+        // Generate signal
+        int signal = signalFunc(tick);
+        processTick(ctx, symbolOf(ctx, tick), tick.price, timestampOf(tick), signal);
+    }
+}
 
 BacktestResult Backtester::run(
     const std::vector<MarketTick>& historicalData,
     SignalGenerator signalFunc
-) {
-    // Reset state
-    currentPosition_ = 0.0;
-    avgEntryPrice_ = 0.0;
-    currentCash_ = config_.initialCapital;
-    pnlTracker_.reset();
+) const {
+    BacktestContext ctx(config_.initialCapital);
+    runRange(ctx, historicalData, signalFunc, nullptr, 0, historicalData.size());
+    return finishRun(ctx);
+}
 
-    std::vector<Trade> trades;
-    std::vector<double> equityCurve;
-    std::vector<long> timestamps;
+BacktestResult Backtester::run(
+    const TickView& ticks,
+    TickSignalGenerator signalFunc
+) const {
+    BacktestContext ctx(config_.initialCapital);
+    runRange(ctx, ticks, signalFunc, nullptr, 0, ticks.size());
+    return finishRun(ctx);
+}
 
-    for (const auto& tick : historicalData) {
-        // Generate signal
-        int signal = signalFunc(tick);
+BacktestResult Backtester::run(
+    BacktestContext& ctx,
+    const TickView& ticks,
+    TickSignalGenerator signalFunc
+) const {
+    runRange(ctx, ticks, signalFunc, nullptr, 0, ticks.size());
+    return finishRun(ctx);
+}
 
-        // Execute trades based on signal
-        if (signal == 1 && currentPosition_ <= 0) {
-            // Buy signal
-            double maxQuantity = (currentCash_ * config_.maxPositionSize) / tick.price;
-            if (canEnterPosition(tick.price, maxQuantity)) {
-                enterPosition(tick, maxQuantity, true, "SIGNAL_BUY");
-            }
-        } else if (signal == -1 && currentPosition_ >= 0) {
-            // Sell signal
-            if (currentPosition_ > 0) {
-                exitPosition(tick, "SIGNAL_SELL");
-
-                // Record trade
-                Trade trade;
-                trade.symbol = tick.symbol;
-                trade.timestamp = tick.timestamp;
-                trade.entryPrice = avgEntryPrice_;
-                trade.exitPrice = tick.price;
-                trade.quantity = currentPosition_;
-                trade.isLong = true;
-                trade.pnl = (tick.price - avgEntryPrice_) * currentPosition_;
-                trade.commission = calculateCommission(tick.price * currentPosition_);
-                trade.slippage = applySlippage(tick.price, currentPosition_, false) - tick.price;
-                trade.entryReason = "SIGNAL_BUY";
-                trade.exitReason = "SIGNAL_SELL";
-
-                trades.push_back(trade);
-            }
+BacktestResult Backtester::run(
+    const TapeReader& tape,
+    TickSignalGenerator signalFunc
+) const {
+    BacktestContext ctx(config_.initialCapital);
+
+    for (size_t c = 0; c < tape.numChunks(); ++c) {
+        TickView chunk = tape.chunk(c);
+        runRange(ctx, chunk, signalFunc, nullptr, 0, chunk.size());
+    }
+
+    return finishRun(ctx);
+}
+
+void Backtester::processTick(
+    BacktestContext& ctx,
+    SymbolId symbol,
+    double price,
+    long timestamp,
+    int signal
+) const {
+    ctx.now = timestamp;
+
+    // Execute trades based on signal
+    if (signal == 1 && ctx.position <= 0) {
+        // Buy signal
+        double maxQuantity = (ctx.cash * config_.maxPositionSize) / price;
+        if (canEnterPosition(ctx, price, maxQuantity)) {
+            enterPosition(ctx, symbol, price, maxQuantity, true, "SIGNAL_BUY");
+        }
+    } else if (signal == -1 && ctx.position >= 0) {
+        // Sell signal
+        if (ctx.position > 0) {
+            // Record trade
+            Trade trade;
+            trade.symbol = SymbolRegistry::instance().name(symbol);
+            trade.timestamp = timestamp;
+            trade.entryPrice = ctx.avgEntryPrice;
+            trade.exitPrice = price;
+            trade.quantity = ctx.position;
+            trade.isLong = true;
+            trade.pnl = (price - ctx.avgEntryPrice) * ctx.position;
+            trade.commission = calculateCommission(price * ctx.position);
+            trade.slippage = applySlippage(price, ctx.position, false) - price;
+            trade.entryReason = "SIGNAL_BUY";
+            trade.exitReason = "SIGNAL_SELL";
+
+            exitPosition(ctx, symbol, price, "SIGNAL_SELL");
+            ctx.trades.push_back(trade);
+        }
 
-            // Short if enabled
-            if (config_.enableShortSelling) {
-                double maxQuantity = (currentCash_ * config_.maxPositionSize) / tick.price;
-                if (canEnterPosition(tick.price, maxQuantity)) {
-                    enterPosition(tick, -maxQuantity, false, "SIGNAL_SELL");
-                }
+        // Short if enabled
+        if (config_.enableShortSelling) {
+            double maxQuantity = (ctx.cash * config_.maxPositionSize) / price;
+            if (canEnterPosition(ctx, price, maxQuantity)) {
+                enterPosition(ctx, symbol, price, -maxQuantity, false, "SIGNAL_SELL");
             }
         }
+    }
 
-        // Update equity curve
-        double equity = currentCash_ + currentPosition_ * tick.price;
-        equityCurve.push_back(equity);
-        timestamps.push_back(tick.timestamp);
+    // Update equity curve
+    double equity = ctx.cash + ctx.position * price;
+    ctx.equityCurve.push_back(equity);
+    ctx.timestamps.push_back(timestamp);
 
-        pnlTracker_.updatePrice(tick.symbol, tick.price);
-    }
+    ctx.pnlTracker.updatePrice(symbol, price);
 
+    ctx.lastSymbol = symbol;
+    ctx.lastPrice = price;
+}
+
+BacktestResult Backtester::finishRun(BacktestContext& ctx) const {
     // Close any open positions at end
-    if (currentPosition_ != 0.0 && !historicalData.empty()) {
-        exitPosition(historicalData.back(), "END_OF_BACKTEST");
+    if (ctx.position != 0.0 && ctx.lastSymbol != INVALID_SYMBOL_ID) {
+        exitPosition(ctx, ctx.lastSymbol, ctx.lastPrice, "END_OF_BACKTEST");
     }
 
-    return computeResults(trades);
+    return computeResults(ctx);
 }
 
-std::vector<BacktestResult> Backtester::walkForward(
-    const std::vector<MarketTick>& historicalData,
-    SignalGenerator signalFunc,
+template <typename Data, typename Factory>
+std::vector<BacktestResult> Backtester::runWalkForward(
+    const Data& data,
+    const Factory& makeSignal,
     size_t trainPeriod,
-    size_t testPeriod
-) {
+    size_t testPeriod,
+    size_t numThreads
+) const {
     std::vector<BacktestResult> results;
-
-    for (size_t i = 0; i + trainPeriod + testPeriod < historicalData.size();
-         i += testPeriod) {
-
-        // Extract test period data
-        std::vector<MarketTick> testData(
-            historicalData.begin() + i + trainPeriod,
-            historicalData.begin() + i + trainPeriod + testPeriod
-        );
-
-        // Run backtest on test period
-        BacktestResult result = run(testData, signalFunc);
-        results.push_back(result);
-
-        std::cout << "[Walk-Forward] Period " << (i / testPeriod + 1)
+    if (testPeriod == 0) return results;
+
+    // Fold k tests on [k * testPeriod + trainPeriod, + testPeriod)
+    size_t numFolds = 0;
+    while (numFolds * testPeriod + trainPeriod + testPeriod < data.size()) ++numFolds;
+    results.resize(numFolds);
+
+    if (numThreads == 0) numThreads = std::thread::hardware_concurrency();
+    ThreadPool pool(std::max<size_t>(1, std::min(numThreads, numFolds)));
+    pool.parallelFor(numFolds, [&](size_t fold, size_t) {
+        auto signalFunc = makeSignal();
+        BacktestContext ctx(config_.initialCapital, false);
+        runRange(ctx, data, signalFunc, nullptr, fold * testPeriod + trainPeriod, testPeriod);
+        results[fold] = finishRun(ctx);
+    });
+
+    for (size_t fold = 0; fold < numFolds; ++fold) {
+        const BacktestResult& result = results[fold];
+        std::cout << "[Walk-Forward] Period " << (fold + 1)
                   << " - PnL: " << result.totalPnL
                   << " | Sharpe: " << result.sharpeRatio
                   << " | Trades: " << result.numTrades
@@ -114,32 +222,87 @@ std::vector<BacktestResult> Backtester::walkForward(
     return results;
 }
 
-std::vector<BacktestResult> Backtester::monteCarlo(
+std::vector<BacktestResult> Backtester::walkForward(
     const std::vector<MarketTick>& historicalData,
-    SignalGenerator signalFunc,
-    int numSimulations
-) {
-    std::vector<BacktestResult> results;
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    SignalGeneratorFactory makeSignal,
+    size_t trainPeriod,
+    size_t testPeriod,
+    size_t numThreads
+) const {
+    return runWalkForward(historicalData, makeSignal, trainPeriod, testPeriod, numThreads);
+}
 
-    for (int sim = 0; sim < numSimulations; ++sim) {
-        // Shuffle historical data (bootstrap resampling)
-        std::vector<MarketTick> shuffledData = historicalData;
-        std::shuffle(shuffledData.begin(), shuffledData.end(), gen);
+std::vector<BacktestResult> Backtester::walkForward(
+    const TickView& ticks,
+    TickSignalGeneratorFactory makeSignal,
+    size_t trainPeriod,
+    size_t testPeriod,
+    size_t numThreads
+) const {
+    return runWalkForward(ticks, makeSignal, trainPeriod, testPeriod, numThreads);
+}
 
-        BacktestResult result = run(shuffledData, signalFunc);
-        results.push_back(result);
+template <typename Data, typename Factory>
+std::vector<BacktestResult> Backtester::runMonteCarlo(
+    const Data& data,
+    const Factory& makeSignal,
+    const MonteCarloConfig& mcConfig
+) const {
+    const size_t numSimulations = static_cast<size_t>(std::max(0, mcConfig.numSimulations));
+    std::vector<BacktestResult> results(numSimulations);
+    if (numSimulations == 0 || data.size() == 0) return results;
+
+    ThreadPool pool(mcConfig.numThreads);
+    std::vector<std::vector<uint32_t>> indexScratch(pool.size());
+    std::atomic<size_t> completed(0);
+
+    pool.parallelFor(numSimulations, [&](size_t sim, size_t worker) {
+        // Seeded per simulation, so the sample never depends on which worker runs it
+        std::seed_seq seq{static_cast<uint32_t>(mcConfig.seed), static_cast<uint32_t>(mcConfig.seed >> 32),
+                          static_cast<uint32_t>(sim), static_cast<uint32_t>(static_cast<uint64_t>(sim) >> 32)};
+        std::mt19937_64 rng(seq);
+
+        std::vector<uint32_t>& index = indexScratch[worker];
+        resample(index, data.size(), mcConfig, rng);
+
+        auto signalFunc = makeSignal();
+        BacktestContext ctx(config_.initialCapital, false);
+        runRange(ctx, data, signalFunc, index.data(), 0, index.size());
+
+        BacktestResult result = finishRun(ctx);
+        if (!mcConfig.keepEquityCurves) {
+            result.equityCurve = std::vector<double>();
+            result.timestamps = std::vector<long>();
+        }
+        results[sim] = std::move(result);
 
-        if ((sim + 1) % 100 == 0) {
-            std::cout << "[Monte Carlo] Completed " << (sim + 1)
-                      << "/" << numSimulations << " simulations" << std::endl;
+        size_t done = completed.fetch_add(1) + 1;
+        if (done % 100 == 0) {
+            std::ostringstream line;
+            line << "[Monte Carlo] Completed " << done << "/" << numSimulations << " simulations\n";
+            std::cout << line.str() << std::flush;
         }
-    }
+    });
 
     return results;
 }
 
+std::vector<BacktestResult> Backtester::monteCarlo(
+    const std::vector<MarketTick>& historicalData,
+    SignalGeneratorFactory makeSignal,
+    const MonteCarloConfig& mcConfig
+) const {
+    return runMonteCarlo(historicalData, makeSignal, mcConfig);
+}
+
+std::vector<BacktestResult> Backtester::monteCarlo(
+    const TickView& ticks,
+    TickSignalGeneratorFactory makeSignal,
+    const MonteCarloConfig& mcConfig
+) const {
+    return runMonteCarlo(ticks, makeSignal, mcConfig);
+}
+
 void Backtester::setExecutionModel(
     std::function<double(double, double, bool)> model
 ) {
@@ -156,64 +319,85 @@ double Backtester::calculateCommission(double notional) const {
     return notional * config_.commissionRate;
 }
 
-bool Backtester::canEnterPosition(double price, double quantity) const {
+bool Backtester::canEnterPosition(const BacktestContext& ctx, double price, double quantity) const {
     double notional = price * std::abs(quantity);
     double requiredCapital = notional * (config_.enableMarginTrading ? config_.marginRequirement : 1.0);
-    return requiredCapital <= currentCash_ * config_.maxPositionSize;
+    return requiredCapital <= ctx.cash * config_.maxPositionSize;
 }
 
 void Backtester::enterPosition(
-    const MarketTick& tick,
+    BacktestContext& ctx,
+    SymbolId symbol,
+    double price,
     double quantity,
     bool isLong,
     const std::string& reason
-) {
-    double executionPrice = applySlippage(tick.price, quantity, isLong);
+) const {
+    double executionPrice = applySlippage(price, quantity, isLong);
     double notional = executionPrice * std::abs(quantity);
     double commission = calculateCommission(notional);
 
-    currentPosition_ = quantity;
-    avgEntryPrice_ = executionPrice;
-    currentCash_ -= notional + commission;
+    ctx.position = quantity;
+    ctx.avgEntryPrice = executionPrice;
+    ctx.cash -= notional + commission;
 
-    pnlTracker_.addPosition(tick.symbol, quantity, executionPrice);
+    ctx.pnlTracker.addPosition(symbol, quantity, executionPrice, ctx.now);
 
-    std::cout << "[Entry] " << (isLong ? "LONG" : "SHORT")
-              << " | Price: " << executionPrice
-              << " | Qty: " << quantity
-              << " | Reason: " << reason
-              << std::endl;
+    if (ctx.logTrades) {
+        std::cout << "[Entry] " << (isLong ? "LONG" : "SHORT")
+                  << " | Price: " << executionPrice
+                  << " | Qty: " << quantity
+                  << " | Reason: " << reason
+                  << std::endl;
+    }
 }
 
-void Backtester::exitPosition(const MarketTick& tick, const std::string& reason) {
-    if (currentPosition_ == 0.0) return;
+void Backtester::exitPosition(
+    BacktestContext& ctx,
+    SymbolId symbol,
+    double price,
+    const std::string& reason
+) const {
+    if (ctx.position == 0.0) return;
 
-    bool isLong = currentPosition_ > 0;
-    double executionPrice = applySlippage(tick.price, std::abs(currentPosition_), !isLong);
-    double notional = executionPrice * std::abs(currentPosition_);
+    bool isLong = ctx.position > 0;
+    double executionPrice = applySlippage(price, std::abs(ctx.position), !isLong);
+    double notional = executionPrice * std::abs(ctx.position);
     double commission = calculateCommission(notional);
 
     double pnl = isLong ?
-        (executionPrice - avgEntryPrice_) * currentPosition_ :
-        (avgEntryPrice_ - executionPrice) * std::abs(currentPosition_);
+        (executionPrice - ctx.avgEntryPrice) * ctx.position :
+        (ctx.avgEntryPrice - executionPrice) * std::abs(ctx.position);
 
-    currentCash_ += notional - commission;
-    pnlTracker_.closePosition(tick.symbol, executionPrice);
+    ctx.cash += notional - commission;
+    ctx.pnlTracker.closePosition(symbol, executionPrice, ctx.now);
 
-    std::cout << "[Exit] " << (isLong ? "LONG" : "SHORT")
-              << " | Price: " << executionPrice
-              << " | PnL: " << pnl
-              << " | Reason: " << reason
-              << std::endl;
+    if (ctx.logTrades) {
+        std::cout << "[Exit] " << (isLong ? "LONG" : "SHORT")
+                  << " | Price: " << executionPrice
+                  << " | PnL: " << pnl
+                  << " | Reason: " << reason
+                  << std::endl;
+    }
 
-    currentPosition_ = 0.0;
-    avgEntryPrice_ = 0.0;
+    ctx.position = 0.0;
+    ctx.avgEntryPrice = 0.0;
 }
 
-BacktestResult Backtester::computeResults(const std::vector<Trade>& trades) const {
+BacktestResult Backtester::computeResults(BacktestContext& ctx) const {
     BacktestResult result;
-    result.trades = trades;
-    result.numTrades = trades.size();
+    result.trades = std::move(ctx.trades);
+    result.equityCurve = std::move(ctx.equityCurve);
+    result.timestamps = std::move(ctx.timestamps);
+
+    computeTradeStatistics(result, config_.initialCapital);
+    return result;
+}
+
+void computeTradeStatistics(BacktestResult& result, double initialCapital) {
+    result.numTrades = result.trades.size();
+
+    const std::vector<Trade>& trades = result.trades;
 
     if (trades.empty()) {
         result.totalPnL = 0.0;
@@ -227,7 +411,8 @@ BacktestResult Backtester::computeResults(const std::vector<Trade>& trades) cons
         result.avgLoss = 0.0;
         result.profitFactor = 0.0;
         result.expectancy = 0.0;
-        return result;
+        result.maxDrawdown = computeMaxDrawdown(result.equityCurve);
+        return;
     }
 
     // Calculate basic metrics
@@ -248,7 +433,7 @@ BacktestResult Backtester::computeResults(const std::vector<Trade>& trades) cons
         }
     }
 
-    result.totalReturn = (result.totalPnL / config_.initialCapital) * 100.0;
+    result.totalReturn = (result.totalPnL / initialCapital) * 100.0;
     result.winRate = static_cast<double>(result.numWinningTrades) / result.numTrades;
     result.avgWin = result.numWinningTrades > 0 ? totalWin / result.numWinningTrades : 0.0;
     result.avgLoss = result.numLosingTrades > 0 ? totalLoss / result.numLosingTrades : 0.0;
@@ -258,11 +443,9 @@ BacktestResult Backtester::computeResults(const std::vector<Trade>& trades) cons
     // Calculate Sharpe ratio and max drawdown
     std::vector<double> returns;
     for (const auto& trade : trades) {
-        returns.push_back(trade.pnl / config_.initialCapital);
+        returns.push_back(trade.pnl / initialCapital);
     }
 
     result.sharpeRatio = computeSharpeRatio(returns, 0.0);
     result.maxDrawdown = computeMaxDrawdown(result.equityCurve);
-
-    return result;
 }
\ No newline at end of file
@@ -0,0 +1,354 @@
+#include "backtest/param_sweep.h"
+#include "alpha/indicator_kernels.h"
+#include "alpha/streaming_indicators.h"
+#include "alpha/regime.h"
+#include "util/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+// === ParameterSet / ParameterGrid ===
+void ParameterSet::set(const std::string& name, double value) {
+    for (auto& v : values_) {
+        if (v.first == name) {
+            v.second = value;
+            return;
+        }
+    }
+    values_.emplace_back(name, value);
+}
+
+double ParameterSet::get(const std::string& name, double fallback) const {
+    for (const auto& v : values_) {
+        if (v.first == name) return v.second;
+    }
+    return fallback;
+}
+
+std::string ParameterSet::toString() const {
+    std::ostringstream out;
+    for (size_t i = 0; i < values_.size(); ++i) {
+        if (i > 0) out << " ";
+        out << values_[i].first << "=" << values_[i].second;
+    }
+    return out.str();
+}
+
+ParameterGrid& ParameterGrid::addAxis(const std::string& name, const std::vector<double>& values) {
+    axes_.emplace_back(name, values);
+    return *this;
+}
+
+size_t ParameterGrid::size() const {
+    if (axes_.empty()) return 0;
+
+    size_t n = 1;
+    for (const auto& axis : axes_) n *= axis.second.size();
+    return n;
+}
+
+ParameterSet ParameterGrid::at(size_t index) const {
+    ParameterSet params;
+    std::vector<size_t> digits(axes_.size());
+
+    for (size_t a = axes_.size(); a-- > 0;) {
+        const size_t radix = axes_[a].second.size();
+        digits[a] = index % radix;
+        index /= radix;
+    }
+
+    for (size_t a = 0; a < axes_.size(); ++a) {
+        params.set(axes_[a].first, axes_[a].second[digits[a]]);
+    }
+    return params;
+}
+
+// === FeatureCache ===
+FeatureCache::FeatureCache(const TickView& ticks)
+    : ticks_(ticks) {}
+
+void FeatureCache::compute(const std::vector<FeatureKey>& keys, ThreadPool* pool) {
+    struct PendingColumn {
+        FeatureKey key;
+        std::vector<double>* out;
+        std::vector<double>* stddev;    // ROLLING_MEAN only: its std dev twin
+    };
+
+    // Create the missing columns up front so workers only touch their own vectors.
+    // Rolling mean and std dev come out of one kernel pass, so they are always
+    // cached as a pair and computed by a single task.
+    std::vector<PendingColumn> pending;
+    for (const auto& key : keys) {
+        if (key.kind == FeatureKind::ROLLING_MEAN || key.kind == FeatureKind::ROLLING_STDDEV) {
+            auto mean = columns_.emplace(FeatureKey{FeatureKind::ROLLING_MEAN, key.period}, std::vector<double>());
+            auto stddev = columns_.emplace(FeatureKey{FeatureKind::ROLLING_STDDEV, key.period}, std::vector<double>());
+            if (mean.second) {
+                pending.push_back(PendingColumn{mean.first->first, &mean.first->second, &stddev.first->second});
+            }
+            continue;
+        }
+
+        auto inserted = columns_.emplace(key, std::vector<double>());
+        if (inserted.second) pending.push_back(PendingColumn{key, &inserted.first->second, nullptr});
+    }
+
+    auto task = [this, &pending](size_t i, size_t) {
+        const PendingColumn& column = pending[i];
+        if (column.stddev) {
+            computeMeanStd(column.key.period, *column.out, *column.stddev);
+        } else {
+            computeColumn(column.key, *column.out);
+        }
+    };
+
+    if (pool) {
+        pool->parallelFor(pending.size(), task);
+    } else {
+        for (size_t i = 0; i < pending.size(); ++i) task(i, 0);
+    }
+}
+
+const std::vector<double>& FeatureCache::get(const FeatureKey& key) const {
+    auto it = columns_.find(key);
+    if (it == columns_.end()) {
+        throw std::out_of_range("FeatureCache: feature not computed");
+    }
+    return it->second;
+}
+
+void FeatureCache::computeMeanStd(size_t period, std::vector<double>& mean, std::vector<double>& stddev) const {
+    const size_t n = ticks_.size();
+    mean.resize(n);
+    stddev.resize(n);
+    computeRollingMeanStdSeries(ticks_.prices(), n, static_cast<int>(std::max<size_t>(1, period)),
+                                mean.data(), stddev.data());
+}
+
+void FeatureCache::computeColumn(const FeatureKey& key, std::vector<double>& out) const {
+    const size_t n = ticks_.size();
+    const size_t period = std::max<size_t>(1, key.period);
+    const double* prices = ticks_.prices();
+
+    switch (key.kind) {
+        case FeatureKind::ROLLING_MEAN:
+        case FeatureKind::ROLLING_STDDEV:
+            break;  // filled in pairs by computeMeanStd
+
+        case FeatureKind::MOMENTUM: {
+            out.assign(n, 0.0);
+            for (size_t i = period - 1; i < n; ++i) {
+                const double first = prices[i - period + 1];
+                out[i] = first > 0.0 ? prices[i] / first - 1.0 : 0.0;
+            }
+            break;
+        }
+
+        case FeatureKind::RSI: {
+            out.resize(n);
+            StreamingRSI rsi(static_cast<int>(period));
+            for (size_t i = 0; i < n; ++i) out[i] = rsi.update(prices[i]);
+            break;
+        }
+
+        case FeatureKind::HURST: {
+            out.assign(n, 0.5);
+            const size_t maxLag = key.lag > 0 ? key.lag : 20;
+            regime::HurstScratch scratch;
+            double hurst = 0.5;
+
+            for (size_t i = period - 1; i < n; ++i) {
+                if ((i - (period - 1)) % HURST_STRIDE == 0) {
+                    hurst = regime::hurstExponent(prices + i - period + 1, period, maxLag, scratch);
+                }
+                out[i] = hurst;
+            }
+            break;
+        }
+    }
+}
+
+// === BollingerSweepStrategy ===
+void BollingerSweepStrategy::requiredFeatures(const ParameterSet& params, std::vector<FeatureKey>& out) const {
+    const size_t period = static_cast<size_t>(params.get("period", 20));
+    out.push_back(FeatureKey{FeatureKind::ROLLING_MEAN, period});
+    out.push_back(FeatureKey{FeatureKind::ROLLING_STDDEV, period});
+
+    if (params.get("momentum", 0.0) > 0.0) {
+        out.push_back(FeatureKey{FeatureKind::MOMENTUM, period});
+    }
+
+    const size_t hurstWindow = static_cast<size_t>(params.get("hurstWindow", 0));
+    if (hurstWindow > 0) {
+        out.push_back(FeatureKey{FeatureKind::HURST, hurstWindow, static_cast<size_t>(params.get("hurstLag", 20))});
+    }
+}
+
+TickSignalGenerator BollingerSweepStrategy::makeGenerator(const ParameterSet& params, const FeatureCache& features) const {
+    const size_t period = static_cast<size_t>(params.get("period", 20));
+    const double mult = params.get("multiplier", 2.0);
+    const double momentum = params.get("momentum", 0.0);
+    const size_t hurstWindow = static_cast<size_t>(params.get("hurstWindow", 0));
+    const double hurstMax = params.get("hurstMax", 0.5);
+
+    const double* mean = features.get(FeatureKind::ROLLING_MEAN, period).data();
+    const double* sd = features.get(FeatureKind::ROLLING_STDDEV, period).data();
+    const double* mom = momentum > 0.0 ? features.get(FeatureKind::MOMENTUM, period).data() : nullptr;
+    const double* hurst = hurstWindow > 0
+        ? features.get(FeatureKind::HURST, hurstWindow, static_cast<size_t>(params.get("hurstLag", 20))).data()
+        : nullptr;
+    const size_t warmup = std::max<size_t>(std::max<size_t>(1, period), hurstWindow);
+
+    size_t index = 0;
+    return [=](const CompactTick& tick) mutable -> int {
+        const size_t i = index++;
+        if (i + 1 < warmup) return 0;  // HOLD
+
+        // Only fade the bands in a mean-reverting regime
+        if (hurst && hurst[i] >= hurstMax) return 0;
+
+        const double upper = mean[i] + mult * sd[i];
+        const double lower = mean[i] - mult * sd[i];
+
+        if (tick.price < lower && (!mom || mom[i] > -momentum)) {
+            return 1;   // BUY
+        } else if (tick.price > upper && (!mom || mom[i] < momentum)) {
+            return -1;  // SELL
+        }
+
+        return 0;  // HOLD
+    };
+}
+
+// === AlphaSweepStrategy ===
+void AlphaSweepStrategy::requiredFeatures(const ParameterSet& params, std::vector<FeatureKey>& out) const {
+    const size_t window = static_cast<size_t>(params.get("window", 20));
+    out.push_back(FeatureKey{FeatureKind::ROLLING_MEAN, window});
+    out.push_back(FeatureKey{FeatureKind::ROLLING_STDDEV, window});
+    out.push_back(FeatureKey{FeatureKind::MOMENTUM, window});
+
+    const size_t hurstWindow = static_cast<size_t>(params.get("hurstWindow", 100));
+    if (hurstWindow > 0) {
+        out.push_back(FeatureKey{FeatureKind::HURST, hurstWindow, static_cast<size_t>(params.get("hurstLag", 20))});
+    }
+}
+
+TickSignalGenerator AlphaSweepStrategy::makeGenerator(const ParameterSet& params, const FeatureCache& features) const {
+    const size_t window = std::max<size_t>(1, static_cast<size_t>(params.get("window", 20)));
+    const size_t hurstWindow = static_cast<size_t>(params.get("hurstWindow", 100));
+    const double threshold = params.get("threshold", 0.01);
+
+    const double* mean = features.get(FeatureKind::ROLLING_MEAN, window).data();
+    const double* sd = features.get(FeatureKind::ROLLING_STDDEV, window).data();
+    const double* mom = features.get(FeatureKind::MOMENTUM, window).data();
+    const double* hurst = hurstWindow > 0
+        ? features.get(FeatureKind::HURST, hurstWindow, static_cast<size_t>(params.get("hurstLag", 20))).data()
+        : nullptr;
+
+    // AlphaEngine's z-score uses the population std dev; the cache holds the sample one
+    const double populationScale = std::sqrt(static_cast<double>(window - 1) / static_cast<double>(window));
+
+    size_t index = 0;
+    return [=](const CompactTick& tick) mutable -> int {
+        const size_t i = index++;
+        if (i + 1 < window) return 0;  // HOLD
+
+        const double vol = sd[i] * populationScale;
+        const double meanRevZ = vol > 1e-8 ? (tick.price - mean[i]) / vol : 0.0;
+
+        // RegimeDetector's low-vol weights by Hurst alone; neutral until it has warmed up
+        double momentumWeight = 0.5, meanRevWeight = 0.5;
+        if (hurst && i + 1 >= hurstWindow) {
+            const bool trending = hurst[i] > 0.55;
+            momentumWeight = trending ? 0.8 : 0.3;
+            meanRevWeight = trending ? 0.1 : 0.8;
+        }
+
+        const double score = momentumWeight * mom[i] + meanRevWeight * meanRevZ;
+        if (score > threshold) return 1;    // BUY
+        if (score < -threshold) return -1;  // SELL
+        return 0;  // HOLD
+    };
+}
+
+// === ParameterSweep ===
+ParameterSweep::ParameterSweep(const Backtester& backtester, const SweepConfig& config)
+    : backtester_(backtester), config_(config) {}
+
+std::vector<SweepResult> ParameterSweep::run(
+    const TickView& ticks,
+    const ParameterGrid& grid,
+    const SweepStrategy& strategy
+) const {
+    const size_t numVariants = grid.size();
+    std::vector<SweepResult> results(numVariants);
+    if (numVariants == 0) return results;
+
+    // Distinct features across the whole grid, each computed once
+    std::vector<FeatureKey> keys;
+    for (size_t v = 0; v < numVariants; ++v) {
+        results[v].params = grid.at(v);
+        strategy.requiredFeatures(results[v].params, keys);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end(),
+                           [](const FeatureKey& a, const FeatureKey& b) { return !(a < b) && !(b < a); }),
+               keys.end());
+
+    ThreadPool pool(config_.numThreads);
+    FeatureCache features(ticks);
+    features.compute(keys, &pool);
+
+    pool.parallelFor(numVariants, [&](size_t v, size_t) {
+        BacktestContext ctx(backtester_.getConfig().initialCapital, false);
+        BacktestResult result = backtester_.run(ctx, ticks, strategy.makeGenerator(results[v].params, features));
+
+        if (!config_.keepTrades) {
+            result.trades = std::vector<Trade>();
+            result.equityCurve = std::vector<double>();
+            result.timestamps = std::vector<long>();
+        }
+
+        results[v].score = score(result);
+        results[v].result = std::move(result);
+    });
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        return a.score > b.score;
+    });
+    return results;
+}
+
+double ParameterSweep::score(const BacktestResult& result) const {
+    double value = 0.0;
+    switch (config_.rankBy) {
+        case SweepMetric::SHARPE:        value = result.sharpeRatio; break;
+        case SweepMetric::TOTAL_RETURN:  value = result.totalReturn; break;
+        case SweepMetric::PROFIT_FACTOR: value = result.profitFactor; break;
+        case SweepMetric::EXPECTANCY:    value = result.expectancy; break;
+    }
+
+    // Variants that never traded (or produced NaN) rank last
+    return (result.numTrades > 0 && std::isfinite(value)) ? value : -INFINITY;
+}
+
+void printSweepTable(const std::vector<SweepResult>& results, size_t maxRows, std::ostream& out) {
+    out << std::left << std::setw(6) << "Rank" << std::setw(56) << "Parameters"
+        << std::right << std::setw(10) << "Return%" << std::setw(9) << "Sharpe"
+        << std::setw(12) << "MaxDD" << std::setw(8) << "Trades"
+        << std::setw(8) << "Win%" << std::setw(9) << "PF" << "\n";
+
+    const size_t rows = std::min(maxRows, results.size());
+    for (size_t i = 0; i < rows; ++i) {
+        const BacktestResult& r = results[i].result;
+        out << std::left << std::setw(6) << (i + 1) << std::setw(56) << results[i].params.toString()
+            << std::right << std::fixed
+            << std::setw(10) << std::setprecision(2) << r.totalReturn
+            << std::setw(9) << std::setprecision(3) << r.sharpeRatio
+            << std::setw(12) << std::setprecision(2) << r.maxDrawdown
+            << std::setw(8) << r.numTrades
+            << std::setw(8) << std::setprecision(1) << r.winRate * 100.0
+            << std::setw(9) << std::setprecision(2) << r.profitFactor << "\n";
+    }
+}
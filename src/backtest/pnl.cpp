@@ -1,29 +1,110 @@
 #include "backtest/pnl.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+
+namespace {
+
+long wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+const char* toString(TransactionType type) {
+    switch (type) {
+        case TransactionType::BUY: return "BUY";
+        case TransactionType::SELL: return "SELL";
+        case TransactionType::CLOSE: return "CLOSE";
+        case TransactionType::PARTIAL_CLOSE: return "PARTIAL_CLOSE";
+    }
+    return "UNKNOWN";
+}
+
+// === TransactionLog ===
+
+TransactionLog::TransactionLog(size_t chunkSize)
+    : chunkSize_(std::max<size_t>(1, chunkSize)), size_(0) {
+    chunks_.emplace_back(new Transaction[chunkSize_]);
+}
+
+void TransactionLog::append(const Transaction& txn) {
+    const size_t chunk = size_ / chunkSize_;
+    if (chunk == chunks_.size()) {
+        chunks_.emplace_back(new Transaction[chunkSize_]);
+    }
+    chunks_[chunk][size_ % chunkSize_] = txn;
+    ++size_;
+}
+
+// === PnLTracker ===
 
 PnLTracker::PnLTracker(double initialCash, CostMethod method)
     : method_(method),
       initialCash_(initialCash),
-      cash_(initialCash) {}
+      cash_(initialCash),
+      realizedTotal_(0.0),
+      unrealizedTotal_(0.0),
+      positionsValue_(0.0),
+      exposure_(0.0),
+      priceUpdates_(0) {}
+
+PnLTracker::Slot& PnLTracker::slot(SymbolId symbol) {
+    if (symbol >= slots_.size()) slots_.resize(symbol + 1);
+    return slots_[symbol];
+}
 
-void PnLTracker::addPosition(const std::string& symbol, double quantity, double price) {
-    auto it = positions_.find(symbol);
+void PnLTracker::open(SymbolId symbol, Slot& s) {
+    s.openIndex = static_cast<uint32_t>(openIds_.size());
+    openIds_.push_back(symbol);
+}
+
+void PnLTracker::close(Slot& s) {
+    // Swap-remove from the open list
+    const SymbolId moved = openIds_.back();
+    openIds_[s.openIndex] = moved;
+    slots_[moved].openIndex = s.openIndex;
+    openIds_.pop_back();
+
+    s.openIndex = NOT_OPEN;
+    s.quantity = 0.0;
+    s.avgEntryPrice = 0.0;
+    s.totalCost = 0.0;
+}
+
+void PnLTracker::addContribution(const Slot& s, double sign) {
+    const double value = s.quantity * s.currentPrice;
+    positionsValue_ += sign * value;
+    unrealizedTotal_ += sign * (s.currentPrice - s.avgEntryPrice) * s.quantity;
+    exposure_ += sign * std::abs(value);
+}
+
+void PnLTracker::resyncTotals() {
+    positionsValue_ = 0.0;
+    unrealizedTotal_ = 0.0;
+    exposure_ = 0.0;
+    for (SymbolId id : openIds_) {
+        addContribution(slots_[id], 1.0);
+    }
+}
 
-    if (it == positions_.end()) {
+void PnLTracker::addPosition(SymbolId symbol, double quantity, double price, long timestamp) {
+    if (symbol == INVALID_SYMBOL_ID) return;
+    Slot& pos = slot(symbol);
+
+    if (pos.openIndex == NOT_OPEN) {
         // New position
-        Position pos;
-        pos.symbol = symbol;
         pos.quantity = quantity;
         pos.avgEntryPrice = price;
         pos.currentPrice = price;
         pos.totalCost = std::abs(quantity) * price;
-        pos.unrealizedPnL = 0.0;
-        pos.realizedPnL = 0.0;
 
-        positions_[symbol] = pos;
+        open(symbol, pos);
+        addContribution(pos, 1.0);
     } else {
         // Add to existing position
-        Position& pos = it->second;
+        addContribution(pos, -1.0);
 
         if ((pos.quantity > 0 && quantity > 0) || (pos.quantity < 0 && quantity < 0)) {
             // Adding to same side
@@ -34,186 +115,193 @@ void PnLTracker::addPosition(const std::string& symbol, double quantity, double
             double pnl = (price - pos.avgEntryPrice) * closeQuantity *
                         (pos.quantity > 0 ? 1.0 : -1.0);
 
-            realizedPnL_[symbol] += pnl;
             pos.realizedPnL += pnl;
+            realizedTotal_ += pnl;
 
             pos.quantity += quantity;
-            if (std::abs(pos.quantity) < 1e-8) {
-                positions_.erase(symbol);
-            } else {
+            if (std::abs(pos.quantity) >= 1e-8) {
                 pos.avgEntryPrice = price;
                 pos.totalCost = std::abs(pos.quantity) * price;
             }
         }
+
+        if (std::abs(pos.quantity) < 1e-8) {
+            close(pos);
+        } else {
+            addContribution(pos, 1.0);
+        }
     }
 
     // Update cash
     cash_ -= quantity * price;
 
-    // Record transaction
-    Transaction txn;
-    txn.symbol = symbol;
-    txn.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-    txn.quantity = quantity;
-    txn.price = price;
-    txn.type = quantity > 0 ? "BUY" : "SELL";
-    transactions_.push_back(txn);
+    record(symbol, quantity > 0 ? TransactionType::BUY : TransactionType::SELL, quantity, price, timestamp);
 }
 
-void PnLTracker::closePosition(const std::string& symbol, double price) {
-    auto it = positions_.find(symbol);
-    if (it == positions_.end()) return;
+void PnLTracker::closePosition(SymbolId symbol, double price, long timestamp) {
+    if (!hasPosition(symbol)) return;
 
-    Position& pos = it->second;
+    Slot& pos = slots_[symbol];
     double pnl = (price - pos.avgEntryPrice) * pos.quantity;
 
-    realizedPnL_[symbol] += pnl;
     pos.realizedPnL += pnl;
+    realizedTotal_ += pnl;
 
     cash_ += pos.quantity * price;
 
-    // Record transaction
-    Transaction txn;
-    txn.symbol = symbol;
-    txn.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-    txn.quantity = -pos.quantity;
-    txn.price = price;
-    txn.type = "CLOSE";
-    transactions_.push_back(txn);
+    record(symbol, TransactionType::CLOSE, -pos.quantity, price, timestamp);
 
-    positions_.erase(symbol);
+    addContribution(pos, -1.0);
+    close(pos);
 }
 
-void PnLTracker::closePartialPosition(const std::string& symbol, double quantity, double price) {
-    auto it = positions_.find(symbol);
-    if (it == positions_.end()) return;
+void PnLTracker::closePartialPosition(SymbolId symbol, double quantity, double price, long timestamp) {
+    if (!hasPosition(symbol)) return;
 
-    Position& pos = it->second;
+    Slot& pos = slots_[symbol];
     double closeQty = std::min(std::abs(quantity), std::abs(pos.quantity));
 
     if ((pos.quantity > 0 && quantity < 0) || (pos.quantity < 0 && quantity > 0)) {
+        addContribution(pos, -1.0);
+
         double pnl = (price - pos.avgEntryPrice) * closeQty * (pos.quantity > 0 ? 1.0 : -1.0);
-        realizedPnL_[symbol] += pnl;
         pos.realizedPnL += pnl;
+        realizedTotal_ += pnl;
 
         pos.quantity += quantity;
         cash_ += closeQty * price * (quantity < 0 ? -1.0 : 1.0);
 
         if (std::abs(pos.quantity) < 1e-8) {
-            positions_.erase(symbol);
+            close(pos);
+        } else {
+            addContribution(pos, 1.0);
         }
 
-        // Record transaction
-        Transaction txn;
-        txn.symbol = symbol;
-        txn.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
-        txn.quantity = quantity;
-        txn.price = price;
-        txn.type = "PARTIAL_CLOSE";
-        transactions_.push_back(txn);
+        record(symbol, TransactionType::PARTIAL_CLOSE, quantity, price, timestamp);
     }
 }
 
-void PnLTracker::updatePrice(const std::string& symbol, double price) {
-    auto it = positions_.find(symbol);
-    if (it != positions_.end()) {
-        Position& pos = it->second;
-        pos.currentPrice = price;
-        pos.unrealizedPnL = (price - pos.avgEntryPrice) * pos.quantity;
+void PnLTracker::updatePrice(SymbolId symbol, double price) {
+    if (!hasPosition(symbol)) return;
+
+    Slot& pos = slots_[symbol];
+    const double value = pos.quantity * pos.currentPrice;
+    const double newValue = pos.quantity * price;
+
+    positionsValue_ += newValue - value;
+    unrealizedTotal_ += (price - pos.currentPrice) * pos.quantity;
+    exposure_ += std::abs(newValue) - std::abs(value);
+    pos.currentPrice = price;
+
+    // Rebuild occasionally so rounding in the running totals cannot accumulate
+    if (++priceUpdates_ % RESYNC_INTERVAL == 0) resyncTotals();
+}
+
+Position PnLTracker::getPosition(SymbolId symbol) const {
+    Position pos;
+    pos.symbol = SymbolRegistry::instance().name(symbol);
+    pos.symbolId = symbol;
+    pos.quantity = 0.0;
+    pos.avgEntryPrice = 0.0;
+    pos.currentPrice = 0.0;
+    pos.unrealizedPnL = 0.0;
+    pos.realizedPnL = symbol < slots_.size() ? slots_[symbol].realizedPnL : 0.0;
+    pos.totalCost = 0.0;
+
+    if (hasPosition(symbol)) {
+        const Slot& s = slots_[symbol];
+        pos.quantity = s.quantity;
+        pos.avgEntryPrice = s.avgEntryPrice;
+        pos.currentPrice = s.currentPrice;
+        pos.unrealizedPnL = (s.currentPrice - s.avgEntryPrice) * s.quantity;
+        pos.totalCost = s.totalCost;
     }
+    return pos;
 }
 
 Position PnLTracker::getPosition(const std::string& symbol) const {
-    auto it = positions_.find(symbol);
-    if (it != positions_.end()) {
-        return it->second;
-    }
+    SymbolId id = lookup(symbol);
+    if (id != INVALID_SYMBOL_ID) return getPosition(id);
 
-    Position empty;
+    Position empty = getPosition(INVALID_SYMBOL_ID);
     empty.symbol = symbol;
-    empty.quantity = 0.0;
-    empty.avgEntryPrice = 0.0;
-    empty.currentPrice = 0.0;
-    empty.unrealizedPnL = 0.0;
-    empty.realizedPnL = 0.0;
-    empty.totalCost = 0.0;
     return empty;
 }
 
 std::vector<Position> PnLTracker::getAllPositions() const {
+    std::vector<SymbolId> ids(openIds_);
+    std::sort(ids.begin(), ids.end());
+
     std::vector<Position> result;
-    for (const auto& pair : positions_) {
-        result.push_back(pair.second);
+    result.reserve(ids.size());
+    for (SymbolId id : ids) {
+        result.push_back(getPosition(id));
     }
     return result;
 }
 
-bool PnLTracker::hasPosition(const std::string& symbol) const {
-    return positions_.find(symbol) != positions_.end();
+double PnLTracker::getUnrealizedPnL(SymbolId symbol) const {
+    if (!hasPosition(symbol)) return 0.0;
+    const Slot& s = slots_[symbol];
+    return (s.currentPrice - s.avgEntryPrice) * s.quantity;
 }
 
-double PnLTracker::getUnrealizedPnL(const std::string& symbol) const {
-    auto it = positions_.find(symbol);
-    return it != positions_.end() ? it->second.unrealizedPnL : 0.0;
+double PnLTracker::getRealizedPnL(SymbolId symbol) const {
+    return symbol < slots_.size() ? slots_[symbol].realizedPnL : 0.0;
 }
 
-double PnLTracker::getRealizedPnL(const std::string& symbol) const {
-    auto it = realizedPnL_.find(symbol);
-    return it != realizedPnL_.end() ? it->second : 0.0;
-}
-
-double PnLTracker::getTotalPnL(const std::string& symbol) const {
+double PnLTracker::getTotalPnL(SymbolId symbol) const {
     return getRealizedPnL(symbol) + getUnrealizedPnL(symbol);
 }
 
 PortfolioMetrics PnLTracker::getPortfolioMetrics() const {
     PortfolioMetrics metrics;
     metrics.cash = cash_;
-    metrics.realizedPnL = 0.0;
-    metrics.unrealizedPnL = 0.0;
-    metrics.exposure = 0.0;
-    metrics.numPositions = positions_.size();
-
-    double positionsValue = 0.0;
-
-    for (const auto& pair : positions_) {
-        const Position& pos = pair.second;
-        positionsValue += pos.quantity * pos.currentPrice;
-        metrics.unrealizedPnL += pos.unrealizedPnL;
-        metrics.exposure += std::abs(pos.quantity * pos.currentPrice);
-    }
-
-    for (const auto& pair : realizedPnL_) {
-        metrics.realizedPnL += pair.second;
-    }
+    metrics.realizedPnL = realizedTotal_;
+    metrics.unrealizedPnL = unrealizedTotal_;
+    metrics.exposure = exposure_;
+    metrics.numPositions = static_cast<int>(openIds_.size());
 
-    metrics.totalValue = cash_ + positionsValue;
+    metrics.totalValue = cash_ + positionsValue_;
     metrics.totalPnL = metrics.realizedPnL + metrics.unrealizedPnL;
     metrics.leverage = metrics.totalValue > 0 ? metrics.exposure / metrics.totalValue : 0.0;
 
     return metrics;
 }
 
-double PnLTracker::getTotalPortfolioPnL() const {
-    PortfolioMetrics metrics = getPortfolioMetrics();
-    return metrics.totalPnL;
-}
-
 void PnLTracker::reset() {
-    positions_.clear();
-    realizedPnL_.clear();
+    slots_.clear();
+    openIds_.clear();
     transactions_.clear();
     cash_ = initialCash_;
+
+    realizedTotal_ = 0.0;
+    unrealizedTotal_ = 0.0;
+    positionsValue_ = 0.0;
+    exposure_ = 0.0;
+    priceUpdates_ = 0;
 }
 
-std::vector<PnLTracker::Transaction> PnLTracker::getTransactionHistory() const {
-    return transactions_;
+std::vector<Transaction> PnLTracker::getTransactionHistory() const {
+    std::vector<Transaction> history;
+    history.reserve(transactions_.size());
+    for (size_t i = 0; i < transactions_.size(); ++i) {
+        history.push_back(transactions_[i]);
+    }
+    return history;
 }
 
-void PnLTracker::updatePositionCost(Position& pos, double quantity, double price) {
+void PnLTracker::record(SymbolId symbol, TransactionType type, double quantity, double price, long timestamp) {
+    Transaction txn;
+    txn.timestamp = timestamp != 0 ? timestamp : wallClockMs();
+    txn.quantity = quantity;
+    txn.price = price;
+    txn.symbolId = symbol;
+    txn.type = type;
+    transactions_.append(txn);
+}
+
+void PnLTracker::updatePositionCost(Slot& pos, double quantity, double price) {
     if (method_ == CostMethod::AVERAGE) {
         double totalQuantity = pos.quantity + quantity;
         pos.avgEntryPrice = ((pos.avgEntryPrice * std::abs(pos.quantity)) +
@@ -227,4 +315,4 @@ void PnLTracker::updatePositionCost(Position& pos, double quantity, double price
         pos.quantity = totalQuantity;
         pos.totalCost = std::abs(pos.quantity) * pos.avgEntryPrice;
     }
-}
\ No newline at end of file
+}
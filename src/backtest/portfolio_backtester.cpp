@@ -0,0 +1,427 @@
+#include "backtest/portfolio_backtester.h"
+#include "backtest/pnl.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <cmath>
+
+namespace {
+
+// Min-heap of stream cursors keyed by (next timestamp, stream index); the
+// stream index breaks ties so equal timestamps replay in a fixed order
+class MergeHeap {
+public:
+    struct Entry {
+        int64_t timestampNs;
+        uint32_t stream;
+
+        bool before(const Entry& o) const {
+            return timestampNs != o.timestampNs ? timestampNs < o.timestampNs : stream < o.stream;
+        }
+    };
+
+    void reserve(size_t n) { heap_.reserve(n); }
+    bool empty() const { return heap_.empty(); }
+    const Entry& top() const { return heap_.front(); }
+
+    void push(const Entry& e) {
+        heap_.push_back(e);
+        size_t i = heap_.size() - 1;
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!heap_[i].before(heap_[parent])) break;
+            std::swap(heap_[i], heap_[parent]);
+            i = parent;
+        }
+    }
+
+    // Advance the top stream in place: one sift-down instead of pop + push
+    void replaceTop(int64_t timestampNs) {
+        heap_.front().timestampNs = timestampNs;
+        siftDown(0);
+    }
+
+    void popTop() {
+        heap_.front() = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) siftDown(0);
+    }
+
+private:
+    void siftDown(size_t i) {
+        const size_t n = heap_.size();
+        while (true) {
+            size_t smallest = i;
+            size_t left = 2 * i + 1;
+            size_t right = left + 1;
+            if (left < n && heap_[left].before(heap_[smallest])) smallest = left;
+            if (right < n && heap_[right].before(heap_[smallest])) smallest = right;
+            if (smallest == i) return;
+            std::swap(heap_[i], heap_[smallest]);
+            i = smallest;
+        }
+    }
+
+    std::vector<Entry> heap_;
+};
+
+struct PendingOrder {
+    int64_t fillTimeNs;
+    SymbolId symbol;
+    Side side;
+};
+
+struct SymbolState {
+    TickSignalGenerator strategy;
+    double position = 0.0;
+    double avgEntryPrice = 0.0;
+    double lastPrice = 0.0;
+    bool orderInFlight = false;     // at most one pending order per symbol
+
+    size_t ticks = 0;
+    int numTrades = 0;
+    double pnl = 0.0;
+};
+
+// Mutable state of one portfolio run
+class PortfolioRun {
+public:
+    PortfolioRun(const PortfolioBacktestConfig& config, const SymbolStrategyFactory& makeStrategy,
+                 double positionFraction)
+        : config_(config),
+          exec_(config.execution),
+          makeStrategy_(makeStrategy),
+          book_(config.execution.initialCapital),
+          positionFraction_(positionFraction),
+          latencyNs_(static_cast<int64_t>(std::max(0.0, config.execution.latencyMs) * 1e6)),
+          intervalNs_(static_cast<int64_t>(std::max(0L, config.equityIntervalMs)) * 1000000LL),
+          nextSampleNs_(INT64_MIN),
+          commissions_(0.0),
+          lastTimestampNs_(0) {}
+
+    void onTick(const CompactTick& tick) {
+        ++result_.eventsProcessed;
+        lastTimestampNs_ = tick.timestampNs;
+
+        // Orders due strictly before this tick fill at the prices that held then
+        fillDue(tick.timestampNs, false);
+
+        SymbolState& state = stateFor(tick.symbolId);
+        state.lastPrice = tick.price;
+        ++state.ticks;
+        book_.updatePrice(tick.symbolId, tick.price);
+
+        int signal = state.strategy(tick);
+        if (signal != 0 && !state.orderInFlight && wantsOrder(state, signal)) {
+            pending_.push_back(PendingOrder{tick.timestampNs + latencyNs_, tick.symbolId,
+                                            signal > 0 ? Side::BUY : Side::SELL});
+            state.orderInFlight = true;
+            ++result_.ordersSubmitted;
+        }
+
+        // With zero latency the order fills at this tick
+        fillDue(tick.timestampNs, true);
+
+        if (tick.timestampNs >= nextSampleNs_) {
+            sampleEquity(tick.timestampNs);
+            nextSampleNs_ = tick.timestampNs + intervalNs_;
+        }
+    }
+
+    PortfolioBacktestResult finish() {
+        result_.ordersExpired = pending_.size();
+        pending_.clear();
+
+        // Close whatever is still open at each symbol's last price
+        for (SymbolId id = 0; id < states_.size(); ++id) {
+            if (states_[id].position != 0.0) {
+                closePosition(id, states_[id], states_[id].lastPrice, "END_OF_BACKTEST");
+            }
+        }
+        if (result_.eventsProcessed > 0) sampleEquity(lastTimestampNs_);
+        result_.commissions = commissions_;
+        result_.finalEquity = currentEquity();
+        if (exec_.initialCapital > 0.0) {
+            result_.netReturn = (result_.finalEquity / exec_.initialCapital - 1.0) * 100.0;
+        }
+
+        for (SymbolId id = 0; id < states_.size(); ++id) {
+            const SymbolState& state = states_[id];
+            if (state.ticks == 0) continue;
+            result_.symbols.push_back(SymbolSummary{
+                SymbolRegistry::instance().name(id), state.ticks, state.numTrades, state.pnl});
+        }
+
+        computeTradeStatistics(result_.portfolio, exec_.initialCapital);
+        return std::move(result_);
+    }
+
+private:
+    SymbolState& stateFor(SymbolId id) {
+        if (id >= states_.size()) states_.resize(id + 1);
+        SymbolState& state = states_[id];
+        if (!state.strategy) state.strategy = makeStrategy_(id);
+        return state;
+    }
+
+    // Same gating as Backtester: buy only when flat or short, sell only when
+    // flat or long (and flat only if shorting is on)
+    bool wantsOrder(const SymbolState& state, int signal) const {
+        if (signal > 0) return state.position <= 0;
+        return state.position > 0 || (state.position == 0 && exec_.enableShortSelling);
+    }
+
+    void fillDue(int64_t nowNs, bool inclusive) {
+        while (!pending_.empty()) {
+            const PendingOrder& order = pending_.front();
+            if (inclusive ? order.fillTimeNs > nowNs : order.fillTimeNs >= nowNs) break;
+
+            PendingOrder due = order;
+            pending_.pop_front();   // constant latency keeps the queue in fill-time order
+            fill(due);
+        }
+    }
+
+    void fill(const PendingOrder& order) {
+        SymbolState& state = states_[order.symbol];
+        state.orderInFlight = false;
+
+        const long fillMs = static_cast<long>(order.fillTimeNs / 1000000);
+        const bool isBuy = order.side == Side::BUY;
+        const char* reason = isBuy ? "SIGNAL_BUY" : "SIGNAL_SELL";
+
+        // Close the opposing position first; a sell with shorting off stops there.
+        // The close always fills; a reopen that fails the capital check leaves
+        // the symbol flat and is counted on its own.
+        if ((isBuy && state.position < 0) || (!isBuy && state.position > 0)) {
+            closePosition(order.symbol, state, state.lastPrice, reason, fillMs);
+            ++result_.ordersFilled;
+
+            if ((isBuy || exec_.enableShortSelling) && !openPosition(order.symbol, state, isBuy, fillMs)) {
+                ++result_.reopensRejected;
+                if (config_.logTrades) {
+                    std::cout << "[Reject] " << SymbolRegistry::instance().name(order.symbol)
+                              << " " << (isBuy ? "LONG" : "SHORT")
+                              << " reopen failed the capital check" << std::endl;
+                }
+            }
+            return;
+        }
+
+        if (openPosition(order.symbol, state, isBuy, fillMs)) {
+            ++result_.ordersFilled;
+        } else {
+            ++result_.ordersRejected;
+        }
+    }
+
+    // False if the capital check fails
+    bool openPosition(SymbolId id, SymbolState& state, bool isBuy, long fillMs) {
+        const double executionPrice = slipped(state.lastPrice, isBuy);
+        const double equity = currentEquity();
+        const double quantity = equity * positionFraction_ / executionPrice;
+        const double notional = executionPrice * quantity;
+
+        const double leverage = exec_.enableMarginTrading && exec_.marginRequirement > 0.0
+            ? 1.0 / exec_.marginRequirement : 1.0;
+        if (quantity <= 0.0 || book_.getPortfolioMetrics().exposure + notional > equity * leverage) {
+            return false;
+        }
+
+        const double signedQty = isBuy ? quantity : -quantity;
+        commissions_ += notional * exec_.commissionRate;
+        book_.addPosition(id, signedQty, executionPrice, fillMs);
+        state.position = signedQty;
+        state.avgEntryPrice = executionPrice;
+
+        if (config_.logTrades) {
+            std::cout << "[Entry] " << SymbolRegistry::instance().name(id)
+                      << " " << (isBuy ? "LONG" : "SHORT")
+                      << " | Price: " << executionPrice
+                      << " | Qty: " << quantity << std::endl;
+        }
+        return true;
+    }
+
+    void closePosition(SymbolId id, SymbolState& state, double price, const char* reason, long timestampMs = 0) {
+        const bool isLong = state.position > 0;
+        const double quantity = std::abs(state.position);
+        const double executionPrice = slipped(price, !isLong);
+        const double commission = executionPrice * quantity * exec_.commissionRate;
+
+        Trade trade;
+        trade.symbol = SymbolRegistry::instance().name(id);
+        trade.timestamp = timestampMs != 0 ? timestampMs : static_cast<long>(lastTimestampNs_ / 1000000);
+        trade.entryPrice = state.avgEntryPrice;
+        trade.exitPrice = executionPrice;
+        trade.quantity = quantity;
+        trade.isLong = isLong;
+        trade.pnl = (executionPrice - state.avgEntryPrice) * state.position;
+        trade.commission = commission;
+        trade.slippage = executionPrice - price;
+        trade.entryReason = isLong ? "SIGNAL_BUY" : "SIGNAL_SELL";
+        trade.exitReason = reason;
+
+        commissions_ += commission;
+        book_.closePosition(id, executionPrice, trade.timestamp);
+
+        state.pnl += trade.pnl;
+        ++state.numTrades;
+        state.position = 0.0;
+        state.avgEntryPrice = 0.0;
+
+        if (config_.logTrades) {
+            std::cout << "[Exit] " << trade.symbol << " " << (isLong ? "LONG" : "SHORT")
+                      << " | Price: " << executionPrice
+                      << " | PnL: " << trade.pnl
+                      << " | Reason: " << reason << std::endl;
+        }
+
+        result_.portfolio.trades.push_back(std::move(trade));
+    }
+
+    double slipped(double price, bool isBuy) const {
+        return price * (1.0 + (isBuy ? 1.0 : -1.0) * (exec_.slippageBps / 10000.0));
+    }
+
+    // Mark-to-market value net of commissions; O(1) from the book's running totals
+    double currentEquity() const {
+        return book_.getPortfolioMetrics().totalValue - commissions_;
+    }
+
+    void sampleEquity(int64_t timestampNs) {
+        result_.portfolio.equityCurve.push_back(currentEquity());
+        result_.portfolio.timestamps.push_back(static_cast<long>(timestampNs / 1000000));
+    }
+
+    const PortfolioBacktestConfig& config_;
+    const BacktestConfig& exec_;
+    const SymbolStrategyFactory& makeStrategy_;
+
+    PnLTracker book_;
+    std::vector<SymbolState> states_;   // indexed by SymbolId
+    std::deque<PendingOrder> pending_;
+
+    double positionFraction_;
+    int64_t latencyNs_;
+    int64_t intervalNs_;
+    int64_t nextSampleNs_;
+    double commissions_;
+    int64_t lastTimestampNs_;
+
+    PortfolioBacktestResult result_;
+};
+
+} // namespace
+
+PortfolioBacktester::PortfolioBacktester(const PortfolioBacktestConfig& config)
+    : config_(config) {}
+
+PortfolioBacktestResult PortfolioBacktester::run(
+    const std::vector<TickView>& streams,
+    const SymbolStrategyFactory& makeStrategy
+) const {
+    auto start = std::chrono::steady_clock::now();
+
+    // Default sizing splits maxPositionSize across the basket
+    double fraction = config_.positionFraction;
+    if (fraction <= 0.0) {
+        std::vector<uint8_t> seen;
+        size_t numSymbols = 0;
+        for (const auto& stream : streams) {
+            for (size_t i = 0; i < stream.size(); ++i) {
+                SymbolId id = stream.symbolId(i);
+                if (id >= seen.size()) seen.resize(id + 1, 0);
+                if (!seen[id]) {
+                    seen[id] = 1;
+                    ++numSymbols;
+                }
+            }
+        }
+        fraction = config_.execution.maxPositionSize / std::max<size_t>(1, numSymbols);
+    }
+
+    PortfolioRun run(config_, makeStrategy, fraction);
+
+    MergeHeap heap;
+    std::vector<size_t> cursor(streams.size(), 0);
+    heap.reserve(streams.size());
+    for (size_t s = 0; s < streams.size(); ++s) {
+        if (!streams[s].empty()) {
+            heap.push(MergeHeap::Entry{streams[s].timestampNs(0), static_cast<uint32_t>(s)});
+        }
+    }
+
+    while (!heap.empty()) {
+        const uint32_t s = heap.top().stream;
+        const TickView& stream = streams[s];
+        size_t& i = cursor[s];
+
+        run.onTick(stream[i]);
+
+        if (++i < stream.size()) {
+            heap.replaceTop(stream.timestampNs(i));
+        } else {
+            heap.popTop();
+        }
+    }
+
+    PortfolioBacktestResult result = run.finish();
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+PortfolioBacktestResult PortfolioBacktester::run(
+    const TapeReader& tape,
+    const SymbolStrategyFactory& makeStrategy
+) const {
+    // A chunk holds whatever the recorder flushed together, from every feed,
+    // so it need not be in time order. Split each into its non-decreasing
+    // runs; the merge then restores one timeline whatever the chunk layout
+    std::vector<TickView> streams;
+    streams.reserve(tape.numChunks());
+    for (size_t c = 0; c < tape.numChunks(); ++c) {
+        const TickView chunk = tape.chunk(c);
+        size_t begin = 0;
+        for (size_t i = 1; i <= chunk.size(); ++i) {
+            if (i == chunk.size() || chunk.timestampNs(i) < chunk.timestampNs(i - 1)) {
+                streams.push_back(chunk.slice(begin, i - begin));
+                begin = i;
+            }
+        }
+    }
+    return run(streams, makeStrategy);
+}
+
+void printPortfolioSummary(const PortfolioBacktestResult& result, std::ostream& out) {
+    const BacktestResult& p = result.portfolio;
+    const double eventsPerSec = result.elapsedSeconds > 0 ? result.eventsProcessed / result.elapsedSeconds : 0.0;
+
+    out << std::fixed << std::setprecision(2);
+    out << " Portfolio Summary:" << std::endl;
+    out << "   • Events: " << result.eventsProcessed << " in " << std::setprecision(3)
+        << result.elapsedSeconds << " s (" << std::setprecision(0) << eventsPerSec << " events/s)" << std::endl;
+    out << "   • Orders: " << result.ordersSubmitted << " submitted, " << result.ordersFilled << " filled, "
+        << result.ordersRejected << " rejected, " << result.ordersExpired << " expired";
+    if (result.reopensRejected > 0) out << " (" << result.reopensRejected << " reversals not reopened)";
+    out << std::endl;
+    out << std::setprecision(2);
+
+    // Trade PnL is gross; the equity curve (and Max Drawdown) is net of commissions
+    out << "   • Total PnL: " << p.totalPnL << " (" << p.totalReturn << "%) before commissions" << std::endl;
+    out << "   • Commissions: " << result.commissions << " | Final Equity: " << result.finalEquity
+        << " (" << result.netReturn << "% net)" << std::endl;
+    out << "   • Total Trades: " << p.numTrades << " | Win Rate: " << p.winRate * 100 << "%" << std::endl;
+    out << "   • Sharpe Ratio: " << std::setprecision(3) << p.sharpeRatio
+        << " | Max Drawdown: " << std::setprecision(2) << p.maxDrawdown << std::endl;
+
+    out << "\n " << std::left << std::setw(12) << "Symbol" << std::right
+        << std::setw(10) << "Ticks" << std::setw(8) << "Trades" << std::setw(14) << "PnL" << std::endl;
+    for (const auto& s : result.symbols) {
+        out << " " << std::left << std::setw(12) << s.symbol << std::right
+            << std::setw(10) << s.ticks << std::setw(8) << s.numTrades
+            << std::setw(14) << s.pnl << std::endl;
+    }
+}
@@ -1,6 +1,8 @@
 #include "backtest/sharpe.h"
+#include "alpha/rolling_stats.h"
 #include <algorithm>
 #include <numeric>
+#include <cmath>
 
 static double mean(const std::vector<double>& data) {
     if (data.empty()) return 0.0;
@@ -103,35 +105,47 @@ double computeMaxDrawdownPercent(const std::vector<double>& equityCurve) {
     return maxDDPct * 100.0;
 }
 
+// Index of the (1 - confidence) percentile in ascending order
+static size_t tailIndex(size_t n, double confidenceLevel) {
+    size_t idx = static_cast<size_t>((1.0 - confidenceLevel) * n);
+    return std::min(idx, n - 1);
+}
+
+// Partition tail so that tail[idx] is the idx-th smallest value and everything
+// before it is <= tail[idx]; fills var / cvar for that percentile
+static void tailRisk(std::vector<double>& tail, double confidenceLevel, double& var, double& cvar) {
+    const size_t idx = tailIndex(tail.size(), confidenceLevel);
+    std::nth_element(tail.begin(), tail.begin() + idx, tail.end());
+
+    double sum = 0.0;
+    for (size_t i = 0; i <= idx; ++i) {
+        sum += tail[i];
+    }
+
+    var = -tail[idx];             // VaR is positive, so negate
+    cvar = -(sum / (idx + 1));    // CVaR is positive, so negate
+}
+
 double computeVaR(const std::vector<double>& returns, double confidenceLevel) {
     if (returns.empty()) return 0.0;
 
-    std::vector<double> sortedReturns = returns;
-    std::sort(sortedReturns.begin(), sortedReturns.end());
+    // Only the percentile is needed, not a full sort
+    std::vector<double> tail = returns;
+    const size_t idx = tailIndex(tail.size(), confidenceLevel);
+    std::nth_element(tail.begin(), tail.begin() + idx, tail.end());
 
-    // Find the (1 - confidence) percentile
-    size_t idx = static_cast<size_t>((1.0 - confidenceLevel) * sortedReturns.size());
-    idx = std::min(idx, sortedReturns.size() - 1);
-
-    return -sortedReturns[idx];  // VaR is positive, so negate
+    return -tail[idx];  // VaR is positive, so negate
 }
 
 double computeCVaR(const std::vector<double>& returns, double confidenceLevel) {
     if (returns.empty()) return 0.0;
 
-    std::vector<double> sortedReturns = returns;
-    std::sort(sortedReturns.begin(), sortedReturns.end());
-
     // Average of all returns below VaR threshold
-    size_t idx = static_cast<size_t>((1.0 - confidenceLevel) * sortedReturns.size());
-    idx = std::min(idx, sortedReturns.size() - 1);
-
-    double sum = 0.0;
-    for (size_t i = 0; i <= idx; ++i) {
-        sum += sortedReturns[i];
-    }
+    std::vector<double> tail = returns;
+    double var, cvar;
+    tailRisk(tail, confidenceLevel, var, cvar);
 
-    return -(sum / (idx + 1));  // CVaR is positive, so negate
+    return cvar;
 }
 
 double computeInformationRatio(const std::vector<double>& portfolioReturns,
@@ -181,22 +195,75 @@ double computeProfitFactor(const std::vector<double>& returns) {
 PerformanceMetrics computeAllMetrics(const std::vector<double>& returns,
                                     const std::vector<double>& equityCurve,
                                     double riskFreeRate) {
+    std::vector<double> scratch;
+    return computeAllMetrics(returns, equityCurve, riskFreeRate, scratch);
+}
+
+PerformanceMetrics computeAllMetrics(const std::vector<double>& returns,
+                                    const std::vector<double>& equityCurve,
+                                    double riskFreeRate,
+                                    std::vector<double>& scratch) {
     PerformanceMetrics metrics{};
 
     if (returns.empty()) return metrics;
 
-    metrics.sharpeRatio = computeSharpeRatio(returns, riskFreeRate);
-    metrics.sortinoRatio = computeSortinoRatio(returns, riskFreeRate);
-    metrics.maxDrawdown = computeMaxDrawdown(equityCurve);
-    metrics.maxDrawdownPercent = computeMaxDrawdownPercent(equityCurve);
-    metrics.calmarRatio = computeCalmarRatio(returns, metrics.maxDrawdown);
-    metrics.var95 = computeVaR(returns, 0.95);
-    metrics.cvar95 = computeCVaR(returns, 0.95);
-    metrics.volatility = stddev(returns) * std::sqrt(252.0);
-    metrics.averageReturn = mean(returns);
-    metrics.totalReturn = std::accumulate(returns.begin(), returns.end(), 0.0);
-    metrics.winRate = computeWinRate(returns);
-    metrics.profitFactor = computeProfitFactor(returns);
+    const double periodsPerYear = 252.0;
+    const size_t n = returns.size();
+
+    // One pass over returns: moments (Welford), downside, wins / losses
+    double meanReturn = 0.0, m2 = 0.0, total = 0.0;
+    double downsideSq = 0.0, sumWins = 0.0, sumLosses = 0.0;
+    size_t downsideCount = 0, wins = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        const double r = returns[i];
+        total += r;
+
+        const double delta = r - meanReturn;
+        meanReturn += delta / static_cast<double>(i + 1);
+        m2 += delta * (r - meanReturn);
+
+        if (r < 0.0) {
+            downsideSq += r * r;
+            ++downsideCount;
+        }
+        if (r > 0) {
+            sumWins += r;
+            ++wins;
+        } else {
+            sumLosses += std::abs(r);
+        }
+    }
+
+    // One pass over equity: absolute and percentage drawdown together
+    double maxDD = 0.0, maxDDPct = 0.0;
+    if (!equityCurve.empty()) {
+        double peak = equityCurve[0];
+        for (auto equity : equityCurve) {
+            peak = std::max(peak, equity);
+            maxDD = std::max(maxDD, peak - equity);
+            if (peak > 0.0) maxDDPct = std::max(maxDDPct, (peak - equity) / peak);
+        }
+    }
+
+    const double sd = n >= 2 ? std::sqrt(m2 / (n - 1)) : 0.0;
+    const double downsideDev = downsideCount > 0 ? std::sqrt(downsideSq / downsideCount) : 0.0;
+    const double excessReturn = meanReturn - riskFreeRate / periodsPerYear;
+
+    metrics.sharpeRatio = (n >= 2 && sd >= 1e-10) ? (excessReturn / sd) * std::sqrt(periodsPerYear) : 0.0;
+    metrics.sortinoRatio = (n >= 2 && downsideDev >= 1e-10) ? (excessReturn / downsideDev) * std::sqrt(periodsPerYear) : 0.0;
+    metrics.maxDrawdown = maxDD;
+    metrics.maxDrawdownPercent = maxDDPct * 100.0;
+    metrics.calmarRatio = maxDD < 1e-10 ? 0.0 : ((total / n) * 252.0) / maxDD;
+    metrics.volatility = sd * std::sqrt(252.0);
+    metrics.averageReturn = meanReturn;
+    metrics.totalReturn = total;
+    metrics.winRate = static_cast<double>(wins) / n;
+    metrics.profitFactor = (sumLosses > 0) ? sumWins / sumLosses : 0.0;
+
+    // VaR and CVaR share one partition of one copy
+    scratch.assign(returns.begin(), returns.end());
+    tailRisk(scratch, 0.95, metrics.var95, metrics.cvar95);
 
     return metrics;
 }
@@ -206,13 +273,24 @@ std::vector<double> computeRollingSharpe(const std::vector<double>& returns,
                                         double riskFreeRate) {
     std::vector<double> rollingSharpe;
 
-    if (returns.size() < window) return rollingSharpe;
+    if (returns.size() < window || window == 0) return rollingSharpe;
+    rollingSharpe.reserve(returns.size() - window + 1);
+
+    const double periodsPerYear = 252.0;
+    const double dailyRiskFree = riskFreeRate / periodsPerYear;
 
-    for (size_t i = window; i <= returns.size(); ++i) {
-        std::vector<double> windowReturns(returns.begin() + i - window,
-                                         returns.begin() + i);
-        double sharpe = computeSharpeRatio(windowReturns, riskFreeRate);
-        rollingSharpe.push_back(sharpe);
+    // Sliding mean / std dev instead of re-scanning every window
+    RollingStats stats(window);
+    for (size_t i = 0; i < returns.size(); ++i) {
+        stats.push(returns[i]);
+        if (!stats.full()) continue;
+
+        const double sd = stats.stddev();
+        if (window < 2 || sd < 1e-10) {
+            rollingSharpe.push_back(0.0);
+        } else {
+            rollingSharpe.push_back(((stats.mean() - dailyRiskFree) / sd) * std::sqrt(periodsPerYear));
+        }
     }
 
     return rollingSharpe;
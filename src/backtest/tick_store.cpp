@@ -0,0 +1,458 @@
+#include "backtest/tick_store.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'A', 'L', 'P', 'H', 'T', 'A', 'P', 'E'};
+constexpr uint32_t TAPE_VERSION = 1;
+constexpr uint32_t CHUNK_MAGIC = 0x4B4E4843;  // "CHNK"
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t chunkTicks;
+    uint64_t reserved[2];
+};
+
+struct ChunkHeader {
+    uint32_t magic;
+    uint32_t tickCount;
+    uint32_t newSymbols;
+    uint32_t symbolBytes;       // size of the symbol definitions, before padding
+    int64_t firstTimestampNs;
+    int64_t lastTimestampNs;
+};
+
+static_assert(sizeof(FileHeader) == 32, "tape header layout");
+static_assert(sizeof(ChunkHeader) == 32, "tape chunk header layout");
+
+size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+size_t columnBytes(size_t count) {
+    return align8(count * (sizeof(int64_t) + 2 * sizeof(double) + sizeof(SymbolId)));
+}
+
+} // namespace
+
+// === TickView / TickColumns ===
+TickView TickView::slice(size_t begin, size_t count) const {
+    begin = std::min(begin, size_);
+    count = std::min(count, size_ - begin);
+    return TickView(timestampsNs_ + begin, prices_ + begin, quantities_ + begin,
+                    symbolIds_ + begin, count, remap_);
+}
+
+void TickColumns::reserve(size_t n) {
+    timestampsNs_.reserve(n);
+    prices_.reserve(n);
+    quantities_.reserve(n);
+    symbolIds_.reserve(n);
+}
+
+void TickColumns::push(const CompactTick& tick) {
+    timestampsNs_.push_back(tick.timestampNs);
+    prices_.push_back(tick.price);
+    quantities_.push_back(tick.quantity);
+    symbolIds_.push_back(tick.symbolId);
+}
+
+void TickColumns::append(const TickView& view) {
+    reserve(size() + view.size());
+    for (size_t i = 0; i < view.size(); ++i) push(view[i]);
+}
+
+void TickColumns::clear() {
+    timestampsNs_.clear();
+    prices_.clear();
+    quantities_.clear();
+    symbolIds_.clear();
+}
+
+TickView TickColumns::view() const {
+    return TickView(timestampsNs_.data(), prices_.data(), quantities_.data(),
+                    symbolIds_.data(), size());
+}
+
+TickColumns TickColumns::fromTicks(const std::vector<MarketTick>& ticks) {
+    TickColumns columns;
+    columns.reserve(ticks.size());
+
+    SymbolLookup symbols;
+    for (const auto& tick : ticks) {
+        columns.push(CompactTick{
+            symbols(tick.symbol),
+            tick.price,
+            tick.volume,
+            static_cast<int64_t>(tick.timestamp) * 1000000
+        });
+    }
+    return columns;
+}
+
+// === TapeWriter ===
+TapeWriter::TapeWriter(const std::string& path, size_t chunkTicks)
+    : path_(path),
+      file_(std::fopen(path.c_str(), "wb")),
+      chunkTicks_(std::max<size_t>(1, chunkTicks)),
+      ticksWritten_(0),
+      chunksWritten_(0) {
+    if (!file_) {
+        throw std::runtime_error("Cannot create tape file: " + path);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = TAPE_VERSION;
+    header.chunkTicks = static_cast<uint32_t>(chunkTicks_);
+    writeBytes(&header, sizeof(header));
+
+    pending_.reserve(chunkTicks_);
+}
+
+TapeWriter::~TapeWriter() {
+    try {
+        close();
+    } catch (const std::exception& e) {
+        std::cerr << "[Tape] " << e.what() << "; last chunk lost" << std::endl;
+    }
+}
+
+void TapeWriter::append(const CompactTick& tick) {
+    noteSymbol(tick.symbolId);
+    pending_.push(tick);
+    if (pending_.size() >= chunkTicks_) writeChunk();
+}
+
+void TapeWriter::append(const TickView& view) {
+    for (size_t i = 0; i < view.size(); ++i) append(view[i]);
+}
+
+void TapeWriter::flush() {
+    if (!pending_.empty()) writeChunk();
+    if (file_) std::fflush(file_);
+}
+
+void TapeWriter::close() {
+    if (!file_) return;
+
+    // The file is closed even if the final write fails
+    try {
+        flush();
+    } catch (...) {
+        std::fclose(file_);
+        file_ = nullptr;
+        throw;
+    }
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void TapeWriter::noteSymbol(SymbolId id) {
+    if (id >= symbolWritten_.size()) symbolWritten_.resize(id + 1, 0);
+    if (!symbolWritten_[id]) {
+        symbolWritten_[id] = 1;
+        newSymbols_.push_back(id);
+    }
+}
+
+void TapeWriter::writeChunk() {
+    if (!file_ || pending_.empty()) return;
+
+    // Symbol definitions first used in this chunk
+    std::vector<uint8_t> symbolBlock;
+    for (SymbolId id : newSymbols_) {
+        const std::string& name = SymbolRegistry::instance().name(id);
+        uint16_t len = static_cast<uint16_t>(std::min<size_t>(name.size(), UINT16_MAX));
+
+        size_t offset = symbolBlock.size();
+        symbolBlock.resize(offset + sizeof(id) + sizeof(len) + len);
+        std::memcpy(&symbolBlock[offset], &id, sizeof(id));
+        std::memcpy(&symbolBlock[offset + sizeof(id)], &len, sizeof(len));
+        std::memcpy(&symbolBlock[offset + sizeof(id) + sizeof(len)], name.data(), len);
+    }
+
+    TickView view = pending_.view();
+    const size_t n = view.size();
+
+    ChunkHeader header{};
+    header.magic = CHUNK_MAGIC;
+    header.tickCount = static_cast<uint32_t>(n);
+    header.newSymbols = static_cast<uint32_t>(newSymbols_.size());
+    header.symbolBytes = static_cast<uint32_t>(symbolBlock.size());
+    header.firstTimestampNs = view.timestampNs(0);
+    header.lastTimestampNs = view.timestampNs(n - 1);
+
+    static const uint8_t padding[8] = {0};
+
+    writeBytes(&header, sizeof(header));
+    writeBytes(symbolBlock.data(), symbolBlock.size());
+    writeBytes(padding, align8(symbolBlock.size()) - symbolBlock.size());
+
+    std::vector<SymbolId> ids(n);
+    for (size_t i = 0; i < n; ++i) ids[i] = view.symbolId(i);
+
+    writeBytes(view.timestampsNs(), n * sizeof(int64_t));
+    writeBytes(view.prices(), n * sizeof(double));
+    writeBytes(view.quantities(), n * sizeof(double));
+    writeBytes(ids.data(), n * sizeof(SymbolId));
+    writeBytes(padding, columnBytes(n) - n * (sizeof(int64_t) + 2 * sizeof(double) + sizeof(SymbolId)));
+
+    ticksWritten_ += n;
+    ++chunksWritten_;
+    pending_.clear();
+    newSymbols_.clear();
+}
+
+void TapeWriter::writeBytes(const void* data, size_t bytes) {
+    if (bytes == 0) return;
+    if (std::fwrite(data, 1, bytes, file_) != bytes) {
+        throw std::runtime_error("Failed writing tape file: " + path_);
+    }
+}
+
+// === TapeReader ===
+TapeReader::TapeReader(const std::string& path)
+    : data_(nullptr), bytes_(0), totalTicks_(0), truncated_(false) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open tape file: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a tick tape (too short): " + path);
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+
+    void* mapped = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Cannot mmap tape file: " + path);
+    }
+    data_ = static_cast<const uint8_t*>(mapped);
+
+#ifdef MADV_SEQUENTIAL
+    ::madvise(mapped, bytes_, MADV_SEQUENTIAL);
+#endif
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != TAPE_VERSION) {
+        ::munmap(mapped, bytes_);
+        throw std::runtime_error("Not a tick tape (bad header): " + path);
+    }
+
+    indexChunks();
+
+    if (truncated_) {
+        std::cerr << "[Tape] " << path << " ends in a partial or corrupt chunk; replaying "
+                  << totalTicks_ << " ticks from complete chunks" << std::endl;
+    }
+}
+
+TapeReader::~TapeReader() {
+    if (data_) ::munmap(const_cast<uint8_t*>(data_), bytes_);
+}
+
+void TapeReader::indexChunks() {
+    size_t offset = sizeof(FileHeader);
+
+    while (offset < bytes_) {
+        if (bytes_ - offset < sizeof(ChunkHeader)) {
+            truncated_ = true;
+            break;
+        }
+
+        ChunkHeader header;
+        std::memcpy(&header, data_ + offset, sizeof(header));
+        if (header.magic != CHUNK_MAGIC) {
+            truncated_ = true;
+            break;
+        }
+
+        size_t symbolsAt = offset + sizeof(ChunkHeader);
+        size_t columnsAt = symbolsAt + align8(header.symbolBytes);
+        size_t chunkEnd = columnsAt + columnBytes(header.tickCount);
+        if (chunkEnd > bytes_) {
+            truncated_ = true;
+            break;
+        }
+
+        // Re-intern this chunk's new symbols into the current process
+        const uint8_t* p = data_ + symbolsAt;
+        const uint8_t* symbolsEnd = p + header.symbolBytes;
+        for (uint32_t s = 0; s < header.newSymbols && p + sizeof(SymbolId) + sizeof(uint16_t) <= symbolsEnd; ++s) {
+            SymbolId tapeId;
+            uint16_t len;
+            std::memcpy(&tapeId, p, sizeof(tapeId));
+            std::memcpy(&len, p + sizeof(tapeId), sizeof(len));
+            p += sizeof(tapeId) + sizeof(len);
+            if (p + len > symbolsEnd) break;
+
+            if (tapeId >= remap_.size()) remap_.resize(tapeId + 1, INVALID_SYMBOL_ID);
+            remap_[tapeId] = SymbolRegistry::instance().intern(
+                std::string_view(reinterpret_cast<const char*>(p), len));
+            p += len;
+        }
+
+        // Every id must name a symbol defined by this or an earlier chunk,
+        // or TickView::symbolId would read past remap_
+        const SymbolId* ids = reinterpret_cast<const SymbolId*>(
+            data_ + columnsAt + header.tickCount * (sizeof(int64_t) + 2 * sizeof(double)));
+        bool idsValid = true;
+        for (uint32_t i = 0; i < header.tickCount && idsValid; ++i) {
+            idsValid = ids[i] < remap_.size() && remap_[ids[i]] != INVALID_SYMBOL_ID;
+        }
+        if (!idsValid) {
+            truncated_ = true;
+            break;
+        }
+
+        chunks_.push_back(ChunkIndex{data_ + columnsAt, header.tickCount,
+                                     header.firstTimestampNs, header.lastTimestampNs});
+        totalTicks_ += header.tickCount;
+        offset = chunkEnd;
+    }
+}
+
+TickView TapeReader::chunk(size_t i) const {
+    const ChunkIndex& c = chunks_[i];
+    const size_t n = c.count;
+
+    // Column offsets are multiples of 8, so these casts are aligned
+    const int64_t* ts = reinterpret_cast<const int64_t*>(c.columns);
+    const double* prices = reinterpret_cast<const double*>(c.columns + n * sizeof(int64_t));
+    const double* quantities = prices + n;
+    const SymbolId* ids = reinterpret_cast<const SymbolId*>(quantities + n);
+
+    return TickView(ts, prices, quantities, ids, n, remap_.data());
+}
+
+int64_t TapeReader::firstTimestampNs() const {
+    return chunks_.empty() ? 0 : chunks_.front().firstTimestampNs;
+}
+
+int64_t TapeReader::lastTimestampNs() const {
+    return chunks_.empty() ? 0 : chunks_.back().lastTimestampNs;
+}
+
+TickColumns TapeReader::load() const {
+    TickColumns columns;
+    columns.reserve(totalTicks_);
+    for (size_t i = 0; i < chunks_.size(); ++i) columns.append(chunk(i));
+    return columns;
+}
+
+// === TapeRecorder ===
+TapeRecorder::TapeRecorder(const std::string& path, size_t chunkTicks)
+    : writer_(path, chunkTicks),
+      chunkTicks_(std::max<size_t>(1, chunkTicks)),
+      stopping_(false),
+      recorded_(0),
+      written_(0),
+      failed_(false) {
+    active_.reserve(chunkTicks_);
+    draining_.reserve(chunkTicks_);
+}
+
+TapeRecorder::~TapeRecorder() {
+    try {
+        stop();
+    } catch (const std::exception& e) {
+        std::cerr << "[Tape] " << e.what() << std::endl;
+    }
+}
+
+void TapeRecorder::start() {
+    if (thread_.joinable() || stopping_) return;
+    thread_ = std::thread(&TapeRecorder::writerLoop, this);
+}
+
+void TapeRecorder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) thread_.join();
+
+    if (error_) {
+        std::exception_ptr error = std::exchange(error_, nullptr);
+        active_.clear();
+        try {
+            writer_.close();
+        } catch (const std::exception&) {
+            // Most likely the same failure again; report the first one
+        }
+        std::rethrow_exception(error);
+    }
+
+    // Anything recorded without a running writer thread
+    writer_.append(active_.view());
+    written_.fetch_add(active_.size(), std::memory_order_relaxed);
+    active_.clear();
+    writer_.close();
+}
+
+void TapeRecorder::record(const CompactTick& tick) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;   // tape already closed
+        active_.push(tick);
+        wake = active_.size() >= chunkTicks_;
+    }
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+    if (wake) wake_.notify_one();
+}
+
+void TapeRecorder::writerLoop() {
+    auto lastFlush = std::chrono::steady_clock::now();
+
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(200), [this] {
+                return stopping_ || active_.size() >= chunkTicks_;
+            });
+            std::swap(active_, draining_);
+            stopping = stopping_;
+        }
+
+        try {
+            writer_.append(draining_.view());
+            written_.fetch_add(draining_.size(), std::memory_order_relaxed);
+            draining_.clear();
+
+            // Bound what a crash can lose to a few seconds of ticks
+            auto now = std::chrono::steady_clock::now();
+            if (now - lastFlush >= std::chrono::seconds(5)) {
+                writer_.flush();
+                lastFlush = now;
+            }
+        } catch (...) {
+            // Disk full or gone: stop taking ticks and let stop() rethrow
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            failed_.store(true, std::memory_order_relaxed);
+            stopping_ = true;
+            draining_.clear();
+            return;
+        }
+
+        if (stopping) break;
+    }
+}
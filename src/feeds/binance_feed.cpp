@@ -2,10 +2,12 @@
 #include "alpha/alpha_engine.h"
 #include "feeds/candle_aggregator.h"
 #include "util/market_types.h"
+#include "util/latency_metrics.h"
+#include "util/logger.h"
 
 #include <nlohmann/json.hpp>
-#include <iostream>
 #include <chrono>
+#include <algorithm>
 
 using json = nlohmann::json;
 
@@ -17,23 +19,68 @@ BinancePublicFeed::BinancePublicFeed(
     : symbols_(symbols),
       engine_(engine),
       aggregator_(aggregator),
+      symbolIds_(symbols),
+      tick_{},
+      fastPathCount_(0),
+      fallbackCount_(0),
+      errorCount_(0),
+      quoteCount_(0),
+      verbose_(true),
       running_(false)
-{}
+{
+    for (const auto& symbol : symbols_) {
+        std::string stream = symbol;
+        std::transform(stream.begin(), stream.end(), stream.begin(), ::tolower);
 
-void BinancePublicFeed::setTickCallback(std::function<void(const MarketTick&)> callback) {
+        SymbolId id = symbolIds_(symbol);
+        depthStreams_.emplace_back(stream, id);
+        if (id >= books_.size()) books_.resize(id + 1);
+        books_[id] = std::make_unique<OrderBook>(64);
+    }
+}
+
+void BinancePublicFeed::setTickCallback(std::function<void(const CompactTick&)> callback) {
     tickCallback_ = std::move(callback);
 }
 
+void BinancePublicFeed::setQuoteCallback(std::function<void(const QuoteEvent&)> callback) {
+    quoteCallback_ = std::move(callback);
+}
+
+bool BinancePublicFeed::getBook(SymbolId symbolId, size_t depth, OrderBookSnapshot& out) const {
+    std::lock_guard<std::mutex> lock(bookMutex_);
+    if (symbolId >= books_.size() || !books_[symbolId] || books_[symbolId]->empty()) return false;
+
+    books_[symbolId]->depth(depth, out);
+    out.symbol = SymbolRegistry::instance().name(symbolId);
+    return true;
+}
+
+void BinancePublicFeed::setRawMessageHook(std::function<void(const std::string&)> hook) {
+    rawMessageHook_ = std::move(hook);
+}
+
+fastjson::ParseStats BinancePublicFeed::getParseStats() const {
+    return {
+        fastPathCount_.load(std::memory_order_relaxed),
+        fallbackCount_.load(std::memory_order_relaxed),
+        errorCount_.load(std::memory_order_relaxed)
+    };
+}
+
 void BinancePublicFeed::start() {
     running_ = true;
     wsThread_ = std::thread(&BinancePublicFeed::connectWebSocket, this);
 }
 
+BinancePublicFeed::~BinancePublicFeed() {
+    stop();
+}
+
+// The socket is created and stopped on the worker thread, so once this
+// returns no callback is running or will run
 void BinancePublicFeed::stop() {
     running_ = false;
-    if (ws_) {
-        ws_->stop();
-    }
     if (wsThread_.joinable()) {
         wsThread_.join();
     }
@@ -47,7 +94,7 @@ void BinancePublicFeed::connectWebSocket() {
         // Convert to lowercase
         std::transform(symbol.begin(), symbol.end(), symbol.begin(), ::tolower);
 
-        streams += symbol + "@trade";
+        streams += symbol + "@trade/" + symbol + "@depth20@100ms";
         if (i < symbols_.size() - 1) {
             streams += "/";
         }
@@ -55,23 +102,24 @@ void BinancePublicFeed::connectWebSocket() {
 
     std::string url = "wss://stream.binance.us:9443/stream?streams=" + streams;
 
-    std::cout << "[Binance WS] Connecting to: " << url << std::endl;
+    LOG_INFO << "[Binance WS] Connecting to: " << url;
 
     ws_ = std::make_unique<ix::WebSocket>();
     ws_->setUrl(url);
 
     ws_->setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
         if (msg->type == ix::WebSocketMessageType::Message) {
+            if (rawMessageHook_) rawMessageHook_(msg->str);
             handleMessage(msg->str);
         }
         else if (msg->type == ix::WebSocketMessageType::Open) {
-            std::cout << "[Binance WS] Connected!" << std::endl;
+            LOG_INFO << "[Binance WS] Connected!";
         }
         else if (msg->type == ix::WebSocketMessageType::Error) {
-            std::cerr << "[Binance WS] Error: " << msg->errorInfo.reason << std::endl;
+            LOG_ERROR << "[Binance WS] Error: " << msg->errorInfo.reason;
         }
         else if (msg->type == ix::WebSocketMessageType::Close) {
-            std::cout << "[Binance WS] Connection closed" << std::endl;
+            LOG_INFO << "[Binance WS] Connection closed";
         }
     });
 
@@ -79,11 +127,33 @@ void BinancePublicFeed::connectWebSocket() {
 
     // Keep thread alive
     while (running_) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
+    ws_->stop();
 }
 
 void BinancePublicFeed::handleMessage(const std::string& message) {
+    // Parse time ends where a trade is handed on; depth messages are timed whole
+    ScopedLatency parseTimer(LatencyStage::PARSE);
+
+    // Fast path: trade events scanned in place
+    fastjson::TradeFields trade;
+    if (fastjson::parseBinanceTrade(message, trade)) {
+        fastPathCount_.fetch_add(1, std::memory_order_relaxed);
+        parseTimer.stop();
+        onTrade(trade);
+        return;
+    }
+
+    std::string_view stream;
+    if (fastjson::findValue(message, "stream", stream) &&
+        stream.find("@depth") != std::string_view::npos && handleDepth(stream, message)) {
+        fastPathCount_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    fallbackCount_.fetch_add(1, std::memory_order_relaxed);
+
     try {
         auto j = json::parse(message);
 
@@ -93,43 +163,120 @@ void BinancePublicFeed::handleMessage(const std::string& message) {
         auto& data = j["data"];
 
         std::string symbol = data.value("s", "");  // e.g., "BTCUSDT"
-        double price = std::stod(data.value("p", "0"));
-        double quantity = std::stod(data.value("q", "0"));
-        long long timestamp = data.value("T", 0LL);
-
-        if (symbol.empty() || price == 0.0) return;
-
-        // Convert timestamp to system clock
-        auto tickTime = std::chrono::system_clock::time_point{
-            std::chrono::milliseconds(timestamp)
-        };
-
-        // Feed to candle aggregator
-        aggregator_.onTick(price, quantity, tickTime);
-
-        // Create market tick
-        MarketTick tick{
-            symbol,
-            price,
-            quantity,
-            timestamp
-        };
-
-        if (tickCallback_) {
-            tickCallback_(tick);
+        trade.symbol = symbol;
+        trade.price = std::stod(data.value("p", "0"));
+        trade.quantity = std::stod(data.value("q", "0"));
+        trade.timestampMs = data.value("T", 0LL);
+
+        parseTimer.stop();
+
+        onTrade(trade);
+
+    } catch (const std::exception& e) {
+        errorCount_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR << "[Binance WS] Parse error: " << e.what();
+    }
+}
+
+void BinancePublicFeed::onTrade(const fastjson::TradeFields& trade) {
+    if (trade.symbol.empty() || trade.price == 0.0) return;
+
+    ScopedLatency timer(LatencyStage::DISPATCH);
+
+    SymbolId symbolId = symbolIds_(trade.symbol);
+
+    // Convert timestamp to system clock
+    auto tickTime = std::chrono::system_clock::time_point{
+        std::chrono::milliseconds(trade.timestampMs)
+    };
+
+    // Feed to candle aggregator
+    aggregator_.onTick(symbolId, trade.price, trade.quantity, tickTime);
+
+    // Fill the reusable market tick
+    tick_.symbol.assign(trade.symbol.data(), trade.symbol.size());
+    tick_.symbolId = symbolId;
+    tick_.price = trade.price;
+    tick_.volume = trade.quantity;
+    tick_.timestamp = static_cast<long>(trade.timestampMs);
+
+    if (tickCallback_) {
+        tickCallback_(CompactTick{
+            symbolId,
+            tick_.price,
+            tick_.volume,
+            static_cast<int64_t>(tick_.timestamp) * 1000000LL
+        });
+    }
+
+    // Alpha generation
+    auto sigOpt = engine_.onTick(tick_);
+    if (sigOpt && verbose_) {
+        const auto& sig = *sigOpt;
+        LOG_INFO << "[Binance Alpha] "
+                 << trade.symbol << " | $" << trade.price
+                 << " | Mom: " << sig.momentum
+                 << " | MRZ: " << sig.meanRevZ;
+    }
+}
+
+bool BinancePublicFeed::handleDepth(std::string_view stream, std::string_view message) {
+    // {"stream":"btcusdt@depth20@100ms","data":{"lastUpdateId":..,"bids":[["price","qty"],..],"asks":[..]}}
+    std::string_view name = stream.substr(0, stream.find('@'));
+    SymbolId symbolId = INVALID_SYMBOL_ID;
+    for (const auto& entry : depthStreams_) {
+        if (entry.first == name) {
+            symbolId = entry.second;
+            break;
         }
+    }
+    if (symbolId == INVALID_SYMBOL_ID) return false;
+
+    std::string_view bids, asks;
+    if (!fastjson::findArray(message, "bids", bids) || !fastjson::findArray(message, "asks", asks)) {
+        return false;
+    }
+
+    std::string_view fields[2];
+    size_t pos = 0;
+    double price, size;
+    TopOfBook before, after;
 
-        // Alpha generation
-        auto sigOpt = engine_.onTick(tick);
-        if (sigOpt) {
-            const auto& sig = *sigOpt;
-            std::cout << "[Binance Alpha] "
-                      << sig.symbol << " | $" << price
-                      << " | Mom: " << sig.momentum
-                      << " | MRZ: " << sig.meanRevZ << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(bookMutex_);
+
+        snapshotBids_.clear();
+        while (fastjson::nextTuple(bids, pos, fields, 2)) {
+            if (fastjson::parseDouble(fields[0], price) && fastjson::parseDouble(fields[1], size)) {
+                snapshotBids_.push_back(OrderBookLevel{price, size});
+            }
+        }
+        snapshotAsks_.clear();
+        pos = 0;
+        while (fastjson::nextTuple(asks, pos, fields, 2)) {
+            if (fastjson::parseDouble(fields[0], price) && fastjson::parseDouble(fields[1], size)) {
+                snapshotAsks_.push_back(OrderBookLevel{price, size});
+            }
         }
 
-    } catch (const std::exception& e) {
-        std::cerr << "[Binance WS] Parse error: " << e.what() << std::endl;
+        // Partial depth is a full top-20 image, so each message replaces the book
+        OrderBook& book = *books_[symbolId];
+        before = book.top();
+        book.loadSnapshot(snapshotBids_, snapshotAsks_);
+        after = book.top();
+    }
+
+    bool changed = after.bidPrice != before.bidPrice || after.bidSize != before.bidSize ||
+                   after.askPrice != before.askPrice || after.askSize != before.askSize;
+    if (!changed || after.bidPrice <= 0.0 || after.askPrice <= 0.0) return true;
+
+    quoteCount_.fetch_add(1, std::memory_order_relaxed);
+    if (quoteCallback_) {
+        // Partial depth carries no event time; stamp on receipt
+        int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+        quoteCallback_(QuoteEvent{symbolId, after.bidPrice, after.bidSize, after.askPrice, after.askSize, nowNs});
     }
+    return true;
 }
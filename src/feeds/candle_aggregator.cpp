@@ -1,71 +1,272 @@
 #include "feeds/candle_aggregator.h"
-#include <iostream>
+#include "util/symbol_registry.h"
 #include <algorithm>
-#include <chrono>
+#include <stdexcept>
+#include <string>
 
 CandleAggregator::CandleAggregator(int intervalSeconds)
-	: intervalSeconds(intervalSeconds), hasCandle(false) {}
+	: CandleAggregator(CandleAggregatorConfig{{intervalSeconds}}) {}
+
+CandleAggregator::CandleAggregator(const CandleAggregatorConfig& config)
+	: intervals_(config.intervalsSeconds),
+	  historyBars_(std::max<size_t>(1, config.historyBars)),
+	  maxGapBars_(config.maxGapBars),
+	  closeDelay_(config.closeDelay)
+{
+	if (intervals_.empty()) {
+		throw std::invalid_argument("CandleAggregator needs at least one interval");
+	}
+	for (size_t i = 0; i < intervals_.size(); ++i) {
+		bool rollsUp = i == 0 || (intervals_[i] > intervals_[i - 1] && intervals_[i] % intervals_[i - 1] == 0);
+		if (intervals_[i] <= 0 || !rollsUp) {
+			throw std::invalid_argument("Candle intervals must ascend, each a multiple of the one before (got " +
+										std::to_string(intervals_[i]) + "s)");
+		}
+	}
+}
 
 void CandleAggregator::setOnCandleClosed(CandleCallback cb) {
+	std::lock_guard<std::mutex> lock(mutex_);
 	onCandleClosed = std::move(cb);
 }
 
+CandleAggregator::TimePoint CandleAggregator::align(TimePoint t, int seconds) const {
+	auto secs = std::chrono::floor<std::chrono::seconds>(t.time_since_epoch()).count();
+	auto start = secs - ((secs % seconds) + seconds) % seconds;
+	return TimePoint{std::chrono::seconds(start)};
+}
+
+std::unique_ptr<CandleAggregator::SymbolBars> CandleAggregator::makeBars() const {
+	auto bars = std::make_unique<SymbolBars>();
+	bars->frames.reserve(intervals_.size());
+	for (int seconds : intervals_) {
+		bars->frames.emplace_back(seconds, historyBars_);
+	}
+	return bars;
+}
+
+CandleAggregator::SymbolBars& CandleAggregator::barsFor(SymbolId symbolId) {
+	if (symbolId >= symbols_.size()) symbols_.resize(symbolId + 1);
+
+	auto& bars = symbols_[symbolId];
+	if (!bars) bars = makeBars();
+	return *bars;
+}
+
+const CandleAggregator::Frame* CandleAggregator::findFrame(SymbolId symbolId, int intervalSeconds) const {
+	if (symbolId >= symbols_.size() || !symbols_[symbolId]) return nullptr;
+
+	for (const auto& frame : symbols_[symbolId]->frames) {
+		if (frame.seconds == intervalSeconds) return &frame;
+	}
+	return nullptr;
+}
+
 void CandleAggregator::onTick(
+	SymbolId symbolId,
 	double price,
 	double volume,
-	std::chrono::system_clock::time_point timestamp
+	TimePoint timestamp
 ) {
-	if (!hasCandle) {
-		hasCandle = true;
-		candleStart = timestamp;
-
-		currentCandle = {
-			price,   // open
-			price,   // high
-			price,   // low
-			price,   // close
-			volume,  // volume
-			candleStart,
-			candleStart
-		};
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	SymbolBars& bars = barsFor(symbolId);
+	Frame& finest = bars.frames[0];
+	TimePoint start = align(timestamp, finest.seconds);
+
+	if (!finest.open) {
+		startBar(finest, symbolId, start, price, volume, true);
 		return;
 	}
 
-	// seconds elapsed since candle start
-	auto elapsed =
-		std::chrono::duration_cast<std::chrono::seconds>(timestamp - candleStart)
-			.count();
-
-	// update current candle with latest tick
-	currentCandle.high   = std::max(currentCandle.high, price);
-	currentCandle.low    = std::min(currentCandle.low, price);
-	currentCandle.close  = price;
-	currentCandle.volume += volume;
-	currentCandle.endTime = timestamp;
-
-	// if candle duration exceeded, emit & reset
-	if (elapsed >= intervalSeconds) {
-		if (onCandleClosed) {
-			std::cout << "[Candle Closed] "
-					  << "O:" << currentCandle.open
-					  << " H:" << currentCandle.high
-					  << " L:" << currentCandle.low
-					  << " C:" << currentCandle.close
-					  << " V:" << currentCandle.volume
-					  << std::endl;
-
-			onCandleClosed(currentCandle);
+	if (start > finest.current.startTime) {
+		advance(bars, symbolId, start);
+	}
+
+	// Late ticks (start before the open bar) are folded into the open bar
+	Candle& bar = finest.current;
+	if (!finest.traded) {
+		bar.open = bar.high = bar.low = price;
+		finest.traded = true;
+	} else {
+		bar.high = std::max(bar.high, price);
+		bar.low = std::min(bar.low, price);
+	}
+	bar.close = price;
+	bar.volume += volume;
+}
+
+void CandleAggregator::onTimer(TimePoint now) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (SymbolId id = 0; id < symbols_.size(); ++id) {
+		if (!symbols_[id]) continue;
+
+		SymbolBars& bars = *symbols_[id];
+		const Frame& finest = bars.frames[0];
+		if (!finest.open) continue;
+
+		TimePoint target = align(now - closeDelay_, finest.seconds);
+		if (target > finest.current.startTime) {
+			advance(bars, id, target);
 		}
+	}
+}
+
+bool CandleAggregator::getHistory(SymbolId symbolId, int intervalSeconds, std::vector<Candle>& out) const {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const Frame* frame = findFrame(symbolId, intervalSeconds);
+	if (!frame || frame->closed.empty()) return false;
+
+	frame->closed.copyTo(out);
+	return true;
+}
+
+bool CandleAggregator::getCurrent(SymbolId symbolId, int intervalSeconds, Candle& out) const {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	const Frame* frame = findFrame(symbolId, intervalSeconds);
+	if (!frame || !frame->open) return false;
+
+	out = frame->current;
+	return true;
+}
+
+void CandleAggregator::saveState(SnapshotWriter& out) const {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	out.write(intervals_);
+	out.write(static_cast<uint64_t>(historyBars_));
+
+	uint64_t count = 0;
+	for (const auto& bars : symbols_) count += bars ? 1 : 0;
+	out.write(count);
+
+	for (SymbolId id = 0; id < symbols_.size(); ++id) {
+		if (!symbols_[id]) continue;
+
+		out.writeString(SymbolRegistry::instance().name(id));
+		for (const Frame& frame : symbols_[id]->frames) {
+			out.write(frame.open);
+			out.write(frame.traded);
+			out.write(frame.current);
+			out.write(frame.closed);
+		}
+	}
+}
+
+void CandleAggregator::loadState(SnapshotReader& in) {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::vector<int> intervals;
+	in.read(intervals);
+	if (intervals != intervals_) SnapshotReader::fail("candle intervals changed");
+	in.expect(static_cast<uint64_t>(historyBars_), "candle history size changed");
+
+	// Read everything into fresh bars first, so a snapshot that fails partway
+	// leaves the aggregator as it was
+	std::vector<std::pair<SymbolId, std::unique_ptr<SymbolBars>>> loaded;
+	const uint64_t count = in.read<uint64_t>();
+	for (uint64_t i = 0; i < count; ++i) {
+		// Ids are per process: re-intern the name and stamp it on every bar
+		SymbolId id = SymbolRegistry::instance().intern(in.readString());
+		auto bars = makeBars();
+
+		for (Frame& frame : bars->frames) {
+			in.read(frame.open);
+			in.read(frame.traded);
+			in.read(frame.current);
+			in.read(frame.closed);
+
+			frame.current.symbolId = id;
+			for (size_t j = 0; j < frame.closed.size(); ++j) frame.closed[j].symbolId = id;
+		}
+		loaded.emplace_back(id, std::move(bars));
+	}
+
+	for (auto& [id, bars] : loaded) {
+		if (id >= symbols_.size()) symbols_.resize(id + 1);
+		symbols_[id] = std::move(bars);
+	}
+}
+
+void CandleAggregator::startBar(Frame& frame, SymbolId symbolId, TimePoint start,
+								double price, double volume, bool traded) {
+	frame.current = {
+		price,   // open
+		price,   // high
+		price,   // low
+		price,   // close
+		volume,
+		start,
+		start + std::chrono::seconds(frame.seconds),
+		symbolId,
+		frame.seconds
+	};
+	frame.open = true;
+	frame.traded = traded;
+}
+
+void CandleAggregator::advance(SymbolBars& bars, SymbolId symbolId, TimePoint target) {
+	Frame& finest = bars.frames[0];
+	const auto step = std::chrono::seconds(finest.seconds);
+	size_t gapBars = 0;
+
+	// Close finest bars up to target, filling quiet intervals with flat bars
+	while (finest.current.startTime < target) {
+		double lastClose = finest.current.close;
+		TimePoint next = finest.current.startTime + step;
+		closeBar(bars, 0);
+
+		// Skip the rest of a long gap; coarser bars it leaves unfinished close on the next roll-up
+		if (next < target && ++gapBars > maxGapBars_) next = target;
+		startBar(finest, symbolId, next, lastClose, 0.0, false);
+	}
+}
+
+void CandleAggregator::closeBar(SymbolBars& bars, size_t level) {
+	Frame& frame = bars.frames[level];
+	frame.closed.push(frame.current);
+	frame.open = false;
+
+	if (onCandleClosed) onCandleClosed(frame.current);
+
+	if (level + 1 < bars.frames.size()) {
+		rollUp(bars, level + 1, frame.current, frame.traded);
+	}
+}
+
+void CandleAggregator::rollUp(SymbolBars& bars, size_t level, const Candle& bar, bool traded) {
+	Frame& frame = bars.frames[level];
+	TimePoint start = align(bar.startTime, frame.seconds);
+
+	if (frame.open && frame.current.startTime != start) {
+		closeBar(bars, level);
+	}
+
+	if (!frame.open) {
+		startBar(frame, bar.symbolId, start, bar.open, bar.volume, traded);
+		frame.current.high = bar.high;
+		frame.current.low = bar.low;
+		frame.current.close = bar.close;
+	} else if (traded) {
+		Candle& current = frame.current;
+		if (!frame.traded) {
+			current.open = bar.open;
+			current.high = bar.high;
+			current.low = bar.low;
+			frame.traded = true;
+		} else {
+			current.high = std::max(current.high, bar.high);
+			current.low = std::min(current.low, bar.low);
+		}
+		current.close = bar.close;
+		current.volume += bar.volume;
+	}
+	// A flat finer bar adds nothing: its price is the last close
 
-		candleStart = timestamp;
-		currentCandle = {
-			price,   // open
-			price,   // high
-			price,   // low
-			price,   // close
-			0.0,     // volume reset
-			candleStart,
-			candleStart
-		};
+	if (bar.endTime >= frame.current.endTime) {
+		closeBar(bars, level);
 	}
 }
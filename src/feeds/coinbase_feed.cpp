@@ -2,9 +2,10 @@
 #include "alpha/alpha_engine.h"
 #include "feeds/candle_aggregator.h"
 #include "util/market_types.h"
+#include "util/latency_metrics.h"
+#include "util/logger.h"
 
 #include <nlohmann/json.hpp>
-#include <iostream>
 #include <chrono>
 
 using json = nlohmann::json;
@@ -17,23 +18,58 @@ CoinbaseAdvancedFeed::CoinbaseAdvancedFeed(
     : productIds_(productIds),
       engine_(engine),
       aggregator_(aggregator),
+      symbolIds_(productIds),
+      tick_{},
+      fastPathCount_(0),
+      fallbackCount_(0),
+      errorCount_(0),
+      quoteCount_(0),
+      verbose_(true),
       running_(false)
 {}
 
-void CoinbaseAdvancedFeed::setTickCallback(std::function<void(const MarketTick&)> callback) {
+void CoinbaseAdvancedFeed::setTickCallback(std::function<void(const CompactTick&)> callback) {
     tickCallback_ = std::move(callback);
 }
 
+void CoinbaseAdvancedFeed::setQuoteCallback(std::function<void(const QuoteEvent&)> callback) {
+    quoteCallback_ = std::move(callback);
+}
+
+bool CoinbaseAdvancedFeed::getBook(SymbolId symbolId, size_t depth, OrderBookSnapshot& out) const {
+    std::lock_guard<std::mutex> lock(bookMutex_);
+    if (symbolId >= books_.size() || !books_[symbolId] || books_[symbolId]->empty()) return false;
+
+    books_[symbolId]->depth(depth, out);
+    out.symbol = SymbolRegistry::instance().name(symbolId);
+    return true;
+}
+
+void CoinbaseAdvancedFeed::setRawMessageHook(std::function<void(const std::string&)> hook) {
+    rawMessageHook_ = std::move(hook);
+}
+
+fastjson::ParseStats CoinbaseAdvancedFeed::getParseStats() const {
+    return {
+        fastPathCount_.load(std::memory_order_relaxed),
+        fallbackCount_.load(std::memory_order_relaxed),
+        errorCount_.load(std::memory_order_relaxed)
+    };
+}
+
 void CoinbaseAdvancedFeed::start() {
     running_ = true;
     wsThread_ = std::thread(&CoinbaseAdvancedFeed::connectWebSocket, this);
 }
 
+CoinbaseAdvancedFeed::~CoinbaseAdvancedFeed() {
+    stop();
+}
+
+// The socket is created and stopped on the worker thread, so once this
+// returns no callback is running or will run
 void CoinbaseAdvancedFeed::stop() {
     running_ = false;
-    if (ws_) {
-        ws_->stop();
-    }
     if (wsThread_.joinable()) {
         wsThread_.join();
     }
@@ -43,24 +79,25 @@ void CoinbaseAdvancedFeed::connectWebSocket() {
     // Coinbase Advanced Trade WebSocket
     std::string url = "wss://advanced-trade-ws.coinbase.com";
 
-    std::cout << "[Coinbase WS] Connecting to: " << url << std::endl;
+    LOG_INFO << "[Coinbase WS] Connecting to: " << url;
 
     ws_ = std::make_unique<ix::WebSocket>();
     ws_->setUrl(url);
 
     ws_->setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
         if (msg->type == ix::WebSocketMessageType::Message) {
+            if (rawMessageHook_) rawMessageHook_(msg->str);
             handleMessage(msg->str);
         }
         else if (msg->type == ix::WebSocketMessageType::Open) {
-            std::cout << "[Coinbase WS] Connected! Subscribing to channels..." << std::endl;
+            LOG_INFO << "[Coinbase WS] Connected! Subscribing to channels...";
             subscribe();
         }
         else if (msg->type == ix::WebSocketMessageType::Error) {
-            std::cerr << "[Coinbase WS] Error: " << msg->errorInfo.reason << std::endl;
+            LOG_ERROR << "[Coinbase WS] Error: " << msg->errorInfo.reason;
         }
         else if (msg->type == ix::WebSocketMessageType::Close) {
-            std::cout << "[Coinbase WS] Connection closed" << std::endl;
+            LOG_INFO << "[Coinbase WS] Connection closed";
         }
     });
 
@@ -68,8 +105,9 @@ void CoinbaseAdvancedFeed::connectWebSocket() {
 
     // Keep thread alive
     while (running_) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
+    ws_->stop();
 }
 
 void CoinbaseAdvancedFeed::subscribe() {
@@ -79,115 +117,245 @@ void CoinbaseAdvancedFeed::subscribe() {
         {"product_ids", productIds_},
         {"channels", json::array({
             "ticker",
-            "matches"
+            "matches",
+            "level2_batch"
         })}
     };
 
     std::string msgStr = subscribeMsg.dump();
-    std::cout << "[Coinbase WS] Subscribing: " << msgStr << std::endl;
+    LOG_INFO << "[Coinbase WS] Subscribing: " << msgStr;
 
     ws_->send(msgStr);
 }
 
 void CoinbaseAdvancedFeed::handleMessage(const std::string& message) {
+    // Parse time ends where a trade or ticker is handed on; book messages are timed whole
+    ScopedLatency parseTimer(LatencyStage::PARSE);
+
+    // Fast path: match / ticker / book messages scanned in place
+    std::string_view fastType;
+    fastjson::TradeFields trade;
+    if (fastjson::parseCoinbaseTrade(message, fastType, trade)) {
+        fastPathCount_.fetch_add(1, std::memory_order_relaxed);
+        parseTimer.stop();
+        onTrade(trade);
+        return;
+    }
+
+    fastjson::QuoteFields ticker;
+    if (fastjson::parseCoinbaseTicker(message, ticker)) {
+        fastPathCount_.fetch_add(1, std::memory_order_relaxed);
+        parseTimer.stop();
+        onTicker(ticker);
+        return;
+    }
+
+    if ((fastType == "snapshot" || fastType == "l2update") && handleBookMessage(fastType, message)) {
+        fastPathCount_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    fallbackCount_.fetch_add(1, std::memory_order_relaxed);
+
     try {
         auto j = json::parse(message);
 
         std::string type = j.value("type", "");
 
         if (type == "subscriptions") {
-            std::cout << "[Coinbase WS] Subscribed successfully" << std::endl;
+            if (verbose_) {
+                LOG_INFO << "[Coinbase WS] Subscribed successfully";
+            }
             return;
         }
 
-        // Handle ticker updates
-        if (type == "ticker") {
-            std::string productId = j.value("product_id", "");
+        bool isTicker = (type == "ticker");
+        if (!isTicker && type != "match" && type != "last_match") return;
+
+        std::string productId = j.value("product_id", "");
+        std::string timeStr = j.value("time", "");
+        int64_t timestampMs = 0;
+        if (!fastjson::parseIso8601Ms(timeStr, timestampMs)) {
+            timestampMs = 0;
+        }
 
-            std::string priceStr = j.value("price", "0");
-            double price = std::stod(priceStr);
+        if (isTicker) {
+            ticker.symbol = productId;
+            ticker.bidPrice = std::stod(j.value("best_bid", "0"));
+            ticker.bidSize = std::stod(j.value("best_bid_size", "0"));
+            ticker.askPrice = std::stod(j.value("best_ask", "0"));
+            ticker.askSize = std::stod(j.value("best_ask_size", "0"));
+            ticker.timestampMs = timestampMs;
+            parseTimer.stop();
+            onTicker(ticker);
+            return;
+        }
 
-            std::string volumeStr = j.value("best_bid_size", "0");
-            double volume = std::stod(volumeStr);
+        trade.symbol = productId;
+        trade.price = std::stod(j.value("price", "0"));
+        trade.quantity = std::stod(j.value("size", "0"));
+        trade.timestampMs = timestampMs;
 
-            std::string timeStr = j.value("time", "");
-            long long timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()
-            ).count();
+        parseTimer.stop();
 
-            if (productId.empty() || price == 0.0) return;
+        onTrade(trade);
 
-            auto tickTime = std::chrono::system_clock::time_point{
-                std::chrono::milliseconds(timestamp)
-            };
+    } catch (const std::exception& e) {
+        errorCount_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR << "[Coinbase WS] Parse error: " << e.what();
+        LOG_ERROR << "[Coinbase WS] Message: " << message.substr(0, 200);
+    }
+}
 
-            aggregator_.onTick(price, volume, tickTime);
+OrderBook& CoinbaseAdvancedFeed::bookFor(SymbolId symbolId) {
+    if (symbolId >= books_.size()) books_.resize(symbolId + 1);
+    if (!books_[symbolId]) books_[symbolId] = std::make_unique<OrderBook>();
+    return *books_[symbolId];
+}
 
-            MarketTick tick{
-                productId,
-                price,
-                volume,
-                timestamp
-            };
+bool CoinbaseAdvancedFeed::handleBookMessage(std::string_view type, std::string_view message) {
+    std::string_view productId;
+    if (!fastjson::findValue(message, "product_id", productId)) return false;
+    SymbolId symbolId = symbolIds_(productId);
+
+    std::string_view fields[3];
+    size_t pos = 0;
+    double price, size;
+    bool changed = false;
+    TopOfBook top;
+
+    {
+        std::lock_guard<std::mutex> lock(bookMutex_);
+        OrderBook& book = bookFor(symbolId);
+
+        if (type == "snapshot") {
+            // {"type":"snapshot","product_id":..,"bids":[["price","size"],..],"asks":[..]}
+            std::string_view bids, asks;
+            if (!fastjson::findArray(message, "bids", bids) || !fastjson::findArray(message, "asks", asks)) {
+                return false;
+            }
 
-            if (tickCallback_) {
-                tickCallback_(tick);
+            snapshotBids_.clear();
+            while (fastjson::nextTuple(bids, pos, fields, 2)) {
+                if (fastjson::parseDouble(fields[0], price) && fastjson::parseDouble(fields[1], size)) {
+                    snapshotBids_.push_back(OrderBookLevel{price, size});
+                }
+            }
+            snapshotAsks_.clear();
+            pos = 0;
+            while (fastjson::nextTuple(asks, pos, fields, 2)) {
+                if (fastjson::parseDouble(fields[0], price) && fastjson::parseDouble(fields[1], size)) {
+                    snapshotAsks_.push_back(OrderBookLevel{price, size});
+                }
             }
 
-            //Alpha generation
-            auto sigOpt = engine_.onTick(tick);
-            if (sigOpt) {
-                const auto& sig = *sigOpt;
-                std::cout << "[Coinbase Alpha] "
-                          << sig.symbol << " | $" << price
-                          << " | Mom: " << sig.momentum
-                          << " | MRZ: " << sig.meanRevZ << std::endl;
+            book.loadSnapshot(snapshotBids_, snapshotAsks_);
+            changed = true;
+        } else {
+            // {"type":"l2update","product_id":..,"changes":[["buy","price","size"],..],"time":..}
+            std::string_view changes;
+            if (!fastjson::findArray(message, "changes", changes)) return false;
+
+            while (fastjson::nextTuple(changes, pos, fields, 3)) {
+                if (!fastjson::parseDouble(fields[1], price) || !fastjson::parseDouble(fields[2], size)) continue;
+                BookSide side = fields[0] == "buy" ? BookSide::BID : BookSide::ASK;
+                changed |= book.apply(side, price, size);
             }
         }
 
-        else if (type == "match" || type == "last_match") {
-            std::string productId = j.value("product_id", "");
+        top = book.top();
+    }
 
-            std::string priceStr = j.value("price", "0");
-            double price = std::stod(priceStr);
+    if (changed) {
+        std::string_view timeStr;
+        int64_t timestampMs = 0;
+        if (fastjson::findValue(message, "time", timeStr)) fastjson::parseIso8601Ms(timeStr, timestampMs);
+        emitQuote(symbolId, top, timestampMs);
+    }
+    return true;
+}
 
-            std::string sizeStr = j.value("size", "0");
-            double size = std::stod(sizeStr);
+void CoinbaseAdvancedFeed::onTicker(const fastjson::QuoteFields& ticker) {
+    if (ticker.symbol.empty()) return;
+    SymbolId symbolId = symbolIds_(ticker.symbol);
 
-            long long timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()
-            ).count();
+    // Once the level2 book is live it is the fresher source
+    {
+        std::lock_guard<std::mutex> lock(bookMutex_);
+        if (symbolId < books_.size() && books_[symbolId] && books_[symbolId]->hasTop()) return;
+    }
 
-            if (productId.empty() || price == 0.0) return;
+    emitQuote(symbolId, TopOfBook{ticker.bidPrice, ticker.bidSize, ticker.askPrice, ticker.askSize},
+              ticker.timestampMs);
+}
 
-            auto tickTime = std::chrono::system_clock::time_point{
-                std::chrono::milliseconds(timestamp)
-            };
+void CoinbaseAdvancedFeed::emitQuote(SymbolId symbolId, const TopOfBook& top, int64_t timestampMs) {
+    if (top.bidPrice <= 0.0 || top.askPrice <= 0.0) return;
 
-            aggregator_.onTick(price, size, tickTime);
+    quoteCount_.fetch_add(1, std::memory_order_relaxed);
+    if (!quoteCallback_) return;
 
-            MarketTick tick{
-                productId,
-                price,
-                size,
-                timestamp
-            };
+    // Exchange time when present, otherwise receive time
+    if (timestampMs == 0) {
+        timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
 
-            if (tickCallback_) {
-                tickCallback_(tick);
-            }
+    quoteCallback_(QuoteEvent{
+        symbolId,
+        top.bidPrice,
+        top.bidSize,
+        top.askPrice,
+        top.askSize,
+        timestampMs * 1000000LL
+    });
+}
 
-            auto sigOpt = engine_.onTick(tick);
-            if (sigOpt) {
-                const auto& sig = *sigOpt;
-                std::cout << "[Coinbase Trade] "
-                          << sig.symbol << " | $" << price
-                          << " | Size: " << size << std::endl;
-            }
-        }
+void CoinbaseAdvancedFeed::onTrade(const fastjson::TradeFields& trade) {
+    if (trade.symbol.empty() || trade.price == 0.0) return;
 
-    } catch (const std::exception& e) {
-        std::cerr << "[Coinbase WS] Parse error: " << e.what() << std::endl;
-        std::cerr << "[Coinbase WS] Message: " << message.substr(0, 200) << std::endl;
+    ScopedLatency timer(LatencyStage::DISPATCH);
+
+    SymbolId symbolId = symbolIds_(trade.symbol);
+
+    // Exchange time when present, otherwise receive time
+    long long timestamp = trade.timestampMs;
+    if (timestamp == 0) {
+        timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
     }
-}
\ No newline at end of file
+
+    auto tickTime = std::chrono::system_clock::time_point{
+        std::chrono::milliseconds(timestamp)
+    };
+
+    aggregator_.onTick(symbolId, trade.price, trade.quantity, tickTime);
+
+    tick_.symbol.assign(trade.symbol.data(), trade.symbol.size());
+    tick_.symbolId = symbolId;
+    tick_.price = trade.price;
+    tick_.volume = trade.quantity;
+    tick_.timestamp = static_cast<long>(timestamp);
+
+    if (tickCallback_) {
+        tickCallback_(CompactTick{
+            symbolId,
+            tick_.price,
+            tick_.volume,
+            static_cast<int64_t>(tick_.timestamp) * 1000000LL
+        });
+    }
+
+    // Alpha generation
+    auto sigOpt = engine_.onTick(tick_);
+    if (!sigOpt || !verbose_) return;
+
+    const auto& sig = *sigOpt;
+    LOG_INFO << "[Coinbase Alpha] "
+             << trade.symbol << " | $" << trade.price
+             << " | Size: " << trade.quantity
+             << " | Mom: " << sig.momentum
+             << " | MRZ: " << sig.meanRevZ;
+}
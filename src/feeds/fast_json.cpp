@@ -0,0 +1,349 @@
+#include "feeds/fast_json.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+namespace fastjson {
+
+namespace {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline std::string_view unquote(std::string_view text) {
+    if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+        return text.substr(1, text.size() - 2);
+    }
+    return text;
+}
+
+// Fixed-width unsigned decimal at text[pos..pos+width)
+inline bool readDigits(std::string_view text, size_t pos, size_t width, int& out) {
+    if (pos + width > text.size()) return false;
+    int value = 0;
+    for (size_t i = pos; i < pos + width; ++i) {
+        char c = text[i];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    out = value;
+    return true;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm)
+inline int64_t daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// Index of the value of "key" (past the colon and any space), or npos
+size_t findValueStart(std::string_view json, std::string_view key) {
+    size_t pos = 0;
+
+    while ((pos = json.find(key, pos)) != std::string_view::npos) {
+        const size_t keyStart = pos;
+        pos += key.size();
+
+        // Must be a whole quoted key ...
+        if (keyStart == 0 || json[keyStart - 1] != '"') continue;
+        if (pos >= json.size() || json[pos] != '"') continue;
+
+        // ... in member position, i.e. preceded by '{' or ','
+        size_t before = keyStart - 1;
+        while (before > 0 && isSpace(json[before - 1])) --before;
+        if (before == 0 || (json[before - 1] != '{' && json[before - 1] != ',')) continue;
+
+        size_t i = pos + 1;
+        while (i < json.size() && isSpace(json[i])) ++i;
+        if (i >= json.size() || json[i] != ':') continue;
+        ++i;
+        while (i < json.size() && isSpace(json[i])) ++i;
+        if (i >= json.size()) return std::string_view::npos;
+
+        return i;
+    }
+
+    return std::string_view::npos;
+}
+
+}
+
+bool findValue(std::string_view json, std::string_view key, std::string_view& out) {
+    size_t i = findValueStart(json, key);
+    if (i == std::string_view::npos) return false;
+
+    if (json[i] == '"') {
+        size_t end = json.find('"', i + 1);
+        if (end == std::string_view::npos) return false;
+
+        std::string_view value = json.substr(i + 1, end - i - 1);
+        if (value.find('\\') != std::string_view::npos) return false;
+
+        out = value;
+        return true;
+    }
+
+    size_t end = i;
+    while (end < json.size() && json[end] != ',' && json[end] != '}' &&
+           json[end] != ']' && !isSpace(json[end])) {
+        ++end;
+    }
+    if (end == i) return false;
+
+    out = json.substr(i, end - i);
+    return true;
+}
+
+bool findArray(std::string_view json, std::string_view key, std::string_view& out) {
+    size_t i = findValueStart(json, key);
+    if (i == std::string_view::npos || json[i] != '[') return false;
+
+    int depth = 0;
+    bool inString = false;
+    for (size_t end = i; end < json.size(); ++end) {
+        char c = json[end];
+        if (inString) {
+            if (c == '\\') ++end;
+            else if (c == '"') inString = false;
+            continue;
+        }
+
+        if (c == '"') {
+            inString = true;
+        } else if (c == '[') {
+            ++depth;
+        } else if (c == ']' && --depth == 0) {
+            out = json.substr(i, end - i + 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool nextTuple(std::string_view array, size_t& pos, std::string_view* fields, size_t count) {
+    // The outer array's own bracket is skipped; tuples are the nested ones
+    if (pos == 0) pos = 1;
+
+    size_t open = array.find('[', pos);
+    if (open == std::string_view::npos) return false;
+    size_t close = array.find(']', open);
+    if (close == std::string_view::npos) return false;
+    pos = close + 1;
+
+    size_t field = 0;
+    size_t start = open + 1;
+    while (field < count && start <= close) {
+        size_t end = array.find(',', start);
+        if (end == std::string_view::npos || end > close) end = close;
+
+        std::string_view value = array.substr(start, end - start);
+        while (!value.empty() && isSpace(value.front())) value.remove_prefix(1);
+        while (!value.empty() && isSpace(value.back())) value.remove_suffix(1);
+        fields[field++] = unquote(value);
+
+        start = end + 1;
+    }
+
+    return field == count;
+}
+
+bool parseDouble(std::string_view text, double& out) {
+    text = unquote(text);
+    if (text.empty()) return false;
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+    return res.ec == std::errc() && res.ptr == text.data() + text.size();
+#else
+    // Standard libraries without floating-point from_chars: strtod on a bounded copy
+    char buf[64];
+    if (text.size() >= sizeof(buf)) return false;
+    std::memcpy(buf, text.data(), text.size());
+    buf[text.size()] = '\0';
+
+    char* end = nullptr;
+    out = std::strtod(buf, &end);
+    return end == buf + text.size();
+#endif
+}
+
+bool parseInt(std::string_view text, int64_t& out) {
+    text = unquote(text);
+    if (text.empty()) return false;
+
+    auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+    return res.ec == std::errc() && res.ptr == text.data() + text.size();
+}
+
+bool findDouble(std::string_view json, std::string_view key, double& out) {
+    std::string_view value;
+    return findValue(json, key, value) && parseDouble(value, out);
+}
+
+bool findInt(std::string_view json, std::string_view key, int64_t& out) {
+    std::string_view value;
+    return findValue(json, key, value) && parseInt(value, out);
+}
+
+bool nextObject(std::string_view json, size_t& pos, std::string_view& out) {
+    size_t start = json.find('{', pos);
+    if (start == std::string_view::npos) return false;
+
+    int depth = 0;
+    bool inString = false;
+    for (size_t i = start; i < json.size(); ++i) {
+        char c = json[i];
+        if (inString) {
+            if (c == '\\') ++i;
+            else if (c == '"') inString = false;
+            continue;
+        }
+
+        if (c == '"') {
+            inString = true;
+        } else if (c == '{') {
+            ++depth;
+        } else if (c == '}' && --depth == 0) {
+            out = json.substr(start, i - start + 1);
+            pos = i + 1;
+            return true;
+        }
+    }
+
+    pos = json.size();
+    return false;
+}
+
+bool parseIso8601Ms(std::string_view text, int64_t& outMs) {
+    // YYYY-MM-DDTHH:MM:SS
+    int year, month, day, hour, minute, second;
+    if (!readDigits(text, 0, 4, year) || text.size() < 19 || text[4] != '-' ||
+        !readDigits(text, 5, 2, month) || text[7] != '-' ||
+        !readDigits(text, 8, 2, day) || (text[10] != 'T' && text[10] != ' ') ||
+        !readDigits(text, 11, 2, hour) || text[13] != ':' ||
+        !readDigits(text, 14, 2, minute) || text[16] != ':' ||
+        !readDigits(text, 17, 2, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    size_t pos = 19;
+
+    // Optional fraction, any precision; keep milliseconds
+    int millis = 0;
+    if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        int digits = 0;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            if (digits < 3) millis = millis * 10 + (text[pos] - '0');
+            ++digits;
+            ++pos;
+        }
+        if (digits == 0) return false;
+        for (; digits < 3; ++digits) millis *= 10;
+    }
+
+    // Zone designator: Z, +hh:mm, -hh:mm or none (UTC)
+    int offsetMinutes = 0;
+    if (pos < text.size()) {
+        char zone = text[pos];
+        if (zone == 'Z') {
+            ++pos;
+        } else if (zone == '+' || zone == '-') {
+            int offH, offM;
+            if (!readDigits(text, pos + 1, 2, offH)) return false;
+            size_t mPos = pos + 3;
+            if (mPos < text.size() && text[mPos] == ':') ++mPos;
+            if (!readDigits(text, mPos, 2, offM)) return false;
+            offsetMinutes = (offH * 60 + offM) * (zone == '+' ? 1 : -1);
+            pos = mPos + 2;
+        }
+    }
+    if (pos != text.size()) return false;
+
+    int64_t seconds = daysFromCivil(year, month, day) * 86400LL +
+                      hour * 3600LL + minute * 60LL + second - offsetMinutes * 60LL;
+    outMs = seconds * 1000LL + millis;
+    return true;
+}
+
+bool parseBinanceTrade(std::string_view json, TradeFields& out) {
+    std::string_view eventType;
+    if (!findValue(json, "e", eventType) || eventType != "trade") return false;
+
+    if (!findValue(json, "s", out.symbol)) return false;
+    if (!findDouble(json, "p", out.price)) return false;
+    if (!findDouble(json, "q", out.quantity)) return false;
+    if (!findInt(json, "T", out.timestampMs)) return false;
+
+    return true;
+}
+
+bool parseCoinbaseTrade(std::string_view json, std::string_view& type, TradeFields& out) {
+    if (!findValue(json, "type", type)) return false;
+
+    if (type != "match" && type != "last_match") return false;
+
+    if (!findValue(json, "product_id", out.symbol)) return false;
+    if (!findDouble(json, "price", out.price)) return false;
+    if (!findDouble(json, "size", out.quantity)) return false;
+
+    std::string_view timeStr;
+    if (!findValue(json, "time", timeStr) || !parseIso8601Ms(timeStr, out.timestampMs)) {
+        out.timestampMs = 0;
+    }
+
+    return true;
+}
+
+bool parseCoinbaseTicker(std::string_view json, QuoteFields& out) {
+    std::string_view type;
+    if (!findValue(json, "type", type) || type != "ticker") return false;
+
+    if (!findValue(json, "product_id", out.symbol)) return false;
+    if (!findDouble(json, "best_bid", out.bidPrice)) return false;
+    if (!findDouble(json, "best_bid_size", out.bidSize)) return false;
+    if (!findDouble(json, "best_ask", out.askPrice)) return false;
+    if (!findDouble(json, "best_ask_size", out.askSize)) return false;
+
+    std::string_view timeStr;
+    if (!findValue(json, "time", timeStr) || !parseIso8601Ms(timeStr, out.timestampMs)) {
+        out.timestampMs = 0;
+    }
+
+    return true;
+}
+
+bool parsePolygonTrade(std::string_view json, TradeFields& out) {
+    std::string_view eventType;
+    if (!findValue(json, "ev", eventType) || eventType != "T") return false;
+
+    if (!findValue(json, "sym", out.symbol)) return false;
+    if (!findDouble(json, "p", out.price)) return false;
+    if (!findDouble(json, "s", out.quantity)) return false;
+    if (!findInt(json, "t", out.timestampMs)) out.timestampMs = 0;
+
+    return true;
+}
+
+bool parsePolygonQuote(std::string_view json, QuoteFields& out) {
+    std::string_view eventType;
+    if (!findValue(json, "ev", eventType) || eventType != "Q") return false;
+
+    if (!findValue(json, "sym", out.symbol)) return false;
+    if (!findDouble(json, "bp", out.bidPrice)) return false;
+    if (!findDouble(json, "bs", out.bidSize)) return false;
+    if (!findDouble(json, "ap", out.askPrice)) return false;
+    if (!findDouble(json, "as", out.askSize)) return false;
+    if (!findInt(json, "t", out.timestampMs)) out.timestampMs = 0;
+
+    return true;
+}
+
+}
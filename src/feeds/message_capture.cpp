@@ -0,0 +1,168 @@
+#include "feeds/message_capture.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'A', 'L', 'P', 'H', 'C', 'A', 'P', 'T'};
+constexpr uint32_t CAPTURE_VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved0;
+    uint64_t reserved[2];
+};
+
+struct RecordHeader {
+    int64_t arrivalNs;
+    uint32_t length;
+    uint8_t source;
+    uint8_t pad[3];
+};
+
+static_assert(sizeof(FileHeader) == 32, "capture header layout");
+static_assert(sizeof(RecordHeader) == 16, "capture record layout");
+
+int64_t wallClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+const char* feedSourceToString(FeedSource source) {
+    switch (source) {
+        case FeedSource::BINANCE: return "BINANCE";
+        case FeedSource::COINBASE: return "COINBASE";
+        case FeedSource::POLYGON: return "POLYGON";
+    }
+    return "UNKNOWN";
+}
+
+// === CaptureWriter ===
+CaptureWriter::CaptureWriter(const std::string& path)
+    : file_(std::fopen(path.c_str(), "wb")), messagesWritten_(0) {
+    if (!file_) {
+        throw std::runtime_error("Cannot create capture file: " + path);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = CAPTURE_VERSION;
+    std::fwrite(&header, sizeof(header), 1, file_);
+}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+void CaptureWriter::write(FeedSource source, const std::string& message) {
+    write(source, wallClockNs(), message);
+}
+
+void CaptureWriter::write(FeedSource source, int64_t arrivalNs, std::string_view message) {
+    RecordHeader header{};
+    header.arrivalNs = arrivalNs;
+    header.length = static_cast<uint32_t>(message.size());
+    header.source = static_cast<uint8_t>(source);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) return;
+
+    std::fwrite(&header, sizeof(header), 1, file_);
+    std::fwrite(message.data(), 1, message.size(), file_);
+    ++messagesWritten_;
+}
+
+void CaptureWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) std::fflush(file_);
+}
+
+void CaptureWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+uint64_t CaptureWriter::messagesWritten() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return messagesWritten_;
+}
+
+// === CaptureReader ===
+CaptureReader::CaptureReader(const std::string& path)
+    : data_(nullptr), bytes_(0), payloadBytes_(0), truncated_(false) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open capture file: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a message capture (too short): " + path);
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+
+    void* mapped = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Cannot mmap capture file: " + path);
+    }
+    data_ = static_cast<const uint8_t*>(mapped);
+
+#ifdef MADV_SEQUENTIAL
+    ::madvise(mapped, bytes_, MADV_SEQUENTIAL);
+#endif
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != CAPTURE_VERSION) {
+        ::munmap(mapped, bytes_);
+        data_ = nullptr;
+        throw std::runtime_error("Not a message capture (bad header): " + path);
+    }
+
+    size_t offset = sizeof(FileHeader);
+    while (offset < bytes_) {
+        RecordHeader record;
+        if (bytes_ - offset < sizeof(record)) {
+            truncated_ = true;
+            break;
+        }
+        std::memcpy(&record, data_ + offset, sizeof(record));
+
+        const size_t payloadAt = offset + sizeof(record);
+        if (record.length > bytes_ - payloadAt) {
+            truncated_ = true;
+            break;
+        }
+
+        messages_.push_back(CapturedMessage{
+            record.arrivalNs,
+            static_cast<FeedSource>(record.source),
+            std::string_view(reinterpret_cast<const char*>(data_ + payloadAt), record.length)
+        });
+        payloadBytes_ += record.length;
+        offset = payloadAt + record.length;
+    }
+
+    if (truncated_) {
+        std::cerr << "[Capture] " << path << " ends mid-record; replaying "
+                  << messages_.size() << " complete messages" << std::endl;
+    }
+}
+
+CaptureReader::~CaptureReader() {
+    if (data_) ::munmap(const_cast<uint8_t*>(data_), bytes_);
+}
@@ -2,10 +2,11 @@
 #include "alpha/alpha_engine.h"
 #include "feeds/candle_aggregator.h"
 #include "util/market_types.h"
+#include "util/logger.h"
 
-#include <curl/curl.h>
 #include <nlohmann/json.hpp>
-#include <iostream>
+#include <algorithm>
+#include <stdexcept>
 #include <chrono>
 #include <thread>
 
@@ -18,34 +19,87 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* use
     return size * nmemb;
 }
 
+static long long wallClockMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 PolygonFeed::PolygonFeed(const std::vector<std::string>& symbols,
                          const std::string& apiKey,
                          AlphaEngine& engine,
-                         CandleAggregator& aggregator)
-    : symbols_(symbols),
-      apiKey_(apiKey),
+                         CandleAggregator& aggregator,
+                         const PolygonFeedConfig& config)
+    : apiKey_(apiKey),
       engine_(engine),
       aggregator_(aggregator),
-      running_(false)
-{}
+      config_(config),
+      multi_(nullptr),
+      bucket_(config.requestsPerSecond, config.burst),
+      nextSymbol_(0),
+      running_(false),
+      requestsCompleted_(0),
+      requestsFailed_(0)
+{
+    auto now = Clock::now();
+    for (const auto& symbol : symbols) {
+        symbols_.push_back(SymbolState{
+            symbol, SymbolRegistry::instance().intern(symbol), 0, 0.0, now, 0, false});
+    }
+
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        throw std::runtime_error("[Polygon REST] curl_multi_init failed");
+    }
+
+    // One easy handle per slot, reused so DNS, TLS sessions and connections carry over
+    const size_t slots = std::max<size_t>(1, config_.maxConcurrent);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(slots));
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(slots));
+
+    requests_.resize(slots);
+    for (auto& request : requests_) {
+        request.easy = curl_easy_init();
+        request.symbol = 0;
+        request.busy = false;
+
+        if (!request.easy) {
+            // The destructor won't run, so release what was created so far
+            for (auto& created : requests_) {
+                if (created.easy) curl_easy_cleanup(created.easy);
+            }
+            curl_multi_cleanup(multi_);
+            throw std::runtime_error("[Polygon REST] curl_easy_init failed");
+        }
+    }
+}
+
+PolygonFeed::~PolygonFeed()
+{
+    stop();
+
+    for (auto& request : requests_) {
+        if (request.busy) curl_multi_remove_handle(multi_, request.easy);
+        curl_easy_cleanup(request.easy);
+    }
+    curl_multi_cleanup(multi_);
+}
 
-void PolygonFeed::setTickCallback(std::function<void(const MarketTick&)> callback) {
+void PolygonFeed::setTickCallback(std::function<void(const CompactTick&)> callback) {
     tickCallback_ = std::move(callback);
 }
 
 
 void PolygonFeed::start()
 {
-    curl_global_init(CURL_GLOBAL_DEFAULT);
-    running_ = true;
-    pollLoop();
+    if (running_.exchange(true)) return;
     pollThread_ = std::thread(&PolygonFeed::pollLoop, this);
-    curl_global_cleanup();
 }
 
 void PolygonFeed::stop()
 {
     running_ = false;
+    curl_multi_wakeup(multi_);
     if (pollThread_.joinable())
         pollThread_.join();
 }
@@ -53,74 +107,163 @@ void PolygonFeed::stop()
 
 void PolygonFeed::pollLoop()
 {
-    std::cout << "[Polygon REST] Polling started (30s)..." << std::endl;
+    LOG_INFO << "[Polygon REST] Polling " << symbols_.size() << " symbols ("
+             << config_.maxConcurrent << " concurrent, " << config_.requestsPerSecond
+             << " req/s, every " << config_.pollIntervalSeconds << "s)...";
 
     try
     {
         while (running_)
         {
-            for (const auto& symbol : symbols_)
-            {
-                fetchSymbol(symbol);
-                std::this_thread::sleep_for(std::chrono::seconds(2));
+            startDueRequests(Clock::now());
+
+            int stillRunning = 0;
+            curl_multi_perform(multi_, &stillRunning);
+
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi_, &queued)) {
+                if (msg->msg != CURLMSG_DONE) continue;
+
+                Request* request = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &request);
+                curl_multi_remove_handle(multi_, msg->easy_handle);
+                if (request) finishRequest(*request, msg->data.result);
             }
 
-            std::this_thread::sleep_for(std::chrono::seconds(30));
+            // Sleep until socket activity, a wakeup from stop(), or the next token
+            int timeoutMs = 100;
+            if (stillRunning == 0) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(bucket_.waitTime());
+                timeoutMs = static_cast<int>(std::clamp<long long>(wait.count(), 10, 1000));
+            }
+            curl_multi_poll(multi_, nullptr, 0, timeoutMs, nullptr);
         }
     }
     catch (const std::exception& e)
     {
-        std::cerr << "[Polygon REST] Uncaught exception in pollLoop: "
-                  << e.what() << std::endl;
+        LOG_ERROR << "[Polygon REST] Uncaught exception in pollLoop: "
+                  << e.what();
     }
     catch (...)
     {
-        std::cerr << "[Polygon REST] Unknown exception in pollLoop" << std::endl;
+        LOG_ERROR << "[Polygon REST] Unknown exception in pollLoop";
     }
 }
 
+void PolygonFeed::startDueRequests(Clock::time_point now)
+{
+    if (symbols_.empty()) return;
+
+    // Round-robin over symbols so a rate limit never starves the tail of the list
+    for (size_t scanned = 0; scanned < symbols_.size(); ++scanned) {
+        auto slot = std::find_if(requests_.begin(), requests_.end(),
+                                 [](const Request& r) { return !r.busy; });
+        if (slot == requests_.end()) return;
+
+        size_t index = nextSymbol_;
+        SymbolState& state = symbols_[index];
+        if (state.inFlight || state.nextDue > now) {
+            nextSymbol_ = (nextSymbol_ + 1) % symbols_.size();
+            continue;
+        }
 
-void PolygonFeed::fetchSymbol(const std::string& symbol) {
-    CURL* curl = curl_easy_init();
-    if (!curl) return;
-
-    long long to = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-
-    long long from = to - (30LL * 24 * 60 * 60 * 1000);
-
-    std::string url =
-        "https://api.polygon.io/v2/aggs/ticker/" + symbol +
-        "/range/1/day/" + std::to_string(from) + "/" + std::to_string(to) +
-        "?adjusted=true&sort=desc&limit=5&apiKey=" + apiKey_;
-
-    std::string response;
+        if (!bucket_.tryAcquire(now)) return;
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+        startRequest(*slot, index);
+        nextSymbol_ = (nextSymbol_ + 1) % symbols_.size();
+    }
+}
 
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
+void PolygonFeed::startRequest(Request& request, size_t symbol)
+{
+    SymbolState& state = symbols_[symbol];
+
+    long long to = wallClockMs();
+    // Resume at the newest bar already seen (it may still be in progress)
+    long long from = state.cursorMs > 0
+        ? state.cursorMs
+        : to - (static_cast<long long>(config_.lookbackDays) * 24 * 60 * 60 * 1000);
+
+    request.url =
+        "https://api.polygon.io/v2/aggs/ticker/" + state.symbol +
+        "/range/" + std::to_string(config_.multiplier) + "/" + config_.timespan + "/" +
+        std::to_string(from) + "/" + std::to_string(to) +
+        "?adjusted=true&sort=asc&limit=50000&apiKey=" + apiKey_;
+    request.response.clear();
+    request.symbol = symbol;
+    request.busy = true;
+    state.inFlight = true;
+
+    CURL* easy = request.easy;
+    curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &request.response);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, &request);
+    curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT, config_.timeoutSeconds);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+
+    CURLMcode added = curl_multi_add_handle(multi_, easy);
+    if (added != CURLM_OK) {
+        // Not in flight after all: free the slot and try again next poll
+        request.busy = false;
+        state.inFlight = false;
+        state.nextDue = Clock::now() + std::chrono::seconds(config_.pollIntervalSeconds);
+        requestsFailed_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR << "[Polygon REST] curl_multi_add_handle failed for " << state.symbol
+                  << ": " << curl_multi_strerror(added);
+    }
+}
 
-    if (res != CURLE_OK) {
-        std::cerr << "[Polygon REST] CURL error for " << symbol << std::endl;
+void PolygonFeed::finishRequest(Request& request, CURLcode result)
+{
+    request.busy = false;
+    SymbolState& state = symbols_[request.symbol];
+    state.inFlight = false;
+
+    long status = 0;
+    curl_easy_getinfo(request.easy, CURLINFO_RESPONSE_CODE, &status);
+
+    auto now = Clock::now();
+    if (result != CURLE_OK || status != 200) {
+        requestsFailed_.fetch_add(1, std::memory_order_relaxed);
+        ++state.failures;
+
+        // Rate-limited: wait out the window; otherwise back off exponentially
+        int backoffSeconds = status == 429
+            ? 60
+            : std::min(300, 5 << std::min(state.failures - 1, 6));
+        state.nextDue = now + std::chrono::seconds(backoffSeconds);
+
+        LOG_ERROR << "[Polygon REST] " << (result != CURLE_OK ? curl_easy_strerror(result) : "HTTP error")
+                  << " (status " << status << ") for " << state.symbol
+                  << ", retrying in " << backoffSeconds << "s";
         return;
     }
 
+    requestsCompleted_.fetch_add(1, std::memory_order_relaxed);
+    state.failures = 0;
+    state.nextDue = now + std::chrono::seconds(config_.pollIntervalSeconds);
+
+    handleResponse(state, request.response);
+}
+
+void PolygonFeed::handleResponse(SymbolState& state, const std::string& body)
+{
     try {
-        auto j = json::parse(response);
+        auto j = json::parse(body);
 
         if (!j.contains("results") || j["results"].empty()) {
-            std::cerr << "[Polygon REST] No results for " << symbol << std::endl;
-            std::cerr << "[Polygon REST] Response: " << response.substr(0, 200) << std::endl;
+            if (state.cursorMs == 0) {
+                LOG_ERROR << "[Polygon REST] No results for " << state.symbol;
+                LOG_ERROR << "[Polygon REST] Response: " << body.substr(0, 200);
+            }
             return;
         }
 
-        std::cout << "[Polygon REST] Got " << j["results"].size()
-                  << " bars for " << symbol << std::endl;
-
+        size_t newBars = 0;
         for (const auto& c : j["results"]) {
             double open  = c.value("o", 0.0);
             double high  = c.value("h", 0.0);
@@ -129,42 +272,61 @@ void PolygonFeed::fetchSymbol(const std::string& symbol) {
             double vol   = c.value("v", 0.0);
             long long ts = c.value("t", 0LL);
 
+            // The cursor bar comes back every poll; only pass it on if it grew,
+            // and then only with the volume added since we last passed it on,
+            // so the aggregator doesn't count the bar's earlier volume twice
+            if (ts < state.cursorMs) continue;
+            if (ts == state.cursorMs && vol <= state.cursorVolume) continue;
+
+            double barVolume = vol;
+            if (ts == state.cursorMs) vol -= state.cursorVolume;
+
+            state.cursorMs = ts;
+            state.cursorVolume = barVolume;
+            ++newBars;
+
             auto tickTime =
                 std::chrono::system_clock::time_point{
                     std::chrono::milliseconds(ts)
                 };
 
-            aggregator_.onTick(close, vol, tickTime);
+            aggregator_.onTick(state.symbolId, close, vol, tickTime);
 
             MarketTick tick{
-                symbol,
+                state.symbol,
                 close,
                 vol,
-                ts
+                ts,
+                state.symbolId
             };
 
             if (tickCallback_) {
-                tickCallback_(tick);
+                tickCallback_(CompactTick{state.symbolId, close, vol, ts * 1000000LL});
             }
 
             // Basic alpha generation
             auto sigOpt = engine_.onTick(tick);
             if (sigOpt) {
                 const auto& sig = *sigOpt;
-                std::cout << "[Polygon REST Alpha] "
-                          << sig.symbol << " | "
-                          << "Price: $" << close << " | "
-                          << "Momentum: " << sig.momentum << " | "
-                          << "MeanRevZ: " << sig.meanRevZ << " | "
-                          << "Signal: " << sig.type << std::endl;
+                LOG_INFO << "[Polygon REST Alpha] "
+                         << state.symbol << " | "
+                         << "Price: $" << close << " | "
+                         << "Momentum: " << sig.momentum << " | "
+                         << "MeanRevZ: " << sig.meanRevZ << " | "
+                         << "Signal: " << signalTypeName(sig.type) << "_" << sig.timeframe;
             }
 
-            std::cout << "[Polygon REST] " << symbol
+            LOG_DEBUG << "[Polygon REST] " << state.symbol
                       << " | O:" << open << " H:" << high << " L:" << low
-                      << " C:$" << close << " | Vol: " << vol << std::endl;
+                      << " C:$" << close << " | Vol: " << barVolume;
+        }
+
+        if (newBars > 0) {
+            LOG_INFO << "[Polygon REST] Got " << newBars
+                     << " new bars for " << state.symbol;
         }
 
     } catch (const std::exception& e) {
-        std::cerr << "[Polygon REST] Parse error: " << e.what() << std::endl;
+        LOG_ERROR << "[Polygon REST] Parse error: " << e.what();
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,280 @@
+#include "feeds/polygon_stream_feed.h"
+#include "alpha/alpha_engine.h"
+#include "feeds/candle_aggregator.h"
+#include "util/market_types.h"
+#include "util/latency_metrics.h"
+#include "util/logger.h"
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+
+using json = nlohmann::json;
+
+static int64_t eventTimeMs(int64_t timestampMs) {
+    // Exchange time when present, otherwise receive time
+    if (timestampMs != 0) return timestampMs;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+PolygonStreamFeed::PolygonStreamFeed(
+    const std::vector<std::string>& symbols,
+    const std::string& apiKey,
+    AlphaEngine& engine,
+    CandleAggregator& aggregator,
+    const std::string& url
+)
+    : symbols_(symbols),
+      apiKey_(apiKey),
+      url_(url),
+      engine_(engine),
+      aggregator_(aggregator),
+      symbolIds_(symbols),
+      tick_{},
+      fastPathCount_(0),
+      fallbackCount_(0),
+      errorCount_(0),
+      quoteCount_(0),
+      verbose_(true),
+      running_(false)
+{}
+
+PolygonStreamFeed::~PolygonStreamFeed() {
+    stop();
+}
+
+void PolygonStreamFeed::setTickCallback(std::function<void(const CompactTick&)> callback) {
+    tickCallback_ = std::move(callback);
+}
+
+void PolygonStreamFeed::setQuoteCallback(std::function<void(const QuoteEvent&)> callback) {
+    quoteCallback_ = std::move(callback);
+}
+
+void PolygonStreamFeed::setRawMessageHook(std::function<void(const std::string&)> hook) {
+    rawMessageHook_ = std::move(hook);
+}
+
+fastjson::ParseStats PolygonStreamFeed::getParseStats() const {
+    return {
+        fastPathCount_.load(std::memory_order_relaxed),
+        fallbackCount_.load(std::memory_order_relaxed),
+        errorCount_.load(std::memory_order_relaxed)
+    };
+}
+
+void PolygonStreamFeed::start() {
+    running_ = true;
+    wsThread_ = std::thread(&PolygonStreamFeed::connectWebSocket, this);
+}
+
+// The socket is created and stopped on the worker thread, so once this
+// returns no callback is running or will run
+void PolygonStreamFeed::stop() {
+    running_ = false;
+    if (wsThread_.joinable()) {
+        wsThread_.join();
+    }
+}
+
+void PolygonStreamFeed::connectWebSocket() {
+    LOG_INFO << "[Polygon WS] Connecting to: " << url_;
+
+    ws_ = std::make_unique<ix::WebSocket>();
+    ws_->setUrl(url_);
+
+    ws_->setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
+        if (msg->type == ix::WebSocketMessageType::Message) {
+            if (rawMessageHook_) rawMessageHook_(msg->str);
+            handleMessage(msg->str);
+        }
+        else if (msg->type == ix::WebSocketMessageType::Open) {
+            // Also runs after every automatic reconnect
+            LOG_INFO << "[Polygon WS] Connected! Authenticating...";
+            authenticate();
+        }
+        else if (msg->type == ix::WebSocketMessageType::Error) {
+            LOG_ERROR << "[Polygon WS] Error: " << msg->errorInfo.reason;
+        }
+        else if (msg->type == ix::WebSocketMessageType::Close) {
+            LOG_INFO << "[Polygon WS] Connection closed";
+        }
+    });
+
+    ws_->start();
+
+    // Keep thread alive
+    while (running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    ws_->stop();
+}
+
+void PolygonStreamFeed::authenticate() {
+    json authMsg = {
+        {"action", "auth"},
+        {"params", apiKey_}
+    };
+    ws_->send(authMsg.dump());
+}
+
+void PolygonStreamFeed::subscribe() {
+    // Replayed captures contain auth_success too; there is no socket to answer it
+    if (!ws_) return;
+
+    std::string params;
+    for (const auto& symbol : symbols_) {
+        if (!params.empty()) params += ',';
+        params += "T." + symbol + ",Q." + symbol;
+    }
+
+    json subscribeMsg = {
+        {"action", "subscribe"},
+        {"params", params}
+    };
+
+    std::string msgStr = subscribeMsg.dump();
+    LOG_INFO << "[Polygon WS] Subscribing: " << msgStr;
+
+    ws_->send(msgStr);
+}
+
+void PolygonStreamFeed::handleMessage(const std::string& message) {
+    size_t pos = 0;
+    size_t events = 0;
+    std::string_view event;
+
+    while (fastjson::nextObject(message, pos, event)) {
+        ++events;
+        handleEvent(event);
+    }
+
+    if (events == 0) {
+        errorCount_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR << "[Polygon WS] Unrecognised message: " << message.substr(0, 200);
+    }
+}
+
+void PolygonStreamFeed::handleEvent(std::string_view event) {
+    // Parse time ends where the trade or quote is handed on
+    ScopedLatency parseTimer(LatencyStage::PARSE);
+
+    // Fast path: trade / quote events scanned in place
+    fastjson::TradeFields trade;
+    if (fastjson::parsePolygonTrade(event, trade)) {
+        fastPathCount_.fetch_add(1, std::memory_order_relaxed);
+        parseTimer.stop();
+        onTrade(trade);
+        return;
+    }
+
+    fastjson::QuoteFields quote;
+    if (fastjson::parsePolygonQuote(event, quote)) {
+        fastPathCount_.fetch_add(1, std::memory_order_relaxed);
+        parseTimer.stop();
+        onQuote(quote);
+        return;
+    }
+
+    fallbackCount_.fetch_add(1, std::memory_order_relaxed);
+
+    try {
+        auto j = json::parse(event);
+
+        std::string ev = j.value("ev", "");
+
+        if (ev == "status") {
+            std::string status = j.value("status", "");
+            if (verbose_ || status == "auth_failed" || status == "error") {
+                LOG_INFO << "[Polygon WS] Status: " << status << " - "
+                         << j.value("message", "");
+            }
+            if (status == "auth_success") subscribe();
+            return;
+        }
+
+        // Symbols the scanner could not take in place (escapes, odd layouts)
+        std::string symbol = j.value("sym", "");
+        if (ev == "T") {
+            trade.symbol = symbol;
+            trade.price = j.value("p", 0.0);
+            trade.quantity = j.value("s", 0.0);
+            trade.timestampMs = j.value("t", int64_t{0});
+            parseTimer.stop();
+            onTrade(trade);
+        } else if (ev == "Q") {
+            quote.symbol = symbol;
+            quote.bidPrice = j.value("bp", 0.0);
+            quote.bidSize = j.value("bs", 0.0);
+            quote.askPrice = j.value("ap", 0.0);
+            quote.askSize = j.value("as", 0.0);
+            quote.timestampMs = j.value("t", int64_t{0});
+            parseTimer.stop();
+            onQuote(quote);
+        }
+
+    } catch (const std::exception& e) {
+        errorCount_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR << "[Polygon WS] Parse error: " << e.what();
+        LOG_ERROR << "[Polygon WS] Event: " << event.substr(0, 200);
+    }
+}
+
+void PolygonStreamFeed::onTrade(const fastjson::TradeFields& trade) {
+    if (trade.symbol.empty() || trade.price == 0.0) return;
+
+    ScopedLatency timer(LatencyStage::DISPATCH);
+
+    SymbolId symbolId = symbolIds_(trade.symbol);
+
+    int64_t timestamp = eventTimeMs(trade.timestampMs);
+
+    auto tickTime = std::chrono::system_clock::time_point{
+        std::chrono::milliseconds(timestamp)
+    };
+
+    aggregator_.onTick(symbolId, trade.price, trade.quantity, tickTime);
+
+    tick_.symbol.assign(trade.symbol.data(), trade.symbol.size());
+    tick_.symbolId = symbolId;
+    tick_.price = trade.price;
+    tick_.volume = trade.quantity;
+    tick_.timestamp = static_cast<long>(timestamp);
+
+    if (tickCallback_) {
+        tickCallback_(CompactTick{
+            symbolId,
+            tick_.price,
+            tick_.volume,
+            timestamp * 1000000LL
+        });
+    }
+
+    // Alpha generation
+    auto sigOpt = engine_.onTick(tick_);
+    if (!sigOpt || !verbose_) return;
+
+    const auto& sig = *sigOpt;
+    LOG_INFO << "[Polygon WS Alpha] "
+             << trade.symbol << " | $" << trade.price
+             << " | Size: " << trade.quantity
+             << " | Mom: " << sig.momentum
+             << " | MRZ: " << sig.meanRevZ;
+}
+
+void PolygonStreamFeed::onQuote(const fastjson::QuoteFields& quote) {
+    if (quote.symbol.empty() || quote.bidPrice <= 0.0 || quote.askPrice <= 0.0) return;
+
+    quoteCount_.fetch_add(1, std::memory_order_relaxed);
+    if (!quoteCallback_) return;
+
+    quoteCallback_(QuoteEvent{
+        symbolIds_(quote.symbol),
+        quote.bidPrice,
+        quote.bidSize,
+        quote.askPrice,
+        quote.askSize,
+        eventTimeMs(quote.timestampMs) * 1000000LL
+    });
+}
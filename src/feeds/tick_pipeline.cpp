@@ -0,0 +1,186 @@
+#include "feeds/tick_pipeline.h"
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+inline int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+void pinCurrentThread(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        std::cerr << "[Pipeline] Could not pin worker to CPU " << cpu << std::endl;
+    }
+#else
+    (void)cpu;  // affinity is advisory only on other platforms
+#endif
+}
+
+constexpr size_t MAX_BURST = 64;      // ticks drained from one ring before moving on
+constexpr int IDLE_SPINS = 256;       // empty polls before the worker starts sleeping
+
+}
+
+TickPipeline::Shard::Shard(size_t numProducers, size_t capacity) {
+    for (size_t p = 0; p < numProducers; ++p) {
+        queues.push_back(std::make_unique<SPSCQueue<QueuedTick>>(capacity));
+    }
+}
+
+TickPipeline::TickPipeline(size_t numProducers, Handler handler, const TickPipelineConfig& config)
+    : numProducers_(numProducers),
+      handler_(std::move(handler)),
+      config_(config),
+      running_(false)
+{
+    size_t numShards = std::max<size_t>(1, config_.numShards);
+    for (size_t s = 0; s < numShards; ++s) {
+        shards_.push_back(std::make_unique<Shard>(numProducers_, config_.queueCapacity));
+    }
+}
+
+TickPipeline::~TickPipeline() {
+    stop();
+}
+
+void TickPipeline::start() {
+    if (running_.exchange(true)) return;
+
+    for (size_t s = 0; s < shards_.size(); ++s) {
+        shards_[s]->worker = std::thread(&TickPipeline::workerLoop, this, s);
+    }
+
+    std::cout << "[Pipeline] " << shards_.size() << " shard worker(s), "
+              << numProducers_ << " producer(s)" << std::endl;
+}
+
+void TickPipeline::stop() {
+    if (!running_.exchange(false)) return;
+
+    for (auto& shard : shards_) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
+        }
+    }
+}
+
+bool TickPipeline::push(size_t producer, const CompactTick& tick) {
+    QueuedTick item;
+    item.tick = tick;
+    item.isQuote = false;
+    item.enqueueNs = steadyNowNs();
+    return enqueue(producer, tick.symbolId, item);
+}
+
+bool TickPipeline::pushQuote(size_t producer, const QuoteEvent& quote) {
+    QueuedTick item;
+    item.quote = quote;
+    item.isQuote = true;
+    item.enqueueNs = steadyNowNs();
+    return enqueue(producer, quote.symbolId, item);
+}
+
+bool TickPipeline::enqueue(size_t producer, SymbolId symbolId, const QueuedTick& item) {
+    Shard& shard = *shards_[shardOf(symbolId)];
+
+    if (!shard.queues[producer]->tryPush(item)) {
+        shard.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void TickPipeline::workerLoop(size_t shardIndex) {
+    Shard& shard = *shards_[shardIndex];
+
+    if (config_.pinThreads) {
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        pinCurrentThread(static_cast<int>((config_.firstCpu + shardIndex) % cpus));
+    }
+
+    QueuedTick item;
+    int idle = 0;
+
+    for (;;) {
+        bool running = running_.load(std::memory_order_acquire);
+        size_t drained = 0;
+
+        for (auto& queue : shard.queues) {
+            for (size_t n = 0; n < MAX_BURST && queue->tryPop(item); ++n) {
+                uint64_t lag = static_cast<uint64_t>(std::max<int64_t>(0, steadyNowNs() - item.enqueueNs));
+
+                if (!item.isQuote) {
+                    handler_(item.tick);
+                } else if (quoteHandler_) {
+                    quoteHandler_(item.quote);
+                }
+
+                // Single writer: plain load/store is enough for the stats
+                shard.lastLagNs.store(lag, std::memory_order_relaxed);
+                shard.totalLagNs.store(shard.totalLagNs.load(std::memory_order_relaxed) + lag,
+                                       std::memory_order_relaxed);
+                if (lag > shard.maxLagNs.load(std::memory_order_relaxed)) {
+                    shard.maxLagNs.store(lag, std::memory_order_relaxed);
+                }
+                shard.processed.store(shard.processed.load(std::memory_order_relaxed) + 1,
+                                      std::memory_order_relaxed);
+                ++drained;
+            }
+        }
+
+        if (drained > 0) {
+            idle = 0;
+            continue;
+        }
+
+        // Rings observed empty after stop was requested: done
+        if (!running) break;
+
+        if (++idle < IDLE_SPINS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+std::vector<ShardStats> TickPipeline::getStats() const {
+    std::vector<ShardStats> stats;
+    stats.reserve(shards_.size());
+
+    for (size_t s = 0; s < shards_.size(); ++s) {
+        const Shard& shard = *shards_[s];
+
+        size_t depth = 0;
+        for (const auto& queue : shard.queues) depth += queue->size();
+
+        uint64_t processed = shard.processed.load(std::memory_order_relaxed);
+        uint64_t totalLag = shard.totalLagNs.load(std::memory_order_relaxed);
+
+        stats.push_back(ShardStats{
+            s,
+            depth,
+            processed,
+            shard.dropped.load(std::memory_order_relaxed),
+            shard.lastLagNs.load(std::memory_order_relaxed) / 1000.0,
+            processed > 0 ? (static_cast<double>(totalLag) / processed) / 1000.0 : 0.0,
+            shard.maxLagNs.load(std::memory_order_relaxed) / 1000.0
+        });
+    }
+
+    return stats;
+}
@@ -1,175 +1,247 @@
 #include "alpha/alpha_engine.h"
+#include "alpha/alpha_pipeline.h"
 #include "alpha/microstructure.h"
 #include "alpha/orderflow.h"
 #include "alpha/regime.h"
 #include "alpha/vwap.h"
 #include "alpha/indicators.h"
+#include "alpha/rolling_stats.h"
+#include "util/latency_histogram.h"
+#include "util/logger.h"
+#include "util/snapshot.h"
 #include "feeds/binance_feed.h"
 #include "feeds/polygon_feed.h"
+#include "feeds/polygon_stream_feed.h"
 #include "feeds/coinbase_feed.h"
 #include "feeds/candle_aggregator.h"
+#include "feeds/tick_pipeline.h"
+#include "feeds/message_capture.h"
 #include "backtest/backtester.h"
+#include "backtest/tick_store.h"
+#include "backtest/param_sweep.h"
+#include "backtest/portfolio_backtester.h"
 #include <curl/curl.h>
 
 #include "storage/influx_writer.h"
+#include "storage/influx_sink.h"
+#include "storage/latency_exporter.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <iostream>
 #include <stdexcept>
 #include <thread>
 #include <chrono>
 #include <iomanip>
-#include <map>
-#include <deque>
 #include <optional>
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <unistd.h>
 
-// ==============================
-//    BOLLINGER BANDS TRACKER
-// ==============================
-
-struct BollingerMetrics {
-    double middleBand;
-    double upperBand;
-    double lowerBand;
-    double bandwidth;      // (upper - lower) / middle
-    double percentB;       // (price - lower) / (upper - lower)
-    bool isSqueezing;      // bandwidth < 5%
-    std::string signal;    // "BUY", "SELL", "NEUTRAL"
-};
+// ==========================
+//     INFLUXDB WIRING
+// ==========================
 
-class BollingerTracker {
-public:
-    explicit BollingerTracker(int period = 10, double mult = 2.0)
-        : period_(period), mult_(mult) {}
+// One writer shared by every alpha system of a live run; null unless INFLUX_* is set
+std::shared_ptr<InfluxWriter> makeInfluxWriterFromEnv() {
+    const char* org    = std::getenv("INFLUX_ORG");
+    const char* bucket = std::getenv("INFLUX_BUCKET");
+    const char* token  = std::getenv("INFLUX_TOKEN");
+    const char* url    = std::getenv("INFLUX_URL");
 
-    std::optional<BollingerMetrics> onPrice(double price) {
-        prices_.push_back(price);
-        if (prices_.size() > static_cast<size_t>(period_)) {
-            prices_.pop_front();
-        }
+    if (!(org && bucket && token && url)) {
+        return nullptr;
+    }
 
-        if (prices_.size() < static_cast<size_t>(period_)) {
-            return std::nullopt;
-        }
+    std::cout << "InfluxDB writer attached (" << url << ")\n";
+    return std::make_shared<InfluxWriter>(org, bucket, token, url);
+}
 
-        // Calculate Bollinger Bands
-        std::vector<double> priceVec(prices_.begin(), prices_.end());
-        double mean, upper, lower;
-        computeBollinger(priceVec, period_, mult_, mean, upper, lower);
-
-        // Calculate metrics
-        BollingerMetrics metrics;
-        metrics.middleBand = mean;
-        metrics.upperBand = upper;
-        metrics.lowerBand = lower;
-        metrics.bandwidth = (mean > 0) ? (upper - lower) / mean : 0.0;
-        metrics.percentB = (upper != lower) ? (price - lower) / (upper - lower) : 0.5;
-        metrics.isSqueezing = metrics.bandwidth < 0.05;  // 5% bandwidth
-
-        // Generate signal
-        if (price < lower && metrics.percentB < 0.1) {
-            metrics.signal = "BUY";
-        } else if (price > upper && metrics.percentB > 0.9) {
-            metrics.signal = "SELL";
-        } else if (metrics.isSqueezing && metrics.percentB > 0.5) {
-            metrics.signal = "BREAKOUT_UP";
-        } else if (metrics.isSqueezing && metrics.percentB < 0.5) {
-            metrics.signal = "BREAKOUT_DOWN";
-        } else {
-            metrics.signal = "NEUTRAL";
-        }
+// Stage latency histograms to Influx every LATENCY_EXPORT_SECONDS (default 10); null without a writer
+std::unique_ptr<LatencyExporter> makeLatencyExporter(const std::shared_ptr<InfluxWriter>& influx) {
+    if (!influx) return nullptr;
 
-        return metrics;
+    int seconds = 10;
+    if (const char* env = std::getenv("LATENCY_EXPORT_SECONDS")) {
+        seconds = std::max(1, std::atoi(env));
     }
 
-    void reset() {
-        prices_.clear();
+    auto exporter = std::make_unique<LatencyExporter>(*influx, std::chrono::seconds(seconds));
+    exporter->start();
+    return exporter;
+}
+
+// Polygon REST limits: POLYGON_RPS / POLYGON_CONCURRENCY / POLYGON_POLL_SECONDS override the defaults
+PolygonFeedConfig polygonConfigFromEnv() {
+    PolygonFeedConfig config;
+    if (const char* rps = std::getenv("POLYGON_RPS")) {
+        config.requestsPerSecond = std::max(0.01, std::atof(rps));
+    }
+    if (const char* concurrency = std::getenv("POLYGON_CONCURRENCY")) {
+        config.maxConcurrent = static_cast<size_t>(std::max(1, std::atoi(concurrency)));
+    }
+    if (const char* poll = std::getenv("POLYGON_POLL_SECONDS")) {
+        config.pollIntervalSeconds = std::max(1, std::atoi(poll));
     }
+    return config;
+}
 
-private:
-    int period_;
-    double mult_;
-    std::deque<double> prices_;
-};
+// POLYGON_STREAM=1 swaps REST polling for the real-time WebSocket; POLYGON_WS_URL picks the cluster
+std::unique_ptr<PolygonStreamFeed> makePolygonStreamFromEnv(const std::vector<std::string>& symbols,
+                                                            const std::string& apiKey,
+                                                            AlphaEngine& engine,
+                                                            CandleAggregator& aggregator) {
+    const char* stream = std::getenv("POLYGON_STREAM");
+    if (!stream || std::string(stream).empty() || std::string(stream) == "0") {
+        return nullptr;
+    }
+
+    const char* url = std::getenv("POLYGON_WS_URL");
+    return std::make_unique<PolygonStreamFeed>(symbols, apiKey, engine, aggregator,
+                                               url ? url : "wss://socket.polygon.io/stocks");
+}
+
+// Live bars: 1s/1m/5m/1h per symbol in one pass. The engine's per-symbol candle
+// indicators run on the minute bars; onTimer() closes bars through quiet spells.
+// Bars close from the feed thread (onTick) and the main loop (onTimer), both
+// under the aggregator's lock, and onCandle shares no state with the feed
+// thread's engine.onTick, so the engine needs no lock of its own.
+std::shared_ptr<CandleAggregator> makeLiveAggregator(const std::shared_ptr<AlphaEngine>& engine) {
+    auto aggregator = std::make_shared<CandleAggregator>(CandleAggregatorConfig{{1, 60, 300, 3600}});
+    aggregator->setOnCandleClosed([engine](const Candle& c) {
+        if (c.intervalSeconds == 60) engine->onCandle(c);
+    });
+    return aggregator;
+}
 
 // ==========================
 //     ALPHA ENGINE
 // ==========================
 
+// ALPHA_RESEARCH_PIPELINE builds pick stages at runtime from ALPHA_STAGES;
+// production builds compile the full stage list in
+#ifdef ALPHA_RESEARCH_PIPELINE
+using LiveAlphaPipeline = DynamicAlphaPipeline;
+
+LiveAlphaPipeline makeLivePipeline() {
+    const char* stages = std::getenv("ALPHA_STAGES");
+    return DynamicAlphaPipeline(stages ? parseAlphaStages(stages) : alpha_stage::ALL);
+}
+#else
+using LiveAlphaPipeline = FullAlphaPipeline;
+
+LiveAlphaPipeline makeLivePipeline() {
+    return LiveAlphaPipeline();
+}
+#endif
+
+// Console panel refresh per symbol (ALPHA_DASHBOARD_MS, default 1000)
+std::chrono::milliseconds dashboardInterval() {
+    int ms = 1000;
+    if (const char* env = std::getenv("ALPHA_DASHBOARD_MS")) {
+        ms = std::max(0, std::atoi(env));
+    }
+    return std::chrono::milliseconds(ms);
+}
+
 class ProductionAlphaSystem {
 public:
-    ProductionAlphaSystem()
-        : alphaEngine_(20, "1m"),
-          microstructure_(50, 50, 100),
-          regime_(100, 20, 50),
-          vwap_(2.0, 0),
-          bollinger_(20, 2.0),
-          lastPrice_(0.0),
-          tickCount_(0) {
-
-        // InfluxDB wiring
-        const char* org    = std::getenv("INFLUX_ORG");
-        const char* bucket = std::getenv("INFLUX_BUCKET");
-        const char* token  = std::getenv("INFLUX_TOKEN");
-        const char* url    = std::getenv("INFLUX_URL");
-
-        if (org && bucket && token && url) {
-            influx_ = std::make_shared<InfluxWriter>(org, bucket, token, url);
-            std::cout << "InfluxDB writer attached for the engine\n";
-        }
+    // verbose = false drops the console panel (backtests)
+    explicit ProductionAlphaSystem(SymbolId symbolId, std::shared_ptr<InfluxWriter> influx = nullptr,
+                                   bool verbose = true)
+        : tick_{SymbolRegistry::instance().name(symbolId), 0.0, 0.0, 0, symbolId},
+          pipeline_(makeLivePipeline()),
+          influx_(std::move(influx)),
+          verbose_(verbose),
+          dashboard_(dashboardInterval()),
+          direction_(0),
+          decision_("NEUTRAL") {}
+
+    // Combined decision after the latest tick: 1 = buy, -1 = sell, 0 = hold
+    int direction() const { return direction_; }
+
+    // Top of book from the feed: trades after it are signed by the quote rule
+    void processQuote(const QuoteEvent& quote) {
+        pipeline_.onQuote(quote);
+        if (snapshotRequested_.load(std::memory_order_relaxed)) publishSnapshot();
     }
 
-    void processMarketTick(const MarketTick& tick) {
-        // 1. Basic Alpha Signals
-        auto basicSignal = alphaEngine_.onTick(tick);
+    // Snapshots are taken by the thread that feeds this system, at the end of
+    // its next tick or quote, so pipeline state is never read mid-update.
+    // copySnapshot() returns the latest one; false if there is none yet.
+    void requestSnapshot() { snapshotRequested_.store(true, std::memory_order_relaxed); }
 
-        // 2. Microstructure Analysis (VPIN, Hasbrouck)
-        microstructure_.onTick(tick);
-        auto vpinMetrics = microstructure_.getVPIN();
-        auto hasbrouckMetrics = microstructure_.getHasbrouckMetrics();
+    bool copySnapshot(std::string& out) const {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        if (published_.empty()) return false;
+        out.assign(published_);
+        return true;
+    }
 
-        // 3. Order Flow Analysis (OFI)
-        bool isBuy = (tick.price > lastPrice_);
-        auto flowSignal = orderflow_.onTick(tick, isBuy);
+    // Before the feeds start. State that no longer fits (changed windows, a
+    // different stage list) is dropped and the system starts cold.
+    bool restore(std::string_view state) {
+        try {
+            SnapshotReader in(state);
+            pipeline_.loadState(in);
+            if (!in.atEnd()) SnapshotReader::fail("trailing bytes");
+        } catch (const std::exception& e) {
+            LOG_WARN << "[Snapshot] " << tick_.symbol << ": " << e.what() << ", starting cold";
+            pipeline_ = makeLivePipeline();
+            return false;
+        }
 
-        // 4. Regime Detection
-        regime_.onTick(tick);
-        auto regimeMetrics = regime_.getMetrics();
+        // Republished as is until the first tick replaces it
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        published_.assign(state.data(), state.size());
+        return true;
+    }
 
-        // 5. VWAP Calculation
-        vwap_.onTick(tick);
-        auto vwapMetrics = vwap_.getMetrics();
+    // Feed entry point: fills the prebuilt tick so the symbol string is never rebuilt
+    void processTick(const CompactTick& tick) {
+        tick_.price = tick.price;
+        tick_.volume = tick.quantity;
+        tick_.timestamp = static_cast<long>(tick.timestampNs / 1000000LL);
+        processMarketTick(tick_);
+    }
+
+    void processMarketTick(const MarketTick& tick) {
+        ScopedLatency timer(LatencyStage::ALPHA_SYSTEM);
+        const TickContext& ctx = pipeline_.onTick(tick);
 
-        // 6. BOLLINGER BANDS
-        auto bollingerSignal = bollinger_.onPrice(tick.price);
+        MarketRegime regime = ctx.regime ? ctx.regime->regime : MarketRegime::UNKNOWN;
 
         // InfluxDB writes
         if (influx_) {
             // Alpha / Bollinger summary
             influx_->writeAlphaSignal(
                 tick.symbol,
-                basicSignal ? basicSignal->momentum : 0.0,
-                basicSignal ? basicSignal->meanRevZ : 0.0,
-                bollingerSignal ? bollingerSignal->percentB : 0.0,
+                ctx.alpha ? ctx.alpha->momentum : 0.0,
+                ctx.alpha ? ctx.alpha->meanRevZ : 0.0,
+                ctx.bollinger ? ctx.bollinger->percentB : 0.0,
                 0.0,  // reserved for combinedScore or extra signal later
-                regime::regimeToString(regimeMetrics.regime)
+                regime::regimeToString(regime)
             );
 
             // Microstructure (VPIN / Hasbrouck)
-            influx_->writeMicrostructureSignal(
-                tick.symbol,
-                vpinMetrics.vpin,
-                vpinMetrics.toxicity,
-                hasbrouckMetrics.lambda,
-                0.0,              // spread placeholder
-                tick.timestamp
-            );
+            if (ctx.vpin && ctx.impact) {
+                influx_->writeMicrostructureSignal(
+                    tick.symbol,
+                    ctx.vpin->vpin,
+                    ctx.vpin->toxicity,
+                    ctx.impact->lambda,
+                    ctx.quotedSpread,
+                    tick.timestamp
+                );
+            }
 
             // Order flow
             influx_->writeOrderFlowSignal(
                 tick.symbol,
-                flowSignal ? flowSignal->ofi : 0.0,
+                ctx.flow ? ctx.flow->ofi : 0.0,
                 0.0,  // buy volume placeholder
                 0.0,  // sell volume placeholder
                 0.0,  // imbalance placeholder
@@ -177,142 +249,320 @@ public:
             );
 
             // Regime state
-            influx_->writeRegimeSignal(
-                tick.symbol,
-                regime::regimeToString(regimeMetrics.regime),
-                regimeMetrics.hurstExponent,
-                regimeMetrics.volatility,
-                regimeMetrics.trendStrength,
-                tick.timestamp
-            );
+            if (ctx.regime) {
+                influx_->writeRegimeSignal(
+                    tick.symbol,
+                    regime::regimeToString(regime),
+                    ctx.regime->hurstExponent,
+                    ctx.regime->volatility,
+                    ctx.regime->trendStrength,
+                    tick.timestamp
+                );
+            }
         }
 
-        lastPrice_ = tick.price;
-        tickCount_++;
+        decide(ctx);
+        timer.stop();
 
-        // Only print every 3rd tick to avoid spam
-        if (tickCount_ % 3 != 0) return;
+        if (snapshotRequested_.load(std::memory_order_relaxed)) publishSnapshot();
 
-        if (basicSignal && flowSignal) {
-            std::cout << "\n╔══════════════════════════════════════════════════════════╗" << std::endl;
-            std::cout << "║     ALPHA SIGNAL: " << std::setw(10) << tick.symbol
-                      << " | Price: $" << std::fixed << std::setprecision(2) << tick.price
-                      << std::setw(20) << " ║" << std::endl;
-            std::cout << "╠══════════════════════════════════════════════════════════╣" << std::endl;
+        // Refresh the panel at a fixed rate rather than per tick; one log
+        // record per panel, written by the logger thread
+        if (!verbose_ || !ctx.alpha || !ctx.flow) return;
+        if (!Logger::instance().enabled(LogLevel::INFO) || !dashboard_.ready()) return;
+
+        {
+            LogLine line(LogLevel::INFO);
+            std::ostream& out = line.stream();
+
+            out << "\n╔══════════════════════════════════════════════════════════╗\n";
+            out << "║     ALPHA SIGNAL: " << std::setw(10) << tick.symbol
+                << " | Price: $" << std::fixed << std::setprecision(2) << tick.price
+                << std::setw(20) << " ║" << '\n';
+            out << "╠══════════════════════════════════════════════════════════╣\n";
 
             // Basic Signals
-            std::cout << "║    MOMENTUM:        "
-                      << std::setw(8) << std::fixed << std::setprecision(4)
-                      << basicSignal->momentum * 100 << "%" << std::setw(25) << "║" << std::endl;
+            out << "║    MOMENTUM:        "
+                << std::setw(8) << std::fixed << std::setprecision(4)
+                << ctx.alpha->momentum * 100 << "%" << std::setw(25) << "║" << '\n';
 
-            std::cout << "║    MEAN REV Z:      "
-                      << std::setw(8) << std::fixed << std::setprecision(4)
-                      << basicSignal->meanRevZ << std::setw(30) << "║" << std::endl;
+            out << "║    MEAN REV Z:      "
+                << std::setw(8) << std::fixed << std::setprecision(4)
+                << ctx.alpha->meanRevZ << std::setw(30) << "║" << '\n';
 
             // BOLLINGER BANDS
-            if (bollingerSignal) {
-                std::cout << "║    BOLLINGER:                                        ║" << std::endl;
-                std::cout << "║    Upper:  $" << std::setw(8) << std::setprecision(2)
-                          << bollingerSignal->upperBand << std::setw(32) << "║" << std::endl;
-                std::cout << "║    Middle: $" << std::setw(8) << bollingerSignal->middleBand
-                          << std::setw(32) << "║" << std::endl;
-                std::cout << "║    Lower:  $" << std::setw(8) << bollingerSignal->lowerBand
-                          << std::setw(32) << "║" << std::endl;
-                std::cout << "║    %B:      " << std::setw(8) << std::setprecision(3)
-                          << bollingerSignal->percentB << std::setw(32) << "║" << std::endl;
-
-                if (bollingerSignal->isSqueezing) {
-                    std::cout << "║   SQUEEZE DETECTED - Breakout Imminent!         ║" << std::endl;
+            if (ctx.bollinger) {
+                const auto& bands = *ctx.bollinger;
+                out << "║    BOLLINGER:                                        ║\n";
+                out << "║    Upper:  $" << std::setw(8) << std::setprecision(2)
+                    << bands.upperBand << std::setw(32) << "║" << '\n';
+                out << "║    Middle: $" << std::setw(8) << bands.middleBand
+                    << std::setw(32) << "║" << '\n';
+                out << "║    Lower:  $" << std::setw(8) << bands.lowerBand
+                    << std::setw(32) << "║" << '\n';
+                out << "║    %B:      " << std::setw(8) << std::setprecision(3)
+                    << bands.percentB << std::setw(32) << "║" << '\n';
+
+                if (bands.isSqueezing) {
+                    out << "║   SQUEEZE DETECTED - Breakout Imminent!         ║\n";
                 }
 
-                if (bollingerSignal->signal != "NEUTRAL") {
-                    std::cout << "║    Signal: " << std::setw(15) << bollingerSignal->signal
-                              << std::setw(24) << "║" << std::endl;
+                if (bands.signal != BollingerSignal::NEUTRAL) {
+                    out << "║    Signal: " << std::setw(15) << bollingerSignalName(bands.signal)
+                        << std::setw(24) << "║" << '\n';
                 }
             }
 
             // Microstructure
-            if (vpinMetrics.vpin > 0.01) {
-                std::cout << "║ VPIN (Toxicity): "
-                          << std::setw(8) << std::fixed << std::setprecision(4)
-                          << vpinMetrics.vpin
-                          << (vpinMetrics.toxicity > 0.5 ? "   TOXIC!" : ")
-                          << std::setw(15) << "║" << std::endl;
-
-                std::cout << "║ Price Impact:    "
-                          << std::setw(8) << std::fixed << std::setprecision(6)
-                          << hasbrouckMetrics.lambda << std::setw(26) << "║" << std::endl;
+            if (ctx.vpin && ctx.impact && ctx.vpin->vpin > 0.01) {
+                out << "║ VPIN (Toxicity): "
+                    << std::setw(8) << std::fixed << std::setprecision(4)
+                    << ctx.vpin->vpin
+                    << (ctx.vpin->toxicity > 0.5 ? "   TOXIC!" : "")
+                    << std::setw(15) << "║" << '\n';
+
+                out << "║ Price Impact:    "
+                    << std::setw(8) << std::fixed << std::setprecision(6)
+                    << ctx.impact->lambda << std::setw(26) << "║" << '\n';
             }
 
             // Order Flow
-            if (flowSignal->ofi != 0.0) {
-                std::cout << "║   Order Flow OFI:  "
-                          << std::setw(8) << std::fixed << std::setprecision(4)
-                          << flowSignal->ofi
-                          << " (" << flowSignal->flowDirection << ")"
-                          << std::setw(10) << "║" << std::endl;
+            if (ctx.flow->ofi != 0.0) {
+                out << "║   Order Flow OFI:  "
+                    << std::setw(8) << std::fixed << std::setprecision(4)
+                    << ctx.flow->ofi
+                    << " (" << flowDirectionToString(ctx.flow->flowDirection) << ")"
+                    << std::setw(10) << "║" << '\n';
+            }
+            if (ctx.bookOfi) {
+                out << "║   Book OFI:        "
+                    << std::setw(8) << std::fixed << std::setprecision(4)
+                    << *ctx.bookOfi
+                    << " | Spread: " << std::setprecision(4) << ctx.quotedSpread
+                    << std::setw(10) << "║" << '\n';
             }
 
             // Regime
-            std::cout << "║    REGIME:          "
-                      << regime::regimeToString(regimeMetrics.regime).substr(0, 20)
-                      << std::setw(20) << "║" << std::endl;
-
-            std::cout << "║    Hurst Exp:       "
-                      << std::setw(8) << std::fixed << std::setprecision(4)
-                      << regimeMetrics.hurstExponent
-                      << (regimeMetrics.hurstExponent > 0.55 ? " (Trending)" : " (Mean-Rev)")
-                      << std::setw(10) << "║" << std::endl;
+            if (ctx.regime) {
+                out << "║    REGIME:          "
+                    << std::string_view(regime::regimeToString(regime)).substr(0, 20)
+                    << std::setw(20) << "║" << '\n';
+
+                out << "║    Hurst Exp:       "
+                    << std::setw(8) << std::fixed << std::setprecision(4)
+                    << ctx.regime->hurstExponent
+                    << (ctx.regime->hurstExponent > 0.55 ? " (Trending)" : " (Mean-Rev)")
+                    << std::setw(10) << "║" << '\n';
+            }
 
             // VWAP
-            if (vwapMetrics.vwap > 0.01) {
-                std::cout << "║    VWAP:            $"
-                          << std::setw(8) << std::fixed << std::setprecision(2)
-                          << vwapMetrics.vwap
-                          << " (Dev: " << std::setprecision(2) << vwapMetrics.deviation << "%)"
-                          << std::setw(8) << "║" << std::endl;
+            if (ctx.vwap && ctx.vwap->vwap > 0.01) {
+                out << "║    VWAP:            $"
+                    << std::setw(8) << std::fixed << std::setprecision(2)
+                    << ctx.vwap->vwap
+                    << " (Dev: " << std::setprecision(2) << ctx.vwap->deviation << "%)"
+                    << std::setw(8) << "║" << '\n';
             }
 
             // TRADING SIGNALS
-            auto weights = regime_.getSignalWeights();
-            double combinedScore = weights.momentumWeight * basicSignal->momentum +
-                                   weights.meanRevWeight * basicSignal->meanRevZ;
-
-            std::string signal = "NEUTRAL";
-            if (bollingerSignal && bollingerSignal->signal == "BUY" &&
-                combinedScore > 0.01 && vpinMetrics.toxicity < 0.5) {
-                signal = " STRONG BUY (BB Confirm)";
-            } else if (bollingerSignal && bollingerSignal->signal == "SELL" &&
-                       combinedScore < -0.01 && vpinMetrics.toxicity < 0.5) {
-                signal = " STRONG SELL (BB Confirm)";
-            } else if (combinedScore > 0.01 && vpinMetrics.toxicity < 0.5) {
-                signal = " BUY";
-            } else if (combinedScore < -0.01 && vpinMetrics.toxicity < 0.5) {
-                signal = " SELL";
-            } else if (vpinMetrics.toxicity > 0.7) {
-                signal = " WAIT (Toxic Flow)";
-            } else if (bollingerSignal && bollingerSignal->isSqueezing) {
-                signal = " WAIT (BB Squeeze)";
+            out << "╠══════════════════════════════════════════════════════════╣\n";
+            out << "║   SIGNAL:          " << std::setw(30) << decision_ << std::setw(10) << "║" << '\n';
+            out << "╚══════════════════════════════════════════════════════════╝\n";
+        }
+    }
+
+private:
+    void publishSnapshot() {
+        snapshotRequested_.store(false, std::memory_order_relaxed);
+        snapshot_.clear();
+        pipeline_.saveState(snapshot_);
+
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        published_.swap(snapshot_.data());
+    }
+
+    void decide(const TickContext& ctx) {
+        direction_ = 0;
+        decision_ = "NEUTRAL";
+        if (!ctx.alpha) return;
+
+        // Without the regime / microstructure stages: neutral weights, no toxicity filter
+        auto weights = ctx.weights.value_or(RegimeSignalWeights{0.5, 0.5, 0.5, 1.0});
+        double toxicity = ctx.vpin ? ctx.vpin->toxicity : 0.0;
+        const auto& bollingerSignal = ctx.bollinger;
+
+        double combinedScore = weights.momentumWeight * ctx.alpha->momentum +
+                               weights.meanRevWeight * ctx.alpha->meanRevZ;
+
+        if (bollingerSignal && bollingerSignal->signal == BollingerSignal::BUY &&
+            combinedScore > 0.01 && toxicity < 0.5) {
+            direction_ = 1;
+            decision_ = " STRONG BUY (BB Confirm)";
+        } else if (bollingerSignal && bollingerSignal->signal == BollingerSignal::SELL &&
+                   combinedScore < -0.01 && toxicity < 0.5) {
+            direction_ = -1;
+            decision_ = " STRONG SELL (BB Confirm)";
+        } else if (combinedScore > 0.01 && toxicity < 0.5) {
+            direction_ = 1;
+            decision_ = " BUY";
+        } else if (combinedScore < -0.01 && toxicity < 0.5) {
+            direction_ = -1;
+            decision_ = " SELL";
+        } else if (toxicity > 0.7) {
+            decision_ = " WAIT (Toxic Flow)";
+        } else if (bollingerSignal && bollingerSignal->isSqueezing) {
+            decision_ = " WAIT (BB Squeeze)";
+        }
+    }
+
+    MarketTick tick_;
+    LiveAlphaPipeline pipeline_;
+    std::shared_ptr<InfluxWriter> influx_;
+    bool verbose_;
+    Throttle dashboard_;
+    int direction_;
+    const char* decision_;
+
+    std::atomic<bool> snapshotRequested_{false};
+    SnapshotWriter snapshot_;
+    mutable std::mutex snapshotMutex_;
+    std::string published_;
+};
+
+// Alpha systems indexed by SymbolId, so routing a tick is a vector index
+class AlphaSystemTable {
+public:
+    explicit AlphaSystemTable(std::shared_ptr<InfluxWriter> influx = nullptr, bool verbose = true)
+        : influx_(std::move(influx)), verbose_(verbose) {}
+
+    void add(const std::vector<std::string>& symbols) {
+        for (const auto& symbol : symbols) {
+            add(SymbolRegistry::instance().intern(symbol));
+        }
+    }
+
+    void add(SymbolId id) {
+        if (id >= systems_.size()) systems_.resize(id + 1);
+        if (!systems_[id]) {
+            systems_[id] = std::make_unique<ProductionAlphaSystem>(id, influx_, verbose_);
+        }
+    }
+
+    size_t size() const {
+        return std::count_if(systems_.begin(), systems_.end(), [](const auto& s) { return s != nullptr; });
+    }
+
+    void dispatch(const CompactTick& tick) const {
+        if (tick.symbolId < systems_.size() && systems_[tick.symbolId]) {
+            systems_[tick.symbolId]->processTick(tick);
+        }
+    }
+
+    void dispatchQuote(const QuoteEvent& quote) const {
+        if (quote.symbolId < systems_.size() && systems_[quote.symbolId]) {
+            systems_[quote.symbolId]->processQuote(quote);
+        }
+    }
+
+    // Snapshot sections are "alpha/<symbol>"
+    void requestSnapshots() const {
+        for (const auto& system : systems_) {
+            if (system) system->requestSnapshot();
+        }
+    }
+
+    void collectSnapshots(SnapshotFileBuilder& builder) const {
+        std::string state;
+        for (SymbolId id = 0; id < systems_.size(); ++id) {
+            if (systems_[id] && systems_[id]->copySnapshot(state)) {
+                builder.add("alpha/" + SymbolRegistry::instance().name(id), state);
             }
+        }
+    }
 
-            std::cout << "╠══════════════════════════════════════════════════════════╣" << std::endl;
-            std::cout << "║   SIGNAL:          " << std::setw(30) << signal << std::setw(10) << "║" << std::endl;
-            std::cout << "╚══════════════════════════════════════════════════════════╝\n" << std::endl;
+    // Number of systems restored
+    size_t restore(const MappedSnapshot& snapshot) {
+        size_t restored = 0;
+        for (SymbolId id = 0; id < systems_.size(); ++id) {
+            if (!systems_[id]) continue;
+
+            std::string_view state = snapshot.find("alpha/" + SymbolRegistry::instance().name(id));
+            if (!state.empty() && systems_[id]->restore(state)) ++restored;
         }
+        return restored;
     }
 
 private:
-    AlphaEngine alphaEngine_;
-    MicrostructureAnalyzer microstructure_;
-    OrderFlowEngine orderflow_;
-    RegimeDetector regime_;
-    VWAPCalculator vwap_;
-    BollingerTracker bollinger_;
     std::shared_ptr<InfluxWriter> influx_;
-    double lastPrice_;
-    int tickCount_;
+    bool verbose_;
+    std::vector<std::unique_ptr<ProductionAlphaSystem>> systems_;
 };
 
+// Warm restarts: with ALPHA_SNAPSHOT_PATH set, alpha and candle state is
+// loaded from that file on startup and rewritten every ALPHA_SNAPSHOT_SECONDS
+// (default 30). Null when unset. Call once the symbols are added and before
+// the feeds start; aggregator sections are keyed by the given names.
+std::unique_ptr<SnapshotService> makeSnapshotService(
+    AlphaSystemTable& alphaSystems,
+    const std::vector<std::pair<std::string, std::shared_ptr<CandleAggregator>>>& aggregators) {
+    const char* path = std::getenv("ALPHA_SNAPSHOT_PATH");
+    if (!path || !*path) return nullptr;
+
+    int seconds = 30;
+    if (const char* env = std::getenv("ALPHA_SNAPSHOT_SECONDS")) {
+        seconds = std::max(1, std::atoi(env));
+    }
+
+    if (::access(path, F_OK) == 0) {
+        try {
+            auto start = std::chrono::steady_clock::now();
+            MappedSnapshot snapshot(path);
+
+            size_t restored = alphaSystems.restore(snapshot);
+            for (const auto& [name, aggregator] : aggregators) {
+                std::string_view state = snapshot.find("candles/" + name);
+                if (state.empty()) continue;
+                try {
+                    SnapshotReader in(state);
+                    aggregator->loadState(in);
+                } catch (const std::exception& e) {
+                    LOG_WARN << "[Snapshot] candles/" << name << ": " << e.what() << ", starting cold";
+                }
+            }
+
+            auto loadUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            auto ageSeconds = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now() - snapshot.writtenAt()).count();
+            std::cout << "Warm start from " << path << ": " << restored << "/" << alphaSystems.size()
+                      << " alpha systems, " << snapshot.sections() << " sections, "
+                      << ageSeconds << "s old, loaded in " << loadUs << " us\n";
+        } catch (const std::exception& e) {
+            std::cerr << "Snapshot not loaded, starting cold: " << e.what() << std::endl;
+        }
+    }
+
+    auto service = std::make_unique<SnapshotService>(path, std::chrono::seconds(seconds));
+    service->addSource([&alphaSystems](SnapshotFileBuilder& builder) {
+        // Publish what the tick threads produced since the last request, then
+        // ask for the next round
+        alphaSystems.collectSnapshots(builder);
+        alphaSystems.requestSnapshots();
+    });
+    service->addSource([aggregators](SnapshotFileBuilder& builder) {
+        SnapshotWriter out;
+        for (const auto& [name, aggregator] : aggregators) {
+            out.clear();
+            aggregator->saveState(out);
+            builder.add("candles/" + name, out.data());
+        }
+    });
+
+    alphaSystems.requestSnapshots();
+    service->start();
+    std::cout << "Snapshots every " << seconds << "s to " << path << "\n";
+    return service;
+}
 
 void runEnhancedLiveTrading() {
     std::cout << " Starting ENHANCED ALPHA SYSTEM...\n" << std::endl;
@@ -321,70 +571,78 @@ void runEnhancedLiveTrading() {
     if (!key) throw std::runtime_error(" POLYGON_API_KEY is not set");
     std::string polygonKey(key);
 
-    // ONE ALPHA SYSTEM PER SYMBOL
-    std::map<std::string, std::shared_ptr<ProductionAlphaSystem>> alphaSystems;
-
-    std::vector<std::string> symbols = {"AAPL", "MSFT"};
-    for (const auto& symbol : symbols) {
-        alphaSystems[symbol] = std::make_shared<ProductionAlphaSystem>();
-    }
+    auto influx = makeInfluxWriterFromEnv();
+    std::unique_ptr<InfluxSignalSink> influxSink;
+    if (influx) influxSink = std::make_unique<InfluxSignalSink>(*influx);
 
-    auto engine = std::make_shared<AlphaEngine>(20, "1m");
-    auto aggregator = std::make_shared<CandleAggregator>(60);
+    AlphaSystemTable alphaSystems(influx);
+    auto latencyExporter = makeLatencyExporter(influx);
 
-    aggregator->setOnCandleClosed([engine](const Candle& c) {
-        engine->onCandle(c);
-    });
+    std::vector<std::string> symbols = {"AAPL", "MSFT"};
+    alphaSystems.add(symbols);
 
-    PolygonFeed polygonFeed(symbols, polygonKey, *engine, *aggregator);
+    auto engine = std::make_shared<AlphaEngine>(20, "1m", influxSink.get());
+    auto aggregator = makeLiveAggregator(engine);
+    auto snapshots = makeSnapshotService(alphaSystems, {{"polygon", aggregator}});
 
     // Route each symbol to its own alpha system
-    polygonFeed.setTickCallback([&alphaSystems](const MarketTick& tick) {
-        auto it = alphaSystems.find(tick.symbol);
-        if (it != alphaSystems.end()) {
-            it->second->processMarketTick(tick);
-        }
-    });
+    auto dispatch = [&alphaSystems](const CompactTick& tick) {
+        alphaSystems.dispatch(tick);
+    };
 
-    std::thread polygonThread([&]() {
+    auto polygonStream = makePolygonStreamFromEnv(symbols, polygonKey, *engine, *aggregator);
+    std::unique_ptr<PolygonFeed> polygonFeed;
+    if (polygonStream) {
+        polygonStream->setTickCallback(dispatch);
+        polygonStream->setQuoteCallback([&alphaSystems](const QuoteEvent& quote) {
+            alphaSystems.dispatchQuote(quote);
+        });
+        polygonStream->start();
+        std::cout << " Polygon stream started\n";
+    } else {
+        polygonFeed = std::make_unique<PolygonFeed>(symbols, polygonKey, *engine, *aggregator,
+                                                    polygonConfigFromEnv());
+        polygonFeed->setTickCallback(dispatch);
+        polygonFeed->start();
         std::cout << " Polygon feed started\n";
-        polygonFeed.start();
-    });
+    }
 
     std::cout << " All systems operational\n" << std::endl;
-    polygonThread.join();
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        aggregator->onTimer();
+    }
 }
 
 void runCoinbaseLive() {
     std::cout << " Starting COINBASE CRYPTO FEED (24/7 Live!)...\n" << std::endl;
 
-    // Create one alpha system per product
-    std::map<std::string, std::shared_ptr<ProductionAlphaSystem>> alphaSystems;
+    auto influx = makeInfluxWriterFromEnv();
+    std::unique_ptr<InfluxSignalSink> influxSink;
+    if (influx) influxSink = std::make_unique<InfluxSignalSink>(*influx);
+
+    AlphaSystemTable alphaSystems(influx);
+    auto latencyExporter = makeLatencyExporter(influx);
 
     std::vector<std::string> products = {
         "ETH-USD",   // Ethereum
         "SOL-USD"    // Solana
     };
 
-    for (const auto& product : products) {
-        alphaSystems[product] = std::make_shared<ProductionAlphaSystem>();
-    }
-
-    auto engine = std::make_shared<AlphaEngine>(20, "1m");
-    auto aggregator = std::make_shared<CandleAggregator>(60);
+    alphaSystems.add(products);
 
-    aggregator->setOnCandleClosed([engine](const Candle& c) {
-        engine->onCandle(c);
-    });
+    auto engine = std::make_shared<AlphaEngine>(20, "1m", influxSink.get());
+    auto aggregator = makeLiveAggregator(engine);
+    auto snapshots = makeSnapshotService(alphaSystems, {{"coinbase", aggregator}});
 
     CoinbaseAdvancedFeed coinbaseFeed(products, *engine, *aggregator);
 
     // Route to per-symbol alpha systems
-    coinbaseFeed.setTickCallback([&alphaSystems](const MarketTick& tick) {
-        auto it = alphaSystems.find(tick.symbol);
-        if (it != alphaSystems.end()) {
-            it->second->processMarketTick(tick);
-        }
+    coinbaseFeed.setTickCallback([&alphaSystems](const CompactTick& tick) {
+        alphaSystems.dispatch(tick);
+    });
+    coinbaseFeed.setQuoteCallback([&alphaSystems](const QuoteEvent& quote) {
+        alphaSystems.dispatchQuote(quote);
     });
 
     coinbaseFeed.start();
@@ -394,118 +652,179 @@ void runCoinbaseLive() {
     // Keep running
     while (true) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
+        aggregator->onTimer();
     }
 }
 
 void runAllExchanges() {
     std::cout << " Starting ALL EXCHANGES (Binance + Coinbase + Polygon!)...\n" << std::endl;
 
-    // Create alpha systems for all symbols across all exchanges
-    std::map<std::string, std::shared_ptr<ProductionAlphaSystem>> alphaSystems;
+    auto influx = makeInfluxWriterFromEnv();
+    std::unique_ptr<InfluxSignalSink> influxSink;
+    if (influx) influxSink = std::make_unique<InfluxSignalSink>(*influx);
+
+    AlphaSystemTable alphaSystems(influx);
+    auto latencyExporter = makeLatencyExporter(influx);
 
     // Binance symbols
     std::vector<std::string> binanceSymbols = {"BTCUSDT", "BNBUSDT"};
-    for (const auto& s : binanceSymbols) {
-        alphaSystems[s] = std::make_shared<ProductionAlphaSystem>();
-    }
+    alphaSystems.add(binanceSymbols);
 
     // Coinbase symbols
     std::vector<std::string> coinbaseProducts = {"ETH-USD", "SOL-USD"};
-    for (const auto& s : coinbaseProducts) {
-        alphaSystems[s] = std::make_shared<ProductionAlphaSystem>();
-    }
+    alphaSystems.add(coinbaseProducts);
 
     // Polygon symbols
     std::vector<std::string> polygonSymbols = {"AAPL", "MSFT", "GOOGL"};
-    for (const auto& s : polygonSymbols) {
-        alphaSystems[s] = std::make_shared<ProductionAlphaSystem>();
-    }
+    alphaSystems.add(polygonSymbols);
 
     // Engines & aggregators per exchange
-    auto binanceEngine = std::make_shared<AlphaEngine>(20, "1m");
-    auto binanceAgg    = std::make_shared<CandleAggregator>(60);
+    auto binanceEngine = std::make_shared<AlphaEngine>(20, "1m", influxSink.get());
+    auto binanceAgg    = makeLiveAggregator(binanceEngine);
 
-    auto coinbaseEngine = std::make_shared<AlphaEngine>(20, "1m");
-    auto coinbaseAgg    = std::make_shared<CandleAggregator>(60);
+    auto coinbaseEngine = std::make_shared<AlphaEngine>(20, "1m", influxSink.get());
+    auto coinbaseAgg    = makeLiveAggregator(coinbaseEngine);
 
-    auto polygonEngine  = std::make_shared<AlphaEngine>(20, "1m");
-    auto polygonAgg     = std::make_shared<CandleAggregator>(60);
+    auto polygonEngine  = std::make_shared<AlphaEngine>(20, "1m", influxSink.get());
+    auto polygonAgg     = makeLiveAggregator(polygonEngine);
+
+    auto snapshots = makeSnapshotService(alphaSystems, {
+        {"binance", binanceAgg}, {"coinbase", coinbaseAgg}, {"polygon", polygonAgg}
+    });
 
     // Feeds
     auto binanceFeed  = std::make_shared<BinancePublicFeed>(binanceSymbols, *binanceEngine, *binanceAgg);
     auto coinbaseFeed = std::make_shared<CoinbaseAdvancedFeed>(coinbaseProducts, *coinbaseEngine, *coinbaseAgg);
 
     const char* polygonKey = std::getenv("POLYGON_API_KEY");
+    std::unique_ptr<PolygonStreamFeed> polygonStream;
     std::unique_ptr<PolygonFeed> polygonFeed;
     if (polygonKey) {
-        polygonFeed = std::make_unique<PolygonFeed>(
-            polygonSymbols, std::string(polygonKey), *polygonEngine, *polygonAgg
-        );
+        polygonStream = makePolygonStreamFromEnv(polygonSymbols, polygonKey, *polygonEngine, *polygonAgg);
+        if (!polygonStream) {
+            polygonFeed = std::make_unique<PolygonFeed>(
+                polygonSymbols, std::string(polygonKey), *polygonEngine, *polygonAgg,
+                polygonConfigFromEnv()
+            );
+        }
     }
 
-    // Shared callback
-    auto callback = [&alphaSystems](const MarketTick& tick) {
-        auto it = alphaSystems.find(tick.symbol);
-        if (it != alphaSystems.end()) {
-            it->second->processMarketTick(tick);
-        }
-    };
+    // Feeds only parse and enqueue; shard workers own disjoint symbol sets
+    enum Producer : size_t { BINANCE, COINBASE, POLYGON, NUM_PRODUCERS };
 
-    binanceFeed->setTickCallback(callback);
-    coinbaseFeed->setTickCallback(callback);
-    if (polygonFeed) {
-        polygonFeed->setTickCallback(callback);
+    TickPipelineConfig pipelineConfig;
+    if (const char* shards = std::getenv("ALPHA_SHARDS")) {
+        pipelineConfig.numShards = std::max(1, std::atoi(shards));
     }
 
+    TickPipeline pipeline(NUM_PRODUCERS, [&alphaSystems](const CompactTick& tick) {
+        alphaSystems.dispatch(tick);
+    }, pipelineConfig);
+    pipeline.setQuoteHandler([&alphaSystems](const QuoteEvent& quote) {
+        alphaSystems.dispatchQuote(quote);
+    });
+    pipeline.start();
+
+    binanceFeed->setTickCallback([&pipeline](const CompactTick& tick) {
+        pipeline.push(BINANCE, tick);
+    });
+    binanceFeed->setQuoteCallback([&pipeline](const QuoteEvent& quote) {
+        pipeline.pushQuote(BINANCE, quote);
+    });
+    coinbaseFeed->setTickCallback([&pipeline](const CompactTick& tick) {
+        pipeline.push(COINBASE, tick);
+    });
+    coinbaseFeed->setQuoteCallback([&pipeline](const QuoteEvent& quote) {
+        pipeline.pushQuote(COINBASE, quote);
+    });
+    auto pushPolygon = [&pipeline](const CompactTick& tick) {
+        pipeline.push(POLYGON, tick);
+    };
+    if (polygonStream) {
+        polygonStream->setTickCallback(pushPolygon);
+        polygonStream->setQuoteCallback([&pipeline](const QuoteEvent& quote) {
+            pipeline.pushQuote(POLYGON, quote);
+        });
+    }
+    if (polygonFeed) polygonFeed->setTickCallback(pushPolygon);
+
     // Threads
     std::thread binanceThread([binanceFeed]() { binanceFeed->start(); });
     std::thread coinbaseThread([coinbaseFeed]() { coinbaseFeed->start(); });
-    std::thread polygonThread;
-
-    if (polygonFeed) {
-        PolygonFeed* rawPolygonFeed = polygonFeed.get();
-        polygonThread = std::thread([rawPolygonFeed]() { rawPolygonFeed->start(); });
-    }
 
     binanceThread.detach();
     coinbaseThread.detach();
-    if (polygonThread.joinable()) {
-        polygonThread.detach();
-    }
+    if (polygonStream) polygonStream->start();
+    if (polygonFeed) polygonFeed->start();
 
     std::cout << " ALL EXCHANGES RUNNING!\n" << std::endl;
     std::cout << " Binance: "  << binanceSymbols.size()   << " symbols" << std::endl;
     std::cout << " Coinbase: " << coinbaseProducts.size() << " symbols" << std::endl;
-    if (polygonFeed) {
-        std::cout << " Polygon: " << polygonSymbols.size() << " symbols" << std::endl;
+    if (polygonKey) {
+        std::cout << " Polygon: "  << polygonSymbols.size() << " symbols"
+                  << (polygonStream ? " (stream)" : " (REST)") << std::endl;
     }
+    std::cout << " Shards: "   << pipeline.numShards() << " worker(s)" << std::endl;
     std::cout << "\nPress Ctrl+C to stop.\n" << std::endl;
 
+    int seconds = 0;
     while (true) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
+        binanceAgg->onTimer();
+        coinbaseAgg->onTimer();
+        polygonAgg->onTimer();
+
+        if (++seconds % 60 != 0) continue;
+
+        for (const auto& st : pipeline.getStats()) {
+            std::cout << "[Pipeline] shard " << st.shard
+                      << " | depth " << st.queueDepth
+                      << " | processed " << st.ticksProcessed
+                      << " | dropped " << st.ticksDropped
+                      << " | lag avg/max " << std::fixed << std::setprecision(1)
+                      << st.avgLagUs << "/" << st.maxLagUs << " us" << std::endl;
+        }
     }
 }
 
-void runBacktestDemo() {
-    std::cout << " Running Backtest with Bollinger Bands + Performance Metrics...\n" << std::endl;
+// Random-walk AAPL ticks, one per second; drift is the mean return per tick
+TickColumns makeSyntheticTicks(size_t count, double drift) {
+    TickColumns ticks;
+    ticks.reserve(count);
 
-    std::vector<MarketTick> historicalData;
+    SymbolId aapl = SymbolRegistry::instance().intern("AAPL");
     double price = 280.0;
 
-    std::cout << " Generating 1000 synthetic ticks..." << std::endl;
-
-    for (int i = 0; i < 1000; ++i) {
-        double change = ((rand() % 200) - 95) / 10000.0;
+    for (size_t i = 0; i < count; ++i) {
+        double change = ((rand() % 200) - 99.5) / 10000.0 + drift;
         price *= (1.0 + change);
 
-        historicalData.push_back(MarketTick{
-            "AAPL",
+        ticks.push(CompactTick{
+            aapl,
             price,
             1000.0 + (rand() % 500),
-            static_cast<long>(i * 1000)
+            static_cast<int64_t>(i) * 1000 * 1000000
         });
     }
 
+    return ticks;
+}
+
+void runBacktestDemo(const std::string& tapePath) {
+    std::cout << " Running Backtest with Bollinger Bands + Performance Metrics...\n" << std::endl;
+
+    std::unique_ptr<TapeReader> tape;
+    TickColumns historicalData;
+
+    if (!tapePath.empty()) {
+        tape = std::make_unique<TapeReader>(tapePath);
+        std::cout << " Replaying " << tape->size() << " ticks from " << tapePath
+                  << " (" << tape->numChunks() << " chunks)..." << std::endl;
+    } else {
+        std::cout << " Generating 1000 synthetic ticks..." << std::endl;
+        historicalData = makeSyntheticTicks(1000, 0.00045);
+    }
+
     BacktestConfig config;
     config.initialCapital = 100000.0;
     config.commissionRate = 0.001;
@@ -513,21 +832,20 @@ void runBacktestDemo() {
 
     Backtester backtester(config);
 
-    auto signalGen = [](const MarketTick& tick) -> int {
-        static std::deque<double> prices;
+    auto signalGen = [](const CompactTick& tick) -> int {
+        static RollingStats prices(20);
         static int tickCount = 0;
         tickCount++;
 
-        prices.push_back(tick.price);
-        if (prices.size() > 20) prices.pop_front();
+        prices.push(tick.price);
 
-        if (prices.size() < 20) {
+        if (!prices.full()) {
             return 0;  // HOLD
         }
 
-        std::vector<double> priceVec(prices.begin(), prices.end());
-        double mean, upper, lower;
-        computeBollinger(priceVec, 20, 2.0, mean, upper, lower);
+        double mean = prices.mean();
+        double upper = mean + 2.0 * prices.stddev();
+        double lower = mean - 2.0 * prices.stddev();
 
         double momentum = (prices.back() / prices.front()) - 1.0;
         double percentB = (upper != lower) ? (tick.price - lower) / (upper - lower) : 0.5;
@@ -542,7 +860,8 @@ void runBacktestDemo() {
     };
 
     std::cout << " Running backtest with Bollinger Bands strategy..." << std::endl;
-    auto result = backtester.run(historicalData, signalGen);
+    auto result = tape ? backtester.run(*tape, signalGen)
+                       : backtester.run(historicalData.view(), signalGen);
 
     std::cout << "\n Backtest complete!\n" << std::endl;
 
@@ -560,36 +879,430 @@ void runBacktestDemo() {
               << result.profitFactor << "\n" << std::endl;
 }
 
+void runParameterSweep(const std::string& tapePath) {
+    std::cout << " Running parameter sweeps...\n" << std::endl;
+
+    TickColumns historicalData;
+    if (!tapePath.empty()) {
+        // A sweep reads feature columns by index, so it needs one contiguous series
+        TapeReader tape(tapePath);
+        historicalData = tape.load();
+        std::cout << " Loaded " << historicalData.size() << " ticks from " << tapePath << std::endl;
+    } else {
+        // Driftless, so a long series stays in a realistic price range
+        std::cout << " Generating 100000 synthetic ticks..." << std::endl;
+        historicalData = makeSyntheticTicks(100000, 0.0);
+    }
+
+    ParameterGrid grid;
+    grid.addAxis("period", {10, 20, 50, 100})
+        .addAxis("multiplier", {1.5, 2.0, 2.5, 3.0})
+        .addAxis("momentum", {0.0, 0.005})
+        .addAxis("hurstWindow", {0, 100});
+
+    BacktestConfig config;
+    config.initialCapital = 100000.0;
+    Backtester backtester(config);
+
+    ParameterSweep sweep(backtester);
+
+    // AlphaEngine window and RegimeDetector lags under the live decision rule
+    ParameterGrid alphaGrid;
+    alphaGrid.addAxis("window", {10, 20, 50, 100})
+        .addAxis("hurstWindow", {0, 100, 200})
+        .addAxis("hurstLag", {10, 20})
+        .addAxis("threshold", {0.005, 0.01, 0.02});
+
+    auto runSweep = [&](const char* name, const ParameterGrid& g, const SweepStrategy& strategy) {
+        auto start = std::chrono::steady_clock::now();
+        auto results = sweep.run(historicalData.view(), g, strategy);
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::cout << " " << name << ": evaluated " << results.size() << " variants in " << elapsedMs << " ms\n" << std::endl;
+        printSweepTable(results, 10, std::cout);
+        std::cout << std::endl;
+    };
+
+    runSweep("Bollinger", grid, BollingerSweepStrategy());
+    runSweep("Alpha / regime", alphaGrid, AlphaSweepStrategy());
+}
+
+// One driftless random-walk stream per symbol, with exponential gaps between
+// ticks (meanGapMs) so the streams interleave irregularly
+std::vector<TickColumns> makeSyntheticBasket(const std::vector<std::string>& symbols,
+                                             size_t ticksPerSymbol, double meanGapMs) {
+    std::vector<TickColumns> streams(symbols.size());
+    std::mt19937_64 rng(7);
+    std::exponential_distribution<double> gap(1.0 / meanGapMs);
+    std::normal_distribution<double> move(0.0, 0.0005);
+    std::uniform_real_distribution<double> size(1.0, 500.0);
+
+    for (size_t s = 0; s < symbols.size(); ++s) {
+        SymbolId id = SymbolRegistry::instance().intern(symbols[s]);
+        double price = 50.0 + 25.0 * s;
+        double timeMs = 0.0;
+
+        streams[s].reserve(ticksPerSymbol);
+        for (size_t i = 0; i < ticksPerSymbol; ++i) {
+            timeMs += gap(rng);
+            price *= 1.0 + move(rng);
+            streams[s].push(CompactTick{id, price, size(rng), static_cast<int64_t>(timeMs * 1e6)});
+        }
+    }
+
+    return streams;
+}
+
+void runPortfolioBacktest(const std::string& tapePath) {
+    std::cout << " Running multi-symbol portfolio backtest...\n" << std::endl;
+
+    std::unique_ptr<TapeReader> tape;
+    std::vector<TickColumns> basket;
+    std::vector<TickView> streams;
+
+    if (!tapePath.empty()) {
+        tape = std::make_unique<TapeReader>(tapePath);
+        std::cout << " Replaying " << tape->size() << " ticks from " << tapePath << std::endl;
+    } else {
+        std::vector<std::string> symbols = {
+            "BTCUSDT", "ETHUSDT", "BNBUSDT", "SOLUSDT", "XRPUSDT", "ADAUSDT",
+            "ETH-USD", "SOL-USD", "BTC-USD", "AVAX-USD", "LINK-USD", "DOGE-USD",
+            "AAPL", "MSFT", "GOOGL", "AMZN", "NVDA", "META",
+            "TSLA", "JPM", "V", "XOM", "UNH", "SPY"
+        };
+        std::cout << " Generating " << symbols.size() << " x 50000 synthetic ticks..." << std::endl;
+        basket = makeSyntheticBasket(symbols, 50000, 400.0);
+        for (const auto& columns : basket) streams.push_back(columns.view());
+    }
+
+    PortfolioBacktestConfig config;
+    config.execution.initialCapital = 1000000.0;
+    config.execution.latencyMs = 10.0;
+
+    PortfolioBacktester backtester(config);
+
+    // The live per-symbol pipeline, with console output and Influx off
+    auto makeStrategy = [](SymbolId id) -> TickSignalGenerator {
+        auto system = std::make_shared<ProductionAlphaSystem>(id, nullptr, false);
+        return [system](const CompactTick& tick) {
+            system->processTick(tick);
+            return system->direction();
+        };
+    };
+
+    auto result = tape ? backtester.run(*tape, makeStrategy)
+                       : backtester.run(streams, makeStrategy);
+
+    std::cout << "\n Backtest complete!\n" << std::endl;
+    printPortfolioSummary(result, std::cout);
+    std::cout << std::endl;
+}
+
+void runRecorder(const std::string& tapePath, int durationSeconds) {
+    std::cout << " Recording live ticks to " << tapePath << "...\n" << std::endl;
+
+    std::vector<std::string> binanceSymbols = {"BTCUSDT", "BNBUSDT"};
+    std::vector<std::string> coinbaseProducts = {"ETH-USD", "SOL-USD"};
+    std::vector<std::string> polygonSymbols = {"AAPL", "MSFT", "GOOGL"};
+
+    // Feeds still drive their engines; nothing is written to Influx
+    auto binanceEngine  = std::make_shared<AlphaEngine>(20, "1m");
+    auto binanceAgg     = std::make_shared<CandleAggregator>(60);
+    auto coinbaseEngine = std::make_shared<AlphaEngine>(20, "1m");
+    auto coinbaseAgg    = std::make_shared<CandleAggregator>(60);
+    auto polygonEngine  = std::make_shared<AlphaEngine>(20, "1m");
+    auto polygonAgg     = std::make_shared<CandleAggregator>(60);
+
+    auto binanceFeed  = std::make_shared<BinancePublicFeed>(binanceSymbols, *binanceEngine, *binanceAgg);
+    auto coinbaseFeed = std::make_shared<CoinbaseAdvancedFeed>(coinbaseProducts, *coinbaseEngine, *coinbaseAgg);
+
+    const char* polygonKey = std::getenv("POLYGON_API_KEY");
+    std::unique_ptr<PolygonStreamFeed> polygonStream;
+    std::unique_ptr<PolygonFeed> polygonFeed;
+    if (polygonKey) {
+        polygonStream = makePolygonStreamFromEnv(polygonSymbols, polygonKey, *polygonEngine, *polygonAgg);
+        if (!polygonStream) {
+            polygonFeed = std::make_unique<PolygonFeed>(
+                polygonSymbols, std::string(polygonKey), *polygonEngine, *polygonAgg,
+                polygonConfigFromEnv()
+            );
+        }
+    }
+
+    // Every feed is stopped (its threads joined) before this function returns
+    // and the engines, aggregators and recorder it references go away
+    auto recorder = std::make_shared<TapeRecorder>(tapePath);
+    recorder->start();
+
+    auto record = [recorder](const CompactTick& tick) { recorder->record(tick); };
+    binanceFeed->setTickCallback(record);
+    coinbaseFeed->setTickCallback(record);
+    if (polygonStream) polygonStream->setTickCallback(record);
+    if (polygonFeed) polygonFeed->setTickCallback(record);
+
+    binanceFeed->start();
+    coinbaseFeed->start();
+    if (polygonStream) polygonStream->start();
+    if (polygonFeed) polygonFeed->start();
+
+    std::cout << " Recording" << (durationSeconds > 0 ? " for " + std::to_string(durationSeconds) + "s" : "")
+              << ". Press Ctrl+C to stop.\n" << std::endl;
+
+    for (int seconds = 1; durationSeconds <= 0 || seconds <= durationSeconds; ++seconds) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        if (seconds % 10 == 0) {
+            std::cout << "[Recorder] " << recorder->ticksRecorded() << " ticks recorded, "
+                      << recorder->ticksWritten() << " written" << std::endl;
+        }
+    }
+
+    binanceFeed->stop();
+    coinbaseFeed->stop();
+    if (polygonStream) polygonStream->stop();
+    if (polygonFeed) polygonFeed->stop();
+    recorder->stop();
+    std::cout << " Wrote " << recorder->ticksWritten() << " ticks to " << tapePath << std::endl;
+}
+
+void runCapture(const std::string& capturePath, int durationSeconds) {
+    std::cout << " Capturing raw feed messages to " << capturePath << "...\n" << std::endl;
+
+    std::vector<std::string> binanceSymbols = {"BTCUSDT", "BNBUSDT"};
+    std::vector<std::string> coinbaseProducts = {"ETH-USD", "SOL-USD"};
+
+    auto binanceEngine  = std::make_shared<AlphaEngine>(20, "1m");
+    auto binanceAgg     = std::make_shared<CandleAggregator>(60);
+    auto coinbaseEngine = std::make_shared<AlphaEngine>(20, "1m");
+    auto coinbaseAgg    = std::make_shared<CandleAggregator>(60);
+
+    auto binanceFeed  = std::make_shared<BinancePublicFeed>(binanceSymbols, *binanceEngine, *binanceAgg);
+    auto coinbaseFeed = std::make_shared<CoinbaseAdvancedFeed>(coinbaseProducts, *coinbaseEngine, *coinbaseAgg);
+    binanceFeed->setVerbose(false);
+    coinbaseFeed->setVerbose(false);
+
+    // Polygon is captured from its WebSocket; REST bars are not socket messages
+    std::vector<std::string> polygonSymbols = {"AAPL", "MSFT", "GOOGL"};
+    auto polygonEngine = std::make_shared<AlphaEngine>(20, "1m");
+    auto polygonAgg    = std::make_shared<CandleAggregator>(60);
+    std::unique_ptr<PolygonStreamFeed> polygonStream;
+    if (const char* polygonKey = std::getenv("POLYGON_API_KEY")) {
+        const char* url = std::getenv("POLYGON_WS_URL");
+        polygonStream = std::make_unique<PolygonStreamFeed>(polygonSymbols, polygonKey, *polygonEngine, *polygonAgg,
+                                                            url ? url : "wss://socket.polygon.io/stocks");
+        polygonStream->setVerbose(false);
+    }
+
+    // Every feed is stopped (its threads joined) before this function returns
+    // and the engines, aggregators and capture file it references go away
+    auto capture = std::make_shared<CaptureWriter>(capturePath);
+    binanceFeed->setRawMessageHook([capture](const std::string& message) {
+        capture->write(FeedSource::BINANCE, message);
+    });
+    coinbaseFeed->setRawMessageHook([capture](const std::string& message) {
+        capture->write(FeedSource::COINBASE, message);
+    });
+    if (polygonStream) {
+        polygonStream->setRawMessageHook([capture](const std::string& message) {
+            capture->write(FeedSource::POLYGON, message);
+        });
+    }
+
+    binanceFeed->start();
+    coinbaseFeed->start();
+    if (polygonStream) polygonStream->start();
+
+    std::cout << " Capturing" << (durationSeconds > 0 ? " for " + std::to_string(durationSeconds) + "s" : "")
+              << ". Press Ctrl+C to stop.\n" << std::endl;
+
+    for (int seconds = 1; durationSeconds <= 0 || seconds <= durationSeconds; ++seconds) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        if (seconds % 10 == 0) {
+            capture->flush();
+            std::cout << "[Capture] " << capture->messagesWritten() << " messages" << std::endl;
+        }
+    }
+
+    binanceFeed->stop();
+    coinbaseFeed->stop();
+    if (polygonStream) polygonStream->stop();
+    capture->close();
+    std::cout << " Wrote " << capture->messagesWritten() << " messages to " << capturePath << std::endl;
+}
+
+void printLatencyRow(const char* stage, const LatencyHistogram& h) {
+    auto us = [](double ns) { return ns / 1000.0; };
+    std::cout << " " << std::left << std::setw(10) << stage << std::right
+              << std::setw(10) << h.count()
+              << std::fixed << std::setprecision(2)
+              << std::setw(10) << us(h.mean())
+              << std::setw(10) << us(h.percentile(0.50))
+              << std::setw(10) << us(h.percentile(0.90))
+              << std::setw(10) << us(h.percentile(0.99))
+              << std::setw(10) << us(h.percentile(0.999))
+              << std::setw(10) << us(h.max()) << std::endl;
+}
+
+// Replays a capture through the live parsing paths and per-symbol alpha
+// systems, with no sockets and no console output from the hot path. speed 0
+// runs flat out; otherwise arrival gaps are reproduced, divided by speed.
+void runReplay(const std::string& capturePath, double speed) {
+    std::cout << " Replaying " << capturePath
+              << (speed > 0 ? " at " + std::to_string(speed) + "x" : " as fast as possible") << "...\n" << std::endl;
+
+    CaptureReader capture(capturePath);
+    std::cout << " " << capture.size() << " messages (" << capture.payloadBytes() << " bytes)" << std::endl;
+    if (capture.size() == 0) return;
+
+    // Same feed wiring as the live modes, minus the sockets
+    std::vector<std::string> binanceSymbols = {"BTCUSDT", "BNBUSDT"};
+    std::vector<std::string> coinbaseProducts = {"ETH-USD", "SOL-USD"};
+
+    AlphaEngine binanceEngine(20, "1m");
+    CandleAggregator binanceAgg(60);
+    AlphaEngine coinbaseEngine(20, "1m");
+    CandleAggregator coinbaseAgg(60);
+
+    std::vector<std::string> polygonSymbols = {"AAPL", "MSFT", "GOOGL"};
+    AlphaEngine polygonEngine(20, "1m");
+    CandleAggregator polygonAgg(60);
+
+    BinancePublicFeed binanceFeed(binanceSymbols, binanceEngine, binanceAgg);
+    CoinbaseAdvancedFeed coinbaseFeed(coinbaseProducts, coinbaseEngine, coinbaseAgg);
+    PolygonStreamFeed polygonFeed(polygonSymbols, "", polygonEngine, polygonAgg);
+    binanceFeed.setVerbose(false);
+    coinbaseFeed.setVerbose(false);
+    polygonFeed.setVerbose(false);
+
+    AlphaSystemTable alphaSystems(nullptr, false);
+    alphaSystems.add(binanceSymbols);
+    alphaSystems.add(coinbaseProducts);
+    alphaSystems.add(polygonSymbols);
+
+    LatencyHistogram messageLatency;    // whole message, socket callback to return
+    LatencyHistogram feedLatency;       // parse, candles, AlphaEngine
+    LatencyHistogram alphaLatency;      // ProductionAlphaSystem per tick
+
+    uint64_t ticks = 0;
+    uint64_t alphaNs = 0;               // alpha time inside the current message
+    auto onTick = [&](const CompactTick& tick) {
+        auto t0 = std::chrono::steady_clock::now();
+        alphaSystems.add(tick.symbolId);
+        alphaSystems.dispatch(tick);
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        alphaLatency.record(ns);
+        alphaNs += ns;
+        ++ticks;
+    };
+    binanceFeed.setTickCallback(onTick);
+    coinbaseFeed.setTickCallback(onTick);
+    polygonFeed.setTickCallback(onTick);
+
+    uint64_t quotes = 0;
+    auto onQuote = [&](const QuoteEvent& quote) {
+        auto t0 = std::chrono::steady_clock::now();
+        alphaSystems.add(quote.symbolId);
+        alphaSystems.dispatchQuote(quote);
+        alphaNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        ++quotes;
+    };
+    binanceFeed.setQuoteCallback(onQuote);
+    coinbaseFeed.setQuoteCallback(onQuote);
+    polygonFeed.setQuoteCallback(onQuote);
+
+    uint64_t skipped = 0;
+    std::string message;
+    const int64_t firstArrivalNs = capture[0].arrivalNs;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < capture.size(); ++i) {
+        const CapturedMessage& captured = capture[i];
+
+        if (speed > 0) {
+            auto offset = std::chrono::nanoseconds(
+                static_cast<int64_t>((captured.arrivalNs - firstArrivalNs) / speed));
+            std::this_thread::sleep_until(start + offset);
+        }
+
+        message.assign(captured.payload.data(), captured.payload.size());
+        alphaNs = 0;
+
+        auto t0 = std::chrono::steady_clock::now();
+        switch (captured.source) {
+            case FeedSource::BINANCE:  binanceFeed.replayMessage(message); break;
+            case FeedSource::COINBASE: coinbaseFeed.replayMessage(message); break;
+            case FeedSource::POLYGON:  polygonFeed.replayMessage(message); break;
+            default: ++skipped; continue;
+        }
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        messageLatency.record(ns);
+        feedLatency.record(ns > alphaNs ? ns - alphaNs : 0);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto binanceStats = binanceFeed.getParseStats();
+    auto coinbaseStats = coinbaseFeed.getParseStats();
+    auto polygonStats = polygonFeed.getParseStats();
+
+    std::cout << "\n Replay complete!\n" << std::endl;
+    std::cout << "   • Messages: " << messageLatency.count() << " replayed, " << skipped << " skipped" << std::endl;
+    std::cout << "   • Ticks: " << ticks << " trades, " << quotes << " quotes across "
+              << alphaSystems.size() << " symbols" << std::endl;
+    std::cout << "   • Wall time: " << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+    std::cout << "   • Throughput: " << std::setprecision(0) << messageLatency.count() / seconds << " msgs/s, "
+              << ticks / seconds << " ticks/s" << std::endl;
+    std::cout << "   • Parse: Binance " << binanceStats.fastPath << " fast / " << binanceStats.fallback
+              << " fallback / " << binanceStats.errors << " errors, Coinbase " << coinbaseStats.fastPath
+              << " fast / " << coinbaseStats.fallback << " fallback / " << coinbaseStats.errors
+              << " errors, Polygon " << polygonStats.fastPath << " fast / " << polygonStats.fallback
+              << " fallback / " << polygonStats.errors << " errors\n" << std::endl;
+
+    std::cout << " " << std::left << std::setw(10) << "Stage (us)" << std::right
+              << std::setw(10) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50"
+              << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+              << std::setw(10) << "max" << std::endl;
+    printLatencyRow("message", messageLatency);
+    printLatencyRow("feed", feedLatency);
+    printLatencyRow("alpha", alphaLatency);
+    std::cout << std::endl;
+}
+
 void runBinanceLive() {
     std::cout << " Starting BINANCE CRYPTO FEED (24/7 Live!)...\n" << std::endl;
 
-    // Create one alpha system per symbol
-    std::map<std::string, std::shared_ptr<ProductionAlphaSystem>> alphaSystems;
-
     std::vector<std::string> symbols = {
         "BTCUSDT",   // Bitcoin
         "ETHUSDT",   // Ethereum
         "BNBUSDT"    // Binance Coin
     };
 
-    for (const auto& symbol : symbols) {
-        alphaSystems[symbol] = std::make_shared<ProductionAlphaSystem>();
-    }
+    auto influx = makeInfluxWriterFromEnv();
+    std::unique_ptr<InfluxSignalSink> influxSink;
+    if (influx) influxSink = std::make_unique<InfluxSignalSink>(*influx);
 
-    auto engine     = std::make_shared<AlphaEngine>(20, "1m");
-    auto aggregator = std::make_shared<CandleAggregator>(60);
+    // One alpha system per symbol
+    AlphaSystemTable alphaSystems(influx);
+    auto latencyExporter = makeLatencyExporter(influx);
+    alphaSystems.add(symbols);
 
-    aggregator->setOnCandleClosed([engine](const Candle& c) {
-        engine->onCandle(c);
-    });
+    auto engine     = std::make_shared<AlphaEngine>(20, "1m", influxSink.get());
+    auto aggregator = makeLiveAggregator(engine);
+    auto snapshots  = makeSnapshotService(alphaSystems, {{"binance", aggregator}});
 
     BinancePublicFeed binanceFeed(symbols, *engine, *aggregator);
 
-    binanceFeed.setTickCallback([&alphaSystems](const MarketTick& tick) {
-        auto it = alphaSystems.find(tick.symbol);
-        if (it != alphaSystems.end()) {
-            it->second->processMarketTick(tick);
-        }
+    binanceFeed.setTickCallback([&alphaSystems](const CompactTick& tick) {
+        alphaSystems.dispatch(tick);
+    });
+    binanceFeed.setQuoteCallback([&alphaSystems](const QuoteEvent& quote) {
+        alphaSystems.dispatchQuote(quote);
     });
 
     binanceFeed.start();
@@ -598,12 +1311,15 @@ void runBinanceLive() {
 
     while (true) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
+        aggregator->onTimer();
     }
 }
 
 
 int main(int argc, char* argv[]) {
     curl_global_init(CURL_GLOBAL_ALL);
+    // The stage timers' clock scale, measured here rather than on the first tick
+    latency_clock::calibrate();
 
     std::string mode = "live";
 
@@ -631,11 +1347,29 @@ int main(int argc, char* argv[]) {
         } else if (mode == "binance") {
             runBinanceLive();
         } else if (mode == "backtest") {
-            runBacktestDemo();
+            runBacktestDemo(argc > 2 ? argv[2] : "");
+        } else if (mode == "portfolio") {
+            runPortfolioBacktest(argc > 2 ? argv[2] : "");
+        } else if (mode == "sweep") {
+            runParameterSweep(argc > 2 ? argv[2] : "");
+        } else if (mode == "capture") {
+            if (argc < 3) throw std::runtime_error("capture mode needs a file path");
+            runCapture(argv[2], argc > 3 ? std::atoi(argv[3]) : 0);
+        } else if (mode == "replay") {
+            if (argc < 3) throw std::runtime_error("replay mode needs a capture file");
+            runReplay(argv[2], argc > 3 ? std::atof(argv[3]) : 0.0);
+        } else if (mode == "record") {
+            if (argc < 3) throw std::runtime_error("record mode needs a tape path");
+            runRecorder(argv[2], argc > 3 ? std::atoi(argv[3]) : 0);
         } else {
             std::cout << "   Usage:" << std::endl;
-            std::cout << "  ./alpha_engine live      - Run live trading (all features)" << std::endl;
-            std::cout << "  ./alpha_engine backtest  - Run backtest with Bollinger Bands" << std::endl;
+            std::cout << "  ./alpha_engine live                 - Run live trading (all features)" << std::endl;
+            std::cout << "  ./alpha_engine backtest [tape]      - Run backtest with Bollinger Bands" << std::endl;
+            std::cout << "  ./alpha_engine portfolio [tape]     - Backtest the alpha pipeline on a basket" << std::endl;
+            std::cout << "  ./alpha_engine sweep [tape]         - Grid-search strategy parameters" << std::endl;
+            std::cout << "  ./alpha_engine record <tape> [secs] - Record live ticks to a tape" << std::endl;
+            std::cout << "  ./alpha_engine capture <file> [secs] - Capture raw feed messages" << std::endl;
+            std::cout << "  ./alpha_engine replay <file> [speed] - Replay a capture (0 = max speed)" << std::endl;
             throw std::runtime_error("Unknown mode: " + mode);
         }
     }
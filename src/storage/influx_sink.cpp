@@ -0,0 +1,23 @@
+#include "storage/influx_sink.h"
+#include "storage/influx_writer.h"
+#include <string>
+
+InfluxSignalSink::InfluxSignalSink(InfluxWriter& writer)
+    : writer_(writer) {}
+
+void InfluxSignalSink::onAlphaSignal(const AlphaSignal& signal) {
+    // "BUY_1m": rebuilt in a per-thread buffer that keeps its capacity
+    thread_local std::string label;
+    label.assign(signalTypeName(signal.type));
+    label += '_';
+    label += signal.timeframe;
+
+    writer_.writeAlphaSignal(
+        SymbolRegistry::instance().name(signal.symbolId),
+        signal.momentum,
+        signal.meanRevZ,
+        signal.rsi,
+        signal.vbr,
+        label
+    );
+}
@@ -1,12 +1,79 @@
 #include "storage/influx_writer.h"
-#include <sstream>
+#include "storage/line_protocol.h"
+#include "util/latency_metrics.h"
+#include <curl/curl.h>
+#include <zlib.h>
 #include <iostream>
+#include <algorithm>
+
+struct InfluxWriter::Transport {
+    CURL* curl = nullptr;
+    curl_slist* headers = nullptr;
+    curl_slist* gzipHeaders = nullptr;
+    z_stream zs{};
+    bool zsReady = false;
+    std::string compressed;
+
+    ~Transport() {
+        if (zsReady) deflateEnd(&zs);
+        if (gzipHeaders) curl_slist_free_all(gzipHeaders);
+        if (headers) curl_slist_free_all(headers);
+        if (curl) curl_easy_cleanup(curl);
+    }
+};
+
+// InfluxDB answers 204 with an empty body on success; errors come back as small
+// JSON documents we only need for the log line
+static size_t DiscardCallback(char* ptr, size_t size, size_t nmemb, void* userp) {
+    auto* s = static_cast<std::string*>(userp);
+    if (s->size() < 256) {
+        s->append(ptr, std::min(size * nmemb, 256 - s->size()));
+    }
+    return size * nmemb;
+}
+
+// gzip (not raw deflate) framing, reusing the same z_stream for every batch
+static bool gzipCompress(z_stream& zs, const std::string& in, std::string& out) {
+    if (deflateReset(&zs) != Z_OK) return false;
+
+    out.resize(deflateBound(&zs, in.size()) + 32);
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+
+    if (deflate(&zs, Z_FINISH) != Z_STREAM_END) return false;
+
+    out.resize(out.size() - zs.avail_out);
+    return true;
+}
 
 InfluxWriter::InfluxWriter(const std::string& org,
                            const std::string& bucket,
                            const std::string& token,
-                           const std::string& url)
-    : org_(org), bucket_(bucket), token_(token), url_(url), running_(true) {
+                           const std::string& url,
+                           const InfluxWriterConfig& config)
+    : org_(org), bucket_(bucket), token_(token), url_(url), config_(config),
+      queue_(config.queueCapacity),
+      running_(true),
+      flushRequested_(false),
+      enqueued_(0),
+      retired_(0),
+      droppedOldest_(0),
+      droppedNewest_(0),
+      blockedWrites_(0),
+      pointsWritten_(0),
+      pointsFailed_(0),
+      batchesSent_(0),
+      batchesFailed_(0),
+      bytesSent_(0),
+      bytesUncompressed_(0),
+      lastBatchLatencyUs_(0),
+      totalBatchLatencyUs_(0),
+      maxBatchLatencyUs_(0) {
+
+    size_t reserve = config_.lineReserve;
+    queue_.initSlots([reserve](std::string& slot) { slot.reserve(reserve); });
 
     // Start async writer thread
     writerThread_ = std::thread(&InfluxWriter::writerLoop, this);
@@ -19,21 +86,31 @@ InfluxWriter::~InfluxWriter() {
     }
 }
 
+// Each producer thread encodes into its own builder; the queue copies the finished
+// line into a preallocated slot, so the write* calls do not allocate once warm
+static LineProtocolBuilder& threadBuilder() {
+    thread_local LineProtocolBuilder builder;
+    return builder;
+}
+
 void InfluxWriter::writeAlphaSignal(const std::string& symbol,
                                     double momentum,
                                     double meanRevZ,
                                     double rsi,
                                     double vbr,
-                                    const std::string& signalType) const {
-    std::ostringstream data;
-    data << "alpha_signal,symbol=" << symbol
-         << " momentum=" << momentum
-         << ",meanRevZ=" << meanRevZ
-         << ",rsi=" << rsi
-         << ",vbr=" << vbr
-         << ",signal_type=\"" << signalType << "\"";
+                                    std::string_view signalType) const {
+    ScopedLatency timer(LatencyStage::INFLUX_ENCODE);
+    thread_local SeriesKeyCache seriesKey("alpha_signal");
 
-    const_cast<InfluxWriter*>(this)->writeAsync(data.str());
+    auto& point = threadBuilder();
+    point.series(seriesKey(symbol))
+         .field("momentum", momentum)
+         .field("meanRevZ", meanRevZ)
+         .field("rsi", rsi)
+         .field("vbr", vbr)
+         .stringField("signal_type", signalType);
+
+    if (point.complete()) const_cast<InfluxWriter*>(this)->writeAsync(point.line());
 }
 
 void InfluxWriter::writeMicrostructureSignal(const std::string& symbol,
@@ -42,15 +119,18 @@ void InfluxWriter::writeMicrostructureSignal(const std::string& symbol,
                                              double lambda,
                                              double spread,
                                              long timestamp) const {
-    std::ostringstream data;
-    data << "microstructure,symbol=" << symbol
-         << " vpin=" << vpin
-         << ",toxicity=" << toxicity
-         << ",lambda=" << lambda
-         << ",spread=" << spread
-         << " " << timestamp << "000000";
+    ScopedLatency timer(LatencyStage::INFLUX_ENCODE);
+    thread_local SeriesKeyCache seriesKey("microstructure");
+
+    auto& point = threadBuilder();
+    point.series(seriesKey(symbol))
+         .field("vpin", vpin)
+         .field("toxicity", toxicity)
+         .field("lambda", lambda)
+         .field("spread", spread)
+         .timestampMs(timestamp);
 
-    const_cast<InfluxWriter*>(this)->writeAsync(data.str());
+    if (point.complete()) const_cast<InfluxWriter*>(this)->writeAsync(point.line());
 }
 
 void InfluxWriter::writeOrderFlowSignal(const std::string& symbol,
@@ -59,45 +139,54 @@ void InfluxWriter::writeOrderFlowSignal(const std::string& symbol,
                                         double askPressure,
                                         double volumeDelta,
                                         long timestamp) const {
-    std::ostringstream data;
-    data << "orderflow,symbol=" << symbol
-         << " ofi=" << ofi
-         << ",bid_pressure=" << bidPressure
-         << ",ask_pressure=" << askPressure
-         << ",volume_delta=" << volumeDelta
-         << " " << timestamp << "000000";
+    ScopedLatency timer(LatencyStage::INFLUX_ENCODE);
+    thread_local SeriesKeyCache seriesKey("orderflow");
 
-    const_cast<InfluxWriter*>(this)->writeAsync(data.str());
+    auto& point = threadBuilder();
+    point.series(seriesKey(symbol))
+         .field("ofi", ofi)
+         .field("bid_pressure", bidPressure)
+         .field("ask_pressure", askPressure)
+         .field("volume_delta", volumeDelta)
+         .timestampMs(timestamp);
+
+    if (point.complete()) const_cast<InfluxWriter*>(this)->writeAsync(point.line());
 }
 
 void InfluxWriter::writeRegimeSignal(const std::string& symbol,
-                                     const std::string& regime,
+                                     std::string_view regime,
                                      double hurstExponent,
                                      double volatility,
                                      double trendStrength,
                                      long timestamp) const {
-    std::ostringstream data;
-    data << "regime,symbol=" << symbol << ",regime=" << regime
-         << " hurst=" << hurstExponent
-         << ",volatility=" << volatility
-         << ",trend_strength=" << trendStrength
-         << " " << timestamp << "000000";
+    ScopedLatency timer(LatencyStage::INFLUX_ENCODE);
+    thread_local SeriesKeyCache seriesKey("regime");
+
+    auto& point = threadBuilder();
+    point.series(seriesKey(symbol))
+         .tag("regime", regime)
+         .field("hurst", hurstExponent)
+         .field("volatility", volatility)
+         .field("trend_strength", trendStrength)
+         .timestampMs(timestamp);
 
-    const_cast<InfluxWriter*>(this)->writeAsync(data.str());
+    if (point.complete()) const_cast<InfluxWriter*>(this)->writeAsync(point.line());
 }
 
 void InfluxWriter::writeVWAP(const std::string& symbol,
                              double vwap,
                              double deviation,
                              long timestamp) const {
+    ScopedLatency timer(LatencyStage::INFLUX_ENCODE);
+    thread_local SeriesKeyCache seriesKey("vwap");
 
-    std::ostringstream data;
-    data << "vwap,symbol=" << symbol
-         << " vwap=" << vwap
-         << ",deviation=" << deviation
-         << " " << timestamp << "000000";
+    auto& point = threadBuilder();
+    point.series(seriesKey(symbol))
+         .field("vwap", vwap)
+         .field("deviation", deviation)
+         .timestampMs(timestamp);
 
-    const_cast<InfluxWriter*>(this)->writeAsync(data.str());
+    if (point.complete()) const_cast<InfluxWriter*>(this)->writeAsync(point.line());
 }
 
 void InfluxWriter::writeCandle(const std::string& symbol,
@@ -107,79 +196,253 @@ void InfluxWriter::writeCandle(const std::string& symbol,
                                double close,
                                double volume,
                                long timestamp) const {
+    ScopedLatency timer(LatencyStage::INFLUX_ENCODE);
+    thread_local SeriesKeyCache seriesKey("candles");
 
-    std::ostringstream data;
-    data << "candles,symbol=" << symbol
-         << " open=" << open
-         << ",high=" << high
-         << ",low=" << low
-         << ",close=" << close
-         << ",volume=" << volume
-         << " " << timestamp << "000000";
+    auto& point = threadBuilder();
+    point.series(seriesKey(symbol))
+         .field("open", open)
+         .field("high", high)
+         .field("low", low)
+         .field("close", close)
+         .field("volume", volume)
+         .timestampMs(timestamp);
 
-    const_cast<InfluxWriter*>(this)->writeAsync(data.str());
+    if (point.complete()) const_cast<InfluxWriter*>(this)->writeAsync(point.line());
 }
 
 void InfluxWriter::writePriceTick(const std::string& symbol,
                                   double price,
                                   double volume,
                                   long timestamp) const {
+    ScopedLatency timer(LatencyStage::INFLUX_ENCODE);
+    thread_local SeriesKeyCache seriesKey("ticks");
+
+    auto& point = threadBuilder();
+    point.series(seriesKey(symbol))
+         .field("price", price)
+         .field("volume", volume)
+         .timestampMs(timestamp);
+
+    if (point.complete()) const_cast<InfluxWriter*>(this)->writeAsync(point.line());
+}
+
+void InfluxWriter::writeAsync(std::string_view lineProtocol) {
+    auto fill = [lineProtocol](std::string& slot) {
+        slot.assign(lineProtocol.data(), lineProtocol.size());
+    };
+
+    if (queue_.tryPush(fill)) {
+        ++enqueued_;
+        return;
+    }
 
-    std::ostringstream data;
-    data << "ticks,symbol=" << symbol
-         << " price=" << price
-         << ",volume=" << volume
-         << " " << timestamp << "000000";
+    switch (config_.overflowPolicy) {
+        case OverflowPolicy::DROP_NEWEST:
+            ++droppedNewest_;
+            return;
 
-    const_cast<InfluxWriter*>(this)->writeAsync(data.str());
+        case OverflowPolicy::DROP_OLDEST:
+            while (!queue_.tryPush(fill)) {
+                if (queue_.tryPop([](std::string&) {})) {
+                    ++droppedOldest_;
+                    retire(1);
+                }
+            }
+            ++enqueued_;
+            return;
+
+        case OverflowPolicy::BLOCK:
+        default:
+            ++blockedWrites_;
+            for (int spins = 0; !queue_.tryPush(fill); ++spins) {
+                if (spins < 64) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+            ++enqueued_;
+            return;
+    }
 }
 
-void InfluxWriter::writeAsync(const std::string& lineProtocol) {
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    writeQueue_.push(lineProtocol);
+void InfluxWriter::retire(uint64_t numPoints) {
+    retired_ += numPoints;
+    flushCv_.notify_all();
 }
 
 void InfluxWriter::writerLoop() {
-    while (running_) {
-        std::string data;
-
-        {
-            std::lock_guard<std::mutex> lock(queueMutex_);
-            if (!writeQueue_.empty()) {
-                data = writeQueue_.front();
-                writeQueue_.pop();
+    Transport transport;
+    transport.curl = curl_easy_init();
+    if (!transport.curl) {
+        // Keep draining so BLOCK producers and flush() never hang; batches count as failed
+        std::cerr << "[InfluxDB] curl_easy_init failed, points will be discarded" << std::endl;
+    }
+
+    std::string writeUrl = url_ + "/api/v2/write?org=" + org_ +
+                           "&bucket=" + bucket_ + "&precision=ns";
+    std::string authHeader = "Authorization: Token " + token_;
+
+    transport.headers = curl_slist_append(transport.headers, authHeader.c_str());
+    transport.headers = curl_slist_append(transport.headers, "Content-Type: text/plain; charset=utf-8");
+    transport.gzipHeaders = curl_slist_append(transport.gzipHeaders, authHeader.c_str());
+    transport.gzipHeaders = curl_slist_append(transport.gzipHeaders, "Content-Type: text/plain; charset=utf-8");
+    transport.gzipHeaders = curl_slist_append(transport.gzipHeaders, "Content-Encoding: gzip");
+
+    // One handle for the writer's lifetime so the connection stays open between batches
+    if (transport.curl) {
+        curl_easy_setopt(transport.curl, CURLOPT_URL, writeUrl.c_str());
+        curl_easy_setopt(transport.curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(transport.curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(transport.curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(transport.curl, CURLOPT_TIMEOUT_MS, config_.requestTimeoutMs);
+        curl_easy_setopt(transport.curl, CURLOPT_WRITEFUNCTION, DiscardCallback);
+    }
+
+    if (config_.gzip) {
+        transport.zsReady = deflateInit2(&transport.zs, Z_BEST_SPEED, Z_DEFLATED,
+                                         15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+        if (!transport.zsReady) {
+            std::cerr << "[InfluxDB] deflateInit2 failed, sending uncompressed" << std::endl;
+        }
+    }
+
+    std::string batch;
+    batch.reserve(config_.maxBatchBytes + 4096);
+    size_t batchPoints = 0;
+    auto batchStart = std::chrono::steady_clock::now();
+
+    while (true) {
+        bool drained = false;
+        auto appendLine = [&batch](std::string& line) {
+            batch.append(line);
+            batch.push_back('\n');
+        };
+
+        while (batchPoints < config_.maxBatchPoints &&
+               batch.size() < config_.maxBatchBytes) {
+            if (batchPoints == 0) {
+                batchStart = std::chrono::steady_clock::now();
             }
+            if (!queue_.tryPop(appendLine)) break;
+            ++batchPoints;
+            drained = true;
         }
 
-        if (!data.empty()) {
-            writeToInflux(data);
-        } else {
+        bool queueEmpty = queue_.empty();
+        bool stopping = !running_;
+
+        if (batchPoints > 0) {
+            bool full = batchPoints >= config_.maxBatchPoints ||
+                        batch.size() >= config_.maxBatchBytes;
+            bool aged = std::chrono::steady_clock::now() - batchStart >= config_.maxBatchAge;
+
+            if (full || aged || stopping || flushRequested_) {
+                sendBatch(transport, batch, batchPoints);
+                retire(batchPoints);
+                batch.clear();
+                batchPoints = 0;
+                continue;
+            }
+        }
+
+        if (stopping && queueEmpty) break;
+        if (queueEmpty) flushRequested_ = false;
+
+        if (!drained) {
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
     }
 }
 
-void InfluxWriter::writeToInflux(const std::string& data) const {
-    std::ostringstream cmd;
-    cmd << "curl -s -XPOST '" << url_
-        << "/api/v2/write?org=" << org_
-        << "&bucket=" << bucket_
-        << "&precision=ns' "
-        << "--header 'Authorization: Token " << token_ << "' "
-        << "--data-binary '" << data << "' > /dev/null 2>&1";
+bool InfluxWriter::sendBatch(Transport& transport, const std::string& body, size_t numPoints) {
+    if (!transport.curl) {
+        ++batchesFailed_;
+        pointsFailed_ += numPoints;
+        return false;
+    }
 
-    int result = system(cmd.str().c_str());
+    ScopedLatency timer(LatencyStage::INFLUX_SEND);
+    auto start = std::chrono::steady_clock::now();
 
-    if (result != 0) {
-        std::cerr << "[InfluxDB] Write failed for: "
-                  << data.substr(0, 60) << "..." << std::endl;
+    const std::string* payload = &body;
+    bool gzipped = false;
+    if (transport.zsReady && gzipCompress(transport.zs, body, transport.compressed)) {
+        payload = &transport.compressed;
+        gzipped = true;
     }
+
+    std::string response;
+    curl_easy_setopt(transport.curl, CURLOPT_HTTPHEADER,
+                     gzipped ? transport.gzipHeaders : transport.headers);
+    curl_easy_setopt(transport.curl, CURLOPT_POSTFIELDS, payload->data());
+    curl_easy_setopt(transport.curl, CURLOPT_POSTFIELDSIZE_LARGE,
+                     static_cast<curl_off_t>(payload->size()));
+    curl_easy_setopt(transport.curl, CURLOPT_WRITEDATA, &response);
+
+    CURLcode res = curl_easy_perform(transport.curl);
+    long httpCode = 0;
+    curl_easy_getinfo(transport.curl, CURLINFO_RESPONSE_CODE, &httpCode);
+
+    auto latencyUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+
+    lastBatchLatencyUs_ = latencyUs;
+    totalBatchLatencyUs_ += latencyUs;
+    if (latencyUs > maxBatchLatencyUs_) maxBatchLatencyUs_ = latencyUs;
+    bytesUncompressed_ += body.size();
+
+    if (res != CURLE_OK || httpCode < 200 || httpCode >= 300) {
+        ++batchesFailed_;
+        pointsFailed_ += numPoints;
+        std::cerr << "[InfluxDB] Batch write failed (" << numPoints << " points, ";
+        if (res != CURLE_OK) {
+            std::cerr << curl_easy_strerror(res);
+        } else {
+            std::cerr << "HTTP " << httpCode << ": " << response;
+        }
+        std::cerr << ")" << std::endl;
+        return false;
+    }
+
+    ++batchesSent_;
+    pointsWritten_ += numPoints;
+    bytesSent_ += payload->size();
+    return true;
 }
 
 void InfluxWriter::flush() {
-    while (true) {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        if (writeQueue_.empty()) break;
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    uint64_t target = enqueued_.load();
+    flushRequested_ = true;
+
+    // Producers evicting under DROP_OLDEST retire lines without the writer's help,
+    // so re-check periodically rather than relying on a final notify
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    while (retired_.load() < target) {
+        flushCv_.wait_for(lock, std::chrono::milliseconds(50));
     }
 }
+
+InfluxWriterStats InfluxWriter::getStats() const {
+    InfluxWriterStats stats;
+    stats.pointsWritten = pointsWritten_;
+    stats.pointsFailed = pointsFailed_;
+    stats.batchesSent = batchesSent_;
+    stats.batchesFailed = batchesFailed_;
+    stats.bytesSent = bytesSent_;
+    stats.bytesUncompressed = bytesUncompressed_;
+    stats.lastBatchLatencyMs = lastBatchLatencyUs_ / 1000.0;
+
+    uint64_t batches = stats.batchesSent + stats.batchesFailed;
+    stats.avgBatchLatencyMs = batches > 0 ? (totalBatchLatencyUs_ / 1000.0) / batches : 0.0;
+    stats.maxBatchLatencyMs = maxBatchLatencyUs_ / 1000.0;
+
+    stats.droppedOldest = droppedOldest_;
+    stats.droppedNewest = droppedNewest_;
+    stats.blockedWrites = blockedWrites_;
+    stats.queueDepth = queue_.size();
+    stats.queueCapacity = queue_.capacity();
+    return stats;
+}
@@ -0,0 +1,90 @@
+#include "storage/latency_exporter.h"
+#include "storage/influx_writer.h"
+#include "storage/line_protocol.h"
+
+LatencyExporter::LatencyExporter(InfluxWriter& writer, std::chrono::milliseconds interval)
+    : writer_(writer),
+      interval_(interval),
+      previous_(NUM_LATENCY_STAGES),
+      current_(std::make_unique<LatencyHistogram>()),
+      delta_(std::make_unique<LatencyHistogram>()),
+      running_(false) {
+    // Before the feeds record anything, not lazily on the first sample
+    latency_clock::calibrate();
+}
+
+LatencyExporter::~LatencyExporter() {
+    stop();
+}
+
+void LatencyExporter::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread(&LatencyExporter::exportLoop, this);
+}
+
+void LatencyExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void LatencyExporter::exportLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cv_.wait_for(lock, interval_, [this] { return !running_; });
+
+        lock.unlock();
+        write(collect());
+        lock.lock();
+    }
+}
+
+std::vector<LatencyStageStats> LatencyExporter::collect() {
+    std::vector<LatencyStageStats> stats;
+
+    for (size_t s = 0; s < NUM_LATENCY_STAGES; ++s) {
+        auto stage = static_cast<LatencyStage>(s);
+        LatencyMetrics::instance().snapshot(stage, *current_);
+        if (current_->count() == previous_[s].count()) continue;
+
+        // Totals only grow, so the interval is the bucket-wise difference
+        delta_->reset();
+        for (size_t i = 0; i < LatencyHistogram::NUM_BUCKETS; ++i) {
+            delta_->addBucket(i, current_->bucket(i) - previous_[s].bucket(i));
+        }
+        previous_[s] = *current_;
+
+        stats.push_back(LatencyStageStats{
+            stage,
+            delta_->count(),
+            delta_->mean(),
+            delta_->percentile(0.50),
+            delta_->percentile(0.99),
+            delta_->percentile(0.999),
+            delta_->max()
+        });
+    }
+
+    return stats;
+}
+
+void LatencyExporter::write(const std::vector<LatencyStageStats>& stats) {
+    LineProtocolBuilder point;
+    for (const auto& s : stats) {
+        point.measurement("latency")
+             .tag("stage", latencyStageName(s.stage))
+             .intField("count", static_cast<int64_t>(s.count))
+             .field("mean_ns", s.meanNs)
+             .intField("p50_ns", static_cast<int64_t>(s.p50Ns))
+             .intField("p99_ns", static_cast<int64_t>(s.p99Ns))
+             .intField("p999_ns", static_cast<int64_t>(s.p999Ns))
+             .intField("max_ns", static_cast<int64_t>(s.maxNs));
+
+        writer_.writeAsync(point.line());
+    }
+}
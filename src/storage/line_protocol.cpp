@@ -0,0 +1,135 @@
+#include "storage/line_protocol.h"
+#include <charconv>
+#include <cmath>
+
+namespace {
+
+template <typename Pred>
+void appendEscaped(std::string& out, std::string_view text, Pred needsEscape) {
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (needsEscape(text[i])) {
+            out.append(text.data() + start, i - start);
+            out.push_back('\\');
+            out.push_back(text[i]);
+            start = i + 1;
+        }
+    }
+    out.append(text.data() + start, text.size() - start);
+}
+
+template <typename T>
+void appendNumber(std::string& out, T value) {
+    char digits[32];
+    auto res = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, res.ptr - digits);
+}
+
+}
+
+LineProtocolBuilder::LineProtocolBuilder(size_t reserve)
+    : numFields_(0), hasTimestamp_(false) {
+    buf_.reserve(reserve);
+}
+
+void LineProtocolBuilder::clear() {
+    buf_.clear();
+    numFields_ = 0;
+    hasTimestamp_ = false;
+}
+
+LineProtocolBuilder& LineProtocolBuilder::measurement(std::string_view name) {
+    clear();
+    appendMeasurement(buf_, name);
+    return *this;
+}
+
+LineProtocolBuilder& LineProtocolBuilder::series(std::string_view seriesKey) {
+    clear();
+    buf_.append(seriesKey.data(), seriesKey.size());
+    return *this;
+}
+
+LineProtocolBuilder& LineProtocolBuilder::tag(std::string_view key, std::string_view value) {
+    // Tags must precede fields; empty tag values are not allowed
+    if (numFields_ > 0 || value.empty()) return *this;
+
+    buf_.push_back(',');
+    appendTagOrKey(buf_, key);
+    buf_.push_back('=');
+    appendTagOrKey(buf_, value);
+    return *this;
+}
+
+void LineProtocolBuilder::beginField(std::string_view key) {
+    buf_.push_back(numFields_ == 0 ? ' ' : ',');
+    appendTagOrKey(buf_, key);
+    buf_.push_back('=');
+    ++numFields_;
+}
+
+LineProtocolBuilder& LineProtocolBuilder::field(std::string_view key, double value) {
+    if (!std::isfinite(value)) return *this;
+
+    beginField(key);
+    appendNumber(buf_, value);
+    return *this;
+}
+
+LineProtocolBuilder& LineProtocolBuilder::intField(std::string_view key, int64_t value) {
+    beginField(key);
+    appendNumber(buf_, value);
+    buf_.push_back('i');
+    return *this;
+}
+
+LineProtocolBuilder& LineProtocolBuilder::boolField(std::string_view key, bool value) {
+    beginField(key);
+    buf_.push_back(value ? 't' : 'f');
+    return *this;
+}
+
+LineProtocolBuilder& LineProtocolBuilder::stringField(std::string_view key, std::string_view value) {
+    beginField(key);
+    buf_.push_back('"');
+    appendStringValue(buf_, value);
+    buf_.push_back('"');
+    return *this;
+}
+
+LineProtocolBuilder& LineProtocolBuilder::timestampNs(int64_t ns) {
+    if (numFields_ == 0 || hasTimestamp_) return *this;
+
+    buf_.push_back(' ');
+    appendNumber(buf_, ns);
+    hasTimestamp_ = true;
+    return *this;
+}
+
+void LineProtocolBuilder::appendMeasurement(std::string& out, std::string_view name) {
+    appendEscaped(out, name, [](char c) { return c == ',' || c == ' '; });
+}
+
+void LineProtocolBuilder::appendTagOrKey(std::string& out, std::string_view text) {
+    appendEscaped(out, text, [](char c) { return c == ',' || c == '=' || c == ' '; });
+}
+
+void LineProtocolBuilder::appendStringValue(std::string& out, std::string_view text) {
+    appendEscaped(out, text, [](char c) { return c == '"' || c == '\\'; });
+}
+
+SeriesKeyCache::SeriesKeyCache(std::string_view measurement)
+    : measurement_(measurement) {}
+
+const std::string& SeriesKeyCache::operator()(const std::string& symbol) {
+    auto it = keys_.find(symbol);
+    if (it != keys_.end()) return it->second;
+
+    std::string key;
+    LineProtocolBuilder::appendMeasurement(key, measurement_);
+    if (!symbol.empty()) {
+        key += ",symbol=";
+        LineProtocolBuilder::appendTagOrKey(key, symbol);
+    }
+    return keys_.emplace(symbol, std::move(key)).first->second;
+}
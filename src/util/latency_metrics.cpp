@@ -0,0 +1,93 @@
+#include "util/latency_metrics.h"
+#include <mutex>
+#include <thread>
+
+const char* latencyStageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::PARSE: return "parse";
+        case LatencyStage::DISPATCH: return "dispatch";
+        case LatencyStage::ALPHA_SYSTEM: return "alpha_system";
+        case LatencyStage::ALPHA_MOMENTUM: return "alpha_momentum";
+        case LatencyStage::ALPHA_MICROSTRUCTURE: return "alpha_microstructure";
+        case LatencyStage::ALPHA_ORDER_FLOW: return "alpha_order_flow";
+        case LatencyStage::ALPHA_REGIME: return "alpha_regime";
+        case LatencyStage::ALPHA_VWAP: return "alpha_vwap";
+        case LatencyStage::ALPHA_BOLLINGER: return "alpha_bollinger";
+        case LatencyStage::INFLUX_ENCODE: return "influx_encode";
+        case LatencyStage::INFLUX_SEND: return "influx_send";
+        default: return "unknown";
+    }
+}
+
+namespace latency_clock {
+
+double nsPerTick() {
+#if defined(__x86_64__) || defined(__i386__)
+    // Count TSC ticks across a short steady_clock interval
+    using Clock = std::chrono::steady_clock;
+    auto wallStart = Clock::now();
+    uint64_t tscStart = now();
+    while (Clock::now() - wallStart < std::chrono::milliseconds(20)) {
+        std::this_thread::yield();
+    }
+    uint64_t tscEnd = now();
+    auto wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - wallStart).count();
+
+    return tscEnd > tscStart ? static_cast<double>(wallNs) / static_cast<double>(tscEnd - tscStart) : 1.0;
+#elif defined(__aarch64__)
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return frequency ? 1e9 / static_cast<double>(frequency) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+namespace detail {
+std::atomic<double> nsPerTickScale{1.0};
+}
+
+void calibrate() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        detail::nsPerTickScale.store(nsPerTick(), std::memory_order_relaxed);
+    });
+}
+
+}
+
+ThreadLatency::ThreadLatency() {
+    for (auto& buckets : stages_) {
+        for (auto& counter : buckets) counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ThreadLatency::addTo(LatencyStage stage, LatencyHistogram& out) const {
+    const Buckets& buckets = stages_[static_cast<size_t>(stage)];
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        out.addBucket(i, buckets[i].load(std::memory_order_relaxed));
+    }
+}
+
+ThreadLatency* LatencyMetrics::registerThread() {
+    auto histograms = std::make_unique<ThreadLatency>();
+    ThreadLatency* ptr = histograms.get();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back(std::move(histograms));
+    return ptr;
+}
+
+void LatencyMetrics::snapshot(LatencyStage stage, LatencyHistogram& out) const {
+    out.reset();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& thread : threads_) {
+        thread->addTo(stage, out);
+    }
+}
+
+size_t LatencyMetrics::threads() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threads_.size();
+}
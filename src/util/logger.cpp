@@ -0,0 +1,141 @@
+#include "util/logger.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(20);
+
+void flushAtExit() {
+    Logger::instance().flush();
+}
+
+LogStream& threadStream() {
+    thread_local LogStream stream;
+    return stream;
+}
+
+}
+
+LogLevel parseLogLevel(std::string_view name) {
+    std::string lower;
+    for (char c : name) lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    if (lower == "debug") return LogLevel::DEBUG;
+    if (lower == "warn" || lower == "warning") return LogLevel::WARN;
+    if (lower == "error") return LogLevel::ERROR;
+    if (lower == "off" || lower == "none") return LogLevel::OFF;
+    return LogLevel::INFO;
+}
+
+Logger& Logger::instance() {
+    // Leaked on purpose: detached feed threads may still log during exit
+    static Logger* logger = [] {
+        auto* created = new Logger();
+        std::atexit(flushAtExit);
+        return created;
+    }();
+    return *logger;
+}
+
+Logger::Logger()
+    : level_(LogLevel::INFO), dropped_(0) {
+    if (const char* env = std::getenv("ALPHA_LOG_LEVEL")) {
+        level_.store(parseLogLevel(env), std::memory_order_relaxed);
+    }
+
+    std::thread([this] { drainLoop(); }).detach();
+}
+
+Logger::ThreadBuffer& Logger::local() {
+    thread_local ThreadBuffer* buffer = [this] {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        buffers_.push_back(std::make_unique<ThreadBuffer>(THREAD_QUEUE_CAPACITY));
+        return buffers_.back().get();
+    }();
+    return *buffer;
+}
+
+void Logger::write(LogLevel level, std::string_view text) {
+    ThreadBuffer& buffer = local();
+    buffer.staging.level = level;
+    buffer.staging.text.assign(text.data(), text.size());
+
+    if (!buffer.queue.tryPush(buffer.staging)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::flush() {
+    drainOnce();
+}
+
+void Logger::drainLoop() {
+    while (true) {
+        std::this_thread::sleep_for(DRAIN_INTERVAL);
+        drainOnce();
+    }
+}
+
+void Logger::drainOnce() {
+    std::lock_guard<std::mutex> drainLock(drainMutex_);
+
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex_);
+        buffers.reserve(buffers_.size());
+        for (auto& buffer : buffers_) buffers.push_back(buffer.get());
+    }
+
+    // Whole rings one after another: a thread's lines stay in order, and a
+    // multi-line message (one record) is never split
+    out_.clear();
+    err_.clear();
+    for (ThreadBuffer* buffer : buffers) {
+        while (buffer->queue.tryPop(popped_)) {
+            std::string& target = popped_.level >= LogLevel::WARN ? err_ : out_;
+            target += popped_.text;
+        }
+    }
+
+    if (!out_.empty()) {
+        std::fwrite(out_.data(), 1, out_.size(), stdout);
+        std::fflush(stdout);
+    }
+    if (!err_.empty()) {
+        std::fwrite(err_.data(), 1, err_.size(), stderr);
+        std::fflush(stderr);
+    }
+}
+
+void LogStream::reset() {
+    text_.clear();
+    clear();
+    flags(std::ios_base::dec | std::ios_base::skipws);
+    precision(6);
+    width(0);
+    fill(' ');
+}
+
+std::streambuf::int_type LogStream::overflow(std::streambuf::int_type c) {
+    if (!std::streambuf::traits_type::eq_int_type(c, std::streambuf::traits_type::eof())) {
+        text_.push_back(std::streambuf::traits_type::to_char_type(c));
+    }
+    return std::streambuf::traits_type::not_eof(c);
+}
+
+std::streamsize LogStream::xsputn(const char* s, std::streamsize n) {
+    text_.append(s, static_cast<size_t>(n));
+    return n;
+}
+
+LogLine::LogLine(LogLevel level)
+    : level_(level), stream_(threadStream()) {
+    stream_.reset();
+}
+
+LogLine::~LogLine() {
+    stream_.text().push_back('\n');
+    Logger::instance().write(level_, stream_.text());
+}
@@ -0,0 +1,195 @@
+#include "util/snapshot.h"
+#include "util/logger.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'A', 'L', 'P', 'H', 'A', 'S', 'N', 'P'};
+constexpr uint32_t SNAPSHOT_VERSION = 3;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t sections;
+    uint64_t payloadBytes;
+    uint64_t checksum;          // FNV-1a over the payload
+    int64_t writtenAtNs;        // system_clock, nanoseconds since epoch
+};
+
+uint64_t fnv1a(const char* data, size_t bytes) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+}
+
+// === SnapshotFileBuilder ===
+void SnapshotFileBuilder::clear() {
+    payload_.clear();
+    sections_ = 0;
+}
+
+void SnapshotFileBuilder::add(std::string_view name, std::string_view blob) {
+    SnapshotWriter out;
+    out.data().swap(payload_);
+    out.writeString(name);
+    out.writeBlob(blob);
+    out.data().swap(payload_);
+    ++sections_;
+}
+
+void SnapshotFileBuilder::write(const std::string& path) const {
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.sections = sections_;
+    header.payloadBytes = payload_.size();
+    header.checksum = fnv1a(payload_.data(), payload_.size());
+    header.writtenAtNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    const std::string tmpPath = path + ".tmp";
+    FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Cannot open snapshot file: " + tmpPath);
+    }
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(payload_.data(), 1, payload_.size(), file) == payload_.size() &&
+              std::fflush(file) == 0 &&
+              ::fsync(::fileno(file)) == 0;
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error("Failed writing snapshot file: " + path);
+    }
+}
+
+// === MappedSnapshot ===
+MappedSnapshot::MappedSnapshot(const std::string& path)
+    : data_(nullptr), bytes_(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open snapshot file: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a snapshot (too short): " + path);
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+
+    void* mapped = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Cannot mmap snapshot file: " + path);
+    }
+    data_ = static_cast<const char*>(mapped);
+
+    try {
+        SnapshotHeader header;
+        std::memcpy(&header, data_, sizeof(header));
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+            header.version != SNAPSHOT_VERSION) {
+            throw std::runtime_error("Not a snapshot (bad header): " + path);
+        }
+
+        const char* payload = data_ + sizeof(header);
+        if (header.payloadBytes != bytes_ - sizeof(header) ||
+            header.checksum != fnv1a(payload, header.payloadBytes)) {
+            throw std::runtime_error("Snapshot is truncated or corrupt: " + path);
+        }
+        writtenAt_ = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(header.writtenAtNs)));
+
+        SnapshotReader in(payload, header.payloadBytes);
+        index_.reserve(header.sections);
+        for (uint32_t i = 0; i < header.sections; ++i) {
+            std::string_view name = in.readString();
+            index_.emplace_back(name, in.readBlob());
+        }
+    } catch (...) {
+        ::munmap(mapped, bytes_);
+        throw;
+    }
+}
+
+MappedSnapshot::~MappedSnapshot() {
+    if (data_) ::munmap(const_cast<char*>(data_), bytes_);
+}
+
+std::string_view MappedSnapshot::find(std::string_view name) const {
+    for (const auto& [sectionName, blob] : index_) {
+        if (sectionName == name) return blob;
+    }
+    return {};
+}
+
+// === SnapshotService ===
+SnapshotService::SnapshotService(std::string path, std::chrono::seconds interval)
+    : path_(std::move(path)),
+      interval_(interval),
+      running_(false),
+      written_(0) {}
+
+SnapshotService::~SnapshotService() {
+    stop();
+}
+
+void SnapshotService::addSource(Source source) {
+    sources_.push_back(std::move(source));
+}
+
+void SnapshotService::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread([this] { run(); });
+}
+
+void SnapshotService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+    writeNow();
+}
+
+bool SnapshotService::writeNow() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    try {
+        builder_.clear();
+        for (auto& source : sources_) source(builder_);
+        builder_.write(path_);
+        written_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR << "[Snapshot] " << e.what();
+        return false;
+    }
+}
+
+void SnapshotService::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        if (cv_.wait_for(lock, interval_, [this] { return !running_; })) break;
+
+        lock.unlock();
+        writeNow();
+        lock.lock();
+    }
+}